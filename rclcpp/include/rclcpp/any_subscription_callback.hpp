@@ -52,6 +52,19 @@ class AnySubscriptionCallback
   using UniquePtrWithInfoCallback =
     std::function<void (MessageUniquePtr, const rclcpp::MessageInfo &)>;
 
+  /// Signature of the callback which was set, so that dispatching does not test each of them.
+  enum class CallbackType
+  {
+    None,
+    SharedPtr,
+    SharedPtrWithInfo,
+    ConstSharedPtr,
+    ConstSharedPtrWithInfo,
+    UniquePtr,
+    UniquePtrWithInfo,
+  };
+
+  CallbackType callback_type_;
   SharedPtrCallback shared_ptr_callback_;
   SharedPtrWithInfoCallback shared_ptr_with_info_callback_;
   ConstSharedPtrCallback const_shared_ptr_callback_;
@@ -61,7 +74,8 @@ class AnySubscriptionCallback
 
 public:
   explicit AnySubscriptionCallback(std::shared_ptr<Alloc> allocator)
-  : shared_ptr_callback_(nullptr), shared_ptr_with_info_callback_(nullptr),
+  : callback_type_(CallbackType::None),
+    shared_ptr_callback_(nullptr), shared_ptr_with_info_callback_(nullptr),
     const_shared_ptr_callback_(nullptr), const_shared_ptr_with_info_callback_(nullptr),
     unique_ptr_callback_(nullptr), unique_ptr_with_info_callback_(nullptr)
   {
@@ -82,7 +96,9 @@ public:
   >
   void set(CallbackT callback)
   {
+    reset();
     shared_ptr_callback_ = callback;
+    callback_type_ = CallbackType::SharedPtr;
   }
 
   template<
@@ -96,7 +112,9 @@ public:
   >
   void set(CallbackT callback)
   {
+    reset();
     shared_ptr_with_info_callback_ = callback;
+    callback_type_ = CallbackType::SharedPtrWithInfo;
   }
 
   template<
@@ -110,7 +128,9 @@ public:
   >
   void set(CallbackT callback)
   {
+    reset();
     const_shared_ptr_callback_ = callback;
+    callback_type_ = CallbackType::ConstSharedPtr;
   }
 
   template<
@@ -124,7 +144,9 @@ public:
   >
   void set(CallbackT callback)
   {
+    reset();
     const_shared_ptr_with_info_callback_ = callback;
+    callback_type_ = CallbackType::ConstSharedPtrWithInfo;
   }
 
   template<
@@ -138,7 +160,9 @@ public:
   >
   void set(CallbackT callback)
   {
+    reset();
     unique_ptr_callback_ = callback;
+    callback_type_ = CallbackType::UniquePtr;
   }
 
   template<
@@ -152,31 +176,68 @@ public:
   >
   void set(CallbackT callback)
   {
+    reset();
     unique_ptr_with_info_callback_ = callback;
+    callback_type_ = CallbackType::UniquePtrWithInfo;
   }
 
   void dispatch(
     std::shared_ptr<MessageT> message, const rclcpp::MessageInfo & message_info)
   {
     TRACEPOINT(callback_start, static_cast<const void *>(this), false);
-    if (shared_ptr_callback_) {
-      shared_ptr_callback_(message);
-    } else if (shared_ptr_with_info_callback_) {
-      shared_ptr_with_info_callback_(message, message_info);
-    } else if (const_shared_ptr_callback_) {
-      const_shared_ptr_callback_(message);
-    } else if (const_shared_ptr_with_info_callback_) {
-      const_shared_ptr_with_info_callback_(message, message_info);
-    } else if (unique_ptr_callback_) {
-      auto ptr = MessageAllocTraits::allocate(*message_allocator_.get(), 1);
-      MessageAllocTraits::construct(*message_allocator_.get(), ptr, *message);
-      unique_ptr_callback_(MessageUniquePtr(ptr, message_deleter_));
-    } else if (unique_ptr_with_info_callback_) {
-      auto ptr = MessageAllocTraits::allocate(*message_allocator_.get(), 1);
-      MessageAllocTraits::construct(*message_allocator_.get(), ptr, *message);
-      unique_ptr_with_info_callback_(MessageUniquePtr(ptr, message_deleter_), message_info);
-    } else {
-      throw std::runtime_error("unexpected message without any callback set");
+    switch (callback_type_) {
+      case CallbackType::SharedPtr:
+        shared_ptr_callback_(message);
+        break;
+      case CallbackType::SharedPtrWithInfo:
+        shared_ptr_with_info_callback_(message, message_info);
+        break;
+      case CallbackType::ConstSharedPtr:
+        const_shared_ptr_callback_(message);
+        break;
+      case CallbackType::ConstSharedPtrWithInfo:
+        const_shared_ptr_with_info_callback_(message, message_info);
+        break;
+      case CallbackType::UniquePtr:
+        unique_ptr_callback_(copy_message(*message));
+        break;
+      case CallbackType::UniquePtrWithInfo:
+        unique_ptr_with_info_callback_(copy_message(*message), message_info);
+        break;
+      case CallbackType::None:
+      default:
+        throw std::runtime_error("unexpected message without any callback set");
+    }
+    TRACEPOINT(callback_end, static_cast<const void *>(this));
+  }
+
+  void dispatch(
+    MessageUniquePtr message, const rclcpp::MessageInfo & message_info)
+  {
+    TRACEPOINT(callback_start, static_cast<const void *>(this), false);
+    switch (callback_type_) {
+      case CallbackType::UniquePtr:
+        unique_ptr_callback_(std::move(message));
+        break;
+      case CallbackType::UniquePtrWithInfo:
+        unique_ptr_with_info_callback_(std::move(message), message_info);
+        break;
+      case CallbackType::SharedPtr:
+        shared_ptr_callback_(std::shared_ptr<MessageT>(std::move(message)));
+        break;
+      case CallbackType::SharedPtrWithInfo:
+        shared_ptr_with_info_callback_(std::shared_ptr<MessageT>(std::move(message)), message_info);
+        break;
+      case CallbackType::ConstSharedPtr:
+        const_shared_ptr_callback_(ConstMessageSharedPtr(std::move(message)));
+        break;
+      case CallbackType::ConstSharedPtrWithInfo:
+        const_shared_ptr_with_info_callback_(
+          ConstMessageSharedPtr(std::move(message)), message_info);
+        break;
+      case CallbackType::None:
+      default:
+        throw std::runtime_error("unexpected message without any callback set");
     }
     TRACEPOINT(callback_end, static_cast<const void *>(this));
   }
@@ -185,21 +246,19 @@ public:
     ConstMessageSharedPtr message, const rclcpp::MessageInfo & message_info)
   {
     TRACEPOINT(callback_start, static_cast<const void *>(this), true);
-    if (const_shared_ptr_callback_) {
-      const_shared_ptr_callback_(message);
-    } else if (const_shared_ptr_with_info_callback_) {
-      const_shared_ptr_with_info_callback_(message, message_info);
-    } else {
-      if (
-        unique_ptr_callback_ || unique_ptr_with_info_callback_ ||
-        shared_ptr_callback_ || shared_ptr_with_info_callback_)
-      {
+    switch (callback_type_) {
+      case CallbackType::ConstSharedPtr:
+        const_shared_ptr_callback_(message);
+        break;
+      case CallbackType::ConstSharedPtrWithInfo:
+        const_shared_ptr_with_info_callback_(message, message_info);
+        break;
+      case CallbackType::None:
+        throw std::runtime_error("unexpected message without any callback set");
+      default:
         throw std::runtime_error(
                 "unexpected dispatch_intra_process const shared "
                 "message call with no const shared_ptr callback");
-      } else {
-        throw std::runtime_error("unexpected message without any callback set");
-      }
     }
     TRACEPOINT(callback_end, static_cast<const void *>(this));
   }
@@ -208,59 +267,99 @@ public:
     MessageUniquePtr message, const rclcpp::MessageInfo & message_info)
   {
     TRACEPOINT(callback_start, static_cast<const void *>(this), true);
-    if (shared_ptr_callback_) {
-      typename std::shared_ptr<MessageT> shared_message = std::move(message);
-      shared_ptr_callback_(shared_message);
-    } else if (shared_ptr_with_info_callback_) {
-      typename std::shared_ptr<MessageT> shared_message = std::move(message);
-      shared_ptr_with_info_callback_(shared_message, message_info);
-    } else if (unique_ptr_callback_) {
-      unique_ptr_callback_(std::move(message));
-    } else if (unique_ptr_with_info_callback_) {
-      unique_ptr_with_info_callback_(std::move(message), message_info);
-    } else if (const_shared_ptr_callback_ || const_shared_ptr_with_info_callback_) {
-      throw std::runtime_error(
-              "unexpected dispatch_intra_process unique message call"
-              " with const shared_ptr callback");
-    } else {
-      throw std::runtime_error("unexpected message without any callback set");
+    switch (callback_type_) {
+      case CallbackType::SharedPtr:
+        shared_ptr_callback_(std::shared_ptr<MessageT>(std::move(message)));
+        break;
+      case CallbackType::SharedPtrWithInfo:
+        shared_ptr_with_info_callback_(std::shared_ptr<MessageT>(std::move(message)), message_info);
+        break;
+      case CallbackType::UniquePtr:
+        unique_ptr_callback_(std::move(message));
+        break;
+      case CallbackType::UniquePtrWithInfo:
+        unique_ptr_with_info_callback_(std::move(message), message_info);
+        break;
+      case CallbackType::ConstSharedPtr:
+      case CallbackType::ConstSharedPtrWithInfo:
+        throw std::runtime_error(
+                "unexpected dispatch_intra_process unique message call"
+                " with const shared_ptr callback");
+      case CallbackType::None:
+      default:
+        throw std::runtime_error("unexpected message without any callback set");
     }
     TRACEPOINT(callback_end, static_cast<const void *>(this));
   }
 
   bool use_take_shared_method() const
   {
-    return const_shared_ptr_callback_ || const_shared_ptr_with_info_callback_;
+    return
+      callback_type_ == CallbackType::ConstSharedPtr ||
+      callback_type_ == CallbackType::ConstSharedPtrWithInfo;
+  }
+
+  bool use_take_unique_method() const
+  {
+    return
+      callback_type_ == CallbackType::UniquePtr ||
+      callback_type_ == CallbackType::UniquePtrWithInfo;
   }
 
   void register_callback_for_tracing()
   {
 #ifndef TRACETOOLS_DISABLED
-    if (shared_ptr_callback_) {
-      TRACEPOINT(
-        rclcpp_callback_register,
-        static_cast<const void *>(this),
-        get_symbol(shared_ptr_callback_));
-    } else if (shared_ptr_with_info_callback_) {
-      TRACEPOINT(
-        rclcpp_callback_register,
-        static_cast<const void *>(this),
-        get_symbol(shared_ptr_with_info_callback_));
-    } else if (unique_ptr_callback_) {
-      TRACEPOINT(
-        rclcpp_callback_register,
-        static_cast<const void *>(this),
-        get_symbol(unique_ptr_callback_));
-    } else if (unique_ptr_with_info_callback_) {
-      TRACEPOINT(
-        rclcpp_callback_register,
-        static_cast<const void *>(this),
-        get_symbol(unique_ptr_with_info_callback_));
+    switch (callback_type_) {
+      case CallbackType::SharedPtr:
+        TRACEPOINT(
+          rclcpp_callback_register,
+          static_cast<const void *>(this),
+          get_symbol(shared_ptr_callback_));
+        break;
+      case CallbackType::SharedPtrWithInfo:
+        TRACEPOINT(
+          rclcpp_callback_register,
+          static_cast<const void *>(this),
+          get_symbol(shared_ptr_with_info_callback_));
+        break;
+      case CallbackType::UniquePtr:
+        TRACEPOINT(
+          rclcpp_callback_register,
+          static_cast<const void *>(this),
+          get_symbol(unique_ptr_callback_));
+        break;
+      case CallbackType::UniquePtrWithInfo:
+        TRACEPOINT(
+          rclcpp_callback_register,
+          static_cast<const void *>(this),
+          get_symbol(unique_ptr_with_info_callback_));
+        break;
+      default:
+        break;
     }
 #endif  // TRACETOOLS_DISABLED
   }
 
 private:
+  /// Clear the previously set callback, as only one of them is used.
+  void reset()
+  {
+    shared_ptr_callback_ = nullptr;
+    shared_ptr_with_info_callback_ = nullptr;
+    const_shared_ptr_callback_ = nullptr;
+    const_shared_ptr_with_info_callback_ = nullptr;
+    unique_ptr_callback_ = nullptr;
+    unique_ptr_with_info_callback_ = nullptr;
+    callback_type_ = CallbackType::None;
+  }
+
+  MessageUniquePtr copy_message(const MessageT & message)
+  {
+    auto ptr = MessageAllocTraits::allocate(*message_allocator_.get(), 1);
+    MessageAllocTraits::construct(*message_allocator_.get(), ptr, message);
+    return MessageUniquePtr(ptr, message_deleter_);
+  }
+
   std::shared_ptr<MessageAlloc> message_allocator_;
   MessageDeleter message_deleter_;
 };
@@ -0,0 +1,130 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__ASYNC_ROSOUT_PUBLISHER_HPP_
+#define RCLCPP__ASYNC_ROSOUT_PUBLISHER_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "rcl/node.h"
+#include "rcl/publisher.h"
+#include "rcl_interfaces/msg/log.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Publish the log records of a node on /rosout from a thread of its own.
+/**
+ * Normally, each log record of a node is published on /rosout by rcl, from
+ * the thread logging it, while the global logging mutex is held, so logging
+ * in any thread waits for the publication.
+ * Instead, the rclcpp logging output handler only queues the log records of
+ * the logger of a node which has this publisher, and the thread of the
+ * publisher publishes them, all the records queued since its last wake up at
+ * once, without holding the global logging mutex.
+ *
+ * The queue is bounded: the records logged while it is full are dropped and
+ * counted, and a warning with the number of records dropped is published
+ * once the queue could be drained again.
+ *
+ * It is created by nodes created with rclcpp::NodeOptions::async_rosout(),
+ * and the node then doesn't have a rosout publisher in rcl.
+ * Like the rosout publisher of rcl, it receives the records of the logger of
+ * the node only, not the ones of its child loggers.
+ */
+class AsyncRosoutPublisher
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(AsyncRosoutPublisher)
+
+  /// Publications of the publisher.
+  struct Statistics
+  {
+    /// Number of log records published, warnings about dropped records excluded.
+    uint64_t published_count = 0;
+    /// Number of log records dropped because the queue was full.
+    uint64_t dropped_count = 0;
+    /// Largest number of log records published at once.
+    size_t max_batch_size = 0;
+  };
+
+  /// Create the /rosout publisher of a node and start its thread.
+  /**
+   * \param[in] node_handle node to publish with, whose logger is published
+   * \param[in] qos QoS of the /rosout publisher
+   * \param[in] queue_depth maximum number of queued log records
+   * \throws std::invalid_argument if the queue depth is zero
+   * \throws rclcpp::exceptions::RCLError if the publisher can't be created
+   */
+  RCLCPP_PUBLIC
+  AsyncRosoutPublisher(
+    std::shared_ptr<rcl_node_t> node_handle,
+    const rclcpp::QoS & qos,
+    size_t queue_depth);
+
+  /// Publish the queued log records, then stop the thread and destroy the publisher.
+  RCLCPP_PUBLIC
+  virtual ~AsyncRosoutPublisher();
+
+  /// Return the name of the logger whose records are published.
+  RCLCPP_PUBLIC
+  const std::string &
+  get_logger_name() const;
+
+  /// Return the statistics of the publications.
+  RCLCPP_PUBLIC
+  Statistics
+  get_statistics() const;
+
+  /// Queue a log record, or drop it if the queue is full.
+  /** This is called by the logging output handler of rclcpp. */
+  RCLCPP_PUBLIC
+  void
+  enqueue(rcl_interfaces::msg::Log && log);
+
+private:
+  void
+  run();
+
+  /// Publish a log record, return false if it failed.
+  bool
+  publish(const rcl_interfaces::msg::Log & log);
+
+  std::shared_ptr<rcl_node_t> node_handle_;
+  rcl_publisher_t publisher_;
+  std::string logger_name_;
+  const size_t queue_depth_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  bool stopped_;
+  std::deque<rcl_interfaces::msg::Log> queue_;
+  /// Number of records dropped since the last warning about it.
+  uint64_t unreported_dropped_count_;
+  Statistics statistics_;
+  std::thread thread_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__ASYNC_ROSOUT_PUBLISHER_HPP_
@@ -0,0 +1,80 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__BULK_ENTITY_CREATION_SCOPE_HPP_
+#define RCLCPP__BULK_ENTITY_CREATION_SCOPE_HPP_
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/get_node_base_interface.hpp"
+#include "rclcpp/node_interfaces/node_base_interface.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Notify the executor of a node once for all the entities created in a scope.
+/**
+ * Each entity created or destroyed normally notifies the executor of the
+ * node, which then collects all the entities of the node again.
+ * While the scope exists, the notifications of the node are deferred, and the
+ * executor is notified once when the scope is destroyed, so creating many
+ * entities at once, e.g. when a node starts, doesn't wake up the executor for
+ * each of them.
+ *
+ * Scopes can be nested, the executor being notified when the outermost one
+ * is destroyed.
+ *
+ * \code
+ * {
+ *   rclcpp::BulkEntityCreationScope scope(node);
+ *   for (const auto & topic : topics) {
+ *     subscriptions.push_back(node->create_subscription<MsgT>(topic, 10, callback));
+ *   }
+ * }  // The executor is notified here.
+ * \endcode
+ */
+class BulkEntityCreationScope
+{
+public:
+  /// Defer the notifications of the given node.
+  RCLCPP_PUBLIC
+  explicit BulkEntityCreationScope(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base);
+
+  /// Defer the notifications of the given node.
+  /**
+   * The NodeT type needs to have the method get_node_base_interface(), e.g.
+   * rclcpp::Node.
+   */
+  template<typename NodeT>
+  explicit BulkEntityCreationScope(NodeT && node)
+  : BulkEntityCreationScope(rclcpp::node_interfaces::get_node_base_interface(node))
+  {}
+
+  /// Resume the notifications of the node, notifying its executor if needed.
+  /**
+   * A failure to notify the executor is logged, as it can't be thrown.
+   */
+  RCLCPP_PUBLIC
+  ~BulkEntityCreationScope();
+
+private:
+  RCLCPP_DISABLE_COPY(BulkEntityCreationScope)
+
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__BULK_ENTITY_CREATION_SCOPE_HPP_
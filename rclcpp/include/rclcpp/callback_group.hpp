@@ -21,6 +21,8 @@
 #include <vector>
 
 #include "rclcpp/client.hpp"
+#include "rclcpp/cpu_time.hpp"
+#include "rclcpp/detail/keyed_task_queue.hpp"
 #include "rclcpp/publisher_base.hpp"
 #include "rclcpp/service.hpp"
 #include "rclcpp/subscription_base.hpp"
@@ -43,7 +45,8 @@ class NodeWaitables;
 enum class CallbackGroupType
 {
   MutuallyExclusive,
-  Reentrant
+  Reentrant,
+  KeyOrdered
 };
 
 class CallbackGroup
@@ -71,6 +74,19 @@ public:
    *   - will not be run at the same time as other callbacks in their group
    *   - but must run at the same time as callbacks in other groups
    *
+   * Callbacks in Key Ordered Callback Groups are run like in Reentrant
+   * Callback Groups, except that subscription callbacks for messages with the
+   * same key:
+   *   - will not be run at the same time as each other
+   *   - will be run in the order in which their messages were taken
+   *
+   * The key of a message is the subscription it was received by, unless the
+   * subscription has an ordering key function, see
+   * rclcpp::Subscription::set_ordering_key_function().
+   * Messages of serialized subscriptions and loaned messages are not ordered.
+   * Neither are messages delivered intra-process, whose callbacks bypass the
+   * key ordering and are run like in Reentrant Callback Groups.
+   *
    * Additionally, callback groups have a property which determines whether or
    * not they are added to an executor with their associated node automatically.
    * When creating a callback group the automatically_add_to_executor_with_node
@@ -130,6 +146,40 @@ public:
     return _find_ptrs_if_impl<rclcpp::Waitable, Function>(func, waitable_ptrs_);
   }
 
+  /// Call the given functions for every entity of the group which is still alive.
+  /**
+   * Unlike the find_*_ptrs_if() functions, which take the group's mutex once per entity
+   * type, this visits all of the entities of the group while holding the mutex only once.
+   * The functions are called with the mutex held, so they must not call back into this group.
+   *
+   * \param[in] sub_func function called for each subscription
+   * \param[in] service_func function called for each service
+   * \param[in] client_func function called for each client
+   * \param[in] timer_func function called for each timer
+   * \param[in] waitable_func function called for each waitable
+   */
+  template<
+    typename SubscriptionFunction,
+    typename ServiceFunction,
+    typename ClientFunction,
+    typename TimerFunction,
+    typename WaitableFunction>
+  void
+  collect_all_ptrs(
+    SubscriptionFunction sub_func,
+    ServiceFunction service_func,
+    ClientFunction client_func,
+    TimerFunction timer_func,
+    WaitableFunction waitable_func) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    _for_each_ptr_impl<rclcpp::SubscriptionBase>(sub_func, subscription_ptrs_);
+    _for_each_ptr_impl<rclcpp::ServiceBase>(service_func, service_ptrs_);
+    _for_each_ptr_impl<rclcpp::ClientBase>(client_func, client_ptrs_);
+    _for_each_ptr_impl<rclcpp::TimerBase>(timer_func, timer_ptrs_);
+    _for_each_ptr_impl<rclcpp::Waitable>(waitable_func, waitable_ptrs_);
+  }
+
   RCLCPP_PUBLIC
   std::atomic_bool &
   can_be_taken_from();
@@ -138,6 +188,15 @@ public:
   const CallbackGroupType &
   type() const;
 
+  /// Return the queue used to order subscription callbacks by key.
+  /**
+   * This is only used by executors if the type of this group is
+   * CallbackGroupType::KeyOrdered.
+   */
+  RCLCPP_PUBLIC
+  rclcpp::detail::KeyedTaskQueue &
+  get_keyed_task_queue();
+
   /// Return a reference to the 'associated with executor' atomic boolean.
   /**
    * When a callback group is added to an executor this boolean is checked
@@ -163,6 +222,15 @@ public:
   bool
   automatically_add_to_executor_with_node() const;
 
+  /// Return the thread CPU time spent executing the callbacks of this group.
+  /**
+   * Only executors created with rclcpp::ExecutorOptions::cpu_time_accounting
+   * add to this account.
+   */
+  RCLCPP_PUBLIC
+  rclcpp::CpuTimeAccount &
+  get_cpu_time_account();
+
 protected:
   RCLCPP_DISABLE_COPY(CallbackGroup)
 
@@ -205,6 +273,8 @@ protected:
   std::vector<rclcpp::Waitable::WeakPtr> waitable_ptrs_;
   std::atomic_bool can_be_taken_from_;
   const bool automatically_add_to_executor_with_node_;
+  rclcpp::detail::KeyedTaskQueue keyed_task_queue_;
+  rclcpp::CpuTimeAccount cpu_time_account_;
 
 private:
   template<typename TypeT, typename Function>
@@ -220,6 +290,18 @@ private:
     }
     return typename TypeT::SharedPtr();
   }
+
+  template<typename TypeT, typename Function>
+  void _for_each_ptr_impl(
+    Function & func, const std::vector<typename TypeT::WeakPtr> & vect_ptrs) const
+  {
+    for (auto & weak_ptr : vect_ptrs) {
+      auto ref_ptr = weak_ptr.lock();
+      if (ref_ptr) {
+        func(ref_ptr);
+      }
+    }
+  }
 };
 
 namespace callback_group
@@ -136,6 +136,16 @@ public:
   virtual void handle_response(
     std::shared_ptr<rmw_request_id_t> request_header, std::shared_ptr<void> response) = 0;
 
+  /// Return the approximate number of bytes of memory retained by this client.
+  /**
+   * This includes the client itself and its pending requests, see
+   * rclcpp::get_memory_usage().
+   */
+  RCLCPP_PUBLIC
+  virtual
+  size_t
+  get_memory_usage() const;
+
   /// Exchange the "in use by wait set" state for this client.
   /**
    * This is used to ensure this client is not used by multiple
@@ -241,6 +251,17 @@ public:
   {
   }
 
+  size_t
+  get_memory_usage() const override
+  {
+    using PendingRequest = typename decltype(pending_requests_)::value_type;
+    // Each pending request holds a map entry, and its future will hold a response.
+    const size_t pending_request_size =
+      sizeof(PendingRequest) + sizeof(typename ServiceT::Response);
+    std::lock_guard<std::mutex> lock(pending_requests_mutex_);
+    return sizeof(*this) + pending_requests_.size() * pending_request_size;
+  }
+
   /// Take the next response for this client.
   /**
    * \sa ClientBase::take_type_erased_response().
@@ -377,7 +398,7 @@ private:
   RCLCPP_DISABLE_COPY(Client)
 
   std::map<int64_t, std::tuple<SharedPromise, CallbackType, SharedFuture>> pending_requests_;
-  std::mutex pending_requests_mutex_;
+  mutable std::mutex pending_requests_mutex_;
 };
 
 }  // namespace rclcpp
@@ -0,0 +1,76 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__CPU_TIME_HPP_
+#define RCLCPP__CPU_TIME_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Return the CPU time consumed by the calling thread so far.
+/**
+ * On POSIX systems this is CLOCK_THREAD_CPUTIME_ID, on Windows the sum of
+ * the kernel and user times of the thread.
+ * Only differences between two calls on the same thread are meaningful.
+ *
+ * \return the CPU time of the calling thread, or zero if it is not available
+ */
+RCLCPP_PUBLIC
+std::chrono::nanoseconds
+get_thread_cpu_time() noexcept;
+
+/// Thread CPU time spent executing the callbacks of a node or a callback group.
+/**
+ * Executors add to the account of the node and of the callback group of each
+ * executable they execute, when enabled with
+ * rclcpp::ExecutorOptions::cpu_time_accounting.
+ * Accounts can be read and added to concurrently.
+ */
+class CpuTimeAccount
+{
+public:
+  CpuTimeAccount() = default;
+
+  /// Add the CPU time of one execution.
+  RCLCPP_PUBLIC
+  void
+  add(std::chrono::nanoseconds cpu_time) noexcept;
+
+  /// Return the CPU time accumulated so far.
+  RCLCPP_PUBLIC
+  std::chrono::nanoseconds
+  get_cpu_time() const noexcept;
+
+  /// Return the number of executions accounted so far.
+  RCLCPP_PUBLIC
+  uint64_t
+  get_execution_count() const noexcept;
+
+private:
+  RCLCPP_DISABLE_COPY(CpuTimeAccount)
+
+  std::atomic<int64_t> cpu_time_ns_{0};
+  std::atomic<uint64_t> execution_count_{0};
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__CPU_TIME_HPP_
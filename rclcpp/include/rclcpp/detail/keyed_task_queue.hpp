@@ -0,0 +1,116 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__KEYED_TASK_QUEUE_HPP_
+#define RCLCPP__DETAIL__KEYED_TASK_QUEUE_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "rclcpp/scope_exit.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Runs tasks in parallel across keys, but one at a time and in order for each key.
+/**
+ * Tasks are produced by a take function which is called with the queue's
+ * mutex held, so tasks are queued for their key in the same order in which
+ * they were taken, no matter which threads take them.
+ *
+ * The first thread to queue a task for a key which has no running task runs
+ * it, and then keeps running any tasks queued for that key in the meantime.
+ * Other threads only queue their task and return, so no thread ever blocks
+ * waiting for a task with the same key to finish.
+ */
+class KeyedTaskQueue
+{
+public:
+  using Task = std::function<void()>;
+
+  /// Take a task and run it, or queue it behind the running task with the same key.
+  /**
+   * \param[in] take function with the signature `bool(std::size_t & key, Task & task)`
+   *   which returns false if nothing was taken, it is called with a lock held
+   *   so it must not call back into this queue.
+   */
+  template<typename TakeFunctionT>
+  void
+  take_and_run(TakeFunctionT && take)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::size_t key = 0;
+    Task task;
+    if (!take(key, task)) {
+      return;
+    }
+    KeyState & state = keys_[key];
+    state.pending.push_back(std::move(task));
+    if (state.running) {
+      // The thread running the previous task of this key will run this one.
+      return;
+    }
+    state.running = true;
+    // Release the key even if a task throws, in which case the remaining tasks
+    // are left for the next thread to queue a task for this key.
+    RCLCPP_SCOPE_EXIT(
+    {
+      if (!lock.owns_lock()) {
+        lock.lock();
+      }
+      state.running = false;
+      if (state.pending.empty()) {
+        keys_.erase(key);
+      }
+    });
+    // Elements of an unordered_map are not moved by insertions of other keys,
+    // and only the running thread erases this key, so state stays valid.
+    while (!state.pending.empty()) {
+      Task next = std::move(state.pending.front());
+      state.pending.pop_front();
+      lock.unlock();
+      next();
+      lock.lock();
+    }
+  }
+
+  /// Return the number of keys which have running or queued tasks.
+  std::size_t
+  number_of_active_keys() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return keys_.size();
+  }
+
+private:
+  struct KeyState
+  {
+    bool running = false;
+    std::deque<Task> pending;
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::size_t, KeyState> keys_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__KEYED_TASK_QUEUE_HPP_
@@ -0,0 +1,115 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__DETAIL__TIMER_WHEEL_HPP_
+#define RCLCPP__DETAIL__TIMER_WHEEL_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+/// Hashed timer wheel which runs many coarse timers from a single thread.
+/**
+ * Timers are placed in one of a fixed number of slots, according to the tick
+ * in which they expire, so adding, re-arming and canceling a timer takes
+ * constant time no matter how many timers there are.
+ * Expiration times are rounded up to the next tick, and the thread of the
+ * wheel only wakes up at the tick of the earliest expiration.
+ *
+ * Callbacks are called from the thread of the wheel, so they should be short,
+ * e.g. only update some state and trigger a guard condition.
+ * A callback returns the time at which it should be called again, or
+ * `TimePoint()` to be removed from the wheel.
+ */
+class TimerWheel
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(TimerWheel)
+
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = Clock::time_point;
+  using Callback = std::function<TimePoint(TimePoint now)>;
+  using TimerId = uint64_t;
+
+  /// Start the thread of the wheel.
+  /**
+   * \param[in] tick resolution of the wheel
+   * \param[in] number_of_slots number of slots, timers expiring further in the
+   *   future than `tick * number_of_slots` are visited more than once
+   * \throws std::invalid_argument if tick is not positive or number_of_slots is 0
+   */
+  RCLCPP_PUBLIC
+  explicit TimerWheel(
+    std::chrono::nanoseconds tick = std::chrono::milliseconds(1),
+    size_t number_of_slots = 1024);
+
+  /// Stop the thread of the wheel, timers which are still in it are not called again.
+  RCLCPP_PUBLIC
+  ~TimerWheel();
+
+  /// Get the wheel shared by everything in the process.
+  /**
+   * It is created on first use, and kept alive while it is referenced.
+   */
+  RCLCPP_PUBLIC
+  static
+  TimerWheel::SharedPtr
+  get_global_instance();
+
+  /// Add a timer, which calls the callback at or shortly after the given time.
+  RCLCPP_PUBLIC
+  TimerId
+  add_timer(TimePoint expiration_time, Callback callback);
+
+  /// Remove a timer.
+  /**
+   * When this returns the callback of the timer is not running, and will not
+   * be called again, unless this is called from that callback.
+   * Removing a timer which was already removed does nothing.
+   */
+  RCLCPP_PUBLIC
+  void
+  remove_timer(TimerId timer_id);
+
+  /// Return the number of timers in the wheel.
+  RCLCPP_PUBLIC
+  size_t
+  size() const;
+
+private:
+  RCLCPP_DISABLE_COPY(TimerWheel)
+
+  // Shared with the thread of the wheel, which keeps it alive while the wheel
+  // is destroyed from one of the callbacks.
+  struct State;
+
+  std::shared_ptr<State> state_;
+  std::thread thread_;
+};
+
+}  // namespace detail
+}  // namespace rclcpp
+
+#endif  // RCLCPP__DETAIL__TIMER_WHEEL_HPP_
@@ -0,0 +1,243 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXECUTION_WATCHDOG_HPP_
+#define RCLCPP__EXECUTION_WATCHDOG_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "rclcpp/any_executable.hpp"
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/client.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/service.hpp"
+#include "rclcpp/subscription_base.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/visibility_control.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+
+/// Watch the execution time of callbacks against budgets and report overruns.
+/**
+ * Budgets are set for callback groups or for single entities, the budget of
+ * an entity taking precedence over the budget of its callback group.
+ * Executors created with the watchdog in rclcpp::ExecutorOptions report the
+ * start and the end of the execution of each executable to it.
+ *
+ * Callbacks are never interrupted.
+ * When an execution exceeds its budget, the overrun is counted in the
+ * statistics of the budget, and the overrun handler is called once, as soon
+ * as the budget is exceeded, from a thread of the watchdog, so a callback
+ * which doesn't return is reported too.
+ * The handler must therefore be thread safe, and should return quickly, as
+ * it delays the report of other overruns.
+ *
+ * Timers can also skip some of their next invocations after an overrun, to
+ * let a loop catch up.
+ * A skipped invocation rearms the timer without calling its callback.
+ *
+ * Budgets of entities or groups which are destroyed are forgotten.
+ */
+class ExecutionWatchdog
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ExecutionWatchdog)
+
+  /// Overrun of the budget of an execution.
+  struct Overrun
+  {
+    /// The executable, with the entity and the callback group which overran.
+    rclcpp::AnyExecutable executable;
+    std::chrono::nanoseconds budget;
+    /// Execution time when the overrun was reported.
+    std::chrono::nanoseconds execution_time;
+    /// True if the execution was already over, so execution_time is final.
+    bool finished;
+  };
+
+  using OverrunHandler = std::function<void (const Overrun &)>;
+
+  /// Executions of an entity or a callback group which has a budget.
+  struct Statistics
+  {
+    uint64_t execution_count = 0;
+    uint64_t overrun_count = 0;
+    uint64_t skipped_count = 0;
+    std::chrono::nanoseconds max_execution_time{0};
+  };
+
+  /// Create a watchdog and start its thread.
+  RCLCPP_PUBLIC
+  ExecutionWatchdog();
+
+  /// Stop the thread of the watchdog.
+  /**
+   * Overruns which were not reported yet are dropped.
+   */
+  RCLCPP_PUBLIC
+  virtual ~ExecutionWatchdog();
+
+  /// Set the function called for each overrun.
+  RCLCPP_PUBLIC
+  void
+  set_overrun_handler(OverrunHandler handler);
+
+  /// Set the budget of each execution of the callbacks of a callback group.
+  RCLCPP_PUBLIC
+  void
+  set_budget(const rclcpp::CallbackGroup::SharedPtr & group, std::chrono::nanoseconds budget);
+
+  /// Set the budget of each execution of a timer.
+  /**
+   * \param[in] timer timer to watch
+   * \param[in] budget execution time budget of the timer callback
+   * \param[in] skip_on_overrun number of next invocations of the timer to skip
+   *   when an execution overruns its budget
+   */
+  RCLCPP_PUBLIC
+  void
+  set_budget(
+    const rclcpp::TimerBase::SharedPtr & timer,
+    std::chrono::nanoseconds budget,
+    size_t skip_on_overrun = 0);
+
+  /// Set the budget of each execution of a subscription.
+  RCLCPP_PUBLIC
+  void
+  set_budget(
+    const rclcpp::SubscriptionBase::SharedPtr & subscription, std::chrono::nanoseconds budget);
+
+  /// Set the budget of each execution of a service.
+  RCLCPP_PUBLIC
+  void
+  set_budget(const rclcpp::ServiceBase::SharedPtr & service, std::chrono::nanoseconds budget);
+
+  /// Set the budget of each execution of a client.
+  RCLCPP_PUBLIC
+  void
+  set_budget(const rclcpp::ClientBase::SharedPtr & client, std::chrono::nanoseconds budget);
+
+  /// Set the budget of each execution of a waitable.
+  RCLCPP_PUBLIC
+  void
+  set_budget(const rclcpp::Waitable::SharedPtr & waitable, std::chrono::nanoseconds budget);
+
+  /// Remove the budget of an entity or a callback group.
+  template<typename EntityT>
+  void
+  remove_budget(const std::shared_ptr<EntityT> & entity)
+  {
+    remove_budget_impl(entity.get());
+  }
+
+  /// Return the statistics of the executions of an entity or a callback group with a budget.
+  /**
+   * \return the statistics, all zero if there is no budget for the entity
+   */
+  template<typename EntityT>
+  Statistics
+  get_statistics(const std::shared_ptr<EntityT> & entity) const
+  {
+    return get_statistics_impl(entity.get());
+  }
+
+  /// Return true and count it if the next invocation of a timer is to be skipped.
+  /** This is called by executors before executing a timer. */
+  RCLCPP_PUBLIC
+  bool
+  skip_timer(const rclcpp::TimerBase & timer);
+
+  /// Start watching an execution.
+  /**
+   * This is called by executors before executing an executable.
+   *
+   * \return an identifier to give to end_execution(), or 0 if the executable
+   *   has no budget and isn't watched
+   */
+  RCLCPP_PUBLIC
+  uint64_t
+  start_execution(const rclcpp::AnyExecutable & executable);
+
+  /// Stop watching an execution started with start_execution().
+  RCLCPP_PUBLIC
+  void
+  end_execution(uint64_t execution_id);
+
+private:
+  RCLCPP_PUBLIC
+  void
+  set_budget_impl(
+    const void * entity, std::weak_ptr<const void> entity_weak_ptr,
+    std::chrono::nanoseconds budget, size_t skip_on_overrun);
+
+  RCLCPP_PUBLIC
+  void
+  remove_budget_impl(const void * entity);
+
+  RCLCPP_PUBLIC
+  Statistics
+  get_statistics_impl(const void * entity) const;
+
+  struct Budget
+  {
+    std::weak_ptr<const void> entity;
+    std::chrono::nanoseconds budget;
+    size_t skip_on_overrun;
+    size_t pending_skips;
+    Statistics statistics;
+  };
+
+  struct Execution
+  {
+    rclcpp::AnyExecutable executable;
+    const void * budget_key;
+    std::chrono::nanoseconds budget;
+    std::chrono::steady_clock::time_point start;
+    bool reported;
+  };
+
+  /// Return the budget of an entity or group, forgetting it if the entity was destroyed.
+  Budget *
+  find_budget(const void * entity);
+
+  void
+  run();
+
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  bool stopped_;
+  OverrunHandler handler_;
+  std::unordered_map<const void *, Budget> budgets_;
+  uint64_t next_execution_id_;
+  std::map<uint64_t, Execution> executions_;
+  /// Time until which the watchdog thread sleeps, or min() while it is awake.
+  std::chrono::steady_clock::time_point wait_deadline_;
+  std::vector<Overrun> finished_overruns_;
+  std::thread thread_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTION_WATCHDOG_HPP_
@@ -25,12 +25,15 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "rcl/guard_condition.h"
 #include "rcl/wait.h"
 
 #include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/detail/keyed_task_queue.hpp"
 #include "rclcpp/guard_condition.hpp"
 #include "rclcpp/executor_options.hpp"
 #include "rclcpp/future_return_code.hpp"
@@ -424,19 +427,34 @@ protected:
   RCLCPP_PUBLIC
   static void
   execute_subscription(
-    rclcpp::SubscriptionBase::SharedPtr subscription);
+    const rclcpp::SubscriptionBase::SharedPtr & subscription);
+
+  /// Execute a subscription of a callback group of type CallbackGroupType::KeyOrdered.
+  /**
+   * The message is taken while holding the lock of the given queue, and then
+   * its callback is run by this thread or queued behind the running callback
+   * for the same key.
+   *
+   * \param[in] subscription subscription to take a message from
+   * \param[in] queue keyed task queue of the subscription's callback group
+   */
+  RCLCPP_PUBLIC
+  static void
+  execute_key_ordered_subscription(
+    const rclcpp::SubscriptionBase::SharedPtr & subscription,
+    rclcpp::detail::KeyedTaskQueue & queue);
 
   RCLCPP_PUBLIC
   static void
-  execute_timer(rclcpp::TimerBase::SharedPtr timer);
+  execute_timer(const rclcpp::TimerBase::SharedPtr & timer);
 
   RCLCPP_PUBLIC
   static void
-  execute_service(rclcpp::ServiceBase::SharedPtr service);
+  execute_service(const rclcpp::ServiceBase::SharedPtr & service);
 
   RCLCPP_PUBLIC
   static void
-  execute_client(rclcpp::ClientBase::SharedPtr client);
+  execute_client(const rclcpp::ClientBase::SharedPtr & client);
 
   /**
    * \throws std::runtime_error if the wait set can be cleared
@@ -448,7 +466,7 @@ protected:
   RCLCPP_PUBLIC
   rclcpp::node_interfaces::NodeBaseInterface::SharedPtr
   get_node_by_group(
-    WeakCallbackGroupsToNodesMap weak_groups_to_nodes,
+    const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes,
     rclcpp::CallbackGroup::SharedPtr group);
 
   /// Return true if the node has been added to this executor.
@@ -460,8 +478,13 @@ protected:
   bool
   has_node(
     const rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
-    WeakCallbackGroupsToNodesMap weak_groups_to_nodes) const;
+    const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) const;
 
+  /// Return the callback group of a timer, or nullptr if it is in none of the groups.
+  /**
+   * The timers are indexed when their group is added, and the ones created
+   * later when first looked up.
+   */
   RCLCPP_PUBLIC
   rclcpp::CallbackGroup::SharedPtr
   get_group_by_timer(rclcpp::TimerBase::SharedPtr timer);
@@ -497,7 +520,7 @@ protected:
   bool
   get_next_ready_executable_from_map(
     AnyExecutable & any_executable,
-    WeakCallbackGroupsToNodesMap weak_groups_to_nodes);
+    const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes);
 
   RCLCPP_PUBLIC
   bool
@@ -540,6 +563,12 @@ protected:
   /// The context associated with this executor.
   std::shared_ptr<rclcpp::Context> context_;
 
+  /// True to account the thread CPU time of executed callbacks, see ExecutorOptions.
+  const bool cpu_time_accounting_;
+
+  /// Watchdog of the execution time of callbacks, see ExecutorOptions.
+  rclcpp::ExecutionWatchdog::SharedPtr execution_watchdog_;
+
   RCLCPP_DISABLE_COPY(Executor)
 
   RCLCPP_PUBLIC
@@ -563,6 +592,11 @@ protected:
   /// maps all callback groups to nodes
   WeakCallbackGroupsToNodesMap weak_groups_to_nodes_;
 
+  /// maps timers to their callback group, see get_group_by_timer()
+  std::unordered_map<
+    const rclcpp::TimerBase *,
+    std::pair<rclcpp::TimerBase::WeakPtr, rclcpp::CallbackGroup::WeakPtr>> timers_to_groups_;
+
   /// nodes that are associated with the executor
   std::list<rclcpp::node_interfaces::NodeBaseInterface::WeakPtr> weak_nodes_;
 };
@@ -17,6 +17,7 @@
 
 #include "rclcpp/context.hpp"
 #include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/execution_watchdog.hpp"
 #include "rclcpp/memory_strategies.hpp"
 #include "rclcpp/memory_strategy.hpp"
 #include "rclcpp/visibility_control.hpp"
@@ -30,12 +31,26 @@ struct ExecutorOptions
   ExecutorOptions()
   : memory_strategy(rclcpp::memory_strategies::create_default_strategy()),
     context(rclcpp::contexts::get_global_default_context()),
-    max_conditions(0)
+    max_conditions(0),
+    cpu_time_accounting(false)
   {}
 
   rclcpp::memory_strategy::MemoryStrategy::SharedPtr memory_strategy;
   rclcpp::Context::SharedPtr context;
   size_t max_conditions;
+  /// Measure the thread CPU time of each executed callback.
+  /**
+   * The time is added to rclcpp::CallbackGroup::get_cpu_time_account() and
+   * rclcpp::node_interfaces::NodeBaseInterface::get_cpu_time_account() of
+   * the owning callback group and node.
+   * It costs two reads of the thread CPU clock per callback.
+   */
+  bool cpu_time_accounting;
+  /// Watchdog checking the execution time of callbacks against budgets, or nullptr.
+  /**
+   * \see rclcpp::ExecutionWatchdog
+   */
+  rclcpp::ExecutionWatchdog::SharedPtr execution_watchdog;
 };
 
 namespace executor
@@ -19,8 +19,10 @@
 #include <memory>
 
 #include "rclcpp/executors/multi_threaded_executor.hpp"
+#include "rclcpp/executors/numa_executor.hpp"
 #include "rclcpp/executors/single_threaded_executor.hpp"
 #include "rclcpp/executors/static_single_threaded_executor.hpp"
+#include "rclcpp/executors/static_wait_set_executor.hpp"
 #include "rclcpp/node.hpp"
 #include "rclcpp/utilities.hpp"
 #include "rclcpp/visibility_control.hpp"
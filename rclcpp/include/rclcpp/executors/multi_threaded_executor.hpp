@@ -86,7 +86,7 @@ private:
   bool yield_before_execute_;
   std::chrono::nanoseconds next_exec_timeout_;
 
-  std::set<TimerBase::SharedPtr> scheduled_timers_;
+  std::set<const TimerBase *> scheduled_timers_;
 };
 
 }  // namespace executors
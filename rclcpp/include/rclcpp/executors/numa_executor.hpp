@@ -0,0 +1,178 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXECUTORS__NUMA_EXECUTOR_HPP_
+#define RCLCPP__EXECUTORS__NUMA_EXECUTOR_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/executor_options.hpp"
+#include "rclcpp/executors/multi_threaded_executor.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/get_node_base_interface.hpp"
+#include "rclcpp/node_interfaces/node_base_interface.hpp"
+#include "rclcpp/numa.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace executors
+{
+
+/// Executor running the callbacks of each callback group on the CPUs of a NUMA node.
+/**
+ * Callback groups and nodes are assigned to a NUMA node of the topology when
+ * they are added.
+ * For each NUMA node, a rclcpp::executors::MultiThreadedExecutor executes
+ * the callback groups assigned to it with threads bound to the node, see
+ * rclcpp::NumaTopology::bind_current_thread(), so the memory these
+ * callbacks allocate is preferably taken from the node too.
+ * To also take the messages copied for intra-process subscriptions and the
+ * messages of pools from the node, use rclcpp::NumaAllocator.
+ *
+ * Like rclcpp::executors::StaticWaitSetExecutor, this executor is not a
+ * rclcpp::Executor and can't be used with rclcpp::spin().
+ */
+class NumaExecutor
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(NumaExecutor)
+
+  /// Create an executor for the nodes of a topology.
+  /**
+   * \param[in] topology NUMA topology, which may be simulated
+   * \param[in] threads_per_numa_node number of threads of each NUMA node, or 0
+   *   for as many threads as the NUMA node has CPUs
+   * \param[in] options options of the executor of each NUMA node, which each
+   *   get a new default memory strategy, since they can't share one
+   */
+  RCLCPP_PUBLIC
+  explicit NumaExecutor(
+    const rclcpp::NumaTopology & topology = rclcpp::NumaTopology::detect(),
+    size_t threads_per_numa_node = 0,
+    const rclcpp::ExecutorOptions & options = rclcpp::ExecutorOptions());
+
+  RCLCPP_PUBLIC
+  virtual ~NumaExecutor();
+
+  /// Return the topology of the executor.
+  RCLCPP_PUBLIC
+  const rclcpp::NumaTopology &
+  get_numa_topology() const;
+
+  /// Add a callback group, executed on a NUMA node.
+  /**
+   * \see rclcpp::Executor::add_callback_group
+   * \throws std::out_of_range if numa_node is not a node of the topology
+   */
+  RCLCPP_PUBLIC
+  void
+  add_callback_group(
+    rclcpp::CallbackGroup::SharedPtr group_ptr,
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+    size_t numa_node,
+    bool notify = true);
+
+  /// Remove a callback group added with add_callback_group().
+  /**
+   * \throws std::runtime_error if the callback group wasn't added to this executor
+   */
+  RCLCPP_PUBLIC
+  void
+  remove_callback_group(rclcpp::CallbackGroup::SharedPtr group_ptr, bool notify = true);
+
+  /// Add a node, whose callback groups are executed on a NUMA node.
+  /**
+   * \see rclcpp::Executor::add_node
+   * \throws std::out_of_range if numa_node is not a node of the topology
+   */
+  RCLCPP_PUBLIC
+  void
+  add_node(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+    size_t numa_node,
+    bool notify = true);
+
+  /// Add a node, whose callback groups are executed on a NUMA node.
+  template<typename NodeT>
+  void
+  add_node(std::shared_ptr<NodeT> node_ptr, size_t numa_node, bool notify = true)
+  {
+    add_node(rclcpp::node_interfaces::get_node_base_interface(node_ptr), numa_node, notify);
+  }
+
+  /// Remove a node added with add_node().
+  /**
+   * \throws std::runtime_error if the node wasn't added to this executor
+   */
+  RCLCPP_PUBLIC
+  void
+  remove_node(rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr, bool notify = true);
+
+  /// Remove a node added with add_node().
+  template<typename NodeT>
+  void
+  remove_node(std::shared_ptr<NodeT> node_ptr, bool notify = true)
+  {
+    remove_node(rclcpp::node_interfaces::get_node_base_interface(node_ptr), notify);
+  }
+
+  /// Execute callbacks on the threads of all NUMA nodes until cancel() or shutdown.
+  /**
+   * The calling thread only waits for the threads of the NUMA nodes.
+   *
+   * \throws std::runtime_error when spin() is called while already spinning
+   */
+  RCLCPP_PUBLIC
+  void
+  spin();
+
+  /// Stop spinning.
+  RCLCPP_PUBLIC
+  void
+  cancel();
+
+private:
+  void
+  cancel_executors();
+
+  template<typename KeyT>
+  using NumaNodeMap = std::map<std::weak_ptr<KeyT>, size_t, std::owner_less<std::weak_ptr<KeyT>>>;
+
+  rclcpp::NumaTopology topology_;
+  std::vector<std::unique_ptr<rclcpp::executors::MultiThreadedExecutor>> executors_;
+
+  std::mutex mutex_;
+  NumaNodeMap<rclcpp::CallbackGroup> group_numa_nodes_;
+  NumaNodeMap<rclcpp::node_interfaces::NodeBaseInterface> node_numa_nodes_;
+  std::atomic_bool spinning_;
+
+  /// Protects cancelled_ and running_count_ while spinning.
+  std::mutex spin_mutex_;
+  std::condition_variable spin_condition_;
+  bool cancelled_;
+  /// Number of threads of NUMA nodes which haven't returned from spin() yet.
+  size_t running_count_;
+};
+
+}  // namespace executors
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTORS__NUMA_EXECUTOR_HPP_
@@ -0,0 +1,303 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXECUTORS__STATIC_WAIT_SET_EXECUTOR_HPP_
+#define RCLCPP__EXECUTORS__STATIC_WAIT_SET_EXECUTOR_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+#include "rcl/wait.h"
+
+#include "rclcpp/client.hpp"
+#include "rclcpp/context.hpp"
+#include "rclcpp/contexts/default_context.hpp"
+#include "rclcpp/executor.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/scope_exit.hpp"
+#include "rclcpp/service.hpp"
+#include "rclcpp/subscription_base.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/utilities.hpp"
+#include "rclcpp/wait_set.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+namespace executors
+{
+
+/// Single-threaded executor for a set of entities which is fixed at compile time.
+/**
+ * Unlike the other executors, this executor does not work with nodes or
+ * callback groups, and it does not use a memory strategy.
+ * Instead all of the entities it executes are given to the constructor, and
+ * their number is given as template arguments, in the same way as for
+ * rclcpp::StaticWaitSet, which is used internally.
+ *
+ * Waiting therefore uses fixed sized storage, and spinning does no dynamic
+ * allocation of its own, though taking a message may still allocate,
+ * depending on the message memory strategy of the subscription.
+ * This is intended for deployments where the set of entities is known ahead
+ * of time.
+ *
+ * Each time the wait set wakes up, all ready entities are executed, in the
+ * order timers, subscriptions, services, clients and then waitables.
+ * Guard conditions only wake up the executor, they have nothing to execute.
+ *
+ * The given entities must not also be executed by another executor.
+ *
+ * \tparam NumberOfSubscriptions number of subscriptions to execute
+ * \tparam NumberOfGuardConditions number of guard conditions which may wake the executor
+ * \tparam NumberOfTimers number of timers to execute
+ * \tparam NumberOfClients number of clients to execute
+ * \tparam NumberOfServices number of services to execute
+ * \tparam NumberOfWaitables number of waitables to execute
+ */
+template<
+  std::size_t NumberOfSubscriptions,
+  std::size_t NumberOfGuardConditions,
+  std::size_t NumberOfTimers,
+  std::size_t NumberOfClients,
+  std::size_t NumberOfServices,
+  std::size_t NumberOfWaitables
+>
+class StaticWaitSetExecutor
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(StaticWaitSetExecutor)
+
+  using Subscriptions =
+    std::array<rclcpp::SubscriptionBase::SharedPtr, NumberOfSubscriptions>;
+  using GuardConditions =
+    std::array<rclcpp::GuardCondition::SharedPtr, NumberOfGuardConditions>;
+  using Timers = std::array<rclcpp::TimerBase::SharedPtr, NumberOfTimers>;
+  using Clients = std::array<rclcpp::ClientBase::SharedPtr, NumberOfClients>;
+  using Services = std::array<rclcpp::ServiceBase::SharedPtr, NumberOfServices>;
+  using Waitables = std::array<rclcpp::Waitable::SharedPtr, NumberOfWaitables>;
+
+  /// Construct the executor for the given entities.
+  /**
+   * \param[in] subscriptions Subscriptions to be executed.
+   * \param[in] guard_conditions Guard conditions which wake up the executor.
+   * \param[in] timers Timers to be executed.
+   * \param[in] clients Clients to be executed.
+   * \param[in] services Services to be executed.
+   * \param[in] waitables Waitables to be executed.
+   * \param[in] context Context used to create the wait set and to stop on shutdown.
+   * \throws std::invalid_argument if context is nullptr.
+   * \throws std::runtime_error if any of the entities is nullptr.
+   */
+  explicit
+  StaticWaitSetExecutor(
+    const Subscriptions & subscriptions,
+    const GuardConditions & guard_conditions,
+    const Timers & timers,
+    const Clients & clients,
+    const Services & services,
+    const Waitables & waitables,
+    rclcpp::Context::SharedPtr context = rclcpp::contexts::get_global_default_context())
+  : context_(context),
+    interrupt_guard_condition_(std::make_shared<rclcpp::GuardCondition>(context)),
+    subscriptions_(subscriptions),
+    timers_(timers),
+    clients_(clients),
+    services_(services),
+    waitables_(waitables),
+    wait_set_(
+      make_subscription_entries(subscriptions),
+      make_guard_conditions(guard_conditions, interrupt_guard_condition_),
+      timers,
+      clients,
+      services,
+      make_waitable_entries(waitables),
+      context)
+  {
+    // Wake up on shutdown, the guard condition is only weakly referenced as
+    // the callback cannot be removed from the context again.
+    std::weak_ptr<rclcpp::GuardCondition> weak_interrupt = interrupt_guard_condition_;
+    context_->on_shutdown(
+      [weak_interrupt]() {
+        auto interrupt = weak_interrupt.lock();
+        if (interrupt) {
+          interrupt->trigger();
+        }
+      });
+  }
+
+  virtual ~StaticWaitSetExecutor() = default;
+
+  /// Execute ready entities until canceled or the context is shut down.
+  /**
+   * \throws std::runtime_error when spin() called while already spinning
+   */
+  void
+  spin()
+  {
+    if (spinning_.exchange(true)) {
+      throw std::runtime_error("spin() called while already spinning");
+    }
+    RCLCPP_SCOPE_EXIT(this->spinning_.store(false); );
+    while (rclcpp::ok(context_) && spinning_.load()) {
+      this->wait_and_execute(std::chrono::nanoseconds(-1));
+    }
+  }
+
+  /// Wait once for entities to become ready, and execute all that are.
+  /**
+   * \param[in] timeout maximum time to wait, negative to wait indefinitely
+   * \throws std::runtime_error when spin_once() called while already spinning
+   */
+  template<typename RepT = int64_t, typename T = std::milli>
+  void
+  spin_once(std::chrono::duration<RepT, T> timeout = std::chrono::duration<RepT, T>(-1))
+  {
+    if (spinning_.exchange(true)) {
+      throw std::runtime_error("spin_once() called while already spinning");
+    }
+    RCLCPP_SCOPE_EXIT(this->spinning_.store(false); );
+    this->wait_and_execute(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout));
+  }
+
+  /// Cancel any running spin* function, causing it to return.
+  /**
+   * This function can be called asynchonously from any thread.
+   */
+  void
+  cancel()
+  {
+    spinning_.store(false);
+    interrupt_guard_condition_->trigger();
+  }
+
+protected:
+  using WaitSetType = rclcpp::StaticWaitSet<
+    NumberOfSubscriptions,
+    NumberOfGuardConditions + 1,  // Extra guard condition to interrupt waiting.
+    NumberOfTimers,
+    NumberOfClients,
+    NumberOfServices,
+    NumberOfWaitables
+  >;
+
+  /// Exposes the entity execution of rclcpp::Executor, which is protected.
+  struct ExecutorAccess : public rclcpp::Executor
+  {
+    using rclcpp::Executor::execute_client;
+    using rclcpp::Executor::execute_service;
+    using rclcpp::Executor::execute_subscription;
+    using rclcpp::Executor::execute_timer;
+  };
+
+  void
+  wait_and_execute(std::chrono::nanoseconds timeout)
+  {
+    auto wait_result = wait_set_.wait(timeout);
+    if (wait_result.kind() != rclcpp::WaitResultKind::Ready) {
+      return;
+    }
+    // The entities given to the constructor always come first in the rcl
+    // wait set, in order, followed by the ones added by waitables.
+    const rcl_wait_set_t & rcl_wait_set = wait_result.get_wait_set().get_rcl_wait_set();
+    for (std::size_t i = 0; i < NumberOfTimers; ++i) {
+      if (rcl_wait_set.timers[i] && timers_[i]->is_ready()) {
+        ExecutorAccess::execute_timer(timers_[i]);
+      }
+    }
+    for (std::size_t i = 0; i < NumberOfSubscriptions; ++i) {
+      if (rcl_wait_set.subscriptions[i]) {
+        ExecutorAccess::execute_subscription(subscriptions_[i]);
+      }
+    }
+    for (std::size_t i = 0; i < NumberOfServices; ++i) {
+      if (rcl_wait_set.services[i]) {
+        ExecutorAccess::execute_service(services_[i]);
+      }
+    }
+    for (std::size_t i = 0; i < NumberOfClients; ++i) {
+      if (rcl_wait_set.clients[i]) {
+        ExecutorAccess::execute_client(clients_[i]);
+      }
+    }
+    // Waitables need a mutable wait set to check if they are ready.
+    rcl_wait_set_t & mutable_rcl_wait_set = const_cast<rcl_wait_set_t &>(rcl_wait_set);
+    for (std::size_t i = 0; i < NumberOfWaitables; ++i) {
+      if (waitables_[i]->is_ready(&mutable_rcl_wait_set)) {
+        std::shared_ptr<void> data = waitables_[i]->take_data();
+        waitables_[i]->execute(data);
+      }
+    }
+  }
+
+  static
+  std::array<typename WaitSetType::SubscriptionEntry, NumberOfSubscriptions>
+  make_subscription_entries(const Subscriptions & subscriptions)
+  {
+    std::array<typename WaitSetType::SubscriptionEntry, NumberOfSubscriptions> entries;
+    for (std::size_t i = 0; i < NumberOfSubscriptions; ++i) {
+      entries[i] = subscriptions[i];
+    }
+    return entries;
+  }
+
+  static
+  std::array<rclcpp::GuardCondition::SharedPtr, NumberOfGuardConditions + 1>
+  make_guard_conditions(
+    const GuardConditions & guard_conditions,
+    const rclcpp::GuardCondition::SharedPtr & interrupt_guard_condition)
+  {
+    std::array<rclcpp::GuardCondition::SharedPtr, NumberOfGuardConditions + 1> all;
+    for (std::size_t i = 0; i < NumberOfGuardConditions; ++i) {
+      all[i] = guard_conditions[i];
+    }
+    all[NumberOfGuardConditions] = interrupt_guard_condition;
+    return all;
+  }
+
+  static
+  std::array<typename WaitSetType::WaitableEntry, NumberOfWaitables>
+  make_waitable_entries(const Waitables & waitables)
+  {
+    std::array<typename WaitSetType::WaitableEntry, NumberOfWaitables> entries;
+    for (std::size_t i = 0; i < NumberOfWaitables; ++i) {
+      entries[i] = waitables[i];
+    }
+    return entries;
+  }
+
+  rclcpp::Context::SharedPtr context_;
+  rclcpp::GuardCondition::SharedPtr interrupt_guard_condition_;
+  std::atomic_bool spinning_{false};
+
+  const Subscriptions subscriptions_;
+  const Timers timers_;
+  const Clients clients_;
+  const Services services_;
+  const Waitables waitables_;
+
+  WaitSetType wait_set_;
+
+private:
+  RCLCPP_DISABLE_COPY(StaticWaitSetExecutor)
+};
+
+}  // namespace executors
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXECUTORS__STATIC_WAIT_SET_EXECUTOR_HPP_
@@ -15,6 +15,9 @@
 #ifndef RCLCPP__EXPERIMENTAL__BUFFERS__BUFFER_IMPLEMENTATION_BASE_HPP_
 #define RCLCPP__EXPERIMENTAL__BUFFERS__BUFFER_IMPLEMENTATION_BASE_HPP_
 
+#include <chrono>
+#include <cstddef>
+
 namespace rclcpp
 {
 namespace experimental
@@ -33,6 +36,33 @@ public:
 
   virtual void clear() = 0;
   virtual bool has_data() const = 0;
+
+  /// Remove the elements which were enqueued before the given time.
+  /**
+   * Implementations which do not record when elements are enqueued keep all
+   * of them, which is what this default does.
+   *
+   * \param time elements enqueued before this time are removed
+   * \return the number of removed elements
+   */
+  virtual size_t remove_enqueued_before(std::chrono::steady_clock::time_point time)
+  {
+    (void)time;
+    return 0;
+  }
+
+  /// Return the approximate number of bytes of memory retained by the buffer.
+  /**
+   * Implementations which do not account for their memory return 0, which is
+   * what this default does.
+   *
+   * \param element_size size of what each stored element points to
+   */
+  virtual size_t get_memory_usage(size_t element_size) const
+  {
+    (void)element_size;
+    return 0;
+  }
 };
 
 }  // namespace buffers
@@ -15,6 +15,7 @@
 #ifndef RCLCPP__EXPERIMENTAL__BUFFERS__INTRA_PROCESS_BUFFER_HPP_
 #define RCLCPP__EXPERIMENTAL__BUFFERS__INTRA_PROCESS_BUFFER_HPP_
 
+#include <chrono>
 #include <memory>
 #include <type_traits>
 #include <utility>
@@ -42,6 +43,15 @@ public:
 
   virtual bool has_data() const = 0;
   virtual bool use_take_shared_method() const = 0;
+
+  /// Remove the stored messages which are older than the lifespan of the buffer.
+  /**
+   * \return the number of removed messages
+   */
+  virtual size_t remove_expired() {return 0;}
+
+  /// Return the approximate number of bytes of memory retained by the buffer and its messages.
+  virtual size_t get_memory_usage() const {return 0;}
 };
 
 template<
@@ -80,10 +90,20 @@ public:
   using MessageUniquePtr = std::unique_ptr<MessageT, MessageDeleter>;
   using MessageSharedPtr = std::shared_ptr<const MessageT>;
 
+  /// Constructor.
+  /**
+   * \param buffer_impl buffer implementation used to store the messages.
+   * \param allocator allocator used to copy messages.
+   * \param lifespan messages older than this are removed by remove_expired(),
+   *   zero or a negative value disables it.
+   *   The buffer implementation must record enqueue times for this to have an effect.
+   */
   explicit
   TypedIntraProcessBuffer(
     std::unique_ptr<BufferImplementationBase<BufferT>> buffer_impl,
-    std::shared_ptr<Alloc> allocator = nullptr)
+    std::shared_ptr<Alloc> allocator = nullptr,
+    std::chrono::nanoseconds lifespan = std::chrono::nanoseconds::zero())
+  : lifespan_(lifespan)
   {
     bool valid_type = (std::is_same<BufferT, MessageSharedPtr>::value ||
       std::is_same<BufferT, MessageUniquePtr>::value);
@@ -137,8 +157,22 @@ public:
     return std::is_same<BufferT, MessageSharedPtr>::value;
   }
 
+  size_t remove_expired() override
+  {
+    if (lifespan_ <= std::chrono::nanoseconds::zero()) {
+      return 0;
+    }
+    return buffer_->remove_enqueued_before(std::chrono::steady_clock::now() - lifespan_);
+  }
+
+  size_t get_memory_usage() const override
+  {
+    return sizeof(*this) + buffer_->get_memory_usage(sizeof(MessageT));
+  }
+
 private:
   std::unique_ptr<BufferImplementationBase<BufferT>> buffer_;
+  std::chrono::nanoseconds lifespan_;
 
   std::shared_ptr<MessageAlloc> message_allocator_;
 
@@ -16,6 +16,7 @@
 #define RCLCPP__EXPERIMENTAL__BUFFERS__RING_BUFFER_IMPLEMENTATION_HPP_
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -40,14 +41,18 @@ namespace buffers
 /// Store elements in a fixed-size, FIFO buffer
 /**
  * All public member functions are thread-safe.
+ *
+ * If requested, the time at which each element is enqueued is recorded, so
+ * that old elements can be removed with remove_enqueued_before().
  */
 template<typename BufferT>
 class RingBufferImplementation : public BufferImplementationBase<BufferT>
 {
 public:
-  explicit RingBufferImplementation(size_t capacity)
+  explicit RingBufferImplementation(size_t capacity, bool record_enqueue_times = false)
   : capacity_(capacity),
     ring_buffer_(capacity),
+    enqueue_times_(record_enqueue_times ? capacity : 0),
     write_index_(capacity_ - 1),
     read_index_(0),
     size_(0)
@@ -71,6 +76,9 @@ public:
 
     write_index_ = next_(write_index_);
     ring_buffer_[write_index_] = std::move(request);
+    if (!enqueue_times_.empty()) {
+      enqueue_times_[write_index_] = std::chrono::steady_clock::now();
+    }
 
     if (is_full_()) {
       read_index_ = next_(read_index_);
@@ -142,6 +150,48 @@ public:
 
   void clear() {}
 
+  /// Remove the elements which were enqueued before the given time
+  /**
+   * This member function is thread-safe.
+   * Nothing is removed unless the buffer was constructed to record enqueue times.
+   *
+   * \param time elements enqueued before this time are removed
+   * \return the number of removed elements
+   */
+  size_t remove_enqueued_before(std::chrono::steady_clock::time_point time)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (enqueue_times_.empty()) {
+      return 0;
+    }
+    // Elements are stored in the order they were enqueued, so only the oldest ones can expire.
+    size_t removed = 0;
+    while (has_data_() && enqueue_times_[read_index_] < time) {
+      ring_buffer_[read_index_] = BufferT();
+      read_index_ = next_(read_index_);
+      size_--;
+      removed++;
+    }
+    return removed;
+  }
+
+  /// Return the approximate number of bytes of memory retained by the buffer
+  /**
+   * This member function is thread-safe.
+   *
+   * \param element_size size of what each stored element points to
+   * \return the size of the ring and of the stored elements
+   */
+  size_t get_memory_usage(size_t element_size) const override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sizeof(*this) +
+           ring_buffer_.capacity() * sizeof(BufferT) +
+           enqueue_times_.capacity() * sizeof(std::chrono::steady_clock::time_point) +
+           size_ * element_size;
+  }
+
 private:
   /// Get the next index value for the ring buffer
   /**
@@ -181,6 +231,7 @@ private:
   size_t capacity_;
 
   std::vector<BufferT> ring_buffer_;
+  std::vector<std::chrono::steady_clock::time_point> enqueue_times_;
 
   size_t write_index_;
   size_t read_index_;
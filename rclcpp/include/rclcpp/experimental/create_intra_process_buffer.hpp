@@ -15,6 +15,7 @@
 #ifndef RCLCPP__EXPERIMENTAL__CREATE_INTRA_PROCESS_BUFFER_HPP_
 #define RCLCPP__EXPERIMENTAL__CREATE_INTRA_PROCESS_BUFFER_HPP_
 
+#include <chrono>
 #include <memory>
 #include <type_traits>
 #include <utility>
@@ -45,6 +46,15 @@ create_intra_process_buffer(
 
   size_t buffer_size = qos.depth;
 
+  // Lifespan is only enforced if it is finite, otherwise enqueue times are not recorded.
+  std::chrono::nanoseconds lifespan =
+    std::chrono::seconds(qos.lifespan.sec) + std::chrono::nanoseconds(qos.lifespan.nsec);
+  bool enforce_lifespan =
+    lifespan > std::chrono::nanoseconds::zero() && lifespan != std::chrono::nanoseconds::max();
+  if (!enforce_lifespan) {
+    lifespan = std::chrono::nanoseconds::zero();
+  }
+
   using rclcpp::experimental::buffers::IntraProcessBuffer;
   typename IntraProcessBuffer<MessageT, Alloc, Deleter>::UniquePtr buffer;
 
@@ -55,14 +65,15 @@ create_intra_process_buffer(
 
         auto buffer_implementation =
           std::make_unique<rclcpp::experimental::buffers::RingBufferImplementation<BufferT>>(
-          buffer_size);
+          buffer_size, enforce_lifespan);
 
         // Construct the intra_process_buffer
         buffer =
           std::make_unique<rclcpp::experimental::buffers::TypedIntraProcessBuffer<MessageT, Alloc,
             Deleter, BufferT>>(
           std::move(buffer_implementation),
-          allocator);
+          allocator,
+          lifespan);
 
         break;
       }
@@ -72,14 +83,15 @@ create_intra_process_buffer(
 
         auto buffer_implementation =
           std::make_unique<rclcpp::experimental::buffers::RingBufferImplementation<BufferT>>(
-          buffer_size);
+          buffer_size, enforce_lifespan);
 
         // Construct the intra_process_buffer
         buffer =
           std::make_unique<rclcpp::experimental::buffers::TypedIntraProcessBuffer<MessageT, Alloc,
             Deleter, BufferT>>(
           std::move(buffer_implementation),
-          allocator);
+          allocator,
+          lifespan);
 
         break;
       }
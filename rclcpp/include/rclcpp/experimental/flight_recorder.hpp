@@ -0,0 +1,268 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__FLIGHT_RECORDER_HPP_
+#define RCLCPP__EXPERIMENTAL__FLIGHT_RECORDER_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rosidl_runtime_cpp/traits.hpp"
+
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/subscription_base.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+class FlightRecorder;
+
+/// Records the serialized messages of one topic into a region of a FlightRecorder file.
+class FlightRecorderTopic
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(FlightRecorderTopic)
+
+  /// Record a serialized message, received now.
+  /**
+   * Recording only copies the message into the memory mapped file.
+   * The oldest messages are overwritten when the region of the topic is full,
+   * and messages older than the time window of the recorder are dropped.
+   * Messages larger than the region of the topic are not recorded.
+   * This member function is thread-safe.
+   *
+   * \param[in] data serialized message
+   * \param[in] size size of the serialized message in bytes
+   * \return `true` if the message was recorded, `false` if it is too large
+   */
+  RCLCPP_PUBLIC
+  bool
+  record(const uint8_t * data, size_t size);
+
+  /// Record a serialized message, received at the given time.
+  RCLCPP_PUBLIC
+  bool
+  record(const uint8_t * data, size_t size, std::chrono::system_clock::time_point receive_time);
+
+  /// Record a serialized message, received now.
+  RCLCPP_PUBLIC
+  bool
+  record(const rclcpp::SerializedMessage & message);
+
+  /// Return the name of the recorded topic.
+  RCLCPP_PUBLIC
+  std::string
+  get_topic_name() const;
+
+private:
+  friend class FlightRecorder;
+
+  FlightRecorderTopic(
+    std::shared_ptr<void> mapping,
+    uint8_t * topic_base,
+    size_t capacity,
+    std::chrono::nanoseconds window);
+
+  void
+  set_topic_name(const std::string & topic_name);
+
+  uint64_t
+  next_record_offset(uint64_t offset) const;
+
+  void
+  drop_records_until(uint64_t offset, int64_t expired_before);
+
+  // Keeps the mapped file alive while the topic is, e.g. in a subscription callback.
+  std::shared_ptr<void> mapping_;
+  uint8_t * topic_base_;
+  uint8_t * ring_;
+  const size_t capacity_;
+  const std::chrono::nanoseconds window_;
+  mutable std::mutex mutex_;
+};
+
+/// Records the last messages of selected topics into a memory mapped file.
+/**
+ * Each recorded topic gets a fixed size ring in the file, into which its
+ * serialized messages are copied as they are received, along with their
+ * receive time.
+ * As the file is memory mapped and shared, its content is always up to date,
+ * and it is written out by the operating system even if the process crashes,
+ * so no signal handler is needed to keep the data of a crash.
+ * dump() can be used to take a copy on request, e.g. to keep the data of an
+ * incident while recording continues.
+ *
+ * Messages older than the time window of the recorder are dropped when newer
+ * messages are recorded, and skipped by read_flight_record().
+ *
+ * The file format is:
+ *  - a 64 byte file header:
+ *    the magic "RCLFREC1", uint32 version, uint32 number of topic slots,
+ *    uint64 ring size per topic, int64 time window in nanoseconds,
+ *    uint32 number of used topic slots, and padding,
+ *  - for each topic slot a 528 byte topic header:
+ *    topic name and type name as 256 byte nul terminated strings,
+ *    uint64 offset of the oldest record and uint64 offset past the newest one,
+ *    followed by the ring,
+ *  - offsets only increase, the position in the ring is the offset modulo its size,
+ *  - each record is an int64 receive time, a uint32 size, a uint32 kind, which
+ *    is 1 for padding up to the end of the ring and 0 otherwise, and the
+ *    serialized message padded to 8 bytes, records never wrap around,
+ *  - integers use the byte order of the recording machine.
+ */
+class FlightRecorder
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(FlightRecorder)
+
+  /// Create the recorder and its file.
+  /**
+   * \param[in] file_path path of the file, it is replaced if it exists
+   * \param[in] max_number_of_topics maximum number of recorded topics
+   * \param[in] bytes_per_topic size of the ring of each topic
+   * \param[in] window time for which messages are kept
+   * \throws std::invalid_argument if any of the sizes or the window is zero
+   * \throws std::runtime_error if the file cannot be created or mapped
+   */
+  RCLCPP_PUBLIC
+  FlightRecorder(
+    const std::string & file_path,
+    size_t max_number_of_topics,
+    size_t bytes_per_topic,
+    std::chrono::nanoseconds window);
+
+  RCLCPP_PUBLIC
+  virtual ~FlightRecorder();
+
+  /// Add a topic to the recorder, which is then fed by calling record() on the result.
+  /**
+   * This can be used to record messages from any source, e.g. to record the
+   * messages of a publisher.
+   *
+   * \param[in] topic_name name of the topic
+   * \param[in] type_name name of the message type, e.g. "std_msgs/msg/String"
+   * \throws std::runtime_error if the maximum number of topics is reached
+   */
+  RCLCPP_PUBLIC
+  FlightRecorderTopic::SharedPtr
+  add_topic(const std::string & topic_name, const std::string & type_name);
+
+  /// Record a topic with a serialized subscription.
+  /**
+   * The subscription is owned by the recorder, and is executed by whichever
+   * executor the node is added to.
+   *
+   * \param[in] node node used to create the subscription
+   * \param[in] topic_name name of the topic
+   * \param[in] qos QoS of the subscription
+   * \return the created subscription
+   */
+  template<typename MessageT, typename NodeT>
+  rclcpp::SubscriptionBase::SharedPtr
+  record_topic(NodeT && node, const std::string & topic_name, const rclcpp::QoS & qos)
+  {
+    auto topic = this->add_topic(topic_name, rosidl_generator_traits::name<MessageT>());
+    auto subscription = rclcpp::create_subscription<MessageT>(
+      std::forward<NodeT>(node),
+      topic_name,
+      qos,
+      [topic](std::shared_ptr<rclcpp::SerializedMessage> message) {
+        topic->record(*message);
+      });
+    // Replace the name with the fully qualified one.
+    topic->set_topic_name(subscription->get_topic_name());
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscriptions_.push_back(subscription);
+    return subscription;
+  }
+
+  /// Write a copy of the recorded messages to another memory mapped file.
+  /**
+   * Recording is blocked while the copy is made.
+   *
+   * \param[in] file_path path of the copy, it is replaced if it exists
+   * \throws std::runtime_error if the file cannot be created or mapped
+   */
+  RCLCPP_PUBLIC
+  void
+  dump(const std::string & file_path) const;
+
+  /// Ask the operating system to write the recorded messages to the file now.
+  RCLCPP_PUBLIC
+  void
+  flush() const;
+
+private:
+  RCLCPP_DISABLE_COPY(FlightRecorder)
+
+  std::shared_ptr<void> mapping_;
+  uint8_t * base_;
+  size_t size_;
+  size_t max_number_of_topics_;
+  size_t bytes_per_topic_;
+  std::chrono::nanoseconds window_;
+
+  mutable std::mutex mutex_;
+  std::vector<FlightRecorderTopic::SharedPtr> topics_;
+  std::vector<rclcpp::SubscriptionBase::SharedPtr> subscriptions_;
+};
+
+/// Content of a file written by a FlightRecorder.
+struct FlightRecord
+{
+  struct Message
+  {
+    std::chrono::system_clock::time_point receive_time;
+    std::vector<uint8_t> serialized_data;
+  };
+
+  struct Topic
+  {
+    std::string topic_name;
+    std::string type_name;
+    /// Messages ordered from oldest to newest.
+    std::vector<Message> messages;
+  };
+
+  std::chrono::nanoseconds window;
+  std::vector<Topic> topics;
+};
+
+/// Read a file written by a FlightRecorder, e.g. after a crash.
+/**
+ * Only the messages within the time window before the newest message are returned.
+ *
+ * \param[in] file_path path of the file
+ * \throws std::runtime_error if the file cannot be read or is not valid
+ */
+RCLCPP_PUBLIC
+FlightRecord
+read_flight_record(const std::string & file_path);
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__FLIGHT_RECORDER_HPP_
@@ -22,9 +22,12 @@
 #include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <deque>
 #include <exception>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -45,6 +48,94 @@ namespace rclcpp
 namespace experimental
 {
 
+/// Type erased history of the messages published by a transient local publisher.
+class IntraProcessPublisherHistoryBase
+{
+public:
+  RCLCPP_SMART_PTR_ALIASES_ONLY(IntraProcessPublisherHistoryBase)
+
+  virtual ~IntraProcessPublisherHistoryBase() = default;
+
+  /// Give all messages of the history, oldest first, to a late joining subscription.
+  virtual void
+  replay(const SubscriptionIntraProcessBase::SharedPtr & subscription) const = 0;
+
+  /// Return the approximate number of bytes of memory retained by the history.
+  virtual size_t
+  get_memory_usage() const = 0;
+};
+
+/// History of the last messages published by a transient local publisher.
+/**
+ * Only shared pointers to the published messages are kept, so late joining
+ * subscriptions which take shared messages receive them without copies.
+ * All member functions are thread-safe.
+ */
+template<typename MessageT>
+class IntraProcessPublisherHistory : public IntraProcessPublisherHistoryBase
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(IntraProcessPublisherHistory)
+
+  /// Constructor.
+  /**
+   * \param depth maximum number of messages kept, the oldest is dropped first.
+   * \throws std::invalid_argument if depth is 0.
+   */
+  explicit IntraProcessPublisherHistory(size_t depth)
+  : depth_(depth)
+  {
+    if (depth == 0) {
+      throw std::invalid_argument("depth must be a positive, non-zero value");
+    }
+  }
+
+  /// Add a published message, dropping the oldest one if the history is full.
+  void
+  add(std::shared_ptr<const MessageT> message)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (messages_.size() == depth_) {
+      messages_.pop_front();
+    }
+    messages_.push_back(std::move(message));
+  }
+
+  void
+  replay(const SubscriptionIntraProcessBase::SharedPtr & subscription_base) const override
+  {
+    auto subscription = std::static_pointer_cast<
+      rclcpp::experimental::SubscriptionIntraProcess<MessageT>
+      >(subscription_base);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto & message : messages_) {
+      subscription->provide_intra_process_message(message);
+    }
+  }
+
+  /// Return the number of messages in the history.
+  size_t
+  size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messages_.size();
+  }
+
+  size_t
+  get_memory_usage() const override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sizeof(*this) +
+           messages_.size() * (sizeof(std::shared_ptr<const MessageT>) + sizeof(MessageT));
+  }
+
+private:
+  const size_t depth_;
+  std::deque<std::shared_ptr<const MessageT>> messages_;
+  mutable std::mutex mutex_;
+};
+
 /// This class performs intra process communication between nodes.
 /**
  * This class is used in the creation of publishers and subscriptions.
@@ -86,6 +177,11 @@ namespace experimental
  * This information allows this class to operate efficiently by performing the
  * fewest number of copies of the message required.
  *
+ * Publishers with transient local durability are registered with a history,
+ * which keeps shared pointers to their last published messages.
+ * When a transient local subscription is registered, the history of each
+ * matching publisher is replayed into its buffer.
+ *
  * This class is neither CopyConstructable nor CopyAssignable.
  */
 class IntraProcessManager
@@ -134,11 +230,15 @@ public:
    * In addition this generates a unique intra process id for the publisher.
    *
    * \param publisher publisher to be registered with the manager.
+   * \param history history in which published messages are kept for late
+   *   joining subscriptions, only given for transient local publishers.
    * \return an unsigned 64-bit integer which is the publisher's unique id.
    */
   RCLCPP_PUBLIC
   uint64_t
-  add_publisher(rclcpp::PublisherBase::SharedPtr publisher);
+  add_publisher(
+    rclcpp::PublisherBase::SharedPtr publisher,
+    IntraProcessPublisherHistoryBase::SharedPtr history = nullptr);
 
   /// Unregister a publisher using the publisher's unique id.
   /**
@@ -197,14 +297,18 @@ public:
       return;
     }
     const auto & sub_ids = publisher_it->second;
+    auto history = this->template get_publisher_history<MessageT>(intra_process_publisher_id);
 
     if (sub_ids.take_ownership_subscriptions.empty()) {
       // None of the buffers require ownership, so we promote the pointer
       std::shared_ptr<MessageT> msg = std::move(message);
 
       this->template add_shared_msg_to_buffers<MessageT>(msg, sub_ids.take_shared_subscriptions);
+      if (history) {
+        history->add(msg);
+      }
     } else if (!sub_ids.take_ownership_subscriptions.empty() && // NOLINT
-      sub_ids.take_shared_subscriptions.size() <= 1)
+      sub_ids.take_shared_subscriptions.size() <= 1 && !history)
     {
       // There is at maximum 1 buffer that does not require ownership.
       // So this case is equivalent to all the buffers requiring ownership
@@ -220,15 +324,16 @@ public:
         std::move(message),
         concatenated_vector,
         allocator);
-    } else if (!sub_ids.take_ownership_subscriptions.empty() && // NOLINT
-      sub_ids.take_shared_subscriptions.size() > 1)
-    {
+    } else {
       // Construct a new shared pointer from the message
-      // for the buffers that do not require ownership
+      // for the buffers that do not require ownership, and for the history
       auto shared_msg = std::allocate_shared<MessageT, MessageAllocatorT>(*allocator, *message);
 
       this->template add_shared_msg_to_buffers<MessageT>(
         shared_msg, sub_ids.take_shared_subscriptions);
+      if (history) {
+        history->add(shared_msg);
+      }
       this->template add_owned_msg_to_buffers<MessageT, Alloc, Deleter>(
         std::move(message), sub_ids.take_ownership_subscriptions, allocator);
     }
@@ -258,6 +363,7 @@ public:
       return nullptr;
     }
     const auto & sub_ids = publisher_it->second;
+    auto history = this->template get_publisher_history<MessageT>(intra_process_publisher_id);
 
     if (sub_ids.take_ownership_subscriptions.empty()) {
       // If there are no owning, just convert to shared.
@@ -266,6 +372,9 @@ public:
         this->template add_shared_msg_to_buffers<MessageT>(
           shared_msg, sub_ids.take_shared_subscriptions);
       }
+      if (history) {
+        history->add(shared_msg);
+      }
       return shared_msg;
     } else {
       // Construct a new shared pointer from the message for the buffers that
@@ -283,6 +392,9 @@ public:
           sub_ids.take_ownership_subscriptions,
           allocator);
       }
+      if (history) {
+        history->add(shared_msg);
+      }
 
       return shared_msg;
     }
@@ -302,6 +414,15 @@ public:
   rclcpp::experimental::SubscriptionIntraProcessBase::SharedPtr
   get_subscription_intra_process(uint64_t intra_process_subscription_id);
 
+  /// Return the approximate memory retained by the transient local history of a publisher.
+  /**
+   * \param intra_process_publisher_id id of the publisher
+   * \return the number of bytes, 0 if the publisher has no history
+   */
+  RCLCPP_PUBLIC
+  size_t
+  get_publisher_history_memory_usage(uint64_t intra_process_publisher_id) const;
+
 private:
   struct SubscriptionInfo
   {
@@ -320,6 +441,7 @@ private:
     rclcpp::PublisherBase::WeakPtr publisher;
     rmw_qos_profile_t qos;
     const char * topic_name;
+    IntraProcessPublisherHistoryBase::SharedPtr history;
   };
 
   struct SplittedSubscriptions
@@ -350,6 +472,19 @@ private:
   bool
   can_communicate(PublisherInfo pub_info, SubscriptionInfo sub_info) const;
 
+  /// Return the history of a publisher, or nullptr if it has none.
+  template<typename MessageT>
+  std::shared_ptr<IntraProcessPublisherHistory<MessageT>>
+  get_publisher_history(uint64_t intra_process_publisher_id) const
+  {
+    auto publisher_it = publishers_.find(intra_process_publisher_id);
+    if (publisher_it == publishers_.end() || !publisher_it->second.history) {
+      return nullptr;
+    }
+    return std::static_pointer_cast<IntraProcessPublisherHistory<MessageT>>(
+      publisher_it->second.history);
+  }
+
   template<typename MessageT>
   void
   add_shared_msg_to_buffers(
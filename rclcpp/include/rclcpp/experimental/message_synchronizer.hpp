@@ -0,0 +1,399 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__MESSAGE_SYNCHRONIZER_HPP_
+#define RCLCPP__EXPERIMENTAL__MESSAGE_SYNCHRONIZER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/subscription_base.hpp"
+#include "rclcpp/subscription_options.hpp"
+#include "rclcpp/time.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Get the time stamp used to synchronize messages of a type.
+/**
+ * By default the stamp of the header of the message is used.
+ * Specialize this template for message types without a header.
+ */
+template<typename MessageT>
+struct MessageStamp
+{
+  static int64_t
+  nanoseconds(const MessageT & message)
+  {
+    return rclcpp::Time(message.header.stamp).nanoseconds();
+  }
+};
+
+/// Calls a callback with tuples of messages of several topics which have close time stamps.
+/**
+ * Messages are added to a bounded queue of their topic with add_message(), and
+ * a tuple is matched incrementally each time a message is added, so adding a
+ * message costs time proportional to the number of topics.
+ *
+ * Each message is part of at most one tuple.
+ * A tuple is made of the oldest messages of each topic, once every topic has
+ * one, after dropping the messages for which a newer message of the same topic
+ * is closer to the newest message of the tuple.
+ * The tuple is passed to the callback if the difference between the time stamps
+ * of its oldest and newest messages is at most the maximum interval, otherwise
+ * the oldest message is dropped, as it can't be part of any later tuple.
+ * A maximum interval of zero only matches messages with the exact same stamp.
+ *
+ * The messages are held as shared pointers to const, which the subscriptions
+ * created by SynchronizedSubscriptions get without a copy when using intra
+ * process communication.
+ *
+ * Adding messages is thread-safe, and the callback is called without holding
+ * any lock, from the thread which added the last message of the tuple.
+ *
+ * \tparam MessageTs types of the messages of each topic, 2 to 9 of them
+ */
+template<typename ... MessageTs>
+class MessageSynchronizer
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(MessageSynchronizer)
+
+  static constexpr size_t number_of_topics = sizeof...(MessageTs);
+  static_assert(
+    number_of_topics >= 2 && number_of_topics <= 9,
+    "between 2 and 9 message types can be synchronized");
+
+  using Callback = std::function<void (std::shared_ptr<const MessageTs>...)>;
+
+  template<size_t I>
+  using MessageType = typename std::tuple_element<I, std::tuple<MessageTs...>>::type;
+
+  /// Create the synchronizer.
+  /**
+   * \param[in] queue_size maximum number of unmatched messages kept for each topic
+   * \param[in] max_interval maximum difference between the stamps of the messages of a tuple
+   * \param[in] callback function called with each matched tuple
+   * \throws std::invalid_argument if the queue size is zero, the interval is
+   *   negative or the callback is empty
+   */
+  MessageSynchronizer(
+    size_t queue_size,
+    std::chrono::nanoseconds max_interval,
+    Callback callback)
+  : queue_size_(queue_size),
+    max_interval_(max_interval.count()),
+    callback_(std::move(callback))
+  {
+    if (queue_size == 0) {
+      throw std::invalid_argument("queue_size must be a positive, non-zero value");
+    }
+    if (max_interval < std::chrono::nanoseconds::zero()) {
+      throw std::invalid_argument("max_interval must not be negative");
+    }
+    if (!callback_) {
+      throw std::invalid_argument("callback must not be empty");
+    }
+    last_matched_stamps_.fill(std::numeric_limits<int64_t>::min());
+  }
+
+  /// Add a message of the topic I, using its MessageStamp.
+  template<size_t I>
+  void
+  add_message(std::shared_ptr<const MessageType<I>> message)
+  {
+    if (!message) {
+      throw std::invalid_argument("message must not be a nullptr");
+    }
+    const int64_t stamp = MessageStamp<MessageType<I>>::nanoseconds(*message);
+    add_message<I>(std::move(message), stamp);
+  }
+
+  /// Add a message of the topic I, with the given stamp in nanoseconds.
+  template<size_t I>
+  void
+  add_message(std::shared_ptr<const MessageType<I>> message, int64_t stamp)
+  {
+    static_assert(I < number_of_topics, "topic index out of range");
+    if (!message) {
+      throw std::invalid_argument("message must not be a nullptr");
+    }
+    std::vector<Tuple> matched;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stamp <= last_matched_stamps_[I]) {
+        // Older than a message of the same topic which was passed to the callback.
+        ++dropped_count_;
+        return;
+      }
+      auto & queue = std::get<I>(queues_);
+      // Keep the queue ordered by stamp, messages usually come in order.
+      auto position = queue.end();
+      while (position != queue.begin() && std::prev(position)->stamp > stamp) {
+        --position;
+      }
+      queue.insert(position, Entry<MessageType<I>>{stamp, std::move(message)});
+      if (queue.size() > queue_size_) {
+        queue.pop_front();
+        ++dropped_count_;
+      }
+      match(matched);
+    }
+    for (auto & tuple : matched) {
+      call(tuple, std::index_sequence_for<MessageTs...>());
+    }
+  }
+
+  /// Return the number of messages which were dropped without being matched.
+  size_t
+  get_dropped_count() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_count_;
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(MessageSynchronizer)
+
+  template<typename MessageT>
+  struct Entry
+  {
+    int64_t stamp;
+    std::shared_ptr<const MessageT> message;
+  };
+
+  using Tuple = std::tuple<std::shared_ptr<const MessageTs>...>;
+  using Stamps = std::array<int64_t, number_of_topics>;
+
+  /// Call f(integral_constant<size_t, I>, queue of the topic I) for each topic.
+  template<typename FunctionT, size_t ... Is>
+  void
+  for_each_queue(FunctionT && function, std::index_sequence<Is...>)
+  {
+    // Expands to one call for each index, in order.
+    int expand[] = {(function(std::integral_constant<size_t, Is>(), std::get<Is>(queues_)), 0)...};
+    (void)expand;
+  }
+
+  template<typename FunctionT>
+  void
+  for_each_queue(FunctionT && function)
+  {
+    for_each_queue(std::forward<FunctionT>(function), std::index_sequence_for<MessageTs...>());
+  }
+
+  void
+  match(std::vector<Tuple> & matched)
+  {
+    while (true) {
+      bool any_empty = false;
+      for_each_queue(
+        [&any_empty](auto, const auto & queue) {
+          any_empty = any_empty || queue.empty();
+        });
+      if (any_empty) {
+        return;
+      }
+
+      // The newest of the oldest messages of each topic is part of the next tuple.
+      int64_t pivot = std::numeric_limits<int64_t>::min();
+      for_each_queue(
+        [&pivot](auto, const auto & queue) {
+          pivot = std::max(pivot, queue.front().stamp);
+        });
+      Stamps stamps;
+      for_each_queue(
+        [this, pivot, &stamps](auto index, auto & queue) {
+          while (queue.size() > 1 && queue[1].stamp <= pivot) {
+            queue.pop_front();
+            ++dropped_count_;
+          }
+          stamps[decltype(index)::value] = queue.front().stamp;
+        });
+
+      auto oldest = std::min_element(stamps.begin(), stamps.end());
+      if (pivot - *oldest > max_interval_) {
+        const size_t oldest_index = static_cast<size_t>(oldest - stamps.begin());
+        for_each_queue(
+          [this, oldest_index](auto index, auto & queue) {
+            if (decltype(index)::value == oldest_index) {
+              queue.pop_front();
+              ++dropped_count_;
+            }
+          });
+        continue;
+      }
+
+      Tuple tuple;
+      for_each_queue(
+        [this, &tuple](auto index, auto & queue) {
+          constexpr size_t topic_index = decltype(index)::value;
+          std::get<topic_index>(tuple) = std::move(queue.front().message);
+          last_matched_stamps_[topic_index] = queue.front().stamp;
+          queue.pop_front();
+        });
+      matched.push_back(std::move(tuple));
+    }
+  }
+
+  template<size_t ... Is>
+  void
+  call(Tuple & tuple, std::index_sequence<Is...>)
+  {
+    callback_(std::move(std::get<Is>(tuple))...);
+  }
+
+  const size_t queue_size_;
+  const int64_t max_interval_;
+  Callback callback_;
+
+  mutable std::mutex mutex_;
+  std::tuple<std::deque<Entry<MessageTs>>...> queues_;
+  Stamps last_matched_stamps_;
+  size_t dropped_count_ = 0;
+};
+
+/// Subscriptions to several topics whose messages are synchronized by a MessageSynchronizer.
+/**
+ * Example Usage:
+ *
+ * ```cpp
+ * using sensor_msgs::msg::Image;
+ * using sensor_msgs::msg::Imu;
+ * using ImageAndImu = rclcpp::experimental::SynchronizedSubscriptions<Image, Imu>;
+ * auto subscriptions = std::make_shared<ImageAndImu>(
+ *   node, ImageAndImu::TopicNames{{"camera/image", "imu"}}, rclcpp::SensorDataQoS(),
+ *   10, std::chrono::milliseconds(5),
+ *   [](Image::ConstSharedPtr image, Imu::ConstSharedPtr imu) {
+ *     // Fuse the image and the imu data.
+ *   });
+ * ```
+ */
+template<typename ... MessageTs>
+class SynchronizedSubscriptions
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(SynchronizedSubscriptions)
+
+  using Synchronizer = MessageSynchronizer<MessageTs...>;
+  using TopicNames = std::array<std::string, sizeof...(MessageTs)>;
+
+  /// Create a subscription to each topic, feeding a new MessageSynchronizer.
+  /**
+   * \param[in] node node used to create the subscriptions
+   * \param[in] topic_names name of the topic of each message type
+   * \param[in] qos QoS of the subscriptions
+   * \param[in] queue_size maximum number of unmatched messages kept for each topic
+   * \param[in] max_interval maximum difference between the stamps of the messages of a tuple
+   * \param[in] callback function called with each matched tuple
+   * \param[in] options options of the subscriptions
+   */
+  template<typename NodeT>
+  SynchronizedSubscriptions(
+    NodeT && node,
+    const TopicNames & topic_names,
+    const rclcpp::QoS & qos,
+    size_t queue_size,
+    std::chrono::nanoseconds max_interval,
+    typename Synchronizer::Callback callback,
+    const rclcpp::SubscriptionOptions & options = rclcpp::SubscriptionOptions())
+  : synchronizer_(std::make_shared<Synchronizer>(queue_size, max_interval, std::move(callback)))
+  {
+    create_subscriptions(
+      node, topic_names, qos, options, std::index_sequence_for<MessageTs...>());
+  }
+
+  /// Return the synchronizer, e.g. to add messages from other sources.
+  typename Synchronizer::SharedPtr
+  get_synchronizer() const
+  {
+    return synchronizer_;
+  }
+
+  /// Return the subscription to each topic.
+  const std::array<rclcpp::SubscriptionBase::SharedPtr, sizeof...(MessageTs)> &
+  get_subscriptions() const
+  {
+    return subscriptions_;
+  }
+
+private:
+  RCLCPP_DISABLE_COPY(SynchronizedSubscriptions)
+
+  template<typename NodeT, size_t ... Is>
+  void
+  create_subscriptions(
+    NodeT & node,
+    const TopicNames & topic_names,
+    const rclcpp::QoS & qos,
+    const rclcpp::SubscriptionOptions & options,
+    std::index_sequence<Is...>)
+  {
+    int expand[] = {
+      (subscriptions_[Is] = subscribe<Is>(node, topic_names[Is], qos, options), 0)...
+    };
+    (void)expand;
+  }
+
+  template<size_t I, typename NodeT>
+  rclcpp::SubscriptionBase::SharedPtr
+  subscribe(
+    NodeT & node,
+    const std::string & topic_name,
+    const rclcpp::QoS & qos,
+    const rclcpp::SubscriptionOptions & options)
+  {
+    using MessageT = typename Synchronizer::template MessageType<I>;
+    // A weak pointer, as the subscription may be executed while this is destroyed.
+    std::weak_ptr<Synchronizer> weak_synchronizer = synchronizer_;
+    return rclcpp::create_subscription<MessageT>(
+      node,
+      topic_name,
+      qos,
+      [weak_synchronizer](std::shared_ptr<const MessageT> message) {
+        auto synchronizer = weak_synchronizer.lock();
+        if (synchronizer) {
+          synchronizer->template add_message<I>(std::move(message));
+        }
+      },
+      options);
+  }
+
+  typename Synchronizer::SharedPtr synchronizer_;
+  std::array<rclcpp::SubscriptionBase::SharedPtr, sizeof...(MessageTs)> subscriptions_;
+};
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__MESSAGE_SYNCHRONIZER_HPP_
@@ -0,0 +1,221 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__SHARED_MEMORY_CHANNEL_HPP_
+#define RCLCPP__EXPERIMENTAL__SHARED_MEMORY_CHANNEL_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "rmw/types.h"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Ring of message slots in shared memory, to pass messages between the processes of a host.
+/**
+ * A channel is a named POSIX shared memory segment, which every process
+ * opening a channel of the same name maps.
+ * The first one creates it with the given number of slots and slot size, and
+ * the others must give the same ones.
+ * Writers copy a serialized message into the next slot of the ring, and wake
+ * up the readers with a futex, which then copy it out, so that a message is
+ * copied twice in total, whatever the number of readers.
+ * Writers never wait for readers: readers which fall behind by more than the
+ * number of slots lose the oldest messages.
+ *
+ * Each reader keeps its own position in the ring, as a sequence number which
+ * is given to take() and wait_for_data().
+ *
+ * The segment is removed when the last channel using it is destroyed.
+ * Segments of processes which crashed are left behind, and can be removed
+ * with remove().
+ *
+ * This is only supported on Linux, the constructor throws elsewhere.
+ * All member functions are thread-safe.
+ */
+class SharedMemoryChannel
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMemoryChannel)
+
+  /// Maximum number of writers whose gid can be added to a channel at the same time.
+  static constexpr size_t max_number_of_writers = 32;
+  /// Maximum number of readers which can be registered to a channel at the same time.
+  static constexpr size_t max_number_of_readers = 32;
+
+  /// Create or open the channel of the given name.
+  /**
+   * \param[in] name name of the channel, see get_channel_name()
+   * \param[in] number_of_slots number of slots of the ring
+   * \param[in] slot_size size of each slot, i.e. the maximum size of a message
+   * \throws std::invalid_argument if the number of slots or the slot size is zero
+   * \throws std::runtime_error if shared memory is not supported, if the
+   *   segment cannot be created or mapped, or if it exists with another
+   *   number of slots or slot size
+   */
+  RCLCPP_PUBLIC
+  SharedMemoryChannel(const std::string & name, size_t number_of_slots, size_t slot_size);
+
+  RCLCPP_PUBLIC
+  virtual ~SharedMemoryChannel();
+
+  /// Return the name of the channel of a fully qualified topic name in a domain.
+  RCLCPP_PUBLIC
+  static std::string
+  get_channel_name(const std::string & topic_name, size_t domain_id);
+
+  /// Remove the segment of a channel, e.g. left behind by a crashed process.
+  /**
+   * Processes which mapped it keep using it, while later ones create a new one.
+   */
+  RCLCPP_PUBLIC
+  static void
+  remove(const std::string & name);
+
+  RCLCPP_PUBLIC
+  size_t
+  get_number_of_slots() const;
+
+  RCLCPP_PUBLIC
+  size_t
+  get_slot_size() const;
+
+  /// Write a serialized message into the next slot, and wake up the readers.
+  /**
+   * \return `true` if the message was written, `false` if it is larger than a slot
+   */
+  RCLCPP_PUBLIC
+  bool
+  write(const uint8_t * data, size_t size);
+
+  /// Return the sequence number of the next message to be written.
+  /**
+   * A reader starting at this sequence number gets the messages written from now on.
+   */
+  RCLCPP_PUBLIC
+  uint64_t
+  get_write_sequence() const;
+
+  /// Take the next message after the given sequence number.
+  /**
+   * Messages which were overwritten before being taken are skipped, and
+   * counted in get_dropped_count().
+   *
+   * \param[inout] sequence sequence number of the next message for this
+   *   reader, advanced past the taken message
+   * \param[out] message serialized message, resized as needed
+   * \return `true` if a message was taken, `false` if there is no complete
+   *   message yet
+   */
+  RCLCPP_PUBLIC
+  bool
+  take(uint64_t & sequence, rclcpp::SerializedMessage & message);
+
+  /// Return `true` if a message may be ready to be taken after the given sequence number.
+  RCLCPP_PUBLIC
+  bool
+  has_data(uint64_t sequence) const;
+
+  /// Wait until a message is written after the given sequence number, or the timeout.
+  /**
+   * \return `true` if a message may be ready to be taken, `false` on timeout
+   *   or when woken up by notify()
+   */
+  RCLCPP_PUBLIC
+  bool
+  wait_for_data(uint64_t sequence, std::chrono::nanoseconds timeout);
+
+  /// Wake up all the readers waiting in wait_for_data(), e.g. to stop them.
+  RCLCPP_PUBLIC
+  void
+  notify();
+
+  /// Return the number of messages skipped by take() in this process, as they were overwritten.
+  RCLCPP_PUBLIC
+  uint64_t
+  get_dropped_count() const;
+
+  /// Add the gid of a publisher writing into the channel.
+  /**
+   * Readers use it to ignore the copies of the messages of this publisher
+   * which are also received from the middleware.
+   * Writers are removed with remove_writer(), or when their process ends.
+   *
+   * \throws std::runtime_error if the maximum number of writers is reached
+   */
+  RCLCPP_PUBLIC
+  void
+  add_writer(const rmw_gid_t & gid);
+
+  /// Remove the gid of a publisher added with add_writer().
+  RCLCPP_PUBLIC
+  void
+  remove_writer(const rmw_gid_t & gid);
+
+  /// Return `true` if the gid was added with add_writer().
+  RCLCPP_PUBLIC
+  bool
+  has_writer(const rmw_gid_t & gid) const;
+
+  /// Register a reader of the channel in this process.
+  /**
+   * \return index of the reader, given to unregister_reader()
+   * \throws std::runtime_error if the maximum number of readers is reached
+   */
+  RCLCPP_PUBLIC
+  size_t
+  register_reader();
+
+  /// Unregister a reader of the channel registered by register_reader().
+  RCLCPP_PUBLIC
+  void
+  unregister_reader(size_t index);
+
+  /// Return the number of registered readers whose process is still running.
+  RCLCPP_PUBLIC
+  size_t
+  get_reader_count() const;
+
+private:
+  struct Segment;
+
+  struct Slot;
+
+  Slot *
+  get_slot(uint64_t sequence) const;
+
+  std::string name_;
+  size_t number_of_slots_;
+  size_t slot_size_;
+  size_t slot_stride_;
+  size_t mapped_size_;
+  Segment * segment_;
+  std::atomic<uint64_t> dropped_count_{0};
+};
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__SHARED_MEMORY_CHANNEL_HPP_
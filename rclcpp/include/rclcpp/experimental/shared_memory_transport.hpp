@@ -0,0 +1,439 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__EXPERIMENTAL__SHARED_MEMORY_TRANSPORT_HPP_
+#define RCLCPP__EXPERIMENTAL__SHARED_MEMORY_TRANSPORT_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "rcl/wait.h"
+
+#include "rclcpp/context.hpp"
+#include "rclcpp/create_publisher.hpp"
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp/experimental/shared_memory_channel.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/logging.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/message_info.hpp"
+#include "rclcpp/node_interfaces/get_node_base_interface.hpp"
+#include "rclcpp/node_interfaces/get_node_waitables_interface.hpp"
+#include "rclcpp/node_interfaces/node_waitables_interface.hpp"
+#include "rclcpp/publisher.hpp"
+#include "rclcpp/publisher_options.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialization_codec.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/subscription_options.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+/// Options of the shared memory channel of a topic.
+/**
+ * All the publishers and subscriptions of a topic must use the same ones.
+ */
+struct SharedMemoryTransportOptions
+{
+  /// Number of messages a subscription can fall behind before losing some.
+  size_t number_of_slots = 4;
+  /// Maximum size of a serialized message.
+  size_t slot_size = 8 * 1024 * 1024;
+};
+
+/// Open the shared memory channel of a topic, or return nullptr if it cannot be opened.
+inline SharedMemoryChannel::SharedPtr
+open_shared_memory_channel(
+  const rclcpp::Context & context,
+  const std::string & topic_name,
+  const SharedMemoryTransportOptions & options)
+{
+  try {
+    return SharedMemoryChannel::make_shared(
+      SharedMemoryChannel::get_channel_name(topic_name, context.get_domain_id()),
+      options.number_of_slots,
+      options.slot_size);
+  } catch (const std::exception & e) {
+    RCLCPP_WARN(
+      rclcpp::get_logger("rclcpp"),
+      "shared memory transport of topic '%s' not available, using the middleware: %s",
+      topic_name.c_str(), e.what());
+    return nullptr;
+  }
+}
+
+/// Publisher of large messages to the subscriptions of the same host through shared memory.
+/**
+ * Messages are serialized once into a slot of the SharedMemoryChannel of the
+ * topic, from which each SharedMemorySubscription of the host copies them,
+ * instead of going through the network stack of the middleware.
+ *
+ * Messages are also published through the middleware, serialized, for the
+ * subscriptions on other hosts and the regular ones, as the middleware does
+ * not tell which of the matched subscriptions read the channel.
+ * SharedMemorySubscription ignores these copies, as their publisher is a
+ * writer of the channel of its host.
+ *
+ * If the channel cannot be opened, e.g. on platforms without support, only
+ * the middleware is used.
+ */
+template<typename MessageT>
+class SharedMemoryPublisher
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMemoryPublisher)
+
+  /// Create the publisher, and open the shared memory channel of the topic.
+  /**
+   * \param[in] node node used to create the publisher
+   * \param[in] topic_name name of the topic
+   * \param[in] qos QoS of the publisher
+   * \param[in] transport_options options of the shared memory channel
+   * \param[in] options options of the publisher
+   */
+  template<typename NodeT>
+  SharedMemoryPublisher(
+    NodeT && node,
+    const std::string & topic_name,
+    const rclcpp::QoS & qos,
+    const SharedMemoryTransportOptions & transport_options = SharedMemoryTransportOptions(),
+    const rclcpp::PublisherOptions & options = rclcpp::PublisherOptions())
+  {
+    auto node_base = rclcpp::node_interfaces::get_node_base_interface(node);
+    publisher_ = rclcpp::create_publisher<MessageT>(node, topic_name, qos, options);
+    channel_ = open_shared_memory_channel(
+      *node_base->get_context(), publisher_->get_topic_name(), transport_options);
+    if (channel_) {
+      channel_->add_writer(publisher_->get_gid());
+    }
+  }
+
+  virtual ~SharedMemoryPublisher()
+  {
+    if (channel_) {
+      channel_->remove_writer(publisher_->get_gid());
+    }
+  }
+
+  /// Publish a message.
+  /**
+   * \throws std::invalid_argument if the serialized message is larger than a
+   *   slot of the shared memory channel
+   */
+  void
+  publish(const MessageT & message)
+  {
+    if (!channel_) {
+      publisher_->publish(message);
+      return;
+    }
+    auto serialized_message = serialized_message_pool_.acquire();
+    serialization_.serialize_message(&message, serialized_message.get());
+    const auto & rcl_message = serialized_message->get_rcl_serialized_message();
+    if (!channel_->write(rcl_message.buffer, rcl_message.buffer_length)) {
+      serialized_message_pool_.release(std::move(serialized_message));
+      throw std::invalid_argument(
+              "serialized message is larger than a slot of the shared memory channel");
+    }
+    publisher_->publish(*serialized_message);
+    serialized_message_pool_.release(std::move(serialized_message));
+  }
+
+  /// Return `true` if messages are published through shared memory.
+  bool
+  uses_shared_memory() const
+  {
+    return nullptr != channel_;
+  }
+
+  /// Return the publisher used for the middleware.
+  typename rclcpp::Publisher<MessageT>::SharedPtr
+  get_publisher() const
+  {
+    return publisher_;
+  }
+
+  /// Return the shared memory channel, or nullptr if it is not used.
+  SharedMemoryChannel::SharedPtr
+  get_channel() const
+  {
+    return channel_;
+  }
+
+private:
+  typename rclcpp::Publisher<MessageT>::SharedPtr publisher_;
+  SharedMemoryChannel::SharedPtr channel_;
+  rclcpp::Serialization<MessageT> serialization_;
+  rclcpp::SerializedMessagePool serialized_message_pool_;
+};
+
+namespace detail
+{
+
+/// Waitable of a SharedMemorySubscription, executing its callback for the taken messages.
+/**
+ * A thread waits for the messages written into the channel, copies them out
+ * into a queue as deep as the QoS history, and triggers a guard condition.
+ * The messages are deserialized by the executor, before the callback is called.
+ */
+template<typename MessageT>
+class SharedMemoryWaitable : public rclcpp::Waitable
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMemoryWaitable)
+
+  using Callback = std::function<void (std::shared_ptr<const MessageT>)>;
+
+  SharedMemoryWaitable(
+    rclcpp::Context::SharedPtr context,
+    SharedMemoryChannel::SharedPtr channel,
+    size_t depth,
+    Callback callback)
+  : guard_condition_(context),
+    channel_(std::move(channel)),
+    depth_(std::max<size_t>(depth, 1)),
+    callback_(std::move(callback)),
+    reader_index_(channel_->register_reader())
+  {
+    // Only the messages written from now on are received.
+    const uint64_t sequence = channel_->get_write_sequence();
+    thread_ = std::thread([this, sequence]() {this->run(sequence);});
+  }
+
+  virtual ~SharedMemoryWaitable()
+  {
+    stop_.store(true);
+    channel_->notify();
+    thread_.join();
+    channel_->unregister_reader(reader_index_);
+  }
+
+  size_t
+  get_number_of_ready_guard_conditions() override {return 1;}
+
+  bool
+  add_to_wait_set(rcl_wait_set_t * wait_set) override
+  {
+    return RCL_RET_OK == rcl_wait_set_add_guard_condition(
+      wait_set, &guard_condition_.get_rcl_guard_condition(), NULL);
+  }
+
+  bool
+  is_ready(rcl_wait_set_t * wait_set) override
+  {
+    (void)wait_set;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !messages_.empty();
+  }
+
+  std::shared_ptr<void>
+  take_data() override
+  {
+    std::shared_ptr<rclcpp::SerializedMessage> serialized_message;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!messages_.empty()) {
+      serialized_message = std::move(messages_.front());
+      messages_.pop_front();
+      if (!messages_.empty()) {
+        // Each trigger takes a single message.
+        guard_condition_.trigger();
+      }
+    }
+    return std::static_pointer_cast<void>(serialized_message);
+  }
+
+  void
+  execute(std::shared_ptr<void> & data) override
+  {
+    if (!data) {
+      return;
+    }
+    auto serialized_message = std::static_pointer_cast<rclcpp::SerializedMessage>(data);
+    auto message = std::make_shared<MessageT>();
+    serialization_.deserialize_message(serialized_message.get(), message.get());
+    data.reset();
+    callback_(std::move(message));
+  }
+
+  /// Return the number of messages lost as they were overwritten or the queue was full.
+  uint64_t
+  get_dropped_count() const
+  {
+    return dropped_count_.load();
+  }
+
+private:
+  void
+  run(uint64_t sequence)
+  {
+    while (!stop_.load()) {
+      if (!channel_->wait_for_data(sequence, std::chrono::milliseconds(100))) {
+        continue;
+      }
+      const uint64_t channel_dropped_count = channel_->get_dropped_count();
+      bool taken = false;
+      auto serialized_message = std::make_shared<rclcpp::SerializedMessage>();
+      while (channel_->take(sequence, *serialized_message)) {
+        taken = true;
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_.push_back(std::move(serialized_message));
+        if (messages_.size() > depth_) {
+          messages_.pop_front();
+          ++dropped_count_;
+        }
+        serialized_message = std::make_shared<rclcpp::SerializedMessage>();
+      }
+      dropped_count_ += channel_->get_dropped_count() - channel_dropped_count;
+      if (taken) {
+        guard_condition_.trigger();
+      }
+    }
+  }
+
+  rclcpp::GuardCondition guard_condition_;
+  SharedMemoryChannel::SharedPtr channel_;
+  const size_t depth_;
+  Callback callback_;
+  rclcpp::Serialization<MessageT> serialization_;
+  size_t reader_index_;
+  std::mutex mutex_;
+  std::deque<std::shared_ptr<rclcpp::SerializedMessage>> messages_;
+  std::atomic<uint64_t> dropped_count_{0};
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace detail
+
+/// Subscription receiving the messages of SharedMemoryPublisher through shared memory.
+/**
+ * A subscription of the middleware is also created, to receive the messages
+ * of the other publishers, and the messages of the shared memory publishers
+ * are ignored in it, by their gid.
+ *
+ * The callback is executed by whichever executor the node is added to, in
+ * the callback group of the options.
+ * If the channel cannot be opened only the middleware is used.
+ */
+template<typename MessageT>
+class SharedMemorySubscription
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SharedMemorySubscription)
+
+  using Callback = std::function<void (std::shared_ptr<const MessageT>)>;
+
+  /// Create the subscription, and open the shared memory channel of the topic.
+  /**
+   * \param[in] node node used to create the subscription
+   * \param[in] topic_name name of the topic
+   * \param[in] qos QoS of the subscription, whose depth is the one of the
+   *   queue of the messages received through shared memory
+   * \param[in] callback function called with each message
+   * \param[in] transport_options options of the shared memory channel
+   * \param[in] options options of the subscription
+   */
+  template<typename NodeT>
+  SharedMemorySubscription(
+    NodeT && node,
+    const std::string & topic_name,
+    const rclcpp::QoS & qos,
+    Callback callback,
+    const SharedMemoryTransportOptions & transport_options = SharedMemoryTransportOptions(),
+    const rclcpp::SubscriptionOptions & options = rclcpp::SubscriptionOptions())
+  : node_waitables_(rclcpp::node_interfaces::get_node_waitables_interface(node)),
+    callback_group_(options.callback_group)
+  {
+    auto node_base = rclcpp::node_interfaces::get_node_base_interface(node);
+    // Set once the channel of the fully qualified topic name is opened, while
+    // the subscription may already be executed.
+    auto channel_holder = std::make_shared<SharedMemoryChannel::SharedPtr>();
+    subscription_ = rclcpp::create_subscription<MessageT>(
+      node,
+      topic_name,
+      qos,
+      [callback, channel_holder](
+        std::shared_ptr<const MessageT> message, const rclcpp::MessageInfo & message_info)
+      {
+        auto channel = std::atomic_load(channel_holder.get());
+        if (channel && channel->has_writer(message_info.get_rmw_message_info().publisher_gid)) {
+          return;
+        }
+        callback(std::move(message));
+      },
+      options);
+    auto channel = open_shared_memory_channel(
+      *node_base->get_context(), subscription_->get_topic_name(), transport_options);
+    std::atomic_store(channel_holder.get(), channel);
+    if (channel) {
+      waitable_ = std::make_shared<detail::SharedMemoryWaitable<MessageT>>(
+        node_base->get_context(), channel, qos.get_rmw_qos_profile().depth, callback);
+      node_waitables_->add_waitable(waitable_, callback_group_);
+    }
+  }
+
+  virtual ~SharedMemorySubscription()
+  {
+    if (waitable_) {
+      node_waitables_->remove_waitable(waitable_, callback_group_);
+    }
+  }
+
+  /// Return `true` if messages are received through shared memory.
+  bool
+  uses_shared_memory() const
+  {
+    return nullptr != waitable_;
+  }
+
+  /// Return the subscription used for the middleware.
+  typename rclcpp::Subscription<MessageT>::SharedPtr
+  get_subscription() const
+  {
+    return subscription_;
+  }
+
+  /// Return the number of messages lost in shared memory, as the subscription fell behind.
+  uint64_t
+  get_dropped_count() const
+  {
+    return waitable_ ? waitable_->get_dropped_count() : 0;
+  }
+
+private:
+  rclcpp::node_interfaces::NodeWaitablesInterface::SharedPtr node_waitables_;
+  rclcpp::CallbackGroup::SharedPtr callback_group_;
+  typename rclcpp::Subscription<MessageT>::SharedPtr subscription_;
+  typename detail::SharedMemoryWaitable<MessageT>::SharedPtr waitable_;
+};
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+#endif  // RCLCPP__EXPERIMENTAL__SHARED_MEMORY_TRANSPORT_HPP_
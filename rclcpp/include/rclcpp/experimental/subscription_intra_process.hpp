@@ -17,6 +17,9 @@
 
 #include <rmw/rmw.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -27,9 +30,11 @@
 #include "rcl/error_handling.h"
 
 #include "rclcpp/any_subscription_callback.hpp"
+#include "rclcpp/detail/timer_wheel.hpp"
 #include "rclcpp/experimental/buffers/intra_process_buffer.hpp"
 #include "rclcpp/experimental/create_intra_process_buffer.hpp"
 #include "rclcpp/experimental/subscription_intra_process_base.hpp"
+#include "rclcpp/qos_event.hpp"
 #include "rclcpp/type_support_decl.hpp"
 #include "rclcpp/waitable.hpp"
 #include "tracetools/tracetools.h"
@@ -39,6 +44,19 @@ namespace rclcpp
 namespace experimental
 {
 
+/// Subscription side of the intra-process communication.
+/**
+ * As intra-process messages do not go through the middleware, the deadline
+ * and lifespan QoS policies are enforced here instead.
+ * Messages older than the lifespan are dropped from the buffer before they
+ * reach the callback.
+ * If no message arrives within the deadline, the deadline callback, if any,
+ * is called by the executor, with a timer of the process wide
+ * rclcpp::detail::TimerWheel waking it up.
+ * The subscription then doesn't register its deadline callback with the
+ * middleware, but records the messages received from it here, so that a
+ * deadline is missed only if no message arrived through either path.
+ */
 template<
   typename MessageT,
   typename Alloc = std::allocator<void>,
@@ -66,9 +84,11 @@ public:
     rclcpp::Context::SharedPtr context,
     const std::string & topic_name,
     rmw_qos_profile_t qos_profile,
-    rclcpp::IntraProcessBufferType buffer_type)
+    rclcpp::IntraProcessBufferType buffer_type,
+    QOSDeadlineRequestedCallbackType deadline_callback = nullptr)
   : SubscriptionIntraProcessBase(topic_name, qos_profile),
-    any_callback_(callback)
+    any_callback_(callback),
+    deadline_callback_(deadline_callback)
   {
     if (!std::is_same<MessageT, CallbackMessageT>::value) {
       throw std::runtime_error("SubscriptionIntraProcess wrong callback type");
@@ -92,6 +112,24 @@ public:
       throw std::runtime_error("SubscriptionIntraProcess init error initializing guard condition");
     }
 
+    // Monitor the deadline, if it is finite.
+    deadline_ =
+      std::chrono::seconds(qos_profile.deadline.sec) +
+      std::chrono::nanoseconds(qos_profile.deadline.nsec);
+    if (deadline_ > std::chrono::nanoseconds::zero() &&
+      deadline_ != std::chrono::nanoseconds::max())
+    {
+      auto now = std::chrono::steady_clock::now();
+      last_message_time_.store(now.time_since_epoch().count());
+      timer_wheel_ = rclcpp::detail::TimerWheel::get_global_instance();
+      // The timer is removed before this object is destroyed, so capturing this is safe.
+      deadline_timer_id_ = timer_wheel_->add_timer(
+        now + deadline_,
+        [this](std::chrono::steady_clock::time_point check_time) {
+          return this->check_deadline(check_time);
+        });
+    }
+
     TRACEPOINT(
       rclcpp_subscription_callback_added,
       static_cast<const void *>(this),
@@ -106,6 +144,9 @@ public:
 
   ~SubscriptionIntraProcess()
   {
+    if (timer_wheel_) {
+      timer_wheel_->remove_timer(deadline_timer_id_);
+    }
     if (rcl_guard_condition_fini(&gc_) != RCL_RET_OK) {
       RCUTILS_LOG_ERROR_NAMED(
         "rclcpp",
@@ -118,7 +159,8 @@ public:
   is_ready(rcl_wait_set_t * wait_set)
   {
     (void) wait_set;
-    return buffer_->has_data();
+    buffer_->remove_expired();
+    return buffer_->has_data() || deadline_missed_count_change_.load() != 0;
   }
 
   std::shared_ptr<void>
@@ -127,7 +169,11 @@ public:
     ConstMessageSharedPtr shared_msg;
     MessageUniquePtr unique_msg;
 
-    if (any_callback_.use_take_shared_method()) {
+    // Messages may have expired, or a deadline may have been missed, since is_ready().
+    buffer_->remove_expired();
+    if (!buffer_->has_data()) {
+      // Leave both empty, in which case only a missed deadline is handled.
+    } else if (any_callback_.use_take_shared_method()) {
       shared_msg = buffer_->consume_shared();
     } else {
       unique_msg = buffer_->consume_unique();
@@ -148,6 +194,7 @@ public:
   provide_intra_process_message(ConstMessageSharedPtr message)
   {
     buffer_->add_shared(std::move(message));
+    record_message_time(std::chrono::steady_clock::now());
     trigger_guard_condition();
   }
 
@@ -155,6 +202,7 @@ public:
   provide_intra_process_message(MessageUniquePtr message)
   {
     buffer_->add_unique(std::move(message));
+    record_message_time(std::chrono::steady_clock::now());
     trigger_guard_condition();
   }
 
@@ -164,6 +212,32 @@ public:
     return buffer_->use_take_shared_method();
   }
 
+  size_t
+  get_memory_usage() const override
+  {
+    return sizeof(*this) + buffer_->get_memory_usage();
+  }
+
+  /// Restart the deadline period, as a message was received at the given time.
+  /**
+   * Also called by the subscription for the messages received from the middleware.
+   * The period is not moved back by a message received before the latest one.
+   */
+  void
+  record_message_time(std::chrono::steady_clock::time_point time)
+  {
+    if (!timer_wheel_) {
+      return;
+    }
+    const int64_t time_count = time.time_since_epoch().count();
+    int64_t last = last_message_time_.load();
+    while (last < time_count) {
+      if (last_message_time_.compare_exchange_weak(last, time_count)) {
+        break;
+      }
+    }
+  }
+
 private:
   void
   trigger_guard_condition()
@@ -172,6 +246,41 @@ private:
     (void)ret;
   }
 
+
+  /// Called by the timer wheel, returns when the deadline should be checked next.
+  std::chrono::steady_clock::time_point
+  check_deadline(std::chrono::steady_clock::time_point now)
+  {
+    using std::chrono::steady_clock;
+    int64_t last = last_message_time_.load();
+    auto due = steady_clock::time_point(steady_clock::duration(last)) + deadline_;
+    if (now < due) {
+      // A message arrived since the last check.
+      return due;
+    }
+    // Start the next period now, unless a message arrived in the meantime.
+    if (!last_message_time_.compare_exchange_strong(last, now.time_since_epoch().count())) {
+      return steady_clock::time_point(steady_clock::duration(last)) + deadline_;
+    }
+    deadline_missed_total_count_++;
+    deadline_missed_count_change_++;
+    trigger_guard_condition();
+    return now + deadline_;
+  }
+
+  void
+  handle_missed_deadline()
+  {
+    int32_t count_change = deadline_missed_count_change_.exchange(0);
+    if (count_change == 0 || !deadline_callback_) {
+      return;
+    }
+    QOSDeadlineRequestedInfo info;
+    info.total_count = deadline_missed_total_count_.load();
+    info.total_count_change = count_change;
+    deadline_callback_(info);
+  }
+
   template<typename T>
   typename std::enable_if<std::is_same<T, rcl_serialized_message_t>::value, void>::type
   execute_impl(std::shared_ptr<void> & data)
@@ -195,6 +304,12 @@ private:
     auto shared_ptr = std::static_pointer_cast<std::pair<ConstMessageSharedPtr, MessageUniquePtr>>(
       data);
 
+    handle_missed_deadline();
+    if (!shared_ptr->first && !shared_ptr->second) {
+      // Nothing was taken, e.g. because the messages expired.
+      return;
+    }
+
     if (any_callback_.use_take_shared_method()) {
       ConstMessageSharedPtr shared_msg = shared_ptr->first;
       any_callback_.dispatch_intra_process(shared_msg, msg_info);
@@ -207,6 +322,15 @@ private:
 
   AnySubscriptionCallback<CallbackMessageT, Alloc> any_callback_;
   BufferUniquePtr buffer_;
+
+  QOSDeadlineRequestedCallbackType deadline_callback_;
+  std::chrono::nanoseconds deadline_;
+  rclcpp::detail::TimerWheel::SharedPtr timer_wheel_;
+  rclcpp::detail::TimerWheel::TimerId deadline_timer_id_ = 0;
+  // Steady clock time since epoch, in the clock's own duration.
+  std::atomic<int64_t> last_message_time_{0};
+  std::atomic<int32_t> deadline_missed_total_count_{0};
+  std::atomic<int32_t> deadline_missed_count_change_{0};
 };
 
 }  // namespace experimental
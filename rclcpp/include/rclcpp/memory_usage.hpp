@@ -0,0 +1,196 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__MEMORY_USAGE_HPP_
+#define RCLCPP__MEMORY_USAGE_HPP_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/create_publisher.hpp"
+#include "rclcpp/create_timer.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/get_node_base_interface.hpp"
+#include "rclcpp/node_interfaces/get_node_timers_interface.hpp"
+#include "rclcpp/node_interfaces/get_node_topics_interface.hpp"
+#include "rclcpp/node_interfaces/node_base_interface.hpp"
+#include "rclcpp/node_interfaces/node_topics_interface.hpp"
+#include "rclcpp/publisher.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+#include "statistics_msgs/msg/metrics_message.hpp"
+
+namespace rclcpp
+{
+
+/// Kind of an entity whose memory is accounted.
+enum class EntityKind {Publisher, Subscription, Service, Client, Timer, Waitable};
+
+/// Return the name of an entity kind, e.g. "subscription".
+RCLCPP_PUBLIC
+std::string
+to_string(EntityKind kind);
+
+/// Approximate memory retained by an entity of a node.
+struct EntityMemoryUsage
+{
+  EntityKind kind;
+  /// Topic or service name of the entity, empty for timers and waitables.
+  std::string name;
+  size_t bytes;
+};
+
+/// Approximate memory retained by the entities of a node.
+struct NodeMemoryUsage
+{
+  /// Fully qualified name of the node.
+  std::string node_name;
+  /// Sum of the bytes of the entities.
+  size_t bytes = 0;
+  std::vector<EntityMemoryUsage> entities;
+};
+
+/// Return the approximate memory retained by the entities of a node.
+/**
+ * The memory of each entity is the one returned by its get_memory_usage()
+ * function, e.g. rclcpp::SubscriptionBase::get_memory_usage().
+ * It is an approximation of what rclcpp retains for the entity between uses,
+ * like its intra-process buffer, its message pools, or the pending requests
+ * of a client, where messages are counted with the size of their type only.
+ * Memory allocated by the middleware is not included.
+ *
+ * Waitables which don't account for their memory are not listed, and
+ * intra-process subscription waitables are accounted with their subscription.
+ * In a component container, each component is a node and is accounted
+ * separately.
+ *
+ * \param[in] node_base base interface of the node
+ * \param[in] node_topics topics interface of the node, to list its publishers
+ * \return the memory retained by each entity and its sum
+ */
+RCLCPP_PUBLIC
+NodeMemoryUsage
+get_memory_usage(
+  const rclcpp::node_interfaces::NodeBaseInterface & node_base,
+  const rclcpp::node_interfaces::NodeTopicsInterface & node_topics);
+
+/// Return the approximate memory retained by the entities of a node.
+/**
+ * The NodeT type needs to have the methods get_node_base_interface() and
+ * get_node_topics_interface(), e.g. rclcpp::Node.
+ */
+template<typename NodeT>
+NodeMemoryUsage
+get_memory_usage(NodeT && node)
+{
+  return get_memory_usage(
+    *rclcpp::node_interfaces::get_node_base_interface(node),
+    *rclcpp::node_interfaces::get_node_topics_interface(node));
+}
+
+/// Periodically publish the memory retained by the entities of nodes.
+/**
+ * At each period, a statistics_msgs::msg::MetricsMessage is published for
+ * each entity of each node, and one for the sum of each node.
+ * The measurement source name is the fully qualified name of the node, the
+ * metrics source is the kind and the name of the entity, e.g.
+ * "subscription /chatter", or "total" for the sum, and the unit is "bytes".
+ * The number of bytes is given as the average of a single sample.
+ *
+ * The reporter reports the node it was created with, and other nodes can be
+ * added, e.g. the components loaded in a container.
+ * Added nodes are not kept alive by the reporter.
+ */
+class MemoryUsageReporter
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(MemoryUsageReporter)
+
+  /// Create a reporter publishing with the given node.
+  /**
+   * \param[in] node node reported, and used to publish and for the timer
+   * \param[in] period period of the reports
+   * \param[in] topic_name topic of the reports
+   * \param[in] qos QoS of the reports publisher
+   */
+  template<typename NodeT, typename DurationRepT, typename DurationT>
+  MemoryUsageReporter(
+    NodeT && node,
+    std::chrono::duration<DurationRepT, DurationT> period,
+    const std::string & topic_name = "memory_usage",
+    const rclcpp::QoS & qos = rclcpp::QoS(10))
+  : reported_nodes_(std::make_shared<ReportedNodes>())
+  {
+    auto node_base = rclcpp::node_interfaces::get_node_base_interface(node);
+    add_node(node_base, rclcpp::node_interfaces::get_node_topics_interface(node));
+    reported_nodes_->publisher = rclcpp::create_publisher<statistics_msgs::msg::MetricsMessage>(
+      node, topic_name, qos);
+    // Shared with the timer, which may outlive the reporter while its callback runs.
+    auto reported_nodes = reported_nodes_;
+    timer_ = rclcpp::create_wall_timer(
+      period,
+      [reported_nodes]() {reported_nodes->publish();},
+      nullptr,
+      node_base.get(),
+      rclcpp::node_interfaces::get_node_timers_interface(node).get());
+  }
+
+  RCLCPP_PUBLIC
+  virtual ~MemoryUsageReporter();
+
+  /// Add a node to report.
+  RCLCPP_PUBLIC
+  void
+  add_node(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+    rclcpp::node_interfaces::NodeTopicsInterface::SharedPtr node_topics);
+
+  /// Publish the memory retained by the nodes now, which the timer does periodically.
+  /**
+   * Nodes which were destroyed since they were added are forgotten.
+   */
+  RCLCPP_PUBLIC
+  void
+  publish();
+
+private:
+  /// Reported nodes, shared with the timer callback.
+  struct ReportedNodes
+  {
+    RCLCPP_PUBLIC
+    void
+    publish();
+
+    using NodeInterfaces = std::pair<
+      rclcpp::node_interfaces::NodeBaseInterface::WeakPtr,
+      rclcpp::node_interfaces::NodeTopicsInterface::WeakPtr>;
+
+    std::mutex mutex;
+    std::vector<NodeInterfaces> nodes;
+    rclcpp::Publisher<statistics_msgs::msg::MetricsMessage>::SharedPtr publisher;
+  };
+
+  std::shared_ptr<ReportedNodes> reported_nodes_;
+  rclcpp::TimerBase::SharedPtr timer_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__MEMORY_USAGE_HPP_
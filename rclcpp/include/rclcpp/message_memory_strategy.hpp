@@ -46,6 +46,7 @@ public:
   using MessageAllocTraits = allocator::AllocRebind<MessageT, Alloc>;
   using MessageAlloc = typename MessageAllocTraits::allocator_type;
   using MessageDeleter = allocator::Deleter<MessageAlloc, MessageT>;
+  using MessageUniquePtr = std::unique_ptr<MessageT, MessageDeleter>;
 
   using SerializedMessageAllocTraits = allocator::AllocRebind<rclcpp::SerializedMessage, Alloc>;
   using SerializedMessageAlloc = typename SerializedMessageAllocTraits::allocator_type;
@@ -59,6 +60,7 @@ public:
   MessageMemoryStrategy()
   {
     message_allocator_ = std::make_shared<MessageAlloc>();
+    allocator::set_allocator_for_deleter(&message_deleter_, message_allocator_.get());
     serialized_message_allocator_ = std::make_shared<SerializedMessageAlloc>();
     buffer_allocator_ = std::make_shared<BufferAlloc>();
     rcutils_allocator_ = allocator::get_rcl_allocator<char, BufferAlloc>(*buffer_allocator_.get());
@@ -67,6 +69,7 @@ public:
   explicit MessageMemoryStrategy(std::shared_ptr<Alloc> allocator)
   {
     message_allocator_ = std::make_shared<MessageAlloc>(*allocator.get());
+    allocator::set_allocator_for_deleter(&message_deleter_, message_allocator_.get());
     serialized_message_allocator_ = std::make_shared<SerializedMessageAlloc>(*allocator.get());
     buffer_allocator_ = std::make_shared<BufferAlloc>(*allocator.get());
     rcutils_allocator_ = allocator::get_rcl_allocator<char, BufferAlloc>(*buffer_allocator_.get());
@@ -87,6 +90,22 @@ public:
     return std::allocate_shared<MessageT, MessageAlloc>(*message_allocator_.get());
   }
 
+  /// Dynamically allocate a new message, which is owned by the caller.
+  /**
+   * This is used by subscriptions with a unique_ptr callback, to which the
+   * ownership of the message is given, so that the message is never returned
+   * and a new one is allocated for each taken message.
+   * Strategies which reuse their messages return nullptr instead, so that
+   * messages are borrowed with borrow_message() and copied for the callback.
+   * \return Unique pointer to the new message, or nullptr.
+   */
+  virtual MessageUniquePtr borrow_unique_message()
+  {
+    auto ptr = MessageAllocTraits::allocate(*message_allocator_.get(), 1);
+    MessageAllocTraits::construct(*message_allocator_.get(), ptr);
+    return MessageUniquePtr(ptr, message_deleter_);
+  }
+
   virtual std::shared_ptr<rclcpp::SerializedMessage> borrow_serialized_message(size_t capacity)
   {
     return std::make_shared<rclcpp::SerializedMessage>(capacity);
@@ -115,6 +134,16 @@ public:
     serialized_msg.reset();
   }
 
+  /// Return the approximate number of bytes of memory retained between messages.
+  /**
+   * Messages are allocated when borrowed and released when returned by
+   * default, so nothing is retained.
+   */
+  virtual size_t get_memory_usage() const
+  {
+    return 0;
+  }
+
   std::shared_ptr<MessageAlloc> message_allocator_;
   MessageDeleter message_deleter_;
 
@@ -103,6 +103,10 @@ public:
   std::atomic_bool &
   get_associated_with_executor_atomic() override;
 
+  RCLCPP_PUBLIC
+  rclcpp::CpuTimeAccount &
+  get_cpu_time_account() override;
+
   RCLCPP_PUBLIC
   rcl_guard_condition_t *
   get_notify_guard_condition() override;
@@ -111,6 +115,22 @@ public:
   std::unique_lock<std::recursive_mutex>
   acquire_notify_guard_condition_lock() const override;
 
+  RCLCPP_PUBLIC
+  rcl_ret_t
+  trigger_notify_guard_condition() override;
+
+  RCLCPP_PUBLIC
+  void
+  consume_notify_guard_condition() override;
+
+  RCLCPP_PUBLIC
+  void
+  defer_notify_guard_condition() override;
+
+  RCLCPP_PUBLIC
+  rcl_ret_t
+  resume_notify_guard_condition() override;
+
   RCLCPP_PUBLIC
   bool
   get_use_intra_process_default() const override;
@@ -136,10 +156,16 @@ private:
 
   std::atomic_bool associated_with_executor_;
 
+  rclcpp::CpuTimeAccount cpu_time_account_;
+
   /// Guard condition for notifying the Executor of changes to this node.
   mutable std::recursive_mutex notify_guard_condition_mutex_;
   rcl_guard_condition_t notify_guard_condition_ = rcl_get_zero_initialized_guard_condition();
   bool notify_guard_condition_is_valid_;
+  /// True from the trigger of the guard condition until the executor consumes it.
+  std::atomic_bool notify_guard_condition_pending_;
+  size_t notify_guard_condition_deferrals_;
+  bool notify_guard_condition_deferred_trigger_;
 };
 
 }  // namespace node_interfaces
@@ -24,6 +24,7 @@
 
 #include "rclcpp/callback_group.hpp"
 #include "rclcpp/context.hpp"
+#include "rclcpp/cpu_time.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/visibility_control.hpp"
 
@@ -134,6 +135,18 @@ public:
   std::atomic_bool &
   get_associated_with_executor_atomic() = 0;
 
+  /// Return the thread CPU time spent executing the callbacks of this node.
+  /**
+   * Only executors created with rclcpp::ExecutorOptions::cpu_time_accounting
+   * add to this account.
+   * The callbacks of all the callback groups of the node are included, also
+   * of groups which were destroyed since.
+   */
+  RCLCPP_PUBLIC
+  virtual
+  rclcpp::CpuTimeAccount &
+  get_cpu_time_account() = 0;
+
   /// Return guard condition that should be notified when the internal node state changes.
   /**
    * For example, this should be notified when a publisher is added or removed.
@@ -152,6 +165,60 @@ public:
   std::unique_lock<std::recursive_mutex>
   acquire_notify_guard_condition_lock() const = 0;
 
+  /// Notify the executor of the node that the internal node state changed.
+  /**
+   * While the node is associated with an executor, notifications are
+   * coalesced: once the notify guard condition is triggered, the notification
+   * is pending until the executor consumes it with
+   * consume_notify_guard_condition(), and the changes made in the meantime
+   * don't trigger the guard condition again.
+   *
+   * While the notifications are deferred with defer_notify_guard_condition(),
+   * the notification is only recorded and triggered when they are resumed.
+   *
+   * \return the return code of rcl_trigger_guard_condition(), or RCL_RET_OK if
+   *   the notification was coalesced or deferred
+   */
+  RCLCPP_PUBLIC
+  virtual
+  rcl_ret_t
+  trigger_notify_guard_condition() = 0;
+
+  /// Consume the pending notification, if any.
+  /**
+   * This is called by executors before collecting the entities of the node,
+   * so the changes made afterwards trigger the notify guard condition again.
+   */
+  RCLCPP_PUBLIC
+  virtual
+  void
+  consume_notify_guard_condition() = 0;
+
+  /// Defer the notifications until resume_notify_guard_condition() is called.
+  /**
+   * Deferrals can be nested, the notifications being resumed when each
+   * deferral is resumed.
+   * Prefer rclcpp::BulkEntityCreationScope over calling this directly.
+   */
+  RCLCPP_PUBLIC
+  virtual
+  void
+  defer_notify_guard_condition() = 0;
+
+  /// Resume the notifications deferred with defer_notify_guard_condition().
+  /**
+   * When the last deferral is resumed, the notify guard condition is
+   * triggered once if there were notifications in the meantime.
+   *
+   * \return the return code of trigger_notify_guard_condition(), or
+   *   RCL_RET_OK if there was nothing to notify
+   * \throws std::runtime_error if the notifications aren't deferred
+   */
+  RCLCPP_PUBLIC
+  virtual
+  rcl_ret_t
+  resume_notify_guard_condition() = 0;
+
   /// Return the default preference for using intra process communication.
   RCLCPP_PUBLIC
   virtual
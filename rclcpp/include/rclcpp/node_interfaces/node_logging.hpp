@@ -17,10 +17,12 @@
 
 #include <memory>
 
+#include "rclcpp/async_rosout_publisher.hpp"
 #include "rclcpp/logger.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/node_interfaces/node_logging_interface.hpp"
+#include "rclcpp/node_options.hpp"
 #include "rclcpp/visibility_control.hpp"
 
 namespace rclcpp
@@ -37,6 +39,17 @@ public:
   RCLCPP_PUBLIC
   explicit NodeLogging(rclcpp::node_interfaces::NodeBaseInterface * node_base);
 
+  /// Create the logging of a node, with an asynchronous rosout publisher if enabled.
+  /**
+   * The publisher is created if both rclcpp::NodeOptions::enable_rosout()
+   * and rclcpp::NodeOptions::async_rosout() are set, and rosout logging isn't
+   * disabled globally.
+   */
+  RCLCPP_PUBLIC
+  NodeLogging(
+    rclcpp::node_interfaces::NodeBaseInterface * node_base,
+    const rclcpp::NodeOptions & options);
+
   RCLCPP_PUBLIC
   virtual
   ~NodeLogging();
@@ -49,6 +62,10 @@ public:
   const char *
   get_logger_name() const override;
 
+  RCLCPP_PUBLIC
+  rclcpp::AsyncRosoutPublisher::SharedPtr
+  get_async_rosout_publisher() const override;
+
 private:
   RCLCPP_DISABLE_COPY(NodeLogging)
 
@@ -56,6 +73,8 @@ private:
   rclcpp::node_interfaces::NodeBaseInterface * node_base_;
 
   rclcpp::Logger logger_;
+
+  rclcpp::AsyncRosoutPublisher::SharedPtr async_rosout_publisher_;
 };
 
 }  // namespace node_interfaces
@@ -17,6 +17,7 @@
 
 #include <memory>
 
+#include "rclcpp/async_rosout_publisher.hpp"
 #include "rclcpp/logger.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/visibility_control.hpp"
@@ -49,6 +50,16 @@ public:
   virtual
   const char *
   get_logger_name() const = 0;
+
+  /// Return the publisher of the log records of the node on /rosout, if asynchronous.
+  /**
+   * \return the publisher, or nullptr if the node wasn't created with
+   *   rclcpp::NodeOptions::async_rosout() or rosout is disabled
+   */
+  RCLCPP_PUBLIC
+  virtual
+  rclcpp::AsyncRosoutPublisher::SharedPtr
+  get_async_rosout_publisher() const = 0;
 };
 
 }  // namespace node_interfaces
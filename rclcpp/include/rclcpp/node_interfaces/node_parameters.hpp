@@ -41,6 +41,9 @@
 
 namespace rclcpp
 {
+
+class ParameterSnapshot;
+
 namespace node_interfaces
 {
 
@@ -97,7 +100,8 @@ public:
     const rclcpp::QoS & parameter_event_qos,
     const rclcpp::PublisherOptionsBase & parameter_event_publisher_options,
     bool allow_undeclared_parameters,
-    bool automatically_declare_parameters_from_overrides);
+    bool automatically_declare_parameters_from_overrides,
+    const std::string & parameter_snapshot_file = "");
 
   RCLCPP_PUBLIC
   virtual
@@ -179,6 +183,26 @@ public:
 private:
   RCLCPP_DISABLE_COPY(NodeParameters)
 
+  /// Get the parameter overrides from the arguments, then from the given ones.
+  void
+  load_parameter_overrides(const std::vector<Parameter> & parameter_overrides) const;
+
+  /// Restore the parameters from the snapshot file, return false if it has none.
+  bool
+  restore_parameters(const std::string & parameter_snapshot_file);
+
+  /// Declare a parameter restored from the snapshot, return false if it does not match.
+  bool
+  declare_restored_parameter(
+    const std::string & name,
+    const ParameterInfo & restored_info,
+    const rclcpp::ParameterValue & default_value,
+    const rcl_interfaces::msg::ParameterDescriptor & parameter_descriptor);
+
+  /// Record the change of a parameter in the snapshot file, if any.
+  void
+  update_parameter_snapshot(const std::string & name);
+
   mutable std::recursive_mutex mutex_;
 
   // There are times when we don't want to allow modifications to parameters
@@ -192,7 +216,18 @@ private:
 
   std::map<std::string, ParameterInfo> parameters_;
 
-  std::map<std::string, rclcpp::ParameterValue> parameter_overrides_;
+  // Loaded on first use when the parameters are restored from a snapshot.
+  mutable std::map<std::string, rclcpp::ParameterValue> parameter_overrides_;
+
+  mutable bool parameter_overrides_loaded_ = true;
+
+  std::vector<Parameter> deferred_parameter_overrides_;
+
+  std::shared_ptr<rclcpp::ParameterSnapshot> parameter_snapshot_;
+
+  // Parameters restored from the snapshot, which were not declared again yet.
+  // They are not parameters of the node until then, but are kept when the snapshot is rewritten.
+  std::map<std::string, ParameterInfo> restored_parameters_;
 
   bool allow_undeclared_ = false;
 
@@ -202,6 +237,7 @@ private:
 
   std::string combined_name_;
 
+  node_interfaces::NodeBaseInterface::SharedPtr node_base_;
   node_interfaces::NodeLoggingInterface::SharedPtr node_logging_;
   node_interfaces::NodeClockInterface::SharedPtr node_clock_;
 };
@@ -15,7 +15,9 @@
 #ifndef RCLCPP__NODE_INTERFACES__NODE_TOPICS_HPP_
 #define RCLCPP__NODE_INTERFACES__NODE_TOPICS_HPP_
 
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "rcl/publisher.h"
 #include "rcl/subscription.h"
@@ -60,6 +62,10 @@ public:
     rclcpp::PublisherBase::SharedPtr publisher,
     rclcpp::CallbackGroup::SharedPtr callback_group) override;
 
+  RCLCPP_PUBLIC
+  std::vector<rclcpp::PublisherBase::SharedPtr>
+  get_publishers() const override;
+
   RCLCPP_PUBLIC
   rclcpp::SubscriptionBase::SharedPtr
   create_subscription(
@@ -90,6 +96,10 @@ private:
 
   rclcpp::node_interfaces::NodeBaseInterface * node_base_;
   rclcpp::node_interfaces::NodeTimersInterface * node_timers_;
+
+  // Publishers are not owned by the node, they are only kept for introspection.
+  mutable std::mutex publishers_mutex_;
+  std::vector<rclcpp::PublisherBase::WeakPtr> publishers_;
 };
 
 }  // namespace node_interfaces
@@ -18,6 +18,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rcl/publisher.h"
 #include "rcl/subscription.h"
@@ -62,6 +63,12 @@ public:
     rclcpp::PublisherBase::SharedPtr publisher,
     rclcpp::CallbackGroup::SharedPtr callback_group) = 0;
 
+  /// Return the publishers added to this node which still exist.
+  RCLCPP_PUBLIC
+  virtual
+  std::vector<rclcpp::PublisherBase::SharedPtr>
+  get_publishers() const = 0;
+
   RCLCPP_PUBLIC
   virtual
   rclcpp::SubscriptionBase::SharedPtr
@@ -48,11 +48,14 @@ public:
    *   - start_parameter_event_publisher = true
    *   - clock_qos = rclcpp::ClockQoS()
    *   - rosout_qos = rclcpp::RosoutQoS()
+   *   - async_rosout = false
+   *   - async_rosout_queue_depth = 1000
    *   - parameter_event_qos = rclcpp::ParameterEventQoS
    *     - with history setting and depth from rmw_qos_profile_parameter_events
    *   - parameter_event_publisher_options = rclcpp::PublisherOptionsBase
    *   - allow_undeclared_parameters = false
    *   - automatically_declare_parameters_from_overrides = false
+   *   - parameter_snapshot_file = ""
    *   - allocator = rcl_get_default_allocator()
    *
    * \param[in] allocator allocator to use in construction of NodeOptions.
@@ -284,6 +287,38 @@ public:
   NodeOptions &
   rosout_qos(const rclcpp::QoS & rosout_qos);
 
+  /// Return the async_rosout flag.
+  RCLCPP_PUBLIC
+  bool
+  async_rosout() const;
+
+  /// Set the async_rosout flag, return this for parameter idiom.
+  /**
+   * If true, and rosout is enabled, the log records of the node are queued
+   * and published on /rosout from a thread of the node, instead of from the
+   * thread logging them, see rclcpp::AsyncRosoutPublisher.
+   *
+   * This will cause the internal rcl_node_options_t struct to be invalidated.
+   */
+  RCLCPP_PUBLIC
+  NodeOptions &
+  async_rosout(bool async_rosout);
+
+  /// Return the depth of the asynchronous rosout queue.
+  RCLCPP_PUBLIC
+  size_t
+  async_rosout_queue_depth() const;
+
+  /// Set the depth of the asynchronous rosout queue, return this for parameter idiom.
+  /**
+   * The log records logged while the queue is full are dropped and counted.
+   *
+   * \throws std::invalid_argument if the depth is zero
+   */
+  RCLCPP_PUBLIC
+  NodeOptions &
+  async_rosout_queue_depth(size_t async_rosout_queue_depth);
+
   /// Return a reference to the parameter_event_publisher_options.
   RCLCPP_PUBLIC
   const rclcpp::PublisherOptionsBase &
@@ -342,6 +377,30 @@ public:
   automatically_declare_parameters_from_overrides(
     bool automatically_declare_parameters_from_overrides);
 
+  /// Return the path of the parameter snapshot file, empty if disabled.
+  RCLCPP_PUBLIC
+  const std::string &
+  parameter_snapshot_file() const;
+
+  /// Set the path of the parameter snapshot file, return this for parameter idiom.
+  /**
+   * If not empty, the parameters of the node are saved in this memory mapped
+   * file whenever they change, see rclcpp::ParameterSnapshot.
+   * When the node is created again with the same file, e.g. after a restart,
+   * the parameters of the snapshot are restored, and the parameter overrides
+   * are only parsed if a parameter needs them.
+   * A restored parameter is declared again with its restored value, unless
+   * its type or its descriptor changed, in which case it falls back to the
+   * parameter overrides like any other parameter.
+   * Until it is declared again, a restored parameter is not a parameter of
+   * the node, but it is kept in the snapshot.
+   * The file must not be shared by several nodes, and is not supported on
+   * Windows.
+   */
+  RCLCPP_PUBLIC
+  NodeOptions &
+  parameter_snapshot_file(const std::string & parameter_snapshot_file);
+
   /// Return the rcl_allocator_t to be used.
   RCLCPP_PUBLIC
   const rcl_allocator_t &
@@ -390,12 +449,18 @@ private:
 
   rclcpp::QoS rosout_qos_ = rclcpp::RosoutQoS();
 
+  bool async_rosout_ {false};
+
+  size_t async_rosout_queue_depth_ {1000};
+
   rclcpp::PublisherOptionsBase parameter_event_publisher_options_ = rclcpp::PublisherOptionsBase();
 
   bool allow_undeclared_parameters_ {false};
 
   bool automatically_declare_parameters_from_overrides_ {false};
 
+  std::string parameter_snapshot_file_ {};
+
   rcl_allocator_t allocator_ {rcl_get_default_allocator()};
 };
 
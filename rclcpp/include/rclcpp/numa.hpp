@@ -0,0 +1,234 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__NUMA_HPP_
+#define RCLCPP__NUMA_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// CPUs and memory of the NUMA nodes a process can run on.
+/**
+ * NUMA nodes are indexed from 0 to get_node_count() - 1, which are not
+ * necessarily the node numbers of the system, since nodes without any CPU
+ * available to the process are left out.
+ *
+ * A topology can also be simulated, to spread threads over groups of CPUs as
+ * if they were NUMA nodes on a machine with a single node.
+ * Memory is then not bound to any node.
+ */
+class NumaTopology
+{
+public:
+  /// Create a topology from the CPUs of each node.
+  /**
+   * \param[in] node_cpus CPU numbers of each node
+   * \param[in] memory_nodes system node number of each node, to bind memory
+   *   to, or -1 to not bind memory, e.g. for simulated nodes
+   * \throws std::invalid_argument if there is no node, a node has no CPU, or
+   *   the sizes of node_cpus and memory_nodes differ
+   */
+  RCLCPP_PUBLIC
+  NumaTopology(std::vector<std::vector<int>> node_cpus, std::vector<int> memory_nodes);
+
+  /// Detect the NUMA nodes of the system.
+  /**
+   * On Linux the nodes are read from /sys/devices/system/node, and only the
+   * CPUs in the affinity mask of the process are kept.
+   * Elsewhere, or if the nodes can't be read, a single node with all CPUs is
+   * returned, whose memory is not bound.
+   */
+  RCLCPP_PUBLIC
+  static
+  NumaTopology
+  detect();
+
+  /// Simulate a topology by splitting the CPUs available to the process.
+  /**
+   * The CPUs are split in node_count contiguous groups of about the same size.
+   * If there are fewer CPUs than nodes, CPUs are shared by several nodes.
+   *
+   * \param[in] node_count number of simulated nodes
+   * \throws std::invalid_argument if node_count is 0
+   */
+  RCLCPP_PUBLIC
+  static
+  NumaTopology
+  simulate(size_t node_count);
+
+  /// Return the number of nodes.
+  RCLCPP_PUBLIC
+  size_t
+  get_node_count() const;
+
+  /// Return the CPUs of a node.
+  /**
+   * \throws std::out_of_range if node is not less than get_node_count()
+   */
+  RCLCPP_PUBLIC
+  const std::vector<int> &
+  get_cpus(size_t node) const;
+
+  /// Return the system node number memory of a node is bound to, or -1 if it is not bound.
+  /**
+   * \throws std::out_of_range if node is not less than get_node_count()
+   */
+  RCLCPP_PUBLIC
+  int
+  get_memory_node(size_t node) const;
+
+  /// Return true if no memory is bound, i.e. for simulated topologies or a single node.
+  RCLCPP_PUBLIC
+  bool
+  is_simulated() const;
+
+  /// Return the first node with the given CPU, or get_node_count() if there is none.
+  RCLCPP_PUBLIC
+  size_t
+  get_node_of_cpu(int cpu) const;
+
+  /// Return the node of the CPU the calling thread runs on, or 0 if it is unknown.
+  RCLCPP_PUBLIC
+  size_t
+  get_current_node() const;
+
+  /// Bind the calling thread to the CPUs and the memory of a node.
+  /**
+   * The thread is only scheduled on the CPUs of the node, and memory it
+   * touches first is preferably taken from the memory node, if any.
+   * Threads created afterwards by the calling thread inherit both.
+   * On systems other than Linux, this does nothing.
+   *
+   * \throws std::out_of_range if node is not less than get_node_count()
+   * \throws std::runtime_error if the CPU affinity can't be set
+   */
+  RCLCPP_PUBLIC
+  void
+  bind_current_thread(size_t node) const;
+
+private:
+  struct Node
+  {
+    std::vector<int> cpus;
+    int memory_node;
+  };
+
+  std::vector<Node> nodes_;
+};
+
+/// Allocate memory, preferably from a system NUMA node.
+/**
+ * Allocations of at least a page are mapped separately and bound to the
+ * node, smaller ones come from the heap, and are placed on the node of the
+ * thread which first touches them.
+ * Mapped blocks start on a page boundary, unlike the blocks from the heap,
+ * which have a header in front of them, so that blocks can be deallocated
+ * without knowing their size, e.g. through a rcl allocator.
+ * The mappings are kept for reuse by the next blocks of the same node once
+ * deallocated, up to a limit.
+ *
+ * \param[in] size number of bytes to allocate
+ * \param[in] memory_node system node number, or -1 to not bind the memory
+ * \throws std::bad_alloc if the memory can't be allocated
+ */
+RCLCPP_PUBLIC
+void *
+numa_allocate(size_t size, int memory_node);
+
+/// Deallocate memory allocated with numa_allocate(), nullptr being ignored.
+RCLCPP_PUBLIC
+void
+numa_deallocate(void * pointer) noexcept;
+
+/// Allocator taking memory from a NUMA node, see numa_allocate().
+/**
+ * It can be used as the allocator of subscriptions, e.g. with
+ * rclcpp::SubscriptionOptionsWithAllocator, so the messages copied into
+ * their intra-process buffer come from the node of the consumer, or for
+ * rclcpp::strategies::message_pool_memory_strategy::MessagePoolMemoryStrategy.
+ */
+template<typename T>
+class NumaAllocator
+{
+public:
+  using value_type = T;
+
+  template<typename U>
+  struct rebind
+  {
+    using other = NumaAllocator<U>;
+  };
+
+  /// Create an allocator which doesn't bind memory.
+  NumaAllocator() noexcept
+  : memory_node_(-1)
+  {}
+
+  /// Create an allocator taking memory from a node of the topology.
+  NumaAllocator(const NumaTopology & topology, size_t node)
+  : memory_node_(topology.get_memory_node(node))
+  {}
+
+  template<typename U>
+  NumaAllocator(const NumaAllocator<U> & other) noexcept  // NOLINT(runtime/explicit)
+  : memory_node_(other.get_memory_node())
+  {}
+
+  T *
+  allocate(size_t size)
+  {
+    return static_cast<T *>(numa_allocate(size * sizeof(T), memory_node_));
+  }
+
+  /// Deallocate memory, the size being ignored, so rcl allocators can deallocate too.
+  void
+  deallocate(T * pointer, size_t size) noexcept
+  {
+    (void)size;
+    numa_deallocate(pointer);
+  }
+
+  /// Return the system node number memory is bound to, or -1.
+  int
+  get_memory_node() const noexcept
+  {
+    return memory_node_;
+  }
+
+private:
+  int memory_node_;
+};
+
+template<typename T, typename U>
+bool
+operator==(const NumaAllocator<T> & a, const NumaAllocator<U> & b) noexcept
+{
+  return a.get_memory_node() == b.get_memory_node();
+}
+
+template<typename T, typename U>
+bool
+operator!=(const NumaAllocator<T> & a, const NumaAllocator<U> & b) noexcept
+{
+  return !(a == b);
+}
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__NUMA_HPP_
@@ -0,0 +1,215 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__PARAMETER_EVENT_HANDLER_HPP_
+#define RCLCPP__PARAMETER_EVENT_HANDLER_HPP_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rcl_interfaces/msg/parameter_event.hpp"
+
+#include "rclcpp/create_subscription.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/get_node_base_interface.hpp"
+#include "rclcpp/node_interfaces/node_base_interface.hpp"
+#include "rclcpp/parameter.hpp"
+#include "rclcpp/qos.hpp"
+#include "rclcpp/subscription.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Handle of a callback for the changes of one parameter, see ParameterEventHandler.
+struct ParameterCallbackHandle
+{
+  RCLCPP_SMART_PTR_DEFINITIONS(ParameterCallbackHandle)
+
+  using ParameterCallbackType = std::function<void (const rclcpp::Parameter &)>;
+
+  std::string parameter_name;
+  std::string node_name;
+  ParameterCallbackType callback;
+};
+
+/// Handle of a callback for all parameter events, see ParameterEventHandler.
+struct ParameterEventCallbackHandle
+{
+  RCLCPP_SMART_PTR_DEFINITIONS(ParameterEventCallbackHandle)
+
+  using ParameterEventCallbackType =
+    std::function<void (const rcl_interfaces::msg::ParameterEvent::SharedPtr &)>;
+
+  ParameterEventCallbackType callback;
+};
+
+/// Routes parameter events to callbacks registered for a parameter of a node.
+/**
+ * The handler subscribes once to the `/parameter_events` topic.
+ * Callbacks for the changes of a parameter are indexed by node and parameter
+ * name, so that handling an event only costs a lookup for each parameter in the
+ * event, however many callbacks are registered.
+ *
+ * Example Usage:
+ *
+ * ```cpp
+ * auto handler = std::make_shared<rclcpp::ParameterEventHandler>(node);
+ * auto handle = handler->add_parameter_callback(
+ *   "foo",
+ *   [](const rclcpp::Parameter & parameter) {
+ *     RCLCPP_INFO(
+ *       rclcpp::get_logger("example"), "foo is now %s", parameter.value_to_string().c_str());
+ *   },
+ *   "/other_node");
+ * ```
+ *
+ * The callbacks are only called while the returned handles are kept alive, and
+ * until they are removed.
+ * Callbacks may add or remove callbacks.
+ */
+class ParameterEventHandler
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(ParameterEventHandler)
+
+  /// Construct a parameter events handler, subscribing with the given node.
+  /**
+   * The NodeT type needs to have the methods get_node_base_interface() and
+   * get_node_topics_interface(), e.g. rclcpp::Node.
+   *
+   * \param[in] node node used to subscribe to the parameter events
+   * \param[in] qos QoS of the parameter events subscription
+   */
+  template<typename NodeT>
+  explicit ParameterEventHandler(
+    NodeT node,
+    const rclcpp::QoS & qos = rclcpp::ParameterEventsQoS())
+  : callbacks_(std::make_shared<Callbacks>())
+  {
+    node_base_ = rclcpp::node_interfaces::get_node_base_interface(node);
+    // Shared with the subscription, which may outlive the handler while its callback runs.
+    auto callbacks = callbacks_;
+    event_subscription_ = rclcpp::create_subscription<rcl_interfaces::msg::ParameterEvent>(
+      node,
+      "/parameter_events",
+      qos,
+      [callbacks](const rcl_interfaces::msg::ParameterEvent::SharedPtr event) {
+        callbacks->handle_event(event);
+      });
+  }
+
+  /// Add a callback for all parameter events.
+  /**
+   * \param[in] callback function called with each parameter event
+   * \return handle of the callback, which must be kept alive for it to be called
+   */
+  RCLCPP_PUBLIC
+  ParameterEventCallbackHandle::SharedPtr
+  add_parameter_event_callback(
+    ParameterEventCallbackHandle::ParameterEventCallbackType callback);
+
+  /// Remove a callback for all parameter events.
+  /**
+   * \param[in] callback_handle handle returned by add_parameter_event_callback()
+   * \throws std::runtime_error if the callback was not added or was already removed
+   */
+  RCLCPP_PUBLIC
+  void
+  remove_parameter_event_callback(
+    ParameterEventCallbackHandle::SharedPtr callback_handle);
+
+  /// Add a callback for the changes of a parameter of a node.
+  /**
+   * The callback is called when the parameter is declared or changed.
+   *
+   * \param[in] parameter_name name of the parameter
+   * \param[in] callback function called with the new value of the parameter
+   * \param[in] node_name name of the node of the parameter, relative names are
+   *   resolved in the namespace of this node, empty for this node
+   * \return handle of the callback, which must be kept alive for it to be called
+   */
+  RCLCPP_PUBLIC
+  ParameterCallbackHandle::SharedPtr
+  add_parameter_callback(
+    const std::string & parameter_name,
+    ParameterCallbackHandle::ParameterCallbackType callback,
+    const std::string & node_name = "");
+
+  /// Remove a callback for the changes of a parameter.
+  /**
+   * \param[in] callback_handle handle returned by add_parameter_callback()
+   * \throws std::runtime_error if the callback was not added or was already removed
+   */
+  RCLCPP_PUBLIC
+  void
+  remove_parameter_callback(
+    ParameterCallbackHandle::SharedPtr callback_handle);
+
+  /// Get a parameter declared or changed by a parameter event.
+  /**
+   * \param[in] event parameter event
+   * \param[out] parameter parameter found in the event
+   * \param[in] parameter_name name of the parameter
+   * \param[in] node_name fully qualified name of the node of the parameter
+   * \return `true` if the event is from the node and contains the parameter
+   */
+  RCLCPP_PUBLIC
+  static bool
+  get_parameter_from_event(
+    const rcl_interfaces::msg::ParameterEvent & event,
+    rclcpp::Parameter & parameter,
+    const std::string & parameter_name,
+    const std::string & node_name);
+
+  /// Get all the parameters declared or changed by a parameter event.
+  RCLCPP_PUBLIC
+  static std::vector<rclcpp::Parameter>
+  get_parameters_from_event(const rcl_interfaces::msg::ParameterEvent & event);
+
+protected:
+  /// Return the fully qualified name of a node, as given to add_parameter_callback().
+  RCLCPP_PUBLIC
+  std::string
+  resolve_node_name(const std::string & node_name) const;
+
+  /// Registered callbacks, shared with the subscription callback.
+  struct Callbacks
+  {
+    RCLCPP_PUBLIC
+    void
+    handle_event(const rcl_interfaces::msg::ParameterEvent::SharedPtr & event);
+
+    using CallbackList = std::list<ParameterCallbackHandle::WeakPtr>;
+
+    std::mutex mutex;
+    /// Callbacks of parameters, indexed by node name and then by parameter name.
+    std::unordered_map<std::string, std::unordered_map<std::string, CallbackList>>
+    parameter_callbacks;
+    std::list<ParameterEventCallbackHandle::WeakPtr> event_callbacks;
+  };
+
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_;
+  std::shared_ptr<Callbacks> callbacks_;
+  rclcpp::Subscription<rcl_interfaces::msg::ParameterEvent>::SharedPtr event_subscription_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__PARAMETER_EVENT_HANDLER_HPP_
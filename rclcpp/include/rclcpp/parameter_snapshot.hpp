@@ -0,0 +1,131 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__PARAMETER_SNAPSHOT_HPP_
+#define RCLCPP__PARAMETER_SNAPSHOT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/node_interfaces/node_parameters.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Memory mapped file holding the parameters of a node, to restore them quickly on restart.
+/**
+ * The file starts with the fully qualified name of the node, followed by a
+ * log of records, each one holding the value and the descriptor of a
+ * parameter, serialized, or the removal of a parameter.
+ * Each change of a parameter appends a record, so that updates cost the same
+ * whatever the number of parameters, and the file is rewritten with a
+ * single record per parameter when it is full.
+ * Rewrites go through a temporary file renamed over the snapshot, and a
+ * record is only valid once completely written, so that the snapshot of a
+ * process which crashes is left in a consistent state.
+ *
+ * See NodeOptions::parameter_snapshot_file() for its use by the nodes.
+ * This is not supported on Windows, where the constructor throws.
+ * This class is not thread-safe.
+ */
+class ParameterSnapshot
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(ParameterSnapshot)
+
+  using ParameterInfos = std::map<std::string, node_interfaces::ParameterInfo>;
+
+  /// Open the snapshot file of a node, creating it if it does not exist.
+  /**
+   * \param[in] file_path path of the snapshot file
+   * \param[in] node_name fully qualified name of the node
+   * \throws std::runtime_error if the file cannot be opened or mapped
+   */
+  RCLCPP_PUBLIC
+  ParameterSnapshot(const std::string & file_path, const std::string & node_name);
+
+  RCLCPP_PUBLIC
+  virtual ~ParameterSnapshot();
+
+  /// Read the parameters of the snapshot.
+  /**
+   * \param[out] parameters parameters of the snapshot
+   * \return `false` if the file is empty, is not a snapshot of this version,
+   *   is the snapshot of another node, or is corrupted, in which case it
+   *   must be rewritten with write() before being updated
+   */
+  RCLCPP_PUBLIC
+  bool
+  load(ParameterInfos & parameters);
+
+  /// Record the change of a parameter.
+  /**
+   * \param[in] name name of the changed parameter, which was removed if not
+   *   in the parameters
+   * \param[in] parameters all the parameters, written if the file is full
+   * \param[in] pending_parameters parameters kept in the file if it is rewritten, unless
+   *   in the parameters, e.g. loaded ones which were not declared again yet
+   * \return `true` if the file was rewritten
+   * \throws std::runtime_error if the file cannot be rewritten
+   */
+  RCLCPP_PUBLIC
+  bool
+  update(
+    const std::string & name, const ParameterInfos & parameters,
+    const ParameterInfos & pending_parameters = ParameterInfos());
+
+  /// Rewrite the file with the given parameters.
+  /**
+   * \param[in] parameters the parameters to write
+   * \param[in] pending_parameters parameters also written, unless in the parameters
+   * \throws std::runtime_error if the file cannot be written
+   */
+  RCLCPP_PUBLIC
+  void
+  write(
+    const ParameterInfos & parameters,
+    const ParameterInfos & pending_parameters = ParameterInfos());
+
+  RCLCPP_PUBLIC
+  const std::string &
+  get_file_path() const;
+
+  /// Return the number of bytes of the file used by the records.
+  RCLCPP_PUBLIC
+  size_t
+  get_size() const;
+
+  /// Return the size of the file.
+  RCLCPP_PUBLIC
+  size_t
+  get_capacity() const;
+
+private:
+  void
+  unmap();
+
+  std::string file_path_;
+  std::string node_name_;
+  uint8_t * data_;
+  size_t capacity_;
+  size_t size_;
+};
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__PARAMETER_SNAPSHOT_HPP_
@@ -37,6 +37,8 @@
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
 #include "rclcpp/publisher_base.hpp"
 #include "rclcpp/publisher_options.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialization_codec.hpp"
 #include "rclcpp/type_support_decl.hpp"
 #include "rclcpp/visibility_control.hpp"
 
@@ -66,7 +68,8 @@ public:
    * rclcpp::create_publisher().
    *
    * \param[in] node_base NodeBaseInterface pointer that is used in part of the setup.
-   * \param[in] topic Name of the topic to publish to.
+   * \param[in] topic Name of the topic to publish to, which is changed by
+   *   rclcpp::get_encoded_topic_name() if the options have a serialization codec.
    * \param[in] qos QoS profile for Subcription.
    * \param[in] options Options for the subscription.
    */
@@ -77,7 +80,8 @@ public:
     const rclcpp::PublisherOptionsWithAllocator<AllocatorT> & options)
   : PublisherBase(
       node_base,
-      topic,
+      options.serialization_codec ?
+      rclcpp::get_encoded_topic_name(topic, *options.serialization_codec) : topic,
       *rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>(),
       options.template to_rcl_publisher_options<MessageT>(qos)),
     options_(options),
@@ -141,11 +145,22 @@ public:
         throw std::invalid_argument(
                 "intraprocess communication is not allowed with a zero qos history depth value");
       }
-      if (qos.get_rmw_qos_profile().durability != RMW_QOS_POLICY_DURABILITY_VOLATILE) {
-        throw std::invalid_argument(
-                "intraprocess communication allowed only with volatile durability");
+      rclcpp::experimental::IntraProcessPublisherHistoryBase::SharedPtr history;
+      switch (qos.get_rmw_qos_profile().durability) {
+        case RMW_QOS_POLICY_DURABILITY_VOLATILE:
+          break;
+        case RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL:
+          // Keep the last messages for late joining intra-process subscriptions.
+          history = std::make_shared<rclcpp::experimental::IntraProcessPublisherHistory<MessageT>>(
+            qos.get_rmw_qos_profile().depth);
+          break;
+        default:
+          throw std::invalid_argument(
+                  "intraprocess communication allowed only with volatile or transient local "
+                  "durability");
       }
-      uint64_t intra_process_publisher_id = ipm->add_publisher(this->shared_from_this());
+      uint64_t intra_process_publisher_id =
+        ipm->add_publisher(this->shared_from_this(), history);
       this->setup_intra_process(
         intra_process_publisher_id,
         ipm);
@@ -258,7 +273,7 @@ public:
     // otherwise we have to ensure that every middleware implements
     // `rmw_publish_loaned_message` explicitly the same way as `rmw_publish`
     // by taking a copy of the ros message.
-    if (this->can_loan_messages()) {
+    if (this->can_loan_messages() && !options_.serialization_codec) {
       // we release the ownership from the rclpp::LoanedMessage instance
       // and let the middleware clean up the memory.
       this->do_loaned_message_publish(loaned_msg.release());
@@ -275,10 +290,24 @@ public:
     return message_allocator_;
   }
 
+  size_t
+  get_memory_usage() const override
+  {
+    return PublisherBase::get_memory_usage() + sizeof(*this) - sizeof(PublisherBase) +
+           serialized_message_pool_.get_memory_usage();
+  }
+
 protected:
   void
   do_inter_process_publish(const MessageT & msg)
   {
+    if (options_.serialization_codec) {
+      auto serialized_msg = serialized_message_pool_.acquire();
+      serialization_.serialize_message(&msg, serialized_msg.get());
+      this->do_encoded_publish(serialized_msg->get_rcl_serialized_message());
+      serialized_message_pool_.release(std::move(serialized_msg));
+      return;
+    }
     auto status = rcl_publish(publisher_handle_.get(), &msg, nullptr);
 
     if (RCL_RET_PUBLISHER_INVALID == status) {
@@ -303,12 +332,29 @@ protected:
       // TODO(Karsten1987): support serialized message passed by intraprocess
       throw std::runtime_error("storing serialized messages in intra process is not supported yet");
     }
+    if (options_.serialization_codec) {
+      return this->do_encoded_publish(*serialized_msg);
+    }
     auto status = rcl_publish_serialized_message(publisher_handle_.get(), serialized_msg, nullptr);
     if (RCL_RET_OK != status) {
       rclcpp::exceptions::throw_from_rcl_error(status, "failed to publish serialized message");
     }
   }
 
+  /// Publish a serialized message encoded with the serialization codec of the options.
+  void
+  do_encoded_publish(const rcl_serialized_message_t & serialized_msg)
+  {
+    auto encoded_msg = serialized_message_pool_.acquire();
+    rclcpp::encode_serialized_message(*options_.serialization_codec, serialized_msg, *encoded_msg);
+    auto status = rcl_publish_serialized_message(
+      publisher_handle_.get(), &encoded_msg->get_rcl_serialized_message(), nullptr);
+    serialized_message_pool_.release(std::move(encoded_msg));
+    if (RCL_RET_OK != status) {
+      rclcpp::exceptions::throw_from_rcl_error(status, "failed to publish serialized message");
+    }
+  }
+
   void
   do_loaned_message_publish(MessageT * msg)
   {
@@ -375,6 +421,11 @@ protected:
   std::shared_ptr<MessageAllocator> message_allocator_;
 
   MessageDeleter message_deleter_;
+
+  /// Used to serialize messages which are encoded before being published.
+  const rclcpp::Serialization<MessageT> serialization_;
+  /// Buffers of the serialized and encoded messages, kept between publishes.
+  rclcpp::SerializedMessagePool serialized_message_pool_;
 };
 
 }  // namespace rclcpp
@@ -193,6 +193,18 @@ public:
     uint64_t intra_process_publisher_id,
     IntraProcessManagerSharedPtr ipm);
 
+  /// Return the approximate number of bytes of memory retained by this publisher.
+  /**
+   * This includes the publisher itself, the buffers it keeps between
+   * publishes, and its intra-process transient local history, if any.
+   * Memory allocated by the middleware is not included.
+   * See rclcpp::get_memory_usage().
+   */
+  RCLCPP_PUBLIC
+  virtual
+  size_t
+  get_memory_usage() const;
+
 protected:
   template<typename EventCallbackT>
   void
@@ -27,6 +27,7 @@
 #include "rclcpp/qos.hpp"
 #include "rclcpp/qos_event.hpp"
 #include "rclcpp/qos_overriding_options.hpp"
+#include "rclcpp/serialization_codec.hpp"
 
 namespace rclcpp
 {
@@ -53,6 +54,13 @@ struct PublisherOptionsBase
   rmw_implementation_payload = nullptr;
 
   QosOverridingOptions qos_overriding_options;
+
+  /// Optional codec applied to the serialized messages, e.g. to compress them.
+  /**
+   * Messages are then sent on the topic named by rclcpp::get_encoded_topic_name(),
+   * to subscriptions using the same codec.
+   */
+  std::shared_ptr<rclcpp::SerializationCodec> serialization_codec = nullptr;
 };
 
 /// Structure containing optional configuration for Publishers.
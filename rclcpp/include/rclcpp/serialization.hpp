@@ -55,6 +55,19 @@ public:
    */
   explicit SerializationBase(const rosidl_message_type_support_t * type_support);
 
+  /// Constructor of SerializationBase for a type known by name only.
+  /**
+   * The type support is loaded with the global type support registry, which
+   * caches it for all the serializations of the type.
+   *
+   * \param[in] type name of the message type, e.g. `test_msgs/msg/BasicTypes`.
+   * \param[in] typesupport_identifier identifier of the type support.
+   * \throws std::runtime_error if the type support cannot be loaded.
+   */
+  explicit SerializationBase(
+    const std::string & type,
+    const std::string & typesupport_identifier = "rosidl_typesupport_cpp");
+
   /// Destructor of SerializationBase
   virtual ~SerializationBase() = default;
 
@@ -0,0 +1,212 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__SERIALIZATION_CODEC_HPP_
+#define RCLCPP__SERIALIZATION_CODEC_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rcl/types.h"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Interface of a codec applied to serialized messages, e.g. to compress them.
+/**
+ * A codec is set with the `serialization_codec` member of the publisher and
+ * subscription options, and is then applied to every message sent or
+ * received.
+ * Codecs are shared by publishers and subscriptions, which may use them from
+ * different threads at the same time, so they must be stateless.
+ */
+class SerializationCodec
+{
+public:
+  RCLCPP_SMART_PTR_ALIASES_ONLY(SerializationCodec)
+
+  virtual ~SerializationCodec() = default;
+
+  /// Return the name of the codec.
+  /**
+   * The name is part of the name of the topics on which encoded messages are
+   * sent, see get_encoded_topic_name(), so it must be a valid topic name token.
+   */
+  virtual std::string
+  get_name() const = 0;
+
+  /// Return the largest size of the encoding of data of the given size.
+  virtual size_t
+  get_max_encoded_size(size_t decoded_size) const = 0;
+
+  /// Encode data.
+  /**
+   * \param[in] data data to encode
+   * \param[in] size size of the data in bytes
+   * \param[out] encoded buffer of at least get_max_encoded_size(size) bytes
+   * \return size of the encoded data in bytes
+   */
+  virtual size_t
+  encode(const uint8_t * data, size_t size, uint8_t * encoded) const = 0;
+
+  /// Return the size of the data from which encoded data was made.
+  /**
+   * The size is read from the encoded data, which may come from anywhere, so
+   * it is checked against the most the encoded data could decode to before a
+   * buffer of that size is allocated.
+   *
+   * \throws std::runtime_error if the encoded data is not valid, or too short
+   *   for its decoded size
+   */
+  virtual size_t
+  get_decoded_size(const uint8_t * encoded, size_t encoded_size) const = 0;
+
+  /// Decode data.
+  /**
+   * \param[in] encoded encoded data
+   * \param[in] encoded_size size of the encoded data in bytes
+   * \param[out] data buffer of get_decoded_size() bytes
+   * \param[in] size size of the buffer in bytes
+   * \throws std::runtime_error if the encoded data is not valid
+   */
+  virtual void
+  decode(const uint8_t * encoded, size_t encoded_size, uint8_t * data, size_t size) const = 0;
+
+protected:
+  SerializationCodec() = default;
+};
+
+/// Fast compression codec of the LZ77 family, named "lz".
+/**
+ * The format is the block format of LZ4, preceded by the decoded size as an
+ * unsigned 32 bit little endian integer: sequences of literals copied as is
+ * and of matches copied from up to 64 KiB before.
+ * It trades compression ratio for speed, which makes it suited to
+ * compressing large messages, e.g. maps or point clouds, on the fly.
+ * Data which does not compress grows by less than 1%.
+ */
+class LZCodec : public SerializationCodec
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS(LZCodec)
+
+  RCLCPP_PUBLIC
+  std::string
+  get_name() const override;
+
+  RCLCPP_PUBLIC
+  size_t
+  get_max_encoded_size(size_t decoded_size) const override;
+
+  RCLCPP_PUBLIC
+  size_t
+  encode(const uint8_t * data, size_t size, uint8_t * encoded) const override;
+
+  RCLCPP_PUBLIC
+  size_t
+  get_decoded_size(const uint8_t * encoded, size_t encoded_size) const override;
+
+  RCLCPP_PUBLIC
+  void
+  decode(const uint8_t * encoded, size_t encoded_size, uint8_t * data, size_t size) const override;
+};
+
+/// Pool of serialized messages, reused as buffers to avoid allocating for each message.
+/**
+ * This class is thread-safe.
+ */
+class SerializedMessagePool
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(SerializedMessagePool)
+
+  /// Create a pool keeping at most the given number of serialized messages.
+  RCLCPP_PUBLIC
+  explicit SerializedMessagePool(size_t max_size = 4);
+
+  /// Take a serialized message from the pool, or create one if the pool is empty.
+  RCLCPP_PUBLIC
+  std::unique_ptr<rclcpp::SerializedMessage>
+  acquire();
+
+  /// Give a serialized message back to the pool, which keeps its buffer if not full.
+  RCLCPP_PUBLIC
+  void
+  release(std::unique_ptr<rclcpp::SerializedMessage> message);
+
+  /// Return the number of bytes of the buffers kept by the pool.
+  RCLCPP_PUBLIC
+  size_t
+  get_memory_usage() const;
+
+private:
+  const size_t max_size_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<rclcpp::SerializedMessage>> messages_;
+};
+
+/// Encode a serialized message with a codec.
+/**
+ * The 4 byte encapsulation header of the CDR serialized message is kept as is
+ * in front of the encoded data, so that the middleware can still read it.
+ *
+ * \param[in] codec codec used to encode the message
+ * \param[in] serialized_message serialized message to encode
+ * \param[out] encoded_message encoded message, resized as needed
+ * \throws std::invalid_argument if the serialized message is shorter than its header
+ */
+RCLCPP_PUBLIC
+void
+encode_serialized_message(
+  const SerializationCodec & codec,
+  const rcl_serialized_message_t & serialized_message,
+  rclcpp::SerializedMessage & encoded_message);
+
+/// Decode a serialized message encoded by encode_serialized_message().
+/**
+ * \param[in] codec codec used to encode the message
+ * \param[in] encoded_message encoded message
+ * \param[out] serialized_message decoded message, resized as needed
+ * \throws std::runtime_error if the encoded message is not valid
+ */
+RCLCPP_PUBLIC
+void
+decode_serialized_message(
+  const SerializationCodec & codec,
+  const rcl_serialized_message_t & encoded_message,
+  rclcpp::SerializedMessage & serialized_message);
+
+/// Return the name of the topic on which messages encoded with a codec are sent.
+/**
+ * Encoded messages cannot be read by subscriptions which do not decode them,
+ * so they are sent on a topic of their own, named after the topic and the
+ * codec, e.g. `/map/encoded_lz` for the topic `/map` and the LZCodec.
+ * Publishers and subscriptions using the same codec are matched this way,
+ * while the others keep using the topic itself.
+ */
+RCLCPP_PUBLIC
+std::string
+get_encoded_topic_name(const std::string & topic_name, const SerializationCodec & codec);
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__SERIALIZATION_CODEC_HPP_
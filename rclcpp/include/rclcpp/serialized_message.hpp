@@ -15,6 +15,9 @@
 #ifndef RCLCPP__SERIALIZED_MESSAGE_HPP_
 #define RCLCPP__SERIALIZED_MESSAGE_HPP_
 
+#include <cstdint>
+#include <memory>
+
 #include "rcl/allocator.h"
 #include "rcl/types.h"
 
@@ -51,6 +54,26 @@ public:
     size_t initial_capacity,
     const rcl_allocator_t & allocator = rcl_get_default_allocator());
 
+  /// Constructor for a read-only SerializedMessage borrowing serialized data
+  /**
+   * The data is neither copied nor freed by the serialized message, which can
+   * be used to forward or record serialized data held elsewhere without
+   * copying it, e.g. data in a loaned or memory mapped buffer.
+   * The data can't be modified through the borrowed serialized message, and
+   * must stay valid as long as it, which can be ensured by giving the
+   * owner of the data, which is kept alive by the serialized message.
+   * Copies of a borrowed serialized message own a copy of the data.
+   *
+   * \param[in] data The serialized data.
+   * \param[in] size The size of the serialized data in bytes.
+   * \param[in] owner Optional owner of the data, kept alive until the serialized
+   *   message is destroyed or assigned.
+   */
+  SerializedMessage(
+    const uint8_t * data,
+    size_t size,
+    std::shared_ptr<const void> owner = nullptr);
+
   /// Copy Constructor for a SerializedMessage
   SerializedMessage(const SerializedMessage & other);
 
@@ -79,6 +102,10 @@ public:
   virtual ~SerializedMessage();
 
   /// Get the underlying rcl_serialized_t handle
+  /**
+   * \throws std::runtime_error if the serialized message borrows its data,
+   *   which can only be read, through the const overload.
+   */
   rcl_serialized_message_t & get_rcl_serialized_message();
 
   // Get a const handle to the underlying rcl_serialized_message_t
@@ -102,6 +129,8 @@ public:
   /**
    * The data buffer of the underlying rcl_serialized_message_t will be resized.
    * This might change the data layout and invalidates all pointers to the data.
+   *
+   * \throws std::runtime_error if the serialized message borrows its data.
    */
   void reserve(size_t capacity);
 
@@ -109,11 +138,19 @@ public:
   /**
    * The memory (i.e. the data buffer) of the serialized message will no longer
    * be managed by this instance and the memory won't be deallocated on destruction.
+   *
+   * \throws std::runtime_error if the serialized message borrows its data.
    */
   rcl_serialized_message_t release_rcl_serialized_message();
 
+  /// Return true if the serialized message borrows its data, and is read-only.
+  bool is_borrowed() const;
+
 private:
   rcl_serialized_message_t serialized_message_;
+  /// True if the buffer is borrowed, and must not be freed nor resized.
+  bool is_borrowed_ = false;
+  std::shared_ptr<const void> borrowed_data_owner_;
 };
 
 }  // namespace rclcpp
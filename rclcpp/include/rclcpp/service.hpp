@@ -121,6 +121,12 @@ public:
   bool
   exchange_in_use_by_wait_set_state(bool in_use_state);
 
+  /// Return the approximate number of bytes of memory retained by this service.
+  RCLCPP_PUBLIC
+  virtual
+  size_t
+  get_memory_usage() const;
+
 protected:
   RCLCPP_DISABLE_COPY(ServiceBase)
 
@@ -308,6 +314,12 @@ public:
   {
   }
 
+  size_t
+  get_memory_usage() const override
+  {
+    return sizeof(*this);
+  }
+
   /// Take the next request from the service.
   /**
    * \sa ServiceBase::take_type_erased_request().
@@ -15,7 +15,10 @@
 #ifndef RCLCPP__STRATEGIES__ALLOCATOR_MEMORY_STRATEGY_HPP_
 #define RCLCPP__STRATEGIES__ALLOCATOR_MEMORY_STRATEGY_HPP_
 
+#include <functional>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "rcl/allocator.h"
@@ -88,6 +91,12 @@ public:
     client_handles_.clear();
     timer_handles_.clear();
     waitable_handles_.clear();
+
+    subscription_index_.clear();
+    service_index_.clear();
+    client_index_.clear();
+    timer_index_.clear();
+    waitable_index_.clear();
   }
 
   void remove_null_handles(rcl_wait_set_t * wait_set) override
@@ -163,30 +172,32 @@ public:
       if (!group || !group->can_be_taken_from().load()) {
         continue;
       }
-      group->find_subscription_ptrs_if(
-        [this](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
-          subscription_handles_.push_back(subscription->get_subscription_handle());
-          return false;
-        });
-      group->find_service_ptrs_if(
-        [this](const rclcpp::ServiceBase::SharedPtr & service) {
-          service_handles_.push_back(service->get_service_handle());
-          return false;
-        });
-      group->find_client_ptrs_if(
-        [this](const rclcpp::ClientBase::SharedPtr & client) {
-          client_handles_.push_back(client->get_client_handle());
-          return false;
-        });
-      group->find_timer_ptrs_if(
-        [this](const rclcpp::TimerBase::SharedPtr & timer) {
-          timer_handles_.push_back(timer->get_timer_handle());
-          return false;
-        });
-      group->find_waitable_ptrs_if(
-        [this](const rclcpp::Waitable::SharedPtr & waitable) {
+      // Record which entity and callback group each handle belongs to, so that the
+      // get_next_*() functions do not have to search every group for a ready handle.
+      group->collect_all_ptrs(
+        [this, &group](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
+          auto handle = subscription->get_subscription_handle();
+          subscription_index_[handle.get()] = {subscription, group};
+          subscription_handles_.push_back(std::move(handle));
+        },
+        [this, &group](const rclcpp::ServiceBase::SharedPtr & service) {
+          auto handle = service->get_service_handle();
+          service_index_[handle.get()] = {service, group};
+          service_handles_.push_back(std::move(handle));
+        },
+        [this, &group](const rclcpp::ClientBase::SharedPtr & client) {
+          auto handle = client->get_client_handle();
+          client_index_[handle.get()] = {client, group};
+          client_handles_.push_back(std::move(handle));
+        },
+        [this, &group](const rclcpp::TimerBase::SharedPtr & timer) {
+          auto handle = timer->get_timer_handle();
+          timer_index_[handle.get()] = {timer, group};
+          timer_handles_.push_back(std::move(handle));
+        },
+        [this, &group](const rclcpp::Waitable::SharedPtr & waitable) {
+          waitable_index_[waitable.get()] = group;
           waitable_handles_.push_back(waitable);
-          return false;
         });
     }
 
@@ -267,11 +278,19 @@ public:
   {
     auto it = subscription_handles_.begin();
     while (it != subscription_handles_.end()) {
-      auto subscription = get_subscription_by_handle(*it, weak_groups_to_nodes);
+      rclcpp::SubscriptionBase::SharedPtr subscription;
+      rclcpp::CallbackGroup::SharedPtr group;
+      if (!find_collected_entity(subscription_index_, it->get(), subscription, group)) {
+        // The handle was not added by collect_entities(), search the groups for it instead
+        subscription = get_subscription_by_handle(*it, weak_groups_to_nodes);
+        if (subscription) {
+          group = get_group_by_subscription(subscription, weak_groups_to_nodes);
+        }
+      }
       if (subscription) {
-        // Find the group for this handle and see if it can be serviced
-        auto group = get_group_by_subscription(subscription, weak_groups_to_nodes);
-        if (!group) {
+        // Find the node for this group and see if it can be serviced
+        auto node = get_node_by_group(group, weak_groups_to_nodes);
+        if (!node) {
           // Group was not found, meaning the subscription is not valid...
           // Remove it from the ready list and continue looking
           it = subscription_handles_.erase(it);
@@ -284,9 +303,9 @@ public:
           continue;
         }
         // Otherwise it is safe to set and return the any_exec
-        any_exec.subscription = subscription;
-        any_exec.callback_group = group;
-        any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+        any_exec.subscription = std::move(subscription);
+        any_exec.callback_group = std::move(group);
+        any_exec.node_base = std::move(node);
         subscription_handles_.erase(it);
         return;
       }
@@ -302,11 +321,19 @@ public:
   {
     auto it = service_handles_.begin();
     while (it != service_handles_.end()) {
-      auto service = get_service_by_handle(*it, weak_groups_to_nodes);
+      rclcpp::ServiceBase::SharedPtr service;
+      rclcpp::CallbackGroup::SharedPtr group;
+      if (!find_collected_entity(service_index_, it->get(), service, group)) {
+        // The handle was not added by collect_entities(), search the groups for it instead
+        service = get_service_by_handle(*it, weak_groups_to_nodes);
+        if (service) {
+          group = get_group_by_service(service, weak_groups_to_nodes);
+        }
+      }
       if (service) {
-        // Find the group for this handle and see if it can be serviced
-        auto group = get_group_by_service(service, weak_groups_to_nodes);
-        if (!group) {
+        // Find the node for this group and see if it can be serviced
+        auto node = get_node_by_group(group, weak_groups_to_nodes);
+        if (!node) {
           // Group was not found, meaning the service is not valid...
           // Remove it from the ready list and continue looking
           it = service_handles_.erase(it);
@@ -319,9 +346,9 @@ public:
           continue;
         }
         // Otherwise it is safe to set and return the any_exec
-        any_exec.service = service;
-        any_exec.callback_group = group;
-        any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+        any_exec.service = std::move(service);
+        any_exec.callback_group = std::move(group);
+        any_exec.node_base = std::move(node);
         service_handles_.erase(it);
         return;
       }
@@ -337,12 +364,20 @@ public:
   {
     auto it = client_handles_.begin();
     while (it != client_handles_.end()) {
-      auto client = get_client_by_handle(*it, weak_groups_to_nodes);
+      rclcpp::ClientBase::SharedPtr client;
+      rclcpp::CallbackGroup::SharedPtr group;
+      if (!find_collected_entity(client_index_, it->get(), client, group)) {
+        // The handle was not added by collect_entities(), search the groups for it instead
+        client = get_client_by_handle(*it, weak_groups_to_nodes);
+        if (client) {
+          group = get_group_by_client(client, weak_groups_to_nodes);
+        }
+      }
       if (client) {
-        // Find the group for this handle and see if it can be serviced
-        auto group = get_group_by_client(client, weak_groups_to_nodes);
-        if (!group) {
-          // Group was not found, meaning the service is not valid...
+        // Find the node for this group and see if it can be serviced
+        auto node = get_node_by_group(group, weak_groups_to_nodes);
+        if (!node) {
+          // Group was not found, meaning the client is not valid...
           // Remove it from the ready list and continue looking
           it = client_handles_.erase(it);
           continue;
@@ -354,13 +389,13 @@ public:
           continue;
         }
         // Otherwise it is safe to set and return the any_exec
-        any_exec.client = client;
-        any_exec.callback_group = group;
-        any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+        any_exec.client = std::move(client);
+        any_exec.callback_group = std::move(group);
+        any_exec.node_base = std::move(node);
         client_handles_.erase(it);
         return;
       }
-      // Else, the service is no longer valid, remove it and continue
+      // Else, the client is no longer valid, remove it and continue
       it = client_handles_.erase(it);
     }
   }
@@ -372,11 +407,19 @@ public:
   {
     auto it = timer_handles_.begin();
     while (it != timer_handles_.end()) {
-      auto timer = get_timer_by_handle(*it, weak_groups_to_nodes);
+      rclcpp::TimerBase::SharedPtr timer;
+      rclcpp::CallbackGroup::SharedPtr group;
+      if (!find_collected_entity(timer_index_, it->get(), timer, group)) {
+        // The handle was not added by collect_entities(), search the groups for it instead
+        timer = get_timer_by_handle(*it, weak_groups_to_nodes);
+        if (timer) {
+          group = get_group_by_timer(timer, weak_groups_to_nodes);
+        }
+      }
       if (timer) {
-        // Find the group for this handle and see if it can be serviced
-        auto group = get_group_by_timer(timer, weak_groups_to_nodes);
-        if (!group) {
+        // Find the node for this group and see if it can be serviced
+        auto node = get_node_by_group(group, weak_groups_to_nodes);
+        if (!node) {
           // Group was not found, meaning the timer is not valid...
           // Remove it from the ready list and continue looking
           it = timer_handles_.erase(it);
@@ -389,13 +432,13 @@ public:
           continue;
         }
         // Otherwise it is safe to set and return the any_exec
-        any_exec.timer = timer;
-        any_exec.callback_group = group;
-        any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+        any_exec.timer = std::move(timer);
+        any_exec.callback_group = std::move(group);
+        any_exec.node_base = std::move(node);
         timer_handles_.erase(it);
         return;
       }
-      // Else, the service is no longer valid, remove it and continue
+      // Else, the timer is no longer valid, remove it and continue
       it = timer_handles_.erase(it);
     }
   }
@@ -410,8 +453,16 @@ public:
       auto waitable = *it;
       if (waitable) {
         // Find the group for this handle and see if it can be serviced
-        auto group = get_group_by_waitable(waitable, weak_groups_to_nodes);
-        if (!group) {
+        rclcpp::CallbackGroup::SharedPtr group;
+        auto found = waitable_index_.find(waitable.get());
+        if (found != waitable_index_.end()) {
+          group = found->second.lock();
+        } else {
+          // The waitable was not added by collect_entities(), search the groups for it instead
+          group = get_group_by_waitable(waitable, weak_groups_to_nodes);
+        }
+        auto node = get_node_by_group(group, weak_groups_to_nodes);
+        if (!node) {
           // Group was not found, meaning the waitable is not valid...
           // Remove it from the ready list and continue looking
           it = waitable_handles_.erase(it);
@@ -424,9 +475,9 @@ public:
           continue;
         }
         // Otherwise it is safe to set and return the any_exec
-        any_exec.waitable = waitable;
-        any_exec.callback_group = group;
-        any_exec.node_base = get_node_by_group(group, weak_groups_to_nodes);
+        any_exec.waitable = std::move(waitable);
+        any_exec.callback_group = std::move(group);
+        any_exec.node_base = std::move(node);
         waitable_handles_.erase(it);
         return;
       }
@@ -504,6 +555,44 @@ private:
   using VectorRebind =
     std::vector<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
 
+  template<typename KeyT, typename T>
+  using UnorderedMapRebind = std::unordered_map<
+    KeyT, T, std::hash<KeyT>, std::equal_to<KeyT>,
+    typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<const KeyT, T>>>;
+
+  /// Entity and callback group which a handle was collected from.
+  template<typename EntityT>
+  struct CollectedEntity
+  {
+    std::weak_ptr<EntityT> entity;
+    rclcpp::CallbackGroup::WeakPtr group;
+  };
+
+  template<typename EntityT>
+  using EntityIndex = UnorderedMapRebind<const void *, CollectedEntity<EntityT>>;
+
+  /// Look up the entity and callback group of a handle added by collect_entities().
+  /**
+   * \return false if the handle is not in the index, true otherwise, even if the entity or
+   *   its callback group have been destroyed since they were collected.
+   */
+  template<typename EntityT>
+  static bool
+  find_collected_entity(
+    const EntityIndex<EntityT> & index,
+    const void * handle,
+    std::shared_ptr<EntityT> & entity,
+    rclcpp::CallbackGroup::SharedPtr & group)
+  {
+    auto found = index.find(handle);
+    if (found == index.end()) {
+      return false;
+    }
+    entity = found->second.entity.lock();
+    group = found->second.group.lock();
+    return true;
+  }
+
   VectorRebind<const rcl_guard_condition_t *> guard_conditions_;
 
   VectorRebind<std::shared_ptr<const rcl_subscription_t>> subscription_handles_;
@@ -512,6 +601,12 @@ private:
   VectorRebind<std::shared_ptr<const rcl_timer_t>> timer_handles_;
   VectorRebind<std::shared_ptr<Waitable>> waitable_handles_;
 
+  EntityIndex<rclcpp::SubscriptionBase> subscription_index_;
+  EntityIndex<rclcpp::ServiceBase> service_index_;
+  EntityIndex<rclcpp::ClientBase> client_index_;
+  EntityIndex<rclcpp::TimerBase> timer_index_;
+  UnorderedMapRebind<const void *, rclcpp::CallbackGroup::WeakPtr> waitable_index_;
+
   std::shared_ptr<VoidAlloc> allocator_;
 };
 
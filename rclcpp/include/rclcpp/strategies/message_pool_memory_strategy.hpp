@@ -60,6 +60,21 @@ public:
     }
   }
 
+  /// Construct the pool with an allocator for its messages.
+  /**
+   * \param[in] allocator allocator of the messages, e.g. a rclcpp::NumaAllocator
+   *   to take them from the NUMA node of the thread executing the subscription
+   */
+  template<typename AllocatorT>
+  explicit MessagePoolMemoryStrategy(const AllocatorT & allocator)
+  : next_array_index_(0)
+  {
+    for (size_t i = 0; i < Size; ++i) {
+      pool_[i].msg_ptr_ = std::allocate_shared<MessageT>(allocator);
+      pool_[i].used = false;
+    }
+  }
+
   /// Borrow a message from the message pool.
   /**
    * Manage the message pool ring buffer.
@@ -80,6 +95,17 @@ public:
     return pool_[current_index].msg_ptr_;
   }
 
+  /// Decline to give away messages, which are always borrowed from the message pool.
+  /**
+   * \return nullptr, so that subscriptions with a unique_ptr callback borrow
+   *   their messages with borrow_message() too, and copy them for the callback.
+   */
+  typename message_memory_strategy::MessageMemoryStrategy<MessageT>::MessageUniquePtr
+  borrow_unique_message() override
+  {
+    return nullptr;
+  }
+
   /// Return a message to the message pool.
   /**
    * Manage metadata in the message pool ring buffer to release the message.
@@ -96,6 +122,12 @@ public:
     throw std::runtime_error("Unrecognized message ptr in return_message.");
   }
 
+  /// Return the size of the messages of the pool.
+  size_t get_memory_usage() const override
+  {
+    return Size * sizeof(MessageT);
+  }
+
 protected:
   struct PoolMember
   {
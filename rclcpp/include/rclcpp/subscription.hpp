@@ -41,6 +41,8 @@
 #include "rclcpp/message_info.hpp"
 #include "rclcpp/message_memory_strategy.hpp"
 #include "rclcpp/node_interfaces/node_base_interface.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialization_codec.hpp"
 #include "rclcpp/subscription_base.hpp"
 #include "rclcpp/subscription_options.hpp"
 #include "rclcpp/subscription_traits.hpp"
@@ -89,7 +91,8 @@ public:
    *
    * \param[in] node_base NodeBaseInterface pointer that is used in part of the setup.
    * \param[in] type_support_handle rosidl type support struct, for the Message type of the topic.
-   * \param[in] topic_name Name of the topic to subscribe to.
+   * \param[in] topic_name Name of the topic to subscribe to, which is changed by
+   *   rclcpp::get_encoded_topic_name() if the options have a serialization codec.
    * \param[in] qos QoS profile for Subcription.
    * \param[in] callback User defined callback to call when a message is received.
    * \param[in] options Options for the subscription.
@@ -111,14 +114,21 @@ public:
   : SubscriptionBase(
       node_base,
       type_support_handle,
-      topic_name,
+      options.serialization_codec ?
+      rclcpp::get_encoded_topic_name(topic_name, *options.serialization_codec) : topic_name,
       options.template to_rcl_subscription_options<CallbackMessageT>(qos),
-      rclcpp::subscription_traits::is_serialized_subscription_argument<CallbackMessageT>::value),
+      // Encoded messages are taken serialized, and decoded in handle_message().
+      rclcpp::subscription_traits::is_serialized_subscription_argument<CallbackMessageT>::value ||
+      options.serialization_codec),
     any_callback_(callback),
     options_(options),
-    message_memory_strategy_(message_memory_strategy)
+    message_memory_strategy_(message_memory_strategy),
+    serialization_(&type_support_handle)
   {
-    if (options.event_callbacks.deadline_callback) {
+    const bool use_intra_process = rclcpp::detail::resolve_use_intra_process(options, *node_base);
+    // With intra-process, the deadline is monitored by the intra-process subscription, for
+    // messages from both paths, as the middleware doesn't see the intra-process messages.
+    if (options.event_callbacks.deadline_callback && !use_intra_process) {
       this->add_event_handler(
         options.event_callbacks.deadline_callback,
         RCL_SUBSCRIPTION_REQUESTED_DEADLINE_MISSED);
@@ -151,7 +161,7 @@ public:
     }
 
     // Setup intra process publishing if requested.
-    if (rclcpp::detail::resolve_use_intra_process(options, *node_base)) {
+    if (use_intra_process) {
       using rclcpp::detail::resolve_intra_process_buffer_type;
 
       // Check if the QoS is compatible with intra-process.
@@ -164,24 +174,24 @@ public:
         throw std::invalid_argument(
                 "intraprocess communication is not allowed with 0 depth qos policy");
       }
-      if (qos_profile.durability != RMW_QOS_POLICY_DURABILITY_VOLATILE) {
+      if (qos_profile.durability != RMW_QOS_POLICY_DURABILITY_VOLATILE &&
+        qos_profile.durability != RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL)
+      {
         throw std::invalid_argument(
-                "intraprocess communication allowed only with volatile durability");
+                "intraprocess communication allowed only with volatile or transient local "
+                "durability");
       }
 
       // First create a SubscriptionIntraProcess which will be given to the intra-process manager.
       auto context = node_base->get_context();
-      using SubscriptionIntraProcessT = rclcpp::experimental::SubscriptionIntraProcess<
-        CallbackMessageT,
-        AllocatorT,
-        typename MessageUniquePtr::deleter_type>;
       auto subscription_intra_process = std::make_shared<SubscriptionIntraProcessT>(
         callback,
         options.get_allocator(),
         context,
         this->get_topic_name(),  // important to get like this, as it has the fully-qualified name
         qos_profile,
-        resolve_intra_process_buffer_type(options.intra_process_buffer_type, callback));
+        resolve_intra_process_buffer_type(options.intra_process_buffer_type, callback),
+        options.event_callbacks.deadline_callback);
       TRACEPOINT(
         rclcpp_subscription_init,
         static_cast<const void *>(get_subscription_handle().get()),
@@ -192,6 +202,9 @@ public:
       auto ipm = context->get_sub_context<IntraProcessManager>();
       uint64_t intra_process_subscription_id = ipm->add_subscription(subscription_intra_process);
       this->setup_intra_process(intra_process_subscription_id, ipm);
+      if (options.event_callbacks.deadline_callback) {
+        deadline_monitor_ = subscription_intra_process;
+      }
     }
 
     if (subscription_topic_statistics != nullptr) {
@@ -256,7 +269,17 @@ public:
     /* The default message memory strategy provides a dynamically allocated message on each call to
      * create_message, though alternative memory strategies that re-use a preallocated message may be
      * used (see rclcpp/strategies/message_pool_memory_strategy.hpp).
+     * For unique_ptr callbacks the message is owned by the callback once taken, so it is taken
+     * directly into a new allocation which handle_message() can release to the callback without
+     * copying it, unless the memory strategy only lends its messages.
      */
+    if (any_callback_.use_take_unique_method()) {
+      auto unique_message = message_memory_strategy_->borrow_unique_message();
+      if (unique_message) {
+        ReleasableMessageDeleter deleter{unique_message.get_deleter(), false};
+        return std::shared_ptr<void>(unique_message.release(), std::move(deleter));
+      }
+    }
     return message_memory_strategy_->borrow_message();
   }
 
@@ -276,15 +299,15 @@ public:
       // we should ignore this copy of the message.
       return;
     }
-    auto typed_message = std::static_pointer_cast<CallbackMessageT>(message);
-    any_callback_.dispatch(typed_message, message_info);
-
-    if (subscription_topic_statistics_) {
-      const auto nanos = std::chrono::time_point_cast<std::chrono::nanoseconds>(
-        std::chrono::system_clock::now());
-      const auto time = rclcpp::Time(nanos.time_since_epoch().count());
-      subscription_topic_statistics_->handle_message(*typed_message, time);
+    if (options_.serialization_codec) {
+      auto encoded_message = std::static_pointer_cast<rclcpp::SerializedMessage>(message);
+      this->handle_encoded_message(
+        *encoded_message,
+        message_info,
+        rclcpp::subscription_traits::is_serialized_subscription_argument<CallbackMessageT>());
+      return;
     }
+    this->dispatch_message(message, message_info);
   }
 
   void
@@ -292,6 +315,8 @@ public:
     void * loaned_message,
     const rclcpp::MessageInfo & message_info) override
   {
+    // Loaned messages are taken by the executor, which handles them right away.
+    this->record_message_arrival(message_info);
     auto typed_message = static_cast<CallbackMessageT *>(loaned_message);
     // message is loaned, so we have to make sure that the deleter does not deallocate the message
     auto sptr = std::shared_ptr<CallbackMessageT>(
@@ -306,6 +331,11 @@ public:
   void
   return_message(std::shared_ptr<void> & message) override
   {
+    if (std::get_deleter<ReleasableMessageDeleter>(message)) {
+      // Not borrowed from the message memory strategy, which allocates a new one each time.
+      message.reset();
+      return;
+    }
     auto typed_message = std::static_pointer_cast<CallbackMessageT>(message);
     message_memory_strategy_->return_message(typed_message);
   }
@@ -326,9 +356,160 @@ public:
     return any_callback_.use_take_shared_method();
   }
 
+  size_t
+  get_memory_usage() const override
+  {
+    return SubscriptionBase::get_memory_usage() + sizeof(*this) - sizeof(SubscriptionBase) +
+           message_memory_strategy_->get_memory_usage() +
+           serialized_message_pool_.get_memory_usage();
+  }
+
+  /// Set the function used to get the key of a message for ordering callbacks.
+  /**
+   * If this subscription is in a callback group of type
+   * rclcpp::CallbackGroupType::KeyOrdered, its callback is never run at the
+   * same time for two messages with the same key, and messages with the same
+   * key are given to the callback in the order they were taken.
+   * Keys are shared by all subscriptions in the callback group, so messages
+   * with the same key from different subscriptions are ordered too.
+   * Messages delivered intra-process are not ordered.
+   *
+   * This should be set before the subscription is added to an executor.
+   *
+   * \param[in] key_function function which returns the key of a message, or
+   *   nullptr to use a key which is unique to this subscription, the default.
+   */
+  void
+  set_ordering_key_function(std::function<std::size_t(const CallbackMessageT &)> key_function)
+  {
+    if (!key_function) {
+      ordering_key_function_ = nullptr;
+      return;
+    }
+    ordering_key_function_ =
+      [key_function = std::move(key_function)](const void * message) -> std::size_t {
+        return key_function(*static_cast<const CallbackMessageT *>(message));
+      };
+  }
+
 private:
   RCLCPP_DISABLE_COPY(Subscription)
 
+  using SubscriptionIntraProcessT = rclcpp::experimental::SubscriptionIntraProcess<
+    CallbackMessageT,
+    AllocatorT,
+    typename MessageUniquePtr::deleter_type>;
+
+  /// Restart the intra-process deadline period when the middleware received a message.
+  /**
+   * The time comes from the message info, as the message may be executed
+   * long after it was taken, or else it is the time when it is taken.
+   */
+  void
+  record_message_arrival(const rclcpp::MessageInfo & message_info) override
+  {
+    auto deadline_monitor = deadline_monitor_.lock();
+    if (!deadline_monitor) {
+      return;
+    }
+    const auto & rmw_message_info = message_info.get_rmw_message_info();
+    // The source timestamp is of the publisher's host, whose clock may differ.
+    rmw_time_point_value_t timestamp = rmw_message_info.received_timestamp;
+    if (0 == timestamp) {
+      timestamp = rmw_message_info.source_timestamp;
+    }
+    auto arrival_time = std::chrono::steady_clock::now();
+    if (0 != timestamp) {
+      // The timestamps are of the system clock, unlike the deadline periods.
+      const auto age = std::chrono::system_clock::now().time_since_epoch() -
+        std::chrono::nanoseconds(timestamp);
+      if (age > std::chrono::nanoseconds::zero()) {
+        arrival_time -= std::chrono::duration_cast<std::chrono::steady_clock::duration>(age);
+      }
+    }
+    deadline_monitor->record_message_time(arrival_time);
+  }
+
+  /// Deleter of messages taken for unique_ptr callbacks, which does nothing once released.
+  struct ReleasableMessageDeleter
+  {
+    void
+    operator()(CallbackMessageT * message)
+    {
+      if (!released) {
+        deleter(message);
+      }
+    }
+
+    MessageDeleter deleter;
+    bool released;
+  };
+
+  /// Give a taken message to the callback, along with its topic statistics.
+  void
+  dispatch_message(std::shared_ptr<void> & message, const rclcpp::MessageInfo & message_info)
+  {
+    auto releasable_deleter = std::get_deleter<ReleasableMessageDeleter>(message);
+    if (releasable_deleter && message.use_count() == 1) {
+      // Give the ownership of the message to the callback, after which it must not be used.
+      auto typed_message = static_cast<CallbackMessageT *>(message.get());
+      handle_topic_statistics(*typed_message);
+      releasable_deleter->released = true;
+      any_callback_.dispatch(
+        MessageUniquePtr(typed_message, releasable_deleter->deleter), message_info);
+      return;
+    }
+    auto typed_message = std::static_pointer_cast<CallbackMessageT>(message);
+    any_callback_.dispatch(typed_message, message_info);
+    handle_topic_statistics(*typed_message);
+  }
+
+  /// Decode a message for a callback taking serialized messages, and dispatch it.
+  void
+  handle_encoded_message(
+    const rclcpp::SerializedMessage & encoded_message,
+    const rclcpp::MessageInfo & message_info,
+    std::true_type /* is_serialized_subscription_argument */)
+  {
+    // Not returned, as the callback may keep it.
+    std::shared_ptr<void> message = create_serialized_message();
+    rclcpp::decode_serialized_message(
+      *options_.serialization_codec,
+      encoded_message.get_rcl_serialized_message(),
+      *std::static_pointer_cast<rclcpp::SerializedMessage>(message));
+    this->dispatch_message(message, message_info);
+  }
+
+  /// Decode and deserialize a message, and dispatch it.
+  void
+  handle_encoded_message(
+    const rclcpp::SerializedMessage & encoded_message,
+    const rclcpp::MessageInfo & message_info,
+    std::false_type /* is_serialized_subscription_argument */)
+  {
+    auto serialized_message = serialized_message_pool_.acquire();
+    rclcpp::decode_serialized_message(
+      *options_.serialization_codec,
+      encoded_message.get_rcl_serialized_message(),
+      *serialized_message);
+    std::shared_ptr<void> message = create_message();
+    serialization_.deserialize_message(serialized_message.get(), message.get());
+    serialized_message_pool_.release(std::move(serialized_message));
+    this->dispatch_message(message, message_info);
+    this->return_message(message);
+  }
+
+  void
+  handle_topic_statistics(const CallbackMessageT & message)
+  {
+    if (subscription_topic_statistics_) {
+      const auto nanos = std::chrono::time_point_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now());
+      const auto time = rclcpp::Time(nanos.time_since_epoch().count());
+      subscription_topic_statistics_->handle_message(message, time);
+    }
+  }
+
   AnySubscriptionCallback<CallbackMessageT, AllocatorT> any_callback_;
   /// Copy of original options passed during construction.
   /**
@@ -340,6 +521,12 @@ private:
     message_memory_strategy_;
   /// Component which computes and publishes topic statistics for this subscriber
   SubscriptionTopicStatisticsSharedPtr subscription_topic_statistics_{nullptr};
+  /// Used to deserialize messages decoded with the serialization codec of the options.
+  const rclcpp::SerializationBase serialization_;
+  /// Buffers of the decoded messages, kept between messages.
+  rclcpp::SerializedMessagePool serialized_message_pool_;
+  /// Intra-process subscription monitoring the deadline, if there is a deadline callback.
+  std::weak_ptr<SubscriptionIntraProcessT> deadline_monitor_;
 };
 
 }  // namespace rclcpp
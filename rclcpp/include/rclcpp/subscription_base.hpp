@@ -16,6 +16,8 @@
 #define RCLCPP__SUBSCRIPTION_BASE_HPP_
 
 #include <atomic>
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -227,6 +229,19 @@ public:
   bool
   can_loan_messages() const;
 
+  /// Return the key used to order the given message in a key ordered callback group.
+  /**
+   * \sa rclcpp::CallbackGroupType::KeyOrdered
+   * \sa rclcpp::Subscription::set_ordering_key_function()
+   *
+   * \param[in] message type erased message, as created by create_message()
+   * \return the key returned by the ordering key function, or if there is
+   *   none, a key which is unique to this subscription.
+   */
+  RCLCPP_PUBLIC
+  std::size_t
+  get_ordering_key(const void * message) const;
+
   using IntraProcessManagerWeakPtr =
     std::weak_ptr<rclcpp::experimental::IntraProcessManager>;
 
@@ -246,6 +261,18 @@ public:
   rclcpp::Waitable::SharedPtr
   get_intra_process_waitable() const;
 
+  /// Return the approximate number of bytes of memory retained by this subscription.
+  /**
+   * This includes the subscription itself, its message pools, and the buffer
+   * of its intra-process waitable, if any.
+   * Memory allocated by the middleware is not included.
+   * See rclcpp::get_memory_usage().
+   */
+  RCLCPP_PUBLIC
+  virtual
+  size_t
+  get_memory_usage() const;
+
   /// Exchange state of whether or not a part of the subscription is used by a wait set.
   /**
    * Used to ensure parts of the subscription are not used with multiple wait
@@ -287,6 +314,13 @@ protected:
   bool
   matches_any_intra_process_publishers(const rmw_gid_t * sender_gid) const;
 
+  /// Called when a message is taken from the middleware, before it is handled.
+  /** \param[in] message_info Metadata of the taken message. */
+  RCLCPP_PUBLIC
+  virtual
+  void
+  record_message_arrival(const rclcpp::MessageInfo & message_info);
+
   rclcpp::node_interfaces::NodeBaseInterface * const node_base_;
 
   std::shared_ptr<rcl_node_t> node_handle_;
@@ -299,6 +333,8 @@ protected:
   IntraProcessManagerWeakPtr weak_ipm_;
   uint64_t intra_process_subscription_id_;
 
+  std::function<std::size_t(const void *)> ordering_key_function_;
+
 private:
   RCLCPP_DISABLE_COPY(SubscriptionBase)
 
@@ -27,6 +27,7 @@
 #include "rclcpp/qos.hpp"
 #include "rclcpp/qos_event.hpp"
 #include "rclcpp/qos_overriding_options.hpp"
+#include "rclcpp/serialization_codec.hpp"
 #include "rclcpp/topic_statistics_state.hpp"
 #include "rclcpp/visibility_control.hpp"
 
@@ -75,6 +76,12 @@ struct SubscriptionOptionsBase
   TopicStatisticsOptions topic_stats_options;
 
   QosOverridingOptions qos_overriding_options;
+
+  /// Optional codec of the serialized messages, which must be the one of the publishers.
+  /**
+   * Messages are then received on the topic named by rclcpp::get_encoded_topic_name().
+   */
+  std::shared_ptr<rclcpp::SerializationCodec> serialization_codec = nullptr;
 };
 
 /// Structure containing optional configuration for Subscriptions.
@@ -91,6 +91,16 @@ public:
   void
   reset();
 
+  /// Consume the timer signal without calling the callback function.
+  /**
+   * The timer is rearmed for its next period as if the callback had been called.
+   *
+   * \throws std::runtime_error if it failed to notify timer that callback was skipped
+   */
+  RCLCPP_PUBLIC
+  void
+  skip_callback();
+
   /// Call the callback function when the timer signal is emitted.
   RCLCPP_PUBLIC
   virtual void
@@ -137,6 +147,12 @@ public:
   bool
   exchange_in_use_by_wait_set_state(bool in_use_state);
 
+  /// Return the approximate number of bytes of memory retained by this timer.
+  RCLCPP_PUBLIC
+  virtual
+  size_t
+  get_memory_usage() const;
+
 protected:
   Clock::SharedPtr clock_;
   std::shared_ptr<rcl_timer_t> timer_handle_;
@@ -191,6 +207,12 @@ public:
     cancel();
   }
 
+  size_t
+  get_memory_usage() const override
+  {
+    return sizeof(*this);
+  }
+
   /**
    * \sa rclcpp::TimerBase::execute_callback
    * \throws std::runtime_error if it failed to notify timer that callback occurred
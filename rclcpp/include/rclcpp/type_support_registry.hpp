@@ -0,0 +1,101 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__TYPE_SUPPORT_REGISTRY_HPP_
+#define RCLCPP__TYPE_SUPPORT_REGISTRY_HPP_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "rcpputils/shared_library.hpp"
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
+#include "rclcpp/macros.hpp"
+#include "rclcpp/visibility_control.hpp"
+
+namespace rclcpp
+{
+
+/// Cache of the type supports of messages, loaded by type name.
+/**
+ * Type supports are found in the typesupport library of the package of the
+ * type, e.g. `libtest_msgs__rosidl_typesupport_cpp.so` for the type
+ * `test_msgs/msg/BasicTypes` and the `rosidl_typesupport_cpp` identifier,
+ * which is searched for in the library search path of the system.
+ * Each library is opened once, when a type of its package is first asked for,
+ * and kept open as long as the registry, so that the handles stay valid.
+ * Later lookups only cost a map lookup.
+ *
+ * The registry of the process, get_global_type_support_registry(), should be
+ * used so that libraries are shared, e.g. by the serializations and the
+ * subscriptions of bridges handling many types.
+ *
+ * This class is thread-safe.
+ */
+class TypeSupportRegistry
+{
+public:
+  RCLCPP_SMART_PTR_DEFINITIONS_NOT_COPYABLE(TypeSupportRegistry)
+
+  RCLCPP_PUBLIC
+  TypeSupportRegistry();
+
+  RCLCPP_PUBLIC
+  virtual ~TypeSupportRegistry();
+
+  /// Get the type support of a message type, loading it if needed.
+  /**
+   * \param[in] type name of the type, e.g. `test_msgs/msg/BasicTypes`, or
+   *   `test_msgs/BasicTypes` for a type in the `msg` directory
+   * \param[in] typesupport_identifier identifier of the type support, e.g.
+   *   `rosidl_typesupport_cpp` or `rosidl_typesupport_introspection_cpp`
+   * \return the type support, which is valid as long as the registry is
+   * \throws std::runtime_error if the type name is not valid, or if the
+   *   library or the type support cannot be found
+   */
+  RCLCPP_PUBLIC
+  const rosidl_message_type_support_t *
+  get_message_type_support(
+    const std::string & type,
+    const std::string & typesupport_identifier = "rosidl_typesupport_cpp");
+
+  /// Return the number of typesupport libraries opened by the registry.
+  RCLCPP_PUBLIC
+  size_t
+  get_library_count() const;
+
+private:
+  using Key = std::pair<std::string, std::string>;
+
+  std::shared_ptr<rcpputils::SharedLibrary>
+  get_library(const std::string & package_name, const std::string & typesupport_identifier);
+
+  mutable std::mutex mutex_;
+  /// Libraries, by package name and typesupport identifier.
+  std::map<Key, std::shared_ptr<rcpputils::SharedLibrary>> libraries_;
+  /// Type supports, by type name and typesupport identifier.
+  std::map<Key, const rosidl_message_type_support_t *> message_type_supports_;
+};
+
+/// Return the type support registry shared by the whole process.
+RCLCPP_PUBLIC
+TypeSupportRegistry::SharedPtr
+get_global_type_support_registry();
+
+}  // namespace rclcpp
+
+#endif  // RCLCPP__TYPE_SUPPORT_REGISTRY_HPP_
@@ -23,6 +23,7 @@
 #include "rclcpp/macros.hpp"
 #include "rclcpp/visibility_control.hpp"
 #include "rclcpp/wait_set_policies/dynamic_storage.hpp"
+#include "rclcpp/wait_set_policies/lock_free_synchronization.hpp"
 #include "rclcpp/wait_set_policies/sequential_synchronization.hpp"
 #include "rclcpp/wait_set_policies/static_storage.hpp"
 #include "rclcpp/wait_set_policies/thread_safe_synchronization.hpp"
@@ -101,6 +102,21 @@ using ThreadSafeWaitSet = rclcpp::WaitSetTemplate<
   rclcpp::wait_set_policies::DynamicStorage
 >;
 
+/// Like ThreadSafeWaitSet, but adding and removing items never blocks.
+/**
+ * Changes made from any thread are staged without locking and are applied by
+ * the thread calling wait(), the next time it waits.
+ * Therefore wait() must only be called from one thread at a time, and errors
+ * found while applying a change are logged instead of thrown.
+ *
+ * \sa rclcpp::wait_set_policies::LockFreeSynchronization for details
+ * \sa rclcpp::WaitSetTemplate for API documentation
+ */
+using LockFreeWaitSet = rclcpp::WaitSetTemplate<
+  rclcpp::wait_set_policies::LockFreeSynchronization,
+  rclcpp::wait_set_policies::DynamicStorage
+>;
+
 }  // namespace rclcpp
 
 #endif  // RCLCPP__WAIT_SET_HPP_
@@ -0,0 +1,123 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__WAIT_SET_POLICIES__DETAIL__STAGED_OPERATION_QUEUE_HPP_
+#define RCLCPP__WAIT_SET_POLICIES__DETAIL__STAGED_OPERATION_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/macros.hpp"
+
+namespace rclcpp
+{
+namespace wait_set_policies
+{
+namespace detail
+{
+
+/// Lock-free queue of operations, pushed by any thread and taken by a single thread.
+/**
+ * Producers push onto an intrusive singly linked list with a compare and
+ * swap on its head, so they never block each other or the consumer.
+ * The consumer detaches the whole list with a single exchange and reverses
+ * it, so operations are taken in the order in which they were pushed.
+ *
+ * Only one thread may call take_all() at a time.
+ */
+class StagedOperationQueue
+{
+public:
+  RCLCPP_DISABLE_COPY(StagedOperationQueue)
+
+  using Operation = std::function<void()>;
+
+  StagedOperationQueue() noexcept
+  : head_(nullptr)
+  {}
+
+  ~StagedOperationQueue()
+  {
+    Node * node = head_.exchange(nullptr, std::memory_order_acquire);
+    while (nullptr != node) {
+      Node * next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  /// Stage an operation, this is safe to call from any thread.
+  void
+  push(Operation && operation)
+  {
+    Node * node = new Node{std::move(operation), head_.load(std::memory_order_relaxed)};
+    while (!head_.compare_exchange_weak(
+        node->next, node, std::memory_order_release, std::memory_order_relaxed))
+    {
+      // node->next was updated with the current head, try again.
+    }
+  }
+
+  /// Return true if there are no staged operations.
+  bool
+  empty() const noexcept
+  {
+    return nullptr == head_.load(std::memory_order_acquire);
+  }
+
+  /// Move all staged operations into the given vector, oldest first.
+  /**
+   * \return the number of operations which were taken.
+   */
+  size_t
+  take_all(std::vector<Operation> & operations)
+  {
+    Node * node = head_.exchange(nullptr, std::memory_order_acquire);
+    // Reverse the detached list, which is newest first.
+    Node * reversed = nullptr;
+    while (nullptr != node) {
+      Node * next = node->next;
+      node->next = reversed;
+      reversed = node;
+      node = next;
+    }
+    size_t count = 0;
+    while (nullptr != reversed) {
+      Node * next = reversed->next;
+      operations.push_back(std::move(reversed->operation));
+      delete reversed;
+      reversed = next;
+      ++count;
+    }
+    return count;
+  }
+
+private:
+  struct Node
+  {
+    Operation operation;
+    Node * next;
+  };
+
+  std::atomic<Node *> head_;
+};
+
+}  // namespace detail
+}  // namespace wait_set_policies
+}  // namespace rclcpp
+
+#endif  // RCLCPP__WAIT_SET_POLICIES__DETAIL__STAGED_OPERATION_QUEUE_HPP_
@@ -18,6 +18,7 @@
 #include <memory>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "rcl/wait.h"
 
@@ -154,6 +155,10 @@ protected:
    *   - resizing the wait set if needed,
    *   - clearing the wait set if not already done by resizing, and
    *   - re-adding the entities.
+   *
+   * If the set of entities has not changed since the last full rebuild, the
+   * wait set is instead re-armed from the rcl handles recorded by that
+   * rebuild, see storage_rearm_rcl_wait_set().
    */
   template<
     class SubscriptionsIterable,
@@ -175,6 +180,20 @@ protected:
     const WaitablesIterable & waitables
   )
   {
+    if (!needs_resize_ && !needs_rebuild_) {
+      this->storage_rearm_rcl_wait_set();
+      return;
+    }
+    // Forget the recorded handles until this rebuild completes, so that an
+    // exception part way through does not leave a partial record behind.
+    needs_rebuild_ = true;
+    rearm_subscriptions_.clear();
+    rearm_guard_conditions_.clear();
+    rearm_timers_.clear();
+    rearm_clients_.clear();
+    rearm_services_.clear();
+    rearm_waitables_.clear();
+
     bool was_resized = false;
     // Resize the wait set, but only if it needs to be.
     if (needs_resize_) {
@@ -257,13 +276,13 @@ protected:
         needs_pruning_ = true;
         continue;
       }
-      rcl_ret_t ret = rcl_wait_set_add_subscription(
-        &rcl_wait_set_,
-        subscription_ptr_pair.second->get_subscription_handle().get(),
-        nullptr);
+      const rcl_subscription_t * rcl_subscription =
+        subscription_ptr_pair.second->get_subscription_handle().get();
+      rcl_ret_t ret = rcl_wait_set_add_subscription(&rcl_wait_set_, rcl_subscription, nullptr);
       if (RCL_RET_OK != ret) {
         rclcpp::exceptions::throw_from_rcl_error(ret);
       }
+      rearm_subscriptions_.push_back(rcl_subscription);
     }
 
     // Setup common code to add guard_conditions.
@@ -283,13 +302,14 @@ protected:
             needs_pruning_ = true;
             continue;
           }
+          const rcl_guard_condition_t * rcl_guard_condition =
+            &guard_condition_ptr_pair.second->get_rcl_guard_condition();
           rcl_ret_t ret = rcl_wait_set_add_guard_condition(
-            &rcl_wait_set_,
-            &guard_condition_ptr_pair.second->get_rcl_guard_condition(),
-            nullptr);
+            &rcl_wait_set_, rcl_guard_condition, nullptr);
           if (RCL_RET_OK != ret) {
             rclcpp::exceptions::throw_from_rcl_error(ret);
           }
+          rearm_guard_conditions_.push_back(rcl_guard_condition);
         }
       };
 
@@ -313,13 +333,12 @@ protected:
         needs_pruning_ = true;
         continue;
       }
-      rcl_ret_t ret = rcl_wait_set_add_timer(
-        &rcl_wait_set_,
-        timer_ptr_pair.second->get_timer_handle().get(),
-        nullptr);
+      const rcl_timer_t * rcl_timer = timer_ptr_pair.second->get_timer_handle().get();
+      rcl_ret_t ret = rcl_wait_set_add_timer(&rcl_wait_set_, rcl_timer, nullptr);
       if (RCL_RET_OK != ret) {
         rclcpp::exceptions::throw_from_rcl_error(ret);
       }
+      rearm_timers_.push_back(rcl_timer);
     }
 
     // Add clients.
@@ -336,13 +355,12 @@ protected:
         needs_pruning_ = true;
         continue;
       }
-      rcl_ret_t ret = rcl_wait_set_add_client(
-        &rcl_wait_set_,
-        client_ptr_pair.second->get_client_handle().get(),
-        nullptr);
+      const rcl_client_t * rcl_client = client_ptr_pair.second->get_client_handle().get();
+      rcl_ret_t ret = rcl_wait_set_add_client(&rcl_wait_set_, rcl_client, nullptr);
       if (RCL_RET_OK != ret) {
         rclcpp::exceptions::throw_from_rcl_error(ret);
       }
+      rearm_clients_.push_back(rcl_client);
     }
 
     // Add services.
@@ -359,13 +377,12 @@ protected:
         needs_pruning_ = true;
         continue;
       }
-      rcl_ret_t ret = rcl_wait_set_add_service(
-        &rcl_wait_set_,
-        service_ptr_pair.second->get_service_handle().get(),
-        nullptr);
+      const rcl_service_t * rcl_service = service_ptr_pair.second->get_service_handle().get();
+      rcl_ret_t ret = rcl_wait_set_add_service(&rcl_wait_set_, rcl_service, nullptr);
       if (RCL_RET_OK != ret) {
         rclcpp::exceptions::throw_from_rcl_error(ret);
       }
+      rearm_services_.push_back(rcl_service);
     }
 
     // Add waitables.
@@ -387,6 +404,50 @@ protected:
       if (!successful) {
         throw std::runtime_error("waitable unexpectedly failed to be added to wait set");
       }
+      rearm_waitables_.push_back(&waitable);
+    }
+
+    needs_rebuild_ = false;
+  }
+
+  /// Re-arm the wait set using the rcl handles recorded by the last full rebuild.
+  /**
+   * rcl_wait() sets the entries of entities which are not ready to nullptr,
+   * so the wait set still has to be cleared and refilled before each wait.
+   * This avoids redoing the resize accounting, locking weak pointers, and
+   * copying the shared rcl handles of every entity to do so.
+   *
+   * Waitables are still asked to add themselves, as they own their indexes
+   * into the wait set.
+   *
+   * The caller must ensure the recorded entities are still alive, which is
+   * always the case with strong ownership, and otherwise must call
+   * storage_flag_for_rebuild() when any of them has expired.
+   */
+  void
+  storage_rearm_rcl_wait_set()
+  {
+    rcl_ret_t ret = rcl_wait_set_clear(&rcl_wait_set_);
+    if (RCL_RET_OK != ret) {
+      rclcpp::exceptions::throw_from_rcl_error(ret);
+    }
+    auto add_all = [this](const auto & handles, auto add_function) {
+        for (const auto handle : handles) {
+          rcl_ret_t add_ret = add_function(&rcl_wait_set_, handle, nullptr);
+          if (RCL_RET_OK != add_ret) {
+            rclcpp::exceptions::throw_from_rcl_error(add_ret);
+          }
+        }
+      };
+    add_all(rearm_subscriptions_, rcl_wait_set_add_subscription);
+    add_all(rearm_guard_conditions_, rcl_wait_set_add_guard_condition);
+    add_all(rearm_timers_, rcl_wait_set_add_timer);
+    add_all(rearm_clients_, rcl_wait_set_add_client);
+    add_all(rearm_services_, rcl_wait_set_add_service);
+    for (rclcpp::Waitable * waitable : rearm_waitables_) {
+      if (!waitable->add_to_wait_set(&rcl_wait_set_)) {
+        throw std::runtime_error("waitable unexpectedly failed to be added to wait set");
+      }
     }
   }
 
@@ -408,11 +469,26 @@ protected:
     needs_resize_ = true;
   }
 
+  void
+  storage_flag_for_rebuild()
+  {
+    needs_rebuild_ = true;
+  }
+
   rcl_wait_set_t rcl_wait_set_;
   rclcpp::Context::SharedPtr context_;
 
   bool needs_pruning_ = false;
   bool needs_resize_ = false;
+  bool needs_rebuild_ = true;
+
+  // rcl handles added by the last full rebuild, used to re-arm the wait set.
+  std::vector<const rcl_subscription_t *> rearm_subscriptions_;
+  std::vector<const rcl_guard_condition_t *> rearm_guard_conditions_;
+  std::vector<const rcl_timer_t *> rearm_timers_;
+  std::vector<const rcl_client_t *> rearm_clients_;
+  std::vector<const rcl_service_t *> rearm_services_;
+  std::vector<rclcpp::Waitable *> rearm_waitables_;
 };
 
 }  // namespace detail
@@ -204,6 +204,11 @@ public:
   void
   storage_rebuild_rcl_wait_set(const ArrayOfExtraGuardConditions & extra_guard_conditions)
   {
+    // The handles recorded by the last rebuild can only be reused if none of
+    // the entities they belong to have been deleted since.
+    if (!needs_rebuild_ && this->storage_has_expired_entities()) {
+      this->storage_flag_for_rebuild();
+    }
     this->storage_rebuild_rcl_wait_set_with_sets(
       subscriptions_,
       guard_conditions_,
@@ -215,6 +220,26 @@ public:
     );
   }
 
+  bool
+  storage_has_expired_entities() const noexcept
+  {
+    auto any_expired = [](const auto & weak_ptrs) {
+        for (const auto & weak_ptr : weak_ptrs) {
+          if (weak_ptr.expired()) {
+            return true;
+          }
+        }
+        return false;
+      };
+    return
+      any_expired(subscriptions_) ||
+      any_expired(guard_conditions_) ||
+      any_expired(timers_) ||
+      any_expired(clients_) ||
+      any_expired(services_) ||
+      any_expired(waitables_);
+  }
+
   template<class EntityT, class SequenceOfEntitiesT>
   static
   bool
@@ -389,6 +414,7 @@ public:
     clients_.erase(std::remove_if(clients_.begin(), clients_.end(), p), clients_.end());
     services_.erase(std::remove_if(services_.begin(), services_.end(), p), services_.end());
     waitables_.erase(std::remove_if(waitables_.begin(), waitables_.end(), p), waitables_.end());
+    this->storage_flag_for_rebuild();
   }
 
   void
@@ -407,6 +433,7 @@ public:
         }
       };
     // Lock all the weak pointers and hold them until released.
+    lock_all(subscriptions_, shared_subscriptions_);
     lock_all(guard_conditions_, shared_guard_conditions_);
     lock_all(timers_, shared_timers_);
     lock_all(clients_, shared_clients_);
@@ -438,6 +465,7 @@ public:
           shared_ptr.reset();
         }
       };
+    reset_all(shared_subscriptions_);
     reset_all(shared_guard_conditions_);
     reset_all(shared_timers_);
     reset_all(shared_clients_);
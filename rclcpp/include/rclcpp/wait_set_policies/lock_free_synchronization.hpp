@@ -0,0 +1,416 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__WAIT_SET_POLICIES__LOCK_FREE_SYNCHRONIZATION_HPP_
+#define RCLCPP__WAIT_SET_POLICIES__LOCK_FREE_SYNCHRONIZATION_HPP_
+
+#include <array>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/client.hpp"
+#include "rclcpp/exceptions.hpp"
+#include "rclcpp/guard_condition.hpp"
+#include "rclcpp/logging.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp/scope_exit.hpp"
+#include "rclcpp/service.hpp"
+#include "rclcpp/subscription_base.hpp"
+#include "rclcpp/subscription_wait_set_mask.hpp"
+#include "rclcpp/timer.hpp"
+#include "rclcpp/visibility_control.hpp"
+#include "rclcpp/wait_result.hpp"
+#include "rclcpp/wait_result_kind.hpp"
+#include "rclcpp/wait_set_policies/detail/staged_operation_queue.hpp"
+#include "rclcpp/wait_set_policies/detail/synchronization_policy_common.hpp"
+#include "rclcpp/waitable.hpp"
+
+namespace rclcpp
+{
+namespace wait_set_policies
+{
+
+/// WaitSet policy that stages changes from any thread and applies them when waiting.
+/**
+ * Unlike ThreadSafeSynchronization, adding or removing entities never blocks,
+ * not even on a thread which is currently waiting or holding a WaitResult.
+ * Instead each change is pushed onto a lock-free queue and a guard condition
+ * is triggered to interrupt any ongoing wait.
+ * The thread calling wait() applies all staged changes, in the order they
+ * were made, before it (re)builds the rcl wait set.
+ *
+ * This has some consequences which should be considered:
+ *
+ *   - the entity sets are only ever modified by the thread calling wait(),
+ *     so that must be a single thread at a time, but in exchange a WaitResult
+ *     can be introspected without taking any lock,
+ *   - a change takes effect on the next call to wait(), not when the add or
+ *     remove method returns, and
+ *   - errors found while applying a change, e.g. adding an entity twice, can
+ *     no longer be thrown to the thread which made the change, so they are
+ *     logged instead, and the remaining changes are still applied.
+ *
+ * Entities added this way are kept alive by the wait set until the end of
+ * the wait which applied the change, so that they cannot be deleted while
+ * being waited on, or until the WaitResult is destroyed if it is ready.
+ */
+class LockFreeSynchronization : public detail::SynchronizationPolicyCommon
+{
+protected:
+  explicit LockFreeSynchronization(rclcpp::Context::SharedPtr context)
+  : extra_guard_conditions_{{std::make_shared<rclcpp::GuardCondition>(context)}}
+  {}
+  ~LockFreeSynchronization() = default;
+
+  /// Return any "extra" guard conditions needed to implement the synchronization policy.
+  /**
+   * This policy has one guard condition which is used to interrupt the wait
+   * set when a change is staged.
+   */
+  const std::array<std::shared_ptr<rclcpp::GuardCondition>, 1> &
+  get_extra_guard_conditions()
+  {
+    return extra_guard_conditions_;
+  }
+
+  /// Interrupt any waiting wait set.
+  void
+  interrupt_waiting_wait_set()
+  {
+    extra_guard_conditions_[0]->trigger();
+  }
+
+  /// Stage an operation and wake up the waiting thread to apply it.
+  void
+  stage_operation(detail::StagedOperationQueue::Operation && operation)
+  {
+    staged_operations_.push(std::move(operation));
+    this->interrupt_waiting_wait_set();
+  }
+
+  /// Apply all staged operations, logging rather than throwing any errors.
+  /**
+   * The applied operations, and any entities they hold, are kept until
+   * sync_wait() returns, or handed over to the ready WaitResult, so that newly
+   * added entities outlive the wait.
+   */
+  void
+  apply_staged_operations()
+  {
+    if (staged_operations_.empty()) {
+      return;
+    }
+    const size_t first_operation = applied_operations_.size();
+    staged_operations_.take_all(applied_operations_);
+    for (size_t index = first_operation; index < applied_operations_.size(); ++index) {
+      try {
+        applied_operations_[index]();
+      } catch (const std::exception & exception) {
+        RCLCPP_ERROR(
+          rclcpp::get_logger("rclcpp"),
+          "failed to apply staged change to wait set: %s", exception.what());
+      }
+    }
+  }
+
+  /// Stage add subscription.
+  void
+  sync_add_subscription(
+    std::shared_ptr<rclcpp::SubscriptionBase> && subscription,
+    const rclcpp::SubscriptionWaitSetMask & mask,
+    std::function<
+      void(std::shared_ptr<rclcpp::SubscriptionBase>&&, const rclcpp::SubscriptionWaitSetMask &)
+    > add_subscription_function)
+  {
+    this->stage_operation(
+      [subscription = std::move(subscription), mask,
+      add_subscription_function = std::move(add_subscription_function)]() {
+        auto local_subscription = subscription;
+        add_subscription_function(std::move(local_subscription), mask);
+      });
+  }
+
+  /// Stage remove subscription.
+  void
+  sync_remove_subscription(
+    std::shared_ptr<rclcpp::SubscriptionBase> && subscription,
+    const rclcpp::SubscriptionWaitSetMask & mask,
+    std::function<
+      void(std::shared_ptr<rclcpp::SubscriptionBase>&&, const rclcpp::SubscriptionWaitSetMask &)
+    > remove_subscription_function)
+  {
+    this->stage_operation(
+      [subscription = std::move(subscription), mask,
+      remove_subscription_function = std::move(remove_subscription_function)]() {
+        auto local_subscription = subscription;
+        remove_subscription_function(std::move(local_subscription), mask);
+      });
+  }
+
+  /// Stage add guard condition.
+  void
+  sync_add_guard_condition(
+    std::shared_ptr<rclcpp::GuardCondition> && guard_condition,
+    std::function<void(std::shared_ptr<rclcpp::GuardCondition>&&)> add_guard_condition_function)
+  {
+    this->stage_operation(
+      [guard_condition = std::move(guard_condition),
+      add_guard_condition_function = std::move(add_guard_condition_function)]() {
+        auto local_guard_condition = guard_condition;
+        add_guard_condition_function(std::move(local_guard_condition));
+      });
+  }
+
+  /// Stage remove guard condition.
+  void
+  sync_remove_guard_condition(
+    std::shared_ptr<rclcpp::GuardCondition> && guard_condition,
+    std::function<void(std::shared_ptr<rclcpp::GuardCondition>&&)> remove_guard_condition_function)
+  {
+    this->stage_operation(
+      [guard_condition = std::move(guard_condition),
+      remove_guard_condition_function = std::move(remove_guard_condition_function)]() {
+        auto local_guard_condition = guard_condition;
+        remove_guard_condition_function(std::move(local_guard_condition));
+      });
+  }
+
+  /// Stage add timer.
+  void
+  sync_add_timer(
+    std::shared_ptr<rclcpp::TimerBase> && timer,
+    std::function<void(std::shared_ptr<rclcpp::TimerBase>&&)> add_timer_function)
+  {
+    this->stage_operation(
+      [timer = std::move(timer),
+      add_timer_function = std::move(add_timer_function)]() {
+        auto local_timer = timer;
+        add_timer_function(std::move(local_timer));
+      });
+  }
+
+  /// Stage remove timer.
+  void
+  sync_remove_timer(
+    std::shared_ptr<rclcpp::TimerBase> && timer,
+    std::function<void(std::shared_ptr<rclcpp::TimerBase>&&)> remove_timer_function)
+  {
+    this->stage_operation(
+      [timer = std::move(timer),
+      remove_timer_function = std::move(remove_timer_function)]() {
+        auto local_timer = timer;
+        remove_timer_function(std::move(local_timer));
+      });
+  }
+
+  /// Stage add client.
+  void
+  sync_add_client(
+    std::shared_ptr<rclcpp::ClientBase> && client,
+    std::function<void(std::shared_ptr<rclcpp::ClientBase>&&)> add_client_function)
+  {
+    this->stage_operation(
+      [client = std::move(client),
+      add_client_function = std::move(add_client_function)]() {
+        auto local_client = client;
+        add_client_function(std::move(local_client));
+      });
+  }
+
+  /// Stage remove client.
+  void
+  sync_remove_client(
+    std::shared_ptr<rclcpp::ClientBase> && client,
+    std::function<void(std::shared_ptr<rclcpp::ClientBase>&&)> remove_client_function)
+  {
+    this->stage_operation(
+      [client = std::move(client),
+      remove_client_function = std::move(remove_client_function)]() {
+        auto local_client = client;
+        remove_client_function(std::move(local_client));
+      });
+  }
+
+  /// Stage add service.
+  void
+  sync_add_service(
+    std::shared_ptr<rclcpp::ServiceBase> && service,
+    std::function<void(std::shared_ptr<rclcpp::ServiceBase>&&)> add_service_function)
+  {
+    this->stage_operation(
+      [service = std::move(service),
+      add_service_function = std::move(add_service_function)]() {
+        auto local_service = service;
+        add_service_function(std::move(local_service));
+      });
+  }
+
+  /// Stage remove service.
+  void
+  sync_remove_service(
+    std::shared_ptr<rclcpp::ServiceBase> && service,
+    std::function<void(std::shared_ptr<rclcpp::ServiceBase>&&)> remove_service_function)
+  {
+    this->stage_operation(
+      [service = std::move(service),
+      remove_service_function = std::move(remove_service_function)]() {
+        auto local_service = service;
+        remove_service_function(std::move(local_service));
+      });
+  }
+
+  /// Stage add waitable.
+  void
+  sync_add_waitable(
+    std::shared_ptr<rclcpp::Waitable> && waitable,
+    std::shared_ptr<void> && associated_entity,
+    std::function<
+      void(std::shared_ptr<rclcpp::Waitable>&&, std::shared_ptr<void>&&)
+    > add_waitable_function)
+  {
+    this->stage_operation(
+      [waitable = std::move(waitable), associated_entity = std::move(associated_entity),
+      add_waitable_function = std::move(add_waitable_function)]() {
+        auto local_waitable = waitable;
+        auto local_associated_entity = associated_entity;
+        add_waitable_function(std::move(local_waitable), std::move(local_associated_entity));
+      });
+  }
+
+  /// Stage remove waitable.
+  void
+  sync_remove_waitable(
+    std::shared_ptr<rclcpp::Waitable> && waitable,
+    std::function<void(std::shared_ptr<rclcpp::Waitable>&&)> remove_waitable_function)
+  {
+    this->stage_operation(
+      [waitable = std::move(waitable),
+      remove_waitable_function = std::move(remove_waitable_function)]() {
+        auto local_waitable = waitable;
+        remove_waitable_function(std::move(local_waitable));
+      });
+  }
+
+  /// Stage pruning of deleted entities.
+  void
+  sync_prune_deleted_entities(std::function<void()> prune_deleted_entities_function)
+  {
+    this->stage_operation(std::move(prune_deleted_entities_function));
+  }
+
+  /// Implements wait, applying any staged changes first.
+  template<class WaitResultT>
+  WaitResultT
+  sync_wait(
+    std::chrono::nanoseconds time_to_wait_ns,
+    std::function<void()> rebuild_rcl_wait_set,
+    std::function<rcl_wait_set_t & ()> get_rcl_wait_set,
+    std::function<WaitResultT(WaitResultKind wait_result_kind)> create_wait_result)
+  {
+    // Assumption: this function assumes that some measure has been taken to
+    // ensure none of the entities being waited on by the wait set are allowed
+    // to go out of scope and therefore be deleted.
+    // See SequentialSynchronization::sync_wait() for details.
+    // Entities added by staged changes are held by apply_staged_operations(),
+    // until the wait returns or sync_wait_result_acquire() takes them.
+    RCLCPP_SCOPE_EXIT({applied_operations_.clear();});
+
+    // Setup looping predicate.
+    auto start = std::chrono::steady_clock::now();
+    std::function<bool()> should_loop = this->create_loop_predicate(time_to_wait_ns, start);
+
+    // Wait until exit condition is met.
+    do {
+      // Only this thread modifies the entity sets, so no lock is needed to
+      // apply the staged changes and then rebuild the rcl wait set.
+      this->apply_staged_operations();
+      rebuild_rcl_wait_set();
+
+      rcl_wait_set_t & rcl_wait_set = get_rcl_wait_set();
+
+      // Calculate how much time there is left to wait, unless blocking indefinitely.
+      auto time_left_to_wait_ns = this->calculate_time_left_to_wait(time_to_wait_ns, start);
+
+      // Then wait for entities to become ready.
+      rcl_ret_t ret = rcl_wait(&rcl_wait_set, time_left_to_wait_ns.count());
+      if (RCL_RET_OK == ret) {
+        // Something has become ready in the wait set, check if it was only
+        // the guard condition used by this class to announce staged changes.
+        const rcl_guard_condition_t * interrupt_guard_condition_ptr =
+          &(extra_guard_conditions_[0]->get_rcl_guard_condition());
+        bool was_interrupted_by_this_class = false;
+        bool any_user_guard_conditions_triggered = false;
+        for (size_t index = 0; index < rcl_wait_set.size_of_guard_conditions; ++index) {
+          const rcl_guard_condition_t * current = rcl_wait_set.guard_conditions[index];
+          if (nullptr != current) {
+            if (current == interrupt_guard_condition_ptr) {
+              was_interrupted_by_this_class = true;
+            } else {
+              any_user_guard_conditions_triggered = true;
+            }
+          }
+        }
+
+        if (!was_interrupted_by_this_class || any_user_guard_conditions_triggered) {
+          // Other entities which are ready will still be ready on the next
+          // wait, but user guard conditions are cleared, so return now.
+          return create_wait_result(WaitResultKind::Ready);
+        }
+        // Only interrupted to apply staged changes, so loop, apply them, and
+        // wait again.
+      } else if (RCL_RET_TIMEOUT == ret) {
+        // The wait set timed out, exit the loop.
+        break;
+      } else if (RCL_RET_WAIT_SET_EMPTY == ret) {
+        // Wait set was empty, return Empty.
+        return create_wait_result(WaitResultKind::Empty);
+      } else {
+        // Some other error case, throw.
+        rclcpp::exceptions::throw_from_rcl_error(ret);
+      }
+    } while (should_loop());
+
+    // Wait did not result in ready items, return timeout.
+    return create_wait_result(WaitResultKind::Timeout);
+  }
+
+  void
+  sync_wait_result_acquire()
+  {
+    // The entity sets are only changed by wait(), but the entities it added are
+    // not in the ownerships it acquired, so they are held until the result is released.
+    wait_result_operations_.swap(applied_operations_);
+  }
+
+  void
+  sync_wait_result_release()
+  {
+    wait_result_operations_.clear();
+  }
+
+protected:
+  std::array<std::shared_ptr<rclcpp::GuardCondition>, 1> extra_guard_conditions_;
+  detail::StagedOperationQueue staged_operations_;
+  std::vector<detail::StagedOperationQueue::Operation> applied_operations_;
+  std::vector<detail::StagedOperationQueue::Operation> wait_result_operations_;
+};
+
+}  // namespace wait_set_policies
+}  // namespace rclcpp
+
+#endif  // RCLCPP__WAIT_SET_POLICIES__LOCK_FREE_SYNCHRONIZATION_HPP_
@@ -203,6 +203,17 @@ public:
   bool
   exchange_in_use_by_wait_set_state(bool in_use_state);
 
+  /// Return the approximate number of bytes of memory retained by this waitable.
+  /**
+   * This is used for memory accounting, see rclcpp::get_memory_usage().
+   * The default implementation returns 0, meaning that the memory of the
+   * waitable is not accounted.
+   */
+  RCLCPP_PUBLIC
+  virtual
+  size_t
+  get_memory_usage() const;
+
 private:
   std::atomic<bool> in_use_by_wait_set_{false};
 };  // class Waitable
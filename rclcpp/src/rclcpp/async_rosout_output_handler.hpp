@@ -0,0 +1,37 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCLCPP__ASYNC_ROSOUT_OUTPUT_HANDLER_HPP_
+#define RCLCPP__ASYNC_ROSOUT_OUTPUT_HANDLER_HPP_
+
+#include <cstdarg>
+
+#include "rcutils/logging.h"
+#include "rcutils/time.h"
+
+#include "rclcpp/visibility_control.hpp"
+
+/// Queue a log record in the rclcpp::AsyncRosoutPublisher of its logger, if any.
+/**
+ * This must be called with the global logging mutex held, which also
+ * protects the registration of the publishers.
+ */
+RCLCPP_LOCAL
+void
+async_rosout_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args);
+
+#endif  // RCLCPP__ASYNC_ROSOUT_OUTPUT_HANDLER_HPP_
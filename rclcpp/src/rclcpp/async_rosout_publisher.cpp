@@ -0,0 +1,255 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/async_rosout_publisher.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rcl/error_handling.h"
+#include "rclcpp/exceptions.hpp"
+#include "rcutils/error_handling.h"
+#include "rcutils/logging_macros.h"
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+
+#include "./async_rosout_output_handler.hpp"
+#include "./logging_mutex.hpp"
+
+using rclcpp::AsyncRosoutPublisher;
+
+namespace
+{
+
+/// Publishers by logger name, protected by the global logging mutex.
+std::unordered_map<std::string, AsyncRosoutPublisher *> &
+get_async_rosout_publishers()
+{
+  static std::unordered_map<std::string, AsyncRosoutPublisher *> publishers;
+  return publishers;
+}
+
+std::string
+format_log_message(const char * format, va_list * args)
+{
+  va_list args_for_size;
+  va_copy(args_for_size, *args);
+  const int size = std::vsnprintf(nullptr, 0, format, args_for_size);
+  va_end(args_for_size);
+  if (size < 0) {
+    return format;
+  }
+  std::vector<char> buffer(static_cast<size_t>(size) + 1);
+  std::vsnprintf(buffer.data(), buffer.size(), format, *args);
+  return std::string(buffer.data(), static_cast<size_t>(size));
+}
+
+void
+set_stamp(builtin_interfaces::msg::Time & stamp, rcutils_time_point_value_t timestamp)
+{
+  stamp.sec = static_cast<int32_t>(RCUTILS_NS_TO_S(timestamp));
+  stamp.nanosec = static_cast<uint32_t>(timestamp % RCUTILS_S_TO_NS(1));
+}
+
+}  // namespace
+
+void
+async_rosout_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  auto & publishers = get_async_rosout_publishers();
+  if (publishers.empty() || !name) {
+    return;
+  }
+  auto it = publishers.find(name);
+  if (it == publishers.end()) {
+    return;
+  }
+
+  rcl_interfaces::msg::Log log;
+  set_stamp(log.stamp, timestamp);
+  log.level = static_cast<uint8_t>(severity);
+  log.name = name;
+  log.msg = format_log_message(format, args);
+  if (location) {
+    log.file = location->file_name;
+    log.function = location->function_name;
+    log.line = static_cast<uint32_t>(location->line_number);
+  }
+  it->second->enqueue(std::move(log));
+}
+
+AsyncRosoutPublisher::AsyncRosoutPublisher(
+  std::shared_ptr<rcl_node_t> node_handle,
+  const rclcpp::QoS & qos,
+  size_t queue_depth)
+: node_handle_(std::move(node_handle)),
+  publisher_(rcl_get_zero_initialized_publisher()),
+  queue_depth_(queue_depth),
+  stopped_(false),
+  unreported_dropped_count_(0)
+{
+  if (!node_handle_) {
+    throw std::invalid_argument("node_handle cannot be nullptr");
+  }
+  if (queue_depth_ == 0) {
+    throw std::invalid_argument("queue_depth cannot be zero");
+  }
+  logger_name_ = rcl_node_get_logger_name(node_handle_.get());
+
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.qos = qos.get_rmw_qos_profile();
+  rcl_ret_t ret = rcl_publisher_init(
+    &publisher_,
+    node_handle_.get(),
+    rosidl_typesupport_cpp::get_message_type_support_handle<rcl_interfaces::msg::Log>(),
+    "/rosout",
+    &publisher_options);
+  if (RCL_RET_OK != ret) {
+    rclcpp::exceptions::throw_from_rcl_error(ret, "failed to create the rosout publisher");
+  }
+
+  thread_ = std::thread(&AsyncRosoutPublisher::run, this);
+
+  std::shared_ptr<std::recursive_mutex> logging_mutex = get_global_logging_mutex();
+  std::lock_guard<std::recursive_mutex> guard(*logging_mutex);
+  if (!get_async_rosout_publishers().emplace(logger_name_, this).second) {
+    // Like rcl does for the rosout publishers of nodes with the same name.
+    RCUTILS_LOG_WARN_NAMED(
+      "rclcpp",
+      "Publisher already registered for logger name '%s'. All logs for that logger name will "
+      "go out over the existing publisher.", logger_name_.c_str());
+  }
+}
+
+AsyncRosoutPublisher::~AsyncRosoutPublisher()
+{
+  {
+    std::shared_ptr<std::recursive_mutex> logging_mutex = get_global_logging_mutex();
+    std::lock_guard<std::recursive_mutex> guard(*logging_mutex);
+    auto & publishers = get_async_rosout_publishers();
+    auto it = publishers.find(logger_name_);
+    if (it != publishers.end() && it->second == this) {
+      publishers.erase(it);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  condition_.notify_all();
+  thread_.join();
+
+  if (rcl_publisher_fini(&publisher_, node_handle_.get()) != RCL_RET_OK) {
+    RCUTILS_LOG_ERROR_NAMED(
+      "rclcpp",
+      "failed to destroy the rosout publisher: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+  }
+}
+
+const std::string &
+AsyncRosoutPublisher::get_logger_name() const
+{
+  return logger_name_;
+}
+
+AsyncRosoutPublisher::Statistics
+AsyncRosoutPublisher::get_statistics() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+void
+AsyncRosoutPublisher::enqueue(rcl_interfaces::msg::Log && log)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() >= queue_depth_) {
+      ++unreported_dropped_count_;
+      ++statistics_.dropped_count;
+      return;
+    }
+    queue_.push_back(std::move(log));
+  }
+  condition_.notify_one();
+}
+
+void
+AsyncRosoutPublisher::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    condition_.wait(lock, [this]() {return stopped_ || !queue_.empty();});
+    if (queue_.empty()) {
+      // Stopped, and all the records are published.
+      return;
+    }
+    std::deque<rcl_interfaces::msg::Log> batch;
+    batch.swap(queue_);
+    const uint64_t dropped_count = unreported_dropped_count_;
+    unreported_dropped_count_ = 0;
+    lock.unlock();
+
+    const size_t batch_size = batch.size();
+    uint64_t published_count = 0;
+    for (const auto & log : batch) {
+      if (publish(log)) {
+        ++published_count;
+      }
+    }
+    // The records were dropped after the ones of the batch were queued.
+    if (dropped_count > 0) {
+      rcl_interfaces::msg::Log warning;
+      rcutils_time_point_value_t now = 0;
+      if (rcutils_system_time_now(&now) != RCUTILS_RET_OK) {
+        rcutils_reset_error();
+      }
+      set_stamp(warning.stamp, now);
+      warning.level = rcl_interfaces::msg::Log::WARN;
+      warning.name = logger_name_;
+      warning.msg = "dropped " + std::to_string(dropped_count) +
+        " log records, the rosout queue of depth " + std::to_string(queue_depth_) + " was full";
+      publish(warning);
+    }
+    batch.clear();
+
+    lock.lock();
+    statistics_.published_count += published_count;
+    statistics_.max_batch_size = std::max(statistics_.max_batch_size, batch_size);
+  }
+}
+
+bool
+AsyncRosoutPublisher::publish(const rcl_interfaces::msg::Log & log)
+{
+  if (rcl_publish(&publisher_, &log, nullptr) != RCL_RET_OK) {
+    // Like rcl, don't log the failure, which could be published on /rosout as well.
+    RCUTILS_SAFE_FWRITE_TO_STDERR("failed to publish log message to rosout: ");
+    RCUTILS_SAFE_FWRITE_TO_STDERR(rcl_get_error_string().str);
+    RCUTILS_SAFE_FWRITE_TO_STDERR("\n");
+    rcl_reset_error();
+    return false;
+  }
+  return true;
+}
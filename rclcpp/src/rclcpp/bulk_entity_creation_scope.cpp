@@ -0,0 +1,44 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/bulk_entity_creation_scope.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#include "rclcpp/logging.hpp"
+#include "rcutils/error_handling.h"
+
+using rclcpp::BulkEntityCreationScope;
+
+BulkEntityCreationScope::BulkEntityCreationScope(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base)
+: node_base_(std::move(node_base))
+{
+  if (!node_base_) {
+    throw std::invalid_argument("node_base cannot be nullptr");
+  }
+  node_base_->defer_notify_guard_condition();
+}
+
+BulkEntityCreationScope::~BulkEntityCreationScope()
+{
+  if (node_base_->resume_notify_guard_condition() != RCL_RET_OK) {
+    RCLCPP_ERROR(
+      rclcpp::get_logger("rclcpp"),
+      "failed to notify wait set after bulk entity creation: %s",
+      rcutils_get_error_string().str);
+    rcutils_reset_error();
+  }
+}
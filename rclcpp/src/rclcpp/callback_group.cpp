@@ -40,6 +40,12 @@ CallbackGroup::type() const
   return type_;
 }
 
+rclcpp::detail::KeyedTaskQueue &
+CallbackGroup::get_keyed_task_queue()
+{
+  return keyed_task_queue_;
+}
+
 std::atomic_bool &
 CallbackGroup::get_associated_with_executor_atomic()
 {
@@ -52,6 +58,12 @@ CallbackGroup::automatically_add_to_executor_with_node() const
   return automatically_add_to_executor_with_node_;
 }
 
+rclcpp::CpuTimeAccount &
+CallbackGroup::get_cpu_time_account()
+{
+  return cpu_time_account_;
+}
+
 void
 CallbackGroup::add_subscription(
   const rclcpp::SubscriptionBase::SharedPtr subscription_ptr)
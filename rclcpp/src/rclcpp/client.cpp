@@ -198,3 +198,9 @@ ClientBase::exchange_in_use_by_wait_set_state(bool in_use_state)
 {
   return in_use_by_wait_set_.exchange(in_use_state);
 }
+
+size_t
+ClientBase::get_memory_usage() const
+{
+  return sizeof(ClientBase);
+}
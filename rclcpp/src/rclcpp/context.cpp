@@ -33,6 +33,7 @@
 
 #include "rmw/impl/cpp/demangle.hpp"
 
+#include "./async_rosout_output_handler.hpp"
 #include "./logging_mutex.hpp"
 
 using rclcpp::Context;
@@ -132,8 +133,19 @@ rclcpp_logging_output_handler(
     std::shared_ptr<std::recursive_mutex> logging_mutex;
     logging_mutex = get_global_logging_mutex();
     std::lock_guard<std::recursive_mutex> guard(*logging_mutex);
-    return rcl_logging_multiple_output_handler(
+    va_list async_rosout_args;
+    va_copy(async_rosout_args, *args);
+    rcl_logging_multiple_output_handler(
       location, severity, name, timestamp, format, args);
+    // The records of the nodes with an AsyncRosoutPublisher are only queued here.
+    try {
+      async_rosout_output_handler(
+        location, severity, name, timestamp, format, &async_rosout_args);
+    } catch (...) {
+      va_end(async_rosout_args);
+      throw;
+    }
+    va_end(async_rosout_args);
   } catch (std::exception & ex) {
     RCUTILS_SAFE_FWRITE_TO_STDERR(ex.what());
     RCUTILS_SAFE_FWRITE_TO_STDERR("\n");
@@ -0,0 +1,70 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/cpu_time.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace rclcpp
+{
+
+std::chrono::nanoseconds
+get_thread_cpu_time() noexcept
+{
+#if defined(_WIN32)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+    return std::chrono::nanoseconds(0);
+  }
+  // FILETIME counts 100 nanoseconds intervals.
+  auto to_int = [](const FILETIME & time) {
+      return (static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+  return std::chrono::nanoseconds((to_int(kernel_time) + to_int(user_time)) * 100);
+#else
+  struct timespec time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+    return std::chrono::nanoseconds(0);
+  }
+  return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+#endif
+}
+
+void
+CpuTimeAccount::add(std::chrono::nanoseconds cpu_time) noexcept
+{
+  cpu_time_ns_.fetch_add(cpu_time.count(), std::memory_order_relaxed);
+  execution_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds
+CpuTimeAccount::get_cpu_time() const noexcept
+{
+  return std::chrono::nanoseconds(cpu_time_ns_.load(std::memory_order_relaxed));
+}
+
+uint64_t
+CpuTimeAccount::get_execution_count() const noexcept
+{
+  return execution_count_.load(std::memory_order_relaxed);
+}
+
+}  // namespace rclcpp
@@ -0,0 +1,272 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/detail/timer_wheel.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rcutils/logging_macros.h"
+
+namespace rclcpp
+{
+namespace detail
+{
+
+struct TimerWheel::State
+{
+  struct Timer
+  {
+    uint64_t expiration_tick;
+    Callback callback;
+  };
+
+  State(std::chrono::nanoseconds tick_duration, size_t number_of_slots)
+  : tick(tick_duration), start(Clock::now()), slots(number_of_slots)
+  {}
+
+  uint64_t
+  tick_of(TimePoint time) const
+  {
+    if (time <= start) {
+      return 0;
+    }
+    // Round up, so that timers never expire early.
+    auto since_start = (time - start).count();
+    return static_cast<uint64_t>((since_start + tick.count() - 1) / tick.count());
+  }
+
+  void
+  schedule(TimerId timer_id, uint64_t expiration_tick)
+  {
+    if (expiration_tick <= current_tick) {
+      expiration_tick = current_tick + 1;
+    }
+    timers[timer_id].expiration_tick = expiration_tick;
+    slots[expiration_tick % slots.size()].push_back(timer_id);
+  }
+
+  /// Return the earliest expiration tick of the timers, which must not be empty.
+  uint64_t
+  next_expiration_tick() const
+  {
+    // A slot only holds timers expiring at its tick of the current rotation or
+    // later, so the first slot holding one expiring in this rotation has the
+    // earliest one, and only if there is none all the timers are looked at.
+    const uint64_t number_of_slots = slots.size();
+    uint64_t earliest = std::numeric_limits<uint64_t>::max();
+    for (uint64_t slot_tick = current_tick + 1;
+      slot_tick <= current_tick + number_of_slots; ++slot_tick)
+    {
+      for (TimerId timer_id : slots[slot_tick % number_of_slots]) {
+        auto it = timers.find(timer_id);
+        if (it != timers.end()) {
+          earliest = std::min(earliest, it->second.expiration_tick);
+        }
+      }
+      if (earliest <= slot_tick) {
+        break;
+      }
+    }
+    return earliest;
+  }
+
+  /// Run the timers until stopped, the wheel may be destroyed in the meantime.
+  void
+  run()
+  {
+    const uint64_t number_of_slots = slots.size();
+    std::vector<TimerId> expired;
+    std::vector<TimerId> remaining;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stop) {
+      if (timers.empty()) {
+        wake_condition.wait(lock);
+        continue;
+      }
+      // Sleep through the ticks in which nothing expires.
+      TimePoint wake_up_time = start + tick * next_expiration_tick();
+      if (Clock::now() < wake_up_time) {
+        wake_condition.wait_until(lock, wake_up_time);
+        continue;
+      }
+
+      // Visit each slot passed since the last time, but no slot more than once.
+      const uint64_t now_tick = static_cast<uint64_t>((Clock::now() - start) / tick);
+      uint64_t first_tick = current_tick + 1;
+      if (now_tick - current_tick > number_of_slots) {
+        first_tick = now_tick - number_of_slots + 1;
+      }
+      current_tick = now_tick;
+      expired.clear();
+      for (uint64_t slot_tick = first_tick; slot_tick <= now_tick; ++slot_tick) {
+        std::vector<TimerId> & slot = slots[slot_tick % number_of_slots];
+        remaining.clear();
+        for (TimerId timer_id : slot) {
+          auto it = timers.find(timer_id);
+          if (it == timers.end()) {
+            continue;
+          }
+          if (it->second.expiration_tick <= now_tick) {
+            expired.push_back(timer_id);
+          } else {
+            remaining.push_back(timer_id);
+          }
+        }
+        slot.swap(remaining);
+      }
+
+      for (TimerId timer_id : expired) {
+        if (stop) {
+          // Destroyed by an earlier callback.
+          break;
+        }
+        auto it = timers.find(timer_id);
+        if (it == timers.end() || it->second.expiration_tick > now_tick) {
+          // Removed, or re-armed, by an earlier callback.
+          continue;
+        }
+        // Copied so that the timer can be removed while its callback is running.
+        Callback callback = it->second.callback;
+        running_timer_id = timer_id;
+        lock.unlock();
+        TimePoint next_expiration_time;
+        try {
+          next_expiration_time = callback(Clock::now());
+        } catch (const std::exception & exception) {
+          RCUTILS_LOG_ERROR_NAMED(
+            "rclcpp",
+            "timer wheel callback threw, removing the timer: %s", exception.what());
+        }
+        // The callback may have destroyed the wheel, but not the state.
+        callback = nullptr;
+        lock.lock();
+        running_timer_id = 0;
+        callback_done_condition.notify_all();
+        it = timers.find(timer_id);
+        if (it == timers.end()) {
+          continue;
+        }
+        if (next_expiration_time == TimePoint()) {
+          timers.erase(it);
+        } else {
+          schedule(timer_id, tick_of(next_expiration_time));
+        }
+      }
+    }
+  }
+
+  const std::chrono::nanoseconds tick;
+  const TimePoint start;
+
+  std::mutex mutex;
+  std::condition_variable wake_condition;
+  std::condition_variable callback_done_condition;
+  std::unordered_map<TimerId, Timer> timers;
+  // Ids of the timers expiring in each slot, removed timers are dropped lazily.
+  std::vector<std::vector<TimerId>> slots;
+  uint64_t current_tick = 0;
+  TimerId next_timer_id = 1;
+  TimerId running_timer_id = 0;
+  bool stop = false;
+};
+
+TimerWheel::TimerWheel(std::chrono::nanoseconds tick, size_t number_of_slots)
+{
+  if (tick <= std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("tick must be a positive duration");
+  }
+  if (number_of_slots == 0) {
+    throw std::invalid_argument("number_of_slots must be a positive, non-zero value");
+  }
+  state_ = std::make_shared<State>(tick, number_of_slots);
+  // The thread owns the state too, as it outlives the wheel when it is detached.
+  thread_ = std::thread([state = state_]() {state->run();});
+}
+
+TimerWheel::~TimerWheel()
+{
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->stop = true;
+  }
+  state_->wake_condition.notify_all();
+  if (thread_.get_id() == std::this_thread::get_id()) {
+    // Destroyed from one of the callbacks, which must not join its own thread.
+    thread_.detach();
+  } else {
+    thread_.join();
+  }
+}
+
+TimerWheel::SharedPtr
+TimerWheel::get_global_instance()
+{
+  static std::mutex global_instance_mutex;
+  static std::weak_ptr<TimerWheel> weak_global_instance;
+
+  std::lock_guard<std::mutex> lock(global_instance_mutex);
+  auto global_instance = weak_global_instance.lock();
+  if (!global_instance) {
+    global_instance = std::make_shared<TimerWheel>();
+    weak_global_instance = global_instance;
+  }
+  return global_instance;
+}
+
+TimerWheel::TimerId
+TimerWheel::add_timer(TimePoint expiration_time, Callback callback)
+{
+  if (!callback) {
+    throw std::invalid_argument("callback must not be empty");
+  }
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  TimerId timer_id = state_->next_timer_id++;
+  state_->timers[timer_id].callback = std::move(callback);
+  state_->schedule(timer_id, state_->tick_of(expiration_time));
+  // It may expire before the timer the thread is waiting for.
+  state_->wake_condition.notify_all();
+  return timer_id;
+}
+
+void
+TimerWheel::remove_timer(TimerId timer_id)
+{
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->timers.erase(timer_id);
+  if (thread_.get_id() != std::this_thread::get_id()) {
+    State & state = *state_;
+    state.callback_done_condition.wait(
+      lock, [&state, timer_id]() {return state.running_timer_id != timer_id;});
+  }
+}
+
+size_t
+TimerWheel::size() const
+{
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->timers.size();
+}
+
+}  // namespace detail
+}  // namespace rclcpp
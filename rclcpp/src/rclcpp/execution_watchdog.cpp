@@ -0,0 +1,298 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/execution_watchdog.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/logging.hpp"
+
+namespace rclcpp
+{
+
+ExecutionWatchdog::ExecutionWatchdog()
+: stopped_(false), next_execution_id_(1),
+  wait_deadline_(std::chrono::steady_clock::time_point::min())
+{
+  thread_ = std::thread(&ExecutionWatchdog::run, this);
+}
+
+ExecutionWatchdog::~ExecutionWatchdog()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  condition_.notify_all();
+  thread_.join();
+}
+
+void
+ExecutionWatchdog::set_overrun_handler(OverrunHandler handler)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  handler_ = std::move(handler);
+}
+
+void
+ExecutionWatchdog::set_budget(
+  const rclcpp::CallbackGroup::SharedPtr & group, std::chrono::nanoseconds budget)
+{
+  set_budget_impl(group.get(), group, budget, 0);
+}
+
+void
+ExecutionWatchdog::set_budget(
+  const rclcpp::TimerBase::SharedPtr & timer,
+  std::chrono::nanoseconds budget,
+  size_t skip_on_overrun)
+{
+  set_budget_impl(timer.get(), timer, budget, skip_on_overrun);
+}
+
+void
+ExecutionWatchdog::set_budget(
+  const rclcpp::SubscriptionBase::SharedPtr & subscription, std::chrono::nanoseconds budget)
+{
+  set_budget_impl(subscription.get(), subscription, budget, 0);
+}
+
+void
+ExecutionWatchdog::set_budget(
+  const rclcpp::ServiceBase::SharedPtr & service, std::chrono::nanoseconds budget)
+{
+  set_budget_impl(service.get(), service, budget, 0);
+}
+
+void
+ExecutionWatchdog::set_budget(
+  const rclcpp::ClientBase::SharedPtr & client, std::chrono::nanoseconds budget)
+{
+  set_budget_impl(client.get(), client, budget, 0);
+}
+
+void
+ExecutionWatchdog::set_budget(
+  const rclcpp::Waitable::SharedPtr & waitable, std::chrono::nanoseconds budget)
+{
+  set_budget_impl(waitable.get(), waitable, budget, 0);
+}
+
+void
+ExecutionWatchdog::set_budget_impl(
+  const void * entity, std::weak_ptr<const void> entity_weak_ptr,
+  std::chrono::nanoseconds budget, size_t skip_on_overrun)
+{
+  if (!entity) {
+    throw std::invalid_argument("entity cannot be nullptr");
+  }
+  if (budget <= std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("budget must be positive");
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  Budget * existing_budget = find_budget(entity);
+  if (existing_budget) {
+    existing_budget->budget = budget;
+    existing_budget->skip_on_overrun = skip_on_overrun;
+    existing_budget->pending_skips = std::min(existing_budget->pending_skips, skip_on_overrun);
+    return;
+  }
+  budgets_.emplace(entity, Budget{std::move(entity_weak_ptr), budget, skip_on_overrun, 0, {}});
+}
+
+void
+ExecutionWatchdog::remove_budget_impl(const void * entity)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  budgets_.erase(entity);
+}
+
+ExecutionWatchdog::Statistics
+ExecutionWatchdog::get_statistics_impl(const void * entity) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = budgets_.find(entity);
+  if (it == budgets_.end() || it->second.entity.expired()) {
+    return Statistics();
+  }
+  return it->second.statistics;
+}
+
+ExecutionWatchdog::Budget *
+ExecutionWatchdog::find_budget(const void * entity)
+{
+  auto it = budgets_.find(entity);
+  if (it == budgets_.end()) {
+    return nullptr;
+  }
+  // Another entity may have been created at the address of a destroyed one.
+  if (it->second.entity.expired()) {
+    budgets_.erase(it);
+    return nullptr;
+  }
+  return &it->second;
+}
+
+bool
+ExecutionWatchdog::skip_timer(const rclcpp::TimerBase & timer)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (budgets_.empty()) {
+    return false;
+  }
+  Budget * budget = find_budget(&timer);
+  if (!budget || budget->pending_skips == 0) {
+    return false;
+  }
+  --budget->pending_skips;
+  ++budget->statistics.skipped_count;
+  return true;
+}
+
+uint64_t
+ExecutionWatchdog::start_execution(const rclcpp::AnyExecutable & executable)
+{
+  const void * entity = nullptr;
+  if (executable.timer) {
+    entity = executable.timer.get();
+  } else if (executable.subscription) {
+    entity = executable.subscription.get();
+  } else if (executable.service) {
+    entity = executable.service.get();
+  } else if (executable.client) {
+    entity = executable.client.get();
+  } else if (executable.waitable) {
+    entity = executable.waitable.get();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (budgets_.empty()) {
+    return 0;
+  }
+  const void * budget_key = entity;
+  Budget * budget = find_budget(entity);
+  if (!budget) {
+    budget_key = executable.callback_group.get();
+    budget = find_budget(budget_key);
+  }
+  if (!budget) {
+    return 0;
+  }
+  const uint64_t execution_id = next_execution_id_++;
+  const auto start = std::chrono::steady_clock::now();
+  executions_.emplace(
+    execution_id, Execution{executable, budget_key, budget->budget, start, false});
+  // Otherwise the watchdog already wakes up for an earlier deadline.
+  if (start + budget->budget < wait_deadline_) {
+    condition_.notify_all();
+  }
+  return execution_id;
+}
+
+void
+ExecutionWatchdog::end_execution(uint64_t execution_id)
+{
+  const auto end = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = executions_.find(execution_id);
+  if (it == executions_.end()) {
+    return;
+  }
+  Execution & execution = it->second;
+  const auto execution_time =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(end - execution.start);
+  const bool overrun = execution_time > execution.budget;
+  Budget * budget = find_budget(execution.budget_key);
+  if (budget) {
+    Statistics & statistics = budget->statistics;
+    ++statistics.execution_count;
+    statistics.max_execution_time = std::max(statistics.max_execution_time, execution_time);
+    if (overrun) {
+      ++statistics.overrun_count;
+      if (execution.executable.timer) {
+        budget->pending_skips = budget->skip_on_overrun;
+      }
+    }
+  }
+  if (overrun && !execution.reported) {
+    finished_overruns_.push_back(
+      Overrun{std::move(execution.executable), execution.budget, execution_time, true});
+    condition_.notify_all();
+  }
+  executions_.erase(it);
+}
+
+void
+ExecutionWatchdog::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopped_) {
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<Overrun> overruns;
+    overruns.swap(finished_overruns_);
+    auto next_deadline = std::chrono::steady_clock::time_point::max();
+    for (auto & id_and_execution : executions_) {
+      Execution & execution = id_and_execution.second;
+      if (execution.reported) {
+        continue;
+      }
+      const auto deadline = execution.start + execution.budget;
+      if (deadline <= now) {
+        execution.reported = true;
+        overruns.push_back(
+          Overrun{
+            execution.executable, execution.budget,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - execution.start), false});
+      } else {
+        next_deadline = std::min(next_deadline, deadline);
+      }
+    }
+
+    if (!overruns.empty()) {
+      OverrunHandler handler = handler_;
+      lock.unlock();
+      if (handler) {
+        for (const auto & overrun : overruns) {
+          try {
+            handler(overrun);
+          } catch (const std::exception & exception) {
+            RCLCPP_ERROR(
+              rclcpp::get_logger("rclcpp"),
+              "exception in execution watchdog overrun handler: %s", exception.what());
+          }
+        }
+      }
+      // Release the executables without holding the lock.
+      overruns.clear();
+      lock.lock();
+      continue;
+    }
+
+    wait_deadline_ = next_deadline;
+    if (next_deadline == std::chrono::steady_clock::time_point::max()) {
+      condition_.wait(lock);
+    } else {
+      condition_.wait_until(lock, next_deadline);
+    }
+    wait_deadline_ = std::chrono::steady_clock::time_point::min();
+  }
+}
+
+}  // namespace rclcpp
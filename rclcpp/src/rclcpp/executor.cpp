@@ -23,6 +23,7 @@
 #include "rcl/allocator.h"
 #include "rcl/error_handling.h"
 
+#include "rclcpp/cpu_time.hpp"
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/executor.hpp"
 #include "rclcpp/guard_condition.hpp"
@@ -44,7 +45,9 @@ using rclcpp::FutureReturnCode;
 Executor::Executor(const rclcpp::ExecutorOptions & options)
 : spinning(false),
   shutdown_guard_condition_(std::make_shared<rclcpp::GuardCondition>(options.context)),
-  memory_strategy_(options.memory_strategy)
+  memory_strategy_(options.memory_strategy),
+  cpu_time_accounting_(options.cpu_time_accounting),
+  execution_watchdog_(options.execution_watchdog)
 {
   // Store the context for later use.
   context_ = options.context;
@@ -222,6 +225,11 @@ Executor::add_callback_group_to_map(
   }
   // Also add to the map that contains all callback groups
   weak_groups_to_nodes_.insert(std::make_pair(weak_group_ptr, node_ptr));
+  group_ptr->find_timer_ptrs_if(
+    [this, &weak_group_ptr](const rclcpp::TimerBase::SharedPtr & timer) -> bool {
+      timers_to_groups_[timer.get()] = std::make_pair(timer, weak_group_ptr);
+      return false;
+    });
   if (is_new_node) {
     rclcpp::node_interfaces::NodeBaseInterface::WeakPtr node_weak_ptr(node_ptr);
     weak_nodes_to_guard_conditions_[node_weak_ptr] = node_ptr->get_notify_guard_condition();
@@ -290,6 +298,14 @@ Executor::remove_callback_group_from_map(
     }
     weak_groups_to_nodes.erase(iter);
     weak_groups_to_nodes_.erase(group_ptr);
+    // Also drop the timers of the group, and the ones which were deleted.
+    for (auto it = timers_to_groups_.begin(); it != timers_to_groups_.end(); ) {
+      if (it->second.first.expired() || it->second.second.lock() == group_ptr) {
+        it = timers_to_groups_.erase(it);
+      } else {
+        ++it;
+      }
+    }
     std::atomic_bool & has_executor = group_ptr->get_associated_with_executor_atomic();
     has_executor.store(false);
   } else {
@@ -498,11 +514,35 @@ Executor::execute_any_executable(AnyExecutable & any_exec)
   if (!spinning.load()) {
     return;
   }
+  bool skip_timer = false;
+  uint64_t watched_execution = 0;
+  if (execution_watchdog_) {
+    skip_timer = any_exec.timer && execution_watchdog_->skip_timer(*any_exec.timer);
+    if (!skip_timer) {
+      watched_execution = execution_watchdog_->start_execution(any_exec);
+    }
+  }
+  // Also when the callback throws, so the execution isn't watched forever.
+  RCLCPP_SCOPE_EXIT(
+    if (watched_execution) {execution_watchdog_->end_execution(watched_execution);});
+  std::chrono::nanoseconds start_cpu_time(0);
+  if (cpu_time_accounting_) {
+    start_cpu_time = rclcpp::get_thread_cpu_time();
+  }
   if (any_exec.timer) {
-    execute_timer(any_exec.timer);
+    if (skip_timer) {
+      any_exec.timer->skip_callback();
+    } else {
+      execute_timer(any_exec.timer);
+    }
   }
   if (any_exec.subscription) {
-    execute_subscription(any_exec.subscription);
+    if (any_exec.callback_group->type() == CallbackGroupType::KeyOrdered) {
+      execute_key_ordered_subscription(
+        any_exec.subscription, any_exec.callback_group->get_keyed_task_queue());
+    } else {
+      execute_subscription(any_exec.subscription);
+    }
   }
   if (any_exec.service) {
     execute_service(any_exec.service);
@@ -513,6 +553,13 @@ Executor::execute_any_executable(AnyExecutable & any_exec)
   if (any_exec.waitable) {
     any_exec.waitable->execute(any_exec.data);
   }
+  if (cpu_time_accounting_) {
+    const auto cpu_time = rclcpp::get_thread_cpu_time() - start_cpu_time;
+    any_exec.callback_group->get_cpu_time_account().add(cpu_time);
+    if (any_exec.node_base) {
+      any_exec.node_base->get_cpu_time_account().add(cpu_time);
+    }
+  }
   // Reset the callback_group, regardless of type
   any_exec.callback_group->can_be_taken_from().store(true);
   // Wake the wait, because it may need to be recalculated or work that
@@ -560,7 +607,7 @@ take_and_do_error_handling(
 }
 
 void
-Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
+Executor::execute_subscription(const rclcpp::SubscriptionBase::SharedPtr & subscription)
 {
   rclcpp::MessageInfo message_info;
   message_info.get_rmw_message_info().from_intra_process = false;
@@ -628,13 +675,50 @@ Executor::execute_subscription(rclcpp::SubscriptionBase::SharedPtr subscription)
 }
 
 void
-Executor::execute_timer(rclcpp::TimerBase::SharedPtr timer)
+Executor::execute_key_ordered_subscription(
+  const rclcpp::SubscriptionBase::SharedPtr & subscription,
+  rclcpp::detail::KeyedTaskQueue & queue)
+{
+  if (subscription->is_serialized() || subscription->can_loan_messages()) {
+    // Loaned messages have to be returned before taking the next one, and
+    // serialized messages have no key, so neither can be ordered.
+    execute_subscription(subscription);
+    return;
+  }
+  queue.take_and_run(
+    [&subscription](std::size_t & key, rclcpp::detail::KeyedTaskQueue::Task & task) {
+      rclcpp::MessageInfo message_info;
+      message_info.get_rmw_message_info().from_intra_process = false;
+      std::shared_ptr<void> message = subscription->create_message();
+      bool taken = false;
+      take_and_do_error_handling(
+        "taking a message from topic",
+        subscription->get_topic_name(),
+        [&]() {return subscription->take_type_erased(message.get(), message_info);},
+        [&]()
+        {
+          taken = true;
+          key = subscription->get_ordering_key(message.get());
+          task = [subscription, message, message_info]() mutable {
+              subscription->handle_message(message, message_info);
+              subscription->return_message(message);
+            };
+        });
+      if (!taken) {
+        subscription->return_message(message);
+      }
+      return taken;
+    });
+}
+
+void
+Executor::execute_timer(const rclcpp::TimerBase::SharedPtr & timer)
 {
   timer->execute_callback();
 }
 
 void
-Executor::execute_service(rclcpp::ServiceBase::SharedPtr service)
+Executor::execute_service(const rclcpp::ServiceBase::SharedPtr & service)
 {
   auto request_header = service->create_request_header();
   std::shared_ptr<void> request = service->create_request();
@@ -647,7 +731,7 @@ Executor::execute_service(rclcpp::ServiceBase::SharedPtr service)
 
 void
 Executor::execute_client(
-  rclcpp::ClientBase::SharedPtr client)
+  const rclcpp::ClientBase::SharedPtr & client)
 {
   auto request_header = client->create_request_header();
   std::shared_ptr<void> response = client->create_response();
@@ -670,6 +754,15 @@ Executor::wait_for_work(std::chrono::nanoseconds timeout)
     // allowed to add to another executor
     add_callback_groups_from_nodes_associated_to_executor();
 
+    // Consume the notifications of the nodes before collecting their entities,
+    // so the entities added during the collection notify the executor again.
+    for (const auto & pair : weak_nodes_to_guard_conditions_) {
+      auto node = pair.first.lock();
+      if (node) {
+        node->consume_notify_guard_condition();
+      }
+    }
+
     // Collect the subscriptions and timers to be waited on
     memory_strategy_->clear_handles();
     bool has_invalid_weak_groups_or_nodes =
@@ -677,9 +770,9 @@ Executor::wait_for_work(std::chrono::nanoseconds timeout)
 
     if (has_invalid_weak_groups_or_nodes) {
       std::vector<rclcpp::CallbackGroup::WeakPtr> invalid_group_ptrs;
-      for (auto pair : weak_groups_to_nodes_) {
-        auto weak_group_ptr = pair.first;
-        auto weak_node_ptr = pair.second;
+      for (const auto & pair : weak_groups_to_nodes_) {
+        const auto & weak_group_ptr = pair.first;
+        const auto & weak_node_ptr = pair.second;
         if (weak_group_ptr.expired() || weak_node_ptr.expired()) {
           invalid_group_ptrs.push_back(weak_group_ptr);
           auto node_guard_pair = weak_nodes_to_guard_conditions_.find(weak_node_ptr);
@@ -743,7 +836,7 @@ Executor::wait_for_work(std::chrono::nanoseconds timeout)
 
 rclcpp::node_interfaces::NodeBaseInterface::SharedPtr
 Executor::get_node_by_group(
-  rclcpp::memory_strategy::MemoryStrategy::WeakCallbackGroupsToNodesMap weak_groups_to_nodes,
+  const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes,
   rclcpp::CallbackGroup::SharedPtr group)
 {
   if (!group) {
@@ -761,30 +854,28 @@ Executor::get_node_by_group(
 rclcpp::CallbackGroup::SharedPtr
 Executor::get_group_by_timer(rclcpp::TimerBase::SharedPtr timer)
 {
-  for (const auto & pair : weak_groups_associated_with_executor_to_nodes_) {
-    auto group = pair.first.lock();
-    if (!group) {
-      continue;
-    }
-    auto timer_ref = group->find_timer_ptrs_if(
-      [timer](const rclcpp::TimerBase::SharedPtr & timer_ptr) -> bool {
-        return timer_ptr == timer;
-      });
-    if (timer_ref) {
-      return group;
-    }
+  if (!timer) {
+    return nullptr;
   }
-
-  for (const auto & pair : weak_groups_to_nodes_associated_with_executor_) {
+  auto found = timers_to_groups_.find(timer.get());
+  // The timer may have been deleted, and its address reused by another one.
+  if (found != timers_to_groups_.end() && found->second.first.lock() == timer) {
+    return found->second.second.lock();
+  }
+  // Not indexed yet, as it was created after its group was added.
+  // weak_groups_to_nodes_ holds both the manually and the automatically added groups,
+  // so a single pass over it is enough.
+  for (const auto & pair : weak_groups_to_nodes_) {
     auto group = pair.first.lock();
     if (!group) {
       continue;
     }
     auto timer_ref = group->find_timer_ptrs_if(
-      [timer](const rclcpp::TimerBase::SharedPtr & timer_ptr) -> bool {
+      [&timer](const rclcpp::TimerBase::SharedPtr & timer_ptr) -> bool {
         return timer_ptr == timer;
       });
     if (timer_ref) {
+      timers_to_groups_[timer.get()] = std::make_pair(timer, pair.first);
       return group;
     }
   }
@@ -801,7 +892,7 @@ Executor::get_next_ready_executable(AnyExecutable & any_executable)
 bool
 Executor::get_next_ready_executable_from_map(
   AnyExecutable & any_executable,
-  rclcpp::memory_strategy::MemoryStrategy::WeakCallbackGroupsToNodesMap weak_groups_to_nodes)
+  const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes)
 {
   bool success = false;
   // Check the timers to see if there are any that are ready
@@ -890,7 +981,7 @@ Executor::get_next_executable(AnyExecutable & any_executable, std::chrono::nanos
 bool
 Executor::has_node(
   const rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
-  rclcpp::memory_strategy::MemoryStrategy::WeakCallbackGroupsToNodesMap weak_groups_to_nodes) const
+  const WeakCallbackGroupsToNodesMap & weak_groups_to_nodes) const
 {
   return std::find_if(
     weak_groups_to_nodes.begin(),
@@ -85,7 +85,9 @@ MultiThreadedExecutor::run(size_t)
       }
       if (any_exec.timer) {
         // Guard against multiple threads getting the same timer.
-        if (scheduled_timers_.count(any_exec.timer) != 0) {
+        // The timer is kept alive by any_exec until it is removed from the set again,
+        // so tracking it by address is enough and avoids touching its reference count.
+        if (!scheduled_timers_.insert(any_exec.timer.get()).second) {
           // Make sure that any_exec's callback group is reset before
           // the lock is released.
           if (any_exec.callback_group) {
@@ -93,7 +95,6 @@ MultiThreadedExecutor::run(size_t)
           }
           continue;
         }
-        scheduled_timers_.insert(any_exec.timer);
       }
     }
     if (yield_before_execute_) {
@@ -104,10 +105,7 @@ MultiThreadedExecutor::run(size_t)
 
     if (any_exec.timer) {
       std::lock_guard<std::mutex> wait_lock(wait_mutex_);
-      auto it = scheduled_timers_.find(any_exec.timer);
-      if (it != scheduled_timers_.end()) {
-        scheduled_timers_.erase(it);
-      }
+      scheduled_timers_.erase(any_exec.timer.get());
     }
     // Clear the callback_group to prevent the AnyExecutable destructor from
     // resetting the callback group `can_be_taken_from`
@@ -0,0 +1,187 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/executors/numa_executor.hpp"
+
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/memory_strategies.hpp"
+#include "rclcpp/scope_exit.hpp"
+
+using rclcpp::executors::NumaExecutor;
+
+NumaExecutor::NumaExecutor(
+  const rclcpp::NumaTopology & topology,
+  size_t threads_per_numa_node,
+  const rclcpp::ExecutorOptions & options)
+: topology_(topology), spinning_(false), cancelled_(false), running_count_(0)
+{
+  for (size_t numa_node = 0; numa_node < topology_.get_node_count(); ++numa_node) {
+    rclcpp::ExecutorOptions numa_node_options = options;
+    numa_node_options.memory_strategy = rclcpp::memory_strategies::create_default_strategy();
+    const size_t number_of_threads =
+      threads_per_numa_node ? threads_per_numa_node : topology_.get_cpus(numa_node).size();
+    executors_.push_back(
+      std::make_unique<rclcpp::executors::MultiThreadedExecutor>(
+        numa_node_options, number_of_threads));
+  }
+}
+
+NumaExecutor::~NumaExecutor() {}
+
+const rclcpp::NumaTopology &
+NumaExecutor::get_numa_topology() const
+{
+  return topology_;
+}
+
+void
+NumaExecutor::add_callback_group(
+  rclcpp::CallbackGroup::SharedPtr group_ptr,
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+  size_t numa_node,
+  bool notify)
+{
+  auto & executor = executors_.at(numa_node);
+  std::lock_guard<std::mutex> lock(mutex_);
+  executor->add_callback_group(group_ptr, node_ptr, notify);
+  group_numa_nodes_[group_ptr] = numa_node;
+}
+
+void
+NumaExecutor::remove_callback_group(rclcpp::CallbackGroup::SharedPtr group_ptr, bool notify)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = group_numa_nodes_.find(group_ptr);
+  if (it == group_numa_nodes_.end()) {
+    throw std::runtime_error("Callback group needs to be associated with executor.");
+  }
+  executors_[it->second]->remove_callback_group(group_ptr, notify);
+  group_numa_nodes_.erase(it);
+}
+
+void
+NumaExecutor::add_node(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+  size_t numa_node,
+  bool notify)
+{
+  auto & executor = executors_.at(numa_node);
+  std::lock_guard<std::mutex> lock(mutex_);
+  executor->add_node(node_ptr, notify);
+  node_numa_nodes_[node_ptr] = numa_node;
+}
+
+void
+NumaExecutor::remove_node(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr, bool notify)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = node_numa_nodes_.find(node_ptr);
+  if (it == node_numa_nodes_.end()) {
+    throw std::runtime_error("Node needs to be associated with this executor.");
+  }
+  executors_[it->second]->remove_node(node_ptr, notify);
+  node_numa_nodes_.erase(it);
+}
+
+void
+NumaExecutor::spin()
+{
+  if (spinning_.exchange(true)) {
+    throw std::runtime_error("spin() called while already spinning");
+  }
+  RCLCPP_SCOPE_EXIT(this->spinning_.store(false); );
+  {
+    std::lock_guard<std::mutex> lock(spin_mutex_);
+    cancelled_ = false;
+    running_count_ = executors_.size();
+  }
+  std::vector<std::exception_ptr> exceptions(executors_.size());
+  std::vector<std::thread> threads;
+  for (size_t numa_node = 0; numa_node < executors_.size(); ++numa_node) {
+    threads.emplace_back(
+      [this, numa_node, &exceptions]() {
+        try {
+          // The threads of the executor inherit the binding.
+          topology_.bind_current_thread(numa_node);
+          bool cancelled;
+          {
+            std::lock_guard<std::mutex> lock(spin_mutex_);
+            cancelled = cancelled_;
+          }
+          if (!cancelled) {
+            executors_[numa_node]->spin();
+          }
+        } catch (...) {
+          exceptions[numa_node] = std::current_exception();
+          cancel();
+        }
+        {
+          std::lock_guard<std::mutex> lock(spin_mutex_);
+          --running_count_;
+        }
+        spin_condition_.notify_all();
+      });
+  }
+  {
+    std::unique_lock<std::mutex> lock(spin_mutex_);
+    while (running_count_ > 0) {
+      if (!cancelled_) {
+        spin_condition_.wait(lock);
+        continue;
+      }
+      // A cancel is lost by an executor which is about to start spinning,
+      // so it is repeated until all the executors returned.
+      lock.unlock();
+      cancel_executors();
+      lock.lock();
+      spin_condition_.wait_for(
+        lock, std::chrono::milliseconds(10), [this]() {return running_count_ == 0;});
+    }
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  for (const auto & exception : exceptions) {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+}
+
+void
+NumaExecutor::cancel()
+{
+  {
+    std::lock_guard<std::mutex> lock(spin_mutex_);
+    cancelled_ = true;
+  }
+  spin_condition_.notify_all();
+  cancel_executors();
+}
+
+void
+NumaExecutor::cancel_executors()
+{
+  for (auto & executor : executors_) {
+    executor->cancel();
+  }
+}
@@ -98,6 +98,14 @@ void
 StaticExecutorEntitiesCollector::execute(std::shared_ptr<void> & data)
 {
   (void) data;
+  // Consume the notifications of the nodes before collecting their entities,
+  // so the entities added during the collection notify the executor again.
+  for (const auto & pair : weak_nodes_to_guard_conditions_) {
+    auto node = pair.first.lock();
+    if (node) {
+      node->consume_notify_guard_condition();
+    }
+  }
   // Fill memory strategy with entities coming from weak_nodes_
   fill_memory_strategy();
   // Fill exec_list_ with entities coming from weak_nodes_ (same as memory strategy)
@@ -172,40 +180,21 @@ StaticExecutorEntitiesCollector::fill_executable_list_from_map(
     if (!node || !group || !group->can_be_taken_from().load()) {
       continue;
     }
-    group->find_timer_ptrs_if(
-      [this](const rclcpp::TimerBase::SharedPtr & timer) {
-        if (timer) {
-          exec_list_.add_timer(timer);
-        }
-        return false;
-      });
-    group->find_subscription_ptrs_if(
+    group->collect_all_ptrs(
       [this](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
-        if (subscription) {
-          exec_list_.add_subscription(subscription);
-        }
-        return false;
-      });
-    group->find_service_ptrs_if(
+        exec_list_.add_subscription(subscription);
+      },
       [this](const rclcpp::ServiceBase::SharedPtr & service) {
-        if (service) {
-          exec_list_.add_service(service);
-        }
-        return false;
-      });
-    group->find_client_ptrs_if(
+        exec_list_.add_service(service);
+      },
       [this](const rclcpp::ClientBase::SharedPtr & client) {
-        if (client) {
-          exec_list_.add_client(client);
-        }
-        return false;
-      });
-    group->find_waitable_ptrs_if(
+        exec_list_.add_client(client);
+      },
+      [this](const rclcpp::TimerBase::SharedPtr & timer) {
+        exec_list_.add_timer(timer);
+      },
       [this](const rclcpp::Waitable::SharedPtr & waitable) {
-        if (waitable) {
-          exec_list_.add_waitable(waitable);
-        }
-        return false;
+        exec_list_.add_waitable(waitable);
       });
   }
 }
@@ -0,0 +1,509 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/experimental/flight_recorder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else  // posix
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "rcutils/strerror.h"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+namespace
+{
+
+constexpr char kMagic[8] = {'R', 'C', 'L', 'F', 'R', 'E', 'C', '1'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kRecordKindMessage = 0;
+constexpr uint32_t kRecordKindPadding = 1;
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t number_of_topics;
+  uint64_t bytes_per_topic;
+  int64_t window_ns;
+  uint32_t number_of_used_topics;
+  uint8_t padding[28];
+};
+static_assert(sizeof(FileHeader) == 64, "unexpected flight record file header size");
+
+constexpr size_t kNameSize = 256;
+
+struct TopicHeader
+{
+  char topic_name[kNameSize];
+  char type_name[kNameSize];
+  uint64_t begin;
+  uint64_t end;
+};
+static_assert(sizeof(TopicHeader) == 528, "unexpected flight record topic header size");
+
+struct RecordHeader
+{
+  int64_t receive_time_ns;
+  uint32_t size;
+  uint32_t kind;
+};
+static_assert(sizeof(RecordHeader) == 16, "unexpected flight record record header size");
+
+uint64_t
+align_8(uint64_t size)
+{
+  return (size + 7u) & ~static_cast<uint64_t>(7u);
+}
+
+void
+copy_name(char (& destination)[kNameSize], const std::string & name)
+{
+  size_t length = std::min(name.size(), kNameSize - 1);
+  std::memcpy(destination, name.data(), length);
+  std::memset(destination + length, 0, kNameSize - length);
+}
+
+std::string
+last_error_string()
+{
+  char error_string[1024];
+  rcutils_strerror(error_string, sizeof(error_string));
+  return error_string;
+}
+
+/// A file which is created with the given size and mapped into memory, shared with the file.
+class MappedFile
+{
+public:
+  MappedFile(const std::string & file_path, size_t size)
+  : size_(size)
+  {
+#if defined(_WIN32)
+    file_ = CreateFileA(
+      file_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+      CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == file_) {
+      throw std::runtime_error("failed to create flight record file '" + file_path + "'");
+    }
+    uint64_t size_64 = size;
+    mapping_ = CreateFileMappingA(
+      file_, nullptr, PAGE_READWRITE,
+      static_cast<DWORD>(size_64 >> 32), static_cast<DWORD>(size_64 & 0xFFFFFFFFu), nullptr);
+    if (nullptr == mapping_) {
+      CloseHandle(file_);
+      throw std::runtime_error("failed to map flight record file '" + file_path + "'");
+    }
+    data_ = static_cast<uint8_t *>(MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size));
+    if (nullptr == data_) {
+      CloseHandle(mapping_);
+      CloseHandle(file_);
+      throw std::runtime_error("failed to map flight record file '" + file_path + "'");
+    }
+#else
+    int fd = open(file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      throw std::runtime_error(
+              "failed to create flight record file '" + file_path + "': " + last_error_string());
+    }
+    // The file is zero filled by extending it.
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      std::string error = last_error_string();
+      close(fd);
+      throw std::runtime_error(
+              "failed to resize flight record file '" + file_path + "': " + error);
+    }
+    void * data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    std::string error = last_error_string();
+    // The mapping keeps the file open.
+    close(fd);
+    if (MAP_FAILED == data) {
+      throw std::runtime_error(
+              "failed to map flight record file '" + file_path + "': " + error);
+    }
+    data_ = static_cast<uint8_t *>(data);
+#endif
+  }
+
+  ~MappedFile()
+  {
+#if defined(_WIN32)
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+#else
+    munmap(data_, size_);
+#endif
+  }
+
+  uint8_t *
+  data() const
+  {
+    return data_;
+  }
+
+  void
+  flush() const
+  {
+#if defined(_WIN32)
+    FlushViewOfFile(data_, size_);
+    FlushFileBuffers(file_);
+#else
+    msync(data_, size_, MS_SYNC);
+#endif
+  }
+
+private:
+  size_t size_;
+  uint8_t * data_;
+#if defined(_WIN32)
+  HANDLE file_;
+  HANDLE mapping_;
+#endif
+};
+
+}  // namespace
+
+FlightRecorderTopic::FlightRecorderTopic(
+  std::shared_ptr<void> mapping,
+  uint8_t * topic_base,
+  size_t capacity,
+  std::chrono::nanoseconds window)
+: mapping_(mapping),
+  topic_base_(topic_base),
+  ring_(topic_base + sizeof(TopicHeader)),
+  capacity_(capacity),
+  window_(window)
+{}
+
+bool
+FlightRecorderTopic::record(const uint8_t * data, size_t size)
+{
+  return this->record(data, size, std::chrono::system_clock::now());
+}
+
+bool
+FlightRecorderTopic::record(
+  const uint8_t * data,
+  size_t size,
+  std::chrono::system_clock::time_point receive_time)
+{
+  const uint64_t record_size = sizeof(RecordHeader) + align_8(size);
+  if (size > std::numeric_limits<uint32_t>::max() || record_size > capacity_) {
+    return false;
+  }
+  const int64_t receive_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    receive_time.time_since_epoch()).count();
+  const int64_t expired_before = receive_time_ns - window_.count();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto topic_header = reinterpret_cast<TopicHeader *>(topic_base_);
+  uint64_t end = topic_header->end;
+  uint64_t position = end % capacity_;
+
+  if (capacity_ - position < record_size) {
+    // Records never wrap around, so pad up to the end of the ring.
+    uint64_t padding = capacity_ - position;
+    this->drop_records_until(end + padding, expired_before);
+    if (padding >= sizeof(RecordHeader)) {
+      RecordHeader padding_header{receive_time_ns, 0, kRecordKindPadding};
+      std::memcpy(ring_ + position, &padding_header, sizeof(padding_header));
+    }
+    end += padding;
+    position = 0;
+    topic_header->end = end;
+  }
+
+  // Records to be overwritten are dropped first, so the file is valid at any time.
+  this->drop_records_until(end + record_size, expired_before);
+  RecordHeader record_header{receive_time_ns, static_cast<uint32_t>(size), kRecordKindMessage};
+  std::memcpy(ring_ + position, &record_header, sizeof(record_header));
+  if (size > 0) {
+    std::memcpy(ring_ + position + sizeof(record_header), data, size);
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  topic_header->end = end + record_size;
+  return true;
+}
+
+bool
+FlightRecorderTopic::record(const rclcpp::SerializedMessage & message)
+{
+  const rcl_serialized_message_t & rcl_message = message.get_rcl_serialized_message();
+  return this->record(rcl_message.buffer, rcl_message.buffer_length);
+}
+
+std::string
+FlightRecorderTopic::get_topic_name() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto topic_header = reinterpret_cast<const TopicHeader *>(topic_base_);
+  return std::string(topic_header->topic_name);
+}
+
+void
+FlightRecorderTopic::set_topic_name(const std::string & topic_name)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  copy_name(reinterpret_cast<TopicHeader *>(topic_base_)->topic_name, topic_name);
+}
+
+uint64_t
+FlightRecorderTopic::next_record_offset(uint64_t offset) const
+{
+  uint64_t position = offset % capacity_;
+  uint64_t remaining = capacity_ - position;
+  if (remaining < sizeof(RecordHeader)) {
+    return offset + remaining;
+  }
+  RecordHeader record_header;
+  std::memcpy(&record_header, ring_ + position, sizeof(record_header));
+  if (kRecordKindPadding == record_header.kind) {
+    return offset + remaining;
+  }
+  return offset + sizeof(RecordHeader) + align_8(record_header.size);
+}
+
+void
+FlightRecorderTopic::drop_records_until(uint64_t offset, int64_t expired_before)
+{
+  auto topic_header = reinterpret_cast<TopicHeader *>(topic_base_);
+  while (topic_header->begin < topic_header->end) {
+    uint64_t begin = topic_header->begin;
+    bool needs_room = offset - begin > capacity_;
+    if (!needs_room) {
+      // Drop padding and expired messages, which are not needed anymore.
+      uint64_t position = begin % capacity_;
+      if (capacity_ - position >= sizeof(RecordHeader)) {
+        RecordHeader record_header;
+        std::memcpy(&record_header, ring_ + position, sizeof(record_header));
+        if (kRecordKindMessage == record_header.kind &&
+          record_header.receive_time_ns >= expired_before)
+        {
+          break;
+        }
+      }
+    }
+    topic_header->begin = this->next_record_offset(begin);
+  }
+  if (topic_header->begin >= topic_header->end) {
+    topic_header->begin = topic_header->end;
+  }
+}
+
+FlightRecorder::FlightRecorder(
+  const std::string & file_path,
+  size_t max_number_of_topics,
+  size_t bytes_per_topic,
+  std::chrono::nanoseconds window)
+: max_number_of_topics_(max_number_of_topics),
+  bytes_per_topic_(align_8(bytes_per_topic)),
+  window_(window)
+{
+  if (max_number_of_topics == 0) {
+    throw std::invalid_argument("max_number_of_topics must be a positive, non-zero value");
+  }
+  if (bytes_per_topic < sizeof(RecordHeader)) {
+    throw std::invalid_argument("bytes_per_topic must be large enough for at least one record");
+  }
+  if (window <= std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("window must be a positive duration");
+  }
+  size_ = sizeof(FileHeader) + max_number_of_topics * (sizeof(TopicHeader) + bytes_per_topic_);
+  auto mapped_file = std::make_shared<MappedFile>(file_path, size_);
+  base_ = mapped_file->data();
+  mapping_ = mapped_file;
+
+  FileHeader file_header;
+  std::memset(&file_header, 0, sizeof(file_header));
+  std::memcpy(file_header.magic, kMagic, sizeof(kMagic));
+  file_header.version = kVersion;
+  file_header.number_of_topics = static_cast<uint32_t>(max_number_of_topics);
+  file_header.bytes_per_topic = bytes_per_topic_;
+  file_header.window_ns = window.count();
+  std::memcpy(base_, &file_header, sizeof(file_header));
+}
+
+FlightRecorder::~FlightRecorder()
+{
+  // The mapping is released with the last topic, possibly still in use by a callback.
+  std::lock_guard<std::mutex> lock(mutex_);
+  subscriptions_.clear();
+}
+
+FlightRecorderTopic::SharedPtr
+FlightRecorder::add_topic(const std::string & topic_name, const std::string & type_name)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (topics_.size() >= max_number_of_topics_) {
+    throw std::runtime_error("the flight recorder cannot record more topics");
+  }
+  uint8_t * topic_base =
+    base_ + sizeof(FileHeader) + topics_.size() * (sizeof(TopicHeader) + bytes_per_topic_);
+  auto topic_header = reinterpret_cast<TopicHeader *>(topic_base);
+  copy_name(topic_header->topic_name, topic_name);
+  copy_name(topic_header->type_name, type_name);
+  topic_header->begin = 0;
+  topic_header->end = 0;
+
+  // Not using make_shared, as the constructor is private.
+  FlightRecorderTopic::SharedPtr topic(
+    new FlightRecorderTopic(mapping_, topic_base, bytes_per_topic_, window_));
+  topics_.push_back(topic);
+  reinterpret_cast<FileHeader *>(base_)->number_of_used_topics =
+    static_cast<uint32_t>(topics_.size());
+  return topic;
+}
+
+void
+FlightRecorder::dump(const std::string & file_path) const
+{
+  MappedFile copy(file_path, size_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::unique_lock<std::mutex>> topic_locks;
+  topic_locks.reserve(topics_.size());
+  for (const auto & topic : topics_) {
+    topic_locks.emplace_back(topic->mutex_);
+  }
+  std::memcpy(copy.data(), base_, size_);
+  copy.flush();
+}
+
+void
+FlightRecorder::flush() const
+{
+  std::static_pointer_cast<MappedFile>(mapping_)->flush();
+}
+
+FlightRecord
+read_flight_record(const std::string & file_path)
+{
+  std::ifstream file(file_path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("failed to open flight record file '" + file_path + "'");
+  }
+  std::vector<uint8_t> content(
+    (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  auto invalid = [&file_path]() {
+      return std::runtime_error("invalid flight record file '" + file_path + "'");
+    };
+
+  FileHeader file_header;
+  if (content.size() < sizeof(file_header)) {
+    throw invalid();
+  }
+  std::memcpy(&file_header, content.data(), sizeof(file_header));
+  const uint64_t capacity = file_header.bytes_per_topic;
+  const uint64_t topic_stride = sizeof(TopicHeader) + capacity;
+  if (
+    std::memcmp(file_header.magic, kMagic, sizeof(kMagic)) != 0 ||
+    file_header.version != kVersion ||
+    capacity < sizeof(RecordHeader) || capacity % 8 != 0 ||
+    file_header.number_of_used_topics > file_header.number_of_topics ||
+    (content.size() - sizeof(FileHeader)) / topic_stride < file_header.number_of_used_topics)
+  {
+    throw invalid();
+  }
+
+  FlightRecord flight_record;
+  flight_record.window = std::chrono::nanoseconds(file_header.window_ns);
+  std::vector<std::vector<int64_t>> receive_times;
+  int64_t newest_receive_time_ns = std::numeric_limits<int64_t>::min();
+  for (uint32_t i = 0; i < file_header.number_of_used_topics; ++i) {
+    const uint8_t * topic_base = content.data() + sizeof(FileHeader) + i * topic_stride;
+    const uint8_t * ring = topic_base + sizeof(TopicHeader);
+    TopicHeader topic_header;
+    std::memcpy(&topic_header, topic_base, sizeof(topic_header));
+    if (topic_header.begin > topic_header.end || topic_header.end - topic_header.begin > capacity) {
+      throw invalid();
+    }
+    topic_header.topic_name[kNameSize - 1] = '\0';
+    topic_header.type_name[kNameSize - 1] = '\0';
+
+    FlightRecord::Topic topic;
+    topic.topic_name = topic_header.topic_name;
+    topic.type_name = topic_header.type_name;
+    receive_times.emplace_back();
+    uint64_t offset = topic_header.begin;
+    while (offset < topic_header.end) {
+      uint64_t position = offset % capacity;
+      uint64_t remaining = capacity - position;
+      if (remaining < sizeof(RecordHeader)) {
+        offset += remaining;
+        continue;
+      }
+      RecordHeader record_header;
+      std::memcpy(&record_header, ring + position, sizeof(record_header));
+      if (kRecordKindPadding == record_header.kind) {
+        offset += remaining;
+        continue;
+      }
+      uint64_t record_size = sizeof(RecordHeader) + align_8(record_header.size);
+      if (kRecordKindMessage != record_header.kind || record_size > remaining) {
+        throw invalid();
+      }
+      const uint8_t * data = ring + position + sizeof(RecordHeader);
+      FlightRecord::Message message;
+      message.receive_time = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::nanoseconds(record_header.receive_time_ns)));
+      message.serialized_data.assign(data, data + record_header.size);
+      topic.messages.push_back(std::move(message));
+      receive_times.back().push_back(record_header.receive_time_ns);
+      newest_receive_time_ns = std::max(newest_receive_time_ns, record_header.receive_time_ns);
+      offset += record_size;
+    }
+    flight_record.topics.push_back(std::move(topic));
+  }
+
+  // Topics which stopped receiving may still hold messages from before the window.
+  if (newest_receive_time_ns == std::numeric_limits<int64_t>::min()) {
+    return flight_record;
+  }
+  const int64_t expired_before = newest_receive_time_ns - file_header.window_ns;
+  for (size_t i = 0; i < flight_record.topics.size(); ++i) {
+    auto & messages = flight_record.topics[i].messages;
+    std::vector<FlightRecord::Message> kept_messages;
+    kept_messages.reserve(messages.size());
+    for (size_t j = 0; j < messages.size(); ++j) {
+      if (receive_times[i][j] >= expired_before) {
+        kept_messages.push_back(std::move(messages[j]));
+      }
+    }
+    messages = std::move(kept_messages);
+  }
+  return flight_record;
+}
+
+}  // namespace experimental
+}  // namespace rclcpp
@@ -32,7 +32,9 @@ IntraProcessManager::~IntraProcessManager()
 {}
 
 uint64_t
-IntraProcessManager::add_publisher(rclcpp::PublisherBase::SharedPtr publisher)
+IntraProcessManager::add_publisher(
+  rclcpp::PublisherBase::SharedPtr publisher,
+  IntraProcessPublisherHistoryBase::SharedPtr history)
 {
   std::unique_lock<std::shared_timed_mutex> lock(mutex_);
 
@@ -41,6 +43,7 @@ IntraProcessManager::add_publisher(rclcpp::PublisherBase::SharedPtr publisher)
   publishers_[id].publisher = publisher;
   publishers_[id].topic_name = publisher->get_topic_name();
   publishers_[id].qos = publisher->get_actual_qos().get_rmw_qos_profile();
+  publishers_[id].history = history;
 
   // Initialize the subscriptions storage for this publisher.
   pub_to_subs_[id] = SplittedSubscriptions();
@@ -68,9 +71,15 @@ IntraProcessManager::add_subscription(SubscriptionIntraProcessBase::SharedPtr su
   subscriptions_[id].use_take_shared_method = subscription->use_take_shared_method();
 
   // adds the subscription id to all the matchable publishers
+  bool late_joiner =
+    subscriptions_[id].qos.durability == RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL;
   for (auto & pair : publishers_) {
     if (can_communicate(pair.second, subscriptions_[id])) {
       insert_sub_id_for_pub(id, pair.first, subscriptions_[id].use_take_shared_method);
+      // Publishing takes the lock too, so no message is both replayed and delivered.
+      if (late_joiner && pair.second.history) {
+        pair.second.history->replay(subscription);
+      }
     }
   }
 
@@ -161,6 +170,18 @@ IntraProcessManager::get_subscription_intra_process(uint64_t intra_process_subsc
   }
 }
 
+size_t
+IntraProcessManager::get_publisher_history_memory_usage(uint64_t intra_process_publisher_id) const
+{
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+
+  auto publisher_it = publishers_.find(intra_process_publisher_id);
+  if (publisher_it == publishers_.end() || !publisher_it->second.history) {
+    return 0;
+  }
+  return publisher_it->second.history->get_memory_usage();
+}
+
 uint64_t
 IntraProcessManager::get_next_unique_id()
 {
@@ -215,8 +236,11 @@ IntraProcessManager::can_communicate(
     return false;
   }
 
-  // a publisher and a subscription with different durability can't communicate
-  if (sub_info.qos.durability != pub_info.qos.durability) {
+  // a transient local subscription can't be connected with a volatile publisher
+  if (
+    sub_info.qos.durability == RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL &&
+    pub_info.qos.durability != RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL)
+  {
     return false;
   }
 
@@ -0,0 +1,173 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/memory_usage.hpp"
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/clock.hpp"
+#include "rclcpp/experimental/subscription_intra_process_base.hpp"
+#include "statistics_msgs/msg/statistic_data_type.hpp"
+
+namespace rclcpp
+{
+
+std::string
+to_string(EntityKind kind)
+{
+  switch (kind) {
+    case EntityKind::Publisher:
+      return "publisher";
+    case EntityKind::Subscription:
+      return "subscription";
+    case EntityKind::Service:
+      return "service";
+    case EntityKind::Client:
+      return "client";
+    case EntityKind::Timer:
+      return "timer";
+    case EntityKind::Waitable:
+      return "waitable";
+  }
+  return "unknown";
+}
+
+NodeMemoryUsage
+get_memory_usage(
+  const rclcpp::node_interfaces::NodeBaseInterface & node_base,
+  const rclcpp::node_interfaces::NodeTopicsInterface & node_topics)
+{
+  NodeMemoryUsage usage;
+  usage.node_name = node_base.get_fully_qualified_name();
+  auto add_entity = [&usage](EntityKind kind, std::string name, size_t bytes) {
+      usage.entities.push_back(EntityMemoryUsage{kind, std::move(name), bytes});
+      usage.bytes += bytes;
+    };
+
+  for (const auto & publisher : node_topics.get_publishers()) {
+    add_entity(EntityKind::Publisher, publisher->get_topic_name(), publisher->get_memory_usage());
+  }
+
+  for (const auto & weak_group : node_base.get_callback_groups()) {
+    auto group = weak_group.lock();
+    if (!group) {
+      continue;
+    }
+    group->collect_all_ptrs(
+      [&](const rclcpp::SubscriptionBase::SharedPtr & subscription) {
+        add_entity(
+          EntityKind::Subscription, subscription->get_topic_name(),
+          subscription->get_memory_usage());
+      },
+      [&](const rclcpp::ServiceBase::SharedPtr & service) {
+        add_entity(EntityKind::Service, service->get_service_name(), service->get_memory_usage());
+      },
+      [&](const rclcpp::ClientBase::SharedPtr & client) {
+        add_entity(EntityKind::Client, client->get_service_name(), client->get_memory_usage());
+      },
+      [&](const rclcpp::TimerBase::SharedPtr & timer) {
+        add_entity(EntityKind::Timer, "", timer->get_memory_usage());
+      },
+      [&](const rclcpp::Waitable::SharedPtr & waitable) {
+        // Already accounted with their subscription.
+        if (dynamic_cast<rclcpp::experimental::SubscriptionIntraProcessBase *>(waitable.get())) {
+          return;
+        }
+        const size_t bytes = waitable->get_memory_usage();
+        if (bytes != 0) {
+          add_entity(EntityKind::Waitable, "", bytes);
+        }
+      });
+  }
+  return usage;
+}
+
+MemoryUsageReporter::~MemoryUsageReporter()
+{
+  timer_->cancel();
+}
+
+void
+MemoryUsageReporter::add_node(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+  rclcpp::node_interfaces::NodeTopicsInterface::SharedPtr node_topics)
+{
+  if (!node_base || !node_topics) {
+    throw std::invalid_argument("node interfaces cannot be nullptr");
+  }
+  std::lock_guard<std::mutex> lock(reported_nodes_->mutex);
+  reported_nodes_->nodes.emplace_back(node_base, node_topics);
+}
+
+void
+MemoryUsageReporter::publish()
+{
+  reported_nodes_->publish();
+}
+
+void
+MemoryUsageReporter::ReportedNodes::publish()
+{
+  using statistics_msgs::msg::MetricsMessage;
+  using statistics_msgs::msg::StatisticDataPoint;
+  using statistics_msgs::msg::StatisticDataType;
+
+  std::vector<NodeMemoryUsage> usages;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = nodes.begin(); it != nodes.end(); ) {
+      auto node_base = it->first.lock();
+      auto node_topics = it->second.lock();
+      if (!node_base || !node_topics) {
+        it = nodes.erase(it);
+        continue;
+      }
+      usages.push_back(get_memory_usage(*node_base, *node_topics));
+      ++it;
+    }
+  }
+
+  const auto now = rclcpp::Clock(RCL_SYSTEM_TIME).now();
+  auto make_message = [&now](const std::string & node_name, std::string source, size_t bytes) {
+      MetricsMessage message;
+      message.measurement_source_name = node_name;
+      message.metrics_source = std::move(source);
+      message.unit = "bytes";
+      message.window_start = now;
+      message.window_stop = now;
+      StatisticDataPoint data_point;
+      data_point.data_type = StatisticDataType::STATISTICS_DATA_TYPE_AVERAGE;
+      data_point.data = static_cast<double>(bytes);
+      message.statistics.push_back(data_point);
+      return message;
+    };
+  for (const auto & usage : usages) {
+    for (const auto & entity : usage.entities) {
+      std::string source = to_string(entity.kind);
+      if (!entity.name.empty()) {
+        source += " " + entity.name;
+      }
+      publisher->publish(make_message(usage.node_name, std::move(source), entity.bytes));
+    }
+    publisher->publish(make_message(usage.node_name, "total", usage.bytes));
+  }
+}
+
+}  // namespace rclcpp
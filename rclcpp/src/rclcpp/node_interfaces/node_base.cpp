@@ -15,6 +15,7 @@
 #include <string>
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 #include "rclcpp/node_interfaces/node_base.hpp"
@@ -44,7 +45,10 @@ NodeBase::NodeBase(
   node_handle_(nullptr),
   default_callback_group_(nullptr),
   associated_with_executor_(false),
-  notify_guard_condition_is_valid_(false)
+  notify_guard_condition_is_valid_(false),
+  notify_guard_condition_pending_(false),
+  notify_guard_condition_deferrals_(0),
+  notify_guard_condition_deferred_trigger_(false)
 {
   // Setup the guard condition that is notified when changes occur in the graph.
   rcl_guard_condition_options_t guard_condition_options = rcl_guard_condition_get_default_options();
@@ -262,6 +266,12 @@ NodeBase::get_associated_with_executor_atomic()
   return associated_with_executor_;
 }
 
+rclcpp::CpuTimeAccount &
+NodeBase::get_cpu_time_account()
+{
+  return cpu_time_account_;
+}
+
 rcl_guard_condition_t *
 NodeBase::get_notify_guard_condition()
 {
@@ -278,6 +288,52 @@ NodeBase::acquire_notify_guard_condition_lock() const
   return std::unique_lock<std::recursive_mutex>(notify_guard_condition_mutex_);
 }
 
+rcl_ret_t
+NodeBase::trigger_notify_guard_condition()
+{
+  std::lock_guard<std::recursive_mutex> notify_condition_lock(notify_guard_condition_mutex_);
+  if (notify_guard_condition_deferrals_ > 0) {
+    notify_guard_condition_deferred_trigger_ = true;
+    return RCL_RET_OK;
+  }
+  // Without an executor, nothing consumes the notifications, so don't coalesce them.
+  if (associated_with_executor_.load() && notify_guard_condition_pending_.exchange(true)) {
+    return RCL_RET_OK;
+  }
+  rcl_ret_t ret = rcl_trigger_guard_condition(get_notify_guard_condition());
+  if (RCL_RET_OK != ret) {
+    notify_guard_condition_pending_.store(false);
+  }
+  return ret;
+}
+
+void
+NodeBase::consume_notify_guard_condition()
+{
+  notify_guard_condition_pending_.store(false);
+}
+
+void
+NodeBase::defer_notify_guard_condition()
+{
+  std::lock_guard<std::recursive_mutex> notify_condition_lock(notify_guard_condition_mutex_);
+  ++notify_guard_condition_deferrals_;
+}
+
+rcl_ret_t
+NodeBase::resume_notify_guard_condition()
+{
+  std::lock_guard<std::recursive_mutex> notify_condition_lock(notify_guard_condition_mutex_);
+  if (notify_guard_condition_deferrals_ == 0) {
+    throw std::runtime_error("notify guard condition notifications are not deferred");
+  }
+  if (--notify_guard_condition_deferrals_ > 0 || !notify_guard_condition_deferred_trigger_) {
+    return RCL_RET_OK;
+  }
+  notify_guard_condition_deferred_trigger_ = false;
+  return trigger_notify_guard_condition();
+}
+
 bool
 NodeBase::get_use_intra_process_default() const
 {
@@ -14,6 +14,10 @@
 
 #include "rclcpp/node_interfaces/node_logging.hpp"
 
+#include <memory>
+
+#include "rcl/logging.h"
+
 using rclcpp::node_interfaces::NodeLogging;
 
 NodeLogging::NodeLogging(rclcpp::node_interfaces::NodeBaseInterface * node_base)
@@ -22,6 +26,19 @@ NodeLogging::NodeLogging(rclcpp::node_interfaces::NodeBaseInterface * node_base)
   logger_ = rclcpp::get_logger(this->get_logger_name());
 }
 
+NodeLogging::NodeLogging(
+  rclcpp::node_interfaces::NodeBaseInterface * node_base,
+  const rclcpp::NodeOptions & options)
+: NodeLogging(node_base)
+{
+  if (options.enable_rosout() && options.async_rosout() && rcl_logging_rosout_enabled()) {
+    async_rosout_publisher_ = std::make_shared<rclcpp::AsyncRosoutPublisher>(
+      node_base_->get_shared_rcl_node_handle(),
+      options.rosout_qos(),
+      options.async_rosout_queue_depth());
+  }
+}
+
 NodeLogging::~NodeLogging()
 {
 }
@@ -37,3 +54,9 @@ NodeLogging::get_logger_name() const
 {
   return rcl_node_get_logger_name(node_base_->get_rcl_node_handle());
 }
+
+rclcpp::AsyncRosoutPublisher::SharedPtr
+NodeLogging::get_async_rosout_publisher() const
+{
+  return async_rosout_publisher_;
+}
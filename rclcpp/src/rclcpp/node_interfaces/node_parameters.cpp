@@ -29,7 +29,9 @@
 
 #include "rcl_interfaces/srv/list_parameters.hpp"
 #include "rclcpp/create_publisher.hpp"
+#include "rclcpp/logging.hpp"
 #include "rclcpp/parameter_map.hpp"
+#include "rclcpp/parameter_snapshot.hpp"
 #include "rclcpp/scope_exit.hpp"
 #include "rcutils/logging_macros.h"
 #include "rmw/qos_profiles.h"
@@ -48,9 +50,11 @@ NodeParameters::NodeParameters(
   const rclcpp::QoS & parameter_event_qos,
   const rclcpp::PublisherOptionsBase & parameter_event_publisher_options,
   bool allow_undeclared_parameters,
-  bool automatically_declare_parameters_from_overrides)
+  bool automatically_declare_parameters_from_overrides,
+  const std::string & parameter_snapshot_file)
 : allow_undeclared_(allow_undeclared_parameters),
   events_publisher_(nullptr),
+  node_base_(node_base),
   node_logging_(node_logging),
   node_clock_(node_clock)
 {
@@ -75,8 +79,105 @@ NodeParameters::NodeParameters(
       publisher_options);
   }
 
+  // Get fully qualified node name post-remapping to use to find node's params in yaml files
+  combined_name_ = node_base->get_fully_qualified_name();
+
+  // Parameters restored from a snapshot don't need the overrides, unless declared differently.
+  bool restored = false;
+  if (!parameter_snapshot_file.empty()) {
+    restored = this->restore_parameters(parameter_snapshot_file);
+  }
+  if (restored) {
+    deferred_parameter_overrides_ = parameter_overrides;
+    parameter_overrides_loaded_ = false;
+  } else {
+    this->load_parameter_overrides(parameter_overrides);
+  }
+
+  // If asked, initialize any parameters that ended up in the initial parameter values,
+  // but did not get declared explcitily by this point.
+  if (automatically_declare_parameters_from_overrides) {
+    for (const auto & pair : this->get_parameter_overrides()) {
+      if (!this->has_parameter(pair.first)) {
+        // Unless restored from the snapshot, where it has its latest value.
+        const bool ignore_override = restored_parameters_.count(pair.first) == 0;
+        this->declare_parameter(
+          pair.first,
+          pair.second,
+          rcl_interfaces::msg::ParameterDescriptor(),
+          ignore_override);
+      }
+    }
+  }
+
+  // Start a new snapshot if the previous one could not be used.
+  if (parameter_snapshot_ && !restored) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    try {
+      parameter_snapshot_->write(parameters_);
+    } catch (const std::runtime_error & e) {
+      RCLCPP_ERROR(
+        node_logging_->get_logger(), "Disabling the parameter snapshot: %s", e.what());
+      parameter_snapshot_.reset();
+    }
+  }
+}
+
+NodeParameters::~NodeParameters()
+{}
+
+bool
+NodeParameters::restore_parameters(const std::string & file_path)
+{
+  rclcpp::ParameterSnapshot::ParameterInfos restored_parameters;
+  try {
+    parameter_snapshot_ = std::make_shared<rclcpp::ParameterSnapshot>(file_path, combined_name_);
+    if (!parameter_snapshot_->load(restored_parameters)) {
+      return false;
+    }
+  } catch (const std::runtime_error & e) {
+    RCLCPP_WARN(
+      node_logging_->get_logger(), "Cannot use the parameter snapshot '%s': %s",
+      file_path.c_str(), e.what());
+    parameter_snapshot_.reset();
+    return false;
+  }
+  if (restored_parameters.empty()) {
+    return false;
+  }
+
+  // The restored values are only used once the parameters are declared again.
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  restored_parameters_.swap(restored_parameters);
+  return true;
+}
+
+void
+NodeParameters::update_parameter_snapshot(const std::string & name)
+{
+  // The restored value of a parameter is superseded by any change of the parameter.
+  restored_parameters_.erase(name);
+  if (!parameter_snapshot_) {
+    return;
+  }
+  try {
+    // The restored parameters which were not declared again yet are kept if the file is rewritten.
+    parameter_snapshot_->update(name, parameters_, restored_parameters_);
+  } catch (const std::runtime_error & e) {
+    RCLCPP_ERROR(
+      node_logging_->get_logger(), "Disabling the parameter snapshot: %s", e.what());
+    parameter_snapshot_.reset();
+  }
+}
+
+void
+NodeParameters::load_parameter_overrides(
+  const std::vector<rclcpp::Parameter> & parameter_overrides) const
+{
+  parameter_overrides_loaded_ = true;
+
   // Get the node options
-  const rcl_node_t * node = node_base->get_rcl_node_handle();
+  const rcl_node_t * node = node_base_->get_rcl_node_handle();
   if (nullptr == node) {
     throw std::runtime_error("Need valid node handle in NodeParameters");
   }
@@ -88,14 +189,11 @@ NodeParameters::NodeParameters(
   std::vector<const rcl_arguments_t *> argument_sources;
   // global before local so that local overwrites global
   if (options->use_global_arguments) {
-    auto context_ptr = node_base->get_context()->get_rcl_context();
+    auto context_ptr = node_base_->get_context()->get_rcl_context();
     argument_sources.push_back(&(context_ptr->global_arguments));
   }
   argument_sources.push_back(&options->arguments);
 
-  // Get fully qualified node name post-remapping to use to find node's params in yaml files
-  combined_name_ = node_base->get_fully_qualified_name();
-
   for (const rcl_arguments_t * source : argument_sources) {
     rcl_params_t * params = NULL;
     rcl_ret_t ret = rcl_arguments_get_param_overrides(source, &params);
@@ -129,25 +227,8 @@ NodeParameters::NodeParameters(
     parameter_overrides_[param.get_name()] =
       rclcpp::ParameterValue(param.get_value_message());
   }
-
-  // If asked, initialize any parameters that ended up in the initial parameter values,
-  // but did not get declared explcitily by this point.
-  if (automatically_declare_parameters_from_overrides) {
-    for (const auto & pair : this->get_parameter_overrides()) {
-      if (!this->has_parameter(pair.first)) {
-        this->declare_parameter(
-          pair.first,
-          pair.second,
-          rcl_interfaces::msg::ParameterDescriptor(),
-          true);
-      }
-    }
-  }
 }
 
-NodeParameters::~NodeParameters()
-{}
-
 RCLCPP_LOCAL
 bool
 __lockless_has_parameter(
@@ -380,6 +461,22 @@ NodeParameters::declare_parameter(
     throw rclcpp::exceptions::InvalidParametersException("parameter name must not be empty");
   }
 
+  // Parameters restored from the snapshot get their restored value back when declared again, and
+  // fall back to the parameter overrides if they don't match the declaration anymore.
+  auto restored_parameter = restored_parameters_.find(name);
+  if (restored_parameter != restored_parameters_.end()) {
+    const ParameterInfo restored_info = restored_parameter->second;
+    restored_parameters_.erase(restored_parameter);
+    if (!ignore_override &&
+      this->declare_restored_parameter(name, restored_info, default_value, parameter_descriptor))
+    {
+      return parameters_.at(name).value;
+    }
+  }
+  if (!parameter_overrides_loaded_) {
+    this->load_parameter_overrides(deferred_parameter_overrides_);
+  }
+
   // Error if this parameter has already been declared and is different
   if (__lockless_has_parameter(parameters_, name)) {
     throw rclcpp::exceptions::ParameterAlreadyDeclaredException(
@@ -411,9 +508,58 @@ NodeParameters::declare_parameter(
     events_publisher_->publish(parameter_event);
   }
 
+  this->update_parameter_snapshot(name);
+
   return parameters_.at(name).value;
 }
 
+bool
+NodeParameters::declare_restored_parameter(
+  const std::string & name,
+  const ParameterInfo & restored_info,
+  const rclcpp::ParameterValue & default_value,
+  const rcl_interfaces::msg::ParameterDescriptor & parameter_descriptor)
+{
+  if (__lockless_has_parameter(parameters_, name) ||
+    (rclcpp::PARAMETER_NOT_SET != default_value.get_type() &&
+    default_value.get_type() != restored_info.value.get_type()))
+  {
+    return false;
+  }
+
+  // The restored value takes the place of the parameter overrides.
+  rcl_interfaces::msg::ParameterEvent parameter_event;
+  std::map<std::string, rclcpp::ParameterValue> restored_overrides {{name, restored_info.value}};
+  auto result = __declare_parameter_common(
+    name,
+    default_value,
+    parameter_descriptor,
+    parameters_,
+    restored_overrides,
+    on_parameters_set_callback_container_,
+    on_parameters_set_callback_,
+    &parameter_event);
+  if (!result.successful) {
+    return false;
+  }
+
+  // Publish if events_publisher_ is not nullptr, which may be if disabled in the constructor.
+  if (nullptr != events_publisher_) {
+    parameter_event.node = combined_name_;
+    parameter_event.stamp = node_clock_->get_clock()->now();
+    events_publisher_->publish(parameter_event);
+  }
+
+  // The snapshot already holds the parameter if it was declared as before.
+  const ParameterInfo & declared_info = parameters_.at(name);
+  if (declared_info.value != restored_info.value ||
+    declared_info.descriptor != restored_info.descriptor)
+  {
+    this->update_parameter_snapshot(name);
+  }
+  return true;
+}
+
 void
 NodeParameters::undeclare_parameter(const std::string & name)
 {
@@ -433,6 +579,7 @@ NodeParameters::undeclare_parameter(const std::string & name)
   }
 
   parameters_.erase(parameter_info);
+  this->update_parameter_snapshot(name);
 }
 
 bool
@@ -650,6 +797,10 @@ NodeParameters::set_parameters_atomically(const std::vector<rclcpp::Parameter> &
     events_publisher_->publish(parameter_event_msg);
   }
 
+  for (const auto & parameter : *parameters_to_be_set) {
+    this->update_parameter_snapshot(parameter.get_name());
+  }
+
   return result;
 }
 
@@ -878,5 +1029,9 @@ NodeParameters::add_on_set_parameters_callback(OnParametersSetCallbackType callb
 const std::map<std::string, rclcpp::ParameterValue> &
 NodeParameters::get_parameter_overrides() const
 {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (!parameter_overrides_loaded_) {
+    this->load_parameter_overrides(deferred_parameter_overrides_);
+  }
   return parameter_overrides_;
 }
@@ -14,7 +14,10 @@
 
 #include "rclcpp/node_interfaces/node_topics.hpp"
 
+#include <algorithm>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "rclcpp/exceptions.hpp"
 
@@ -59,15 +62,40 @@ NodeTopics::add_publisher(
     callback_group->add_waitable(publisher_event);
   }
 
-  // Notify the executor that a new publisher was created using the parent Node.
   {
-    auto notify_guard_condition_lock = node_base_->acquire_notify_guard_condition_lock();
-    if (rcl_trigger_guard_condition(node_base_->get_notify_guard_condition()) != RCL_RET_OK) {
-      throw std::runtime_error(
-              std::string("Failed to notify wait set on publisher creation: ") +
-              rmw_get_error_string().str);
+    std::lock_guard<std::mutex> lock(publishers_mutex_);
+    // Forget the destroyed publishers, so that the list doesn't grow when publishers are recreated.
+    publishers_.erase(
+      std::remove_if(
+        publishers_.begin(), publishers_.end(),
+        [](const rclcpp::PublisherBase::WeakPtr & weak_publisher) {
+          return weak_publisher.expired();
+        }),
+      publishers_.end());
+    publishers_.push_back(publisher);
+  }
+
+  // Notify the executor that a new publisher was created using the parent Node.
+  if (node_base_->trigger_notify_guard_condition() != RCL_RET_OK) {
+    throw std::runtime_error(
+            std::string("Failed to notify wait set on publisher creation: ") +
+            rmw_get_error_string().str);
+  }
+}
+
+std::vector<rclcpp::PublisherBase::SharedPtr>
+NodeTopics::get_publishers() const
+{
+  std::lock_guard<std::mutex> lock(publishers_mutex_);
+  std::vector<rclcpp::PublisherBase::SharedPtr> publishers;
+  publishers.reserve(publishers_.size());
+  for (const auto & weak_publisher : publishers_) {
+    auto publisher = weak_publisher.lock();
+    if (publisher) {
+      publishers.push_back(publisher);
     }
   }
+  return publishers;
 }
 
 rclcpp::SubscriptionBase::SharedPtr
@@ -108,13 +136,10 @@ NodeTopics::add_subscription(
   }
 
   // Notify the executor that a new subscription was created using the parent Node.
-  {
-    auto notify_guard_condition_lock = node_base_->acquire_notify_guard_condition_lock();
-    auto ret = rcl_trigger_guard_condition(node_base_->get_notify_guard_condition());
-    if (ret != RCL_RET_OK) {
-      using rclcpp::exceptions::throw_from_rcl_error;
-      throw_from_rcl_error(ret, "failed to notify wait set on subscription creation");
-    }
+  auto ret = node_base_->trigger_notify_guard_condition();
+  if (ret != RCL_RET_OK) {
+    using rclcpp::exceptions::throw_from_rcl_error;
+    throw_from_rcl_error(ret, "failed to notify wait set on subscription creation");
   }
 }
 
@@ -16,6 +16,7 @@
 
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <utility>
@@ -80,10 +81,13 @@ NodeOptions::operator=(const NodeOptions & other)
     this->clock_qos_ = other.clock_qos_;
     this->parameter_event_qos_ = other.parameter_event_qos_;
     this->rosout_qos_ = other.rosout_qos_;
+    this->async_rosout_ = other.async_rosout_;
+    this->async_rosout_queue_depth_ = other.async_rosout_queue_depth_;
     this->parameter_event_publisher_options_ = other.parameter_event_publisher_options_;
     this->allow_undeclared_parameters_ = other.allow_undeclared_parameters_;
     this->automatically_declare_parameters_from_overrides_ =
       other.automatically_declare_parameters_from_overrides_;
+    this->parameter_snapshot_file_ = other.parameter_snapshot_file_;
     this->allocator_ = other.allocator_;
   }
   return *this;
@@ -98,7 +102,8 @@ NodeOptions::get_rcl_node_options() const
     *node_options_ = rcl_node_get_default_options();
     node_options_->allocator = this->allocator_;
     node_options_->use_global_arguments = this->use_global_arguments_;
-    node_options_->enable_rosout = this->enable_rosout_;
+    // With async_rosout, rclcpp publishes on /rosout instead of rcl.
+    node_options_->enable_rosout = this->enable_rosout_ && !this->async_rosout_;
     node_options_->rosout_qos = this->rosout_qos_.get_rmw_qos_profile();
 
     int c_argc = 0;
@@ -299,6 +304,36 @@ NodeOptions::rosout_qos(const rclcpp::QoS & rosout_qos)
   return *this;
 }
 
+bool
+NodeOptions::async_rosout() const
+{
+  return this->async_rosout_;
+}
+
+NodeOptions &
+NodeOptions::async_rosout(bool async_rosout)
+{
+  this->node_options_.reset();  // reset node options to make it be recreated on next access.
+  this->async_rosout_ = async_rosout;
+  return *this;
+}
+
+size_t
+NodeOptions::async_rosout_queue_depth() const
+{
+  return this->async_rosout_queue_depth_;
+}
+
+NodeOptions &
+NodeOptions::async_rosout_queue_depth(size_t async_rosout_queue_depth)
+{
+  if (async_rosout_queue_depth == 0) {
+    throw std::invalid_argument("async_rosout_queue_depth cannot be zero");
+  }
+  this->async_rosout_queue_depth_ = async_rosout_queue_depth;
+  return *this;
+}
+
 const rclcpp::PublisherOptionsBase &
 NodeOptions::parameter_event_publisher_options() const
 {
@@ -341,6 +376,19 @@ NodeOptions::automatically_declare_parameters_from_overrides(
   return *this;
 }
 
+const std::string &
+NodeOptions::parameter_snapshot_file() const
+{
+  return this->parameter_snapshot_file_;
+}
+
+NodeOptions &
+NodeOptions::parameter_snapshot_file(const std::string & parameter_snapshot_file)
+{
+  this->parameter_snapshot_file_ = parameter_snapshot_file;
+  return *this;
+}
+
 const rcl_allocator_t &
 NodeOptions::allocator() const
 {
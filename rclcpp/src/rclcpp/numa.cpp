@@ -0,0 +1,476 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/numa.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "rcutils/strerror.h"
+
+namespace rclcpp
+{
+
+namespace
+{
+
+#if defined(__linux__)
+// From linux/mempolicy.h, which isn't usable without libnuma headers on all distributions.
+constexpr int kMemoryPolicyPreferred = 1;
+
+std::string
+last_error_string()
+{
+  char error_string[1024];
+  rcutils_strerror(error_string, sizeof(error_string));
+  return error_string;
+}
+
+std::vector<int>
+get_allowed_cpus()
+{
+  std::vector<int> cpus;
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpu_set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  return cpus;
+}
+
+/// Parse a list like "0-3,8,10-11" as used in sysfs.
+bool
+parse_list(const std::string & list, std::vector<int> & values)
+{
+  std::istringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    try {
+      const auto dash = range.find('-');
+      const int first = std::stoi(range.substr(0, dash));
+      const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int value = first; value <= last; ++value) {
+        values.push_back(value);
+      }
+    } catch (const std::exception &) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+read_list(const std::string & path, std::vector<int> & values)
+{
+  std::ifstream file(path);
+  std::string list;
+  if (!file || !std::getline(file, list)) {
+    return false;
+  }
+  return parse_list(list, values);
+}
+
+using NodeMask = std::vector<unsigned long>;  // NOLINT(runtime/int)
+constexpr size_t kBitsPerMaskWord = 8 * sizeof(NodeMask::value_type);
+
+NodeMask
+make_node_mask(int memory_node)
+{
+  NodeMask mask(memory_node / kBitsPerMaskWord + 1, 0);
+  mask[memory_node / kBitsPerMaskWord] |=
+    NodeMask::value_type(1) << (memory_node % kBitsPerMaskWord);
+  return mask;
+}
+
+void
+set_preferred_memory_node(int memory_node)
+{
+  const NodeMask mask = make_node_mask(memory_node);
+  // Failures, e.g. in containers forbidding it, only lose the memory placement.
+  syscall(
+    SYS_set_mempolicy, kMemoryPolicyPreferred, mask.data(), mask.size() * kBitsPerMaskWord + 1);
+}
+
+size_t
+get_page_size()
+{
+  static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return page_size;
+}
+#else
+std::vector<int>
+get_allowed_cpus()
+{
+  std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    cpus[i] = static_cast<int>(i);
+  }
+  return cpus;
+}
+#endif
+
+}  // namespace
+
+NumaTopology::NumaTopology(std::vector<std::vector<int>> node_cpus, std::vector<int> memory_nodes)
+{
+  if (node_cpus.empty()) {
+    throw std::invalid_argument("a NUMA topology needs at least one node");
+  }
+  if (node_cpus.size() != memory_nodes.size()) {
+    throw std::invalid_argument("the number of CPU lists and memory nodes differ");
+  }
+  for (size_t i = 0; i < node_cpus.size(); ++i) {
+    if (node_cpus[i].empty()) {
+      throw std::invalid_argument("NUMA node " + std::to_string(i) + " has no CPU");
+    }
+    nodes_.push_back(Node{std::move(node_cpus[i]), memory_nodes[i]});
+  }
+}
+
+NumaTopology
+NumaTopology::detect()
+{
+  const std::vector<int> allowed_cpus = get_allowed_cpus();
+#if defined(__linux__)
+  const std::string nodes_path = "/sys/devices/system/node/";
+  std::vector<int> system_nodes;
+  if (read_list(nodes_path + "online", system_nodes)) {
+    std::vector<std::vector<int>> node_cpus;
+    std::vector<int> memory_nodes;
+    for (int system_node : system_nodes) {
+      std::vector<int> cpus;
+      if (!read_list(nodes_path + "node" + std::to_string(system_node) + "/cpulist", cpus)) {
+        continue;
+      }
+      cpus.erase(
+        std::remove_if(
+          cpus.begin(), cpus.end(),
+          [&allowed_cpus](int cpu) {
+            return !std::binary_search(allowed_cpus.begin(), allowed_cpus.end(), cpu);
+          }),
+        cpus.end());
+      // Nodes with memory only, or whose CPUs the process may not use.
+      if (cpus.empty()) {
+        continue;
+      }
+      node_cpus.push_back(std::move(cpus));
+      memory_nodes.push_back(system_node);
+    }
+    if (node_cpus.size() > 1) {
+      return NumaTopology(std::move(node_cpus), std::move(memory_nodes));
+    }
+  }
+#endif
+  // A single node, or an unknown topology: nothing to bind memory to.
+  return NumaTopology({allowed_cpus}, {-1});
+}
+
+NumaTopology
+NumaTopology::simulate(size_t node_count)
+{
+  if (node_count == 0) {
+    throw std::invalid_argument("a NUMA topology needs at least one node");
+  }
+  std::vector<int> allowed_cpus = get_allowed_cpus();
+  if (allowed_cpus.empty()) {
+    allowed_cpus.push_back(0);
+  }
+  std::vector<std::vector<int>> node_cpus(node_count);
+  const size_t cpu_count = allowed_cpus.size();
+  for (size_t node = 0; node < node_count; ++node) {
+    for (size_t i = node * cpu_count / node_count; i < (node + 1) * cpu_count / node_count; ++i) {
+      node_cpus[node].push_back(allowed_cpus[i]);
+    }
+    if (node_cpus[node].empty()) {
+      node_cpus[node].push_back(allowed_cpus[node % cpu_count]);
+    }
+  }
+  return NumaTopology(std::move(node_cpus), std::vector<int>(node_count, -1));
+}
+
+size_t
+NumaTopology::get_node_count() const
+{
+  return nodes_.size();
+}
+
+const std::vector<int> &
+NumaTopology::get_cpus(size_t node) const
+{
+  return nodes_.at(node).cpus;
+}
+
+int
+NumaTopology::get_memory_node(size_t node) const
+{
+  return nodes_.at(node).memory_node;
+}
+
+bool
+NumaTopology::is_simulated() const
+{
+  return std::all_of(
+    nodes_.begin(), nodes_.end(), [](const Node & node) {return node.memory_node < 0;});
+}
+
+size_t
+NumaTopology::get_node_of_cpu(int cpu) const
+{
+  for (size_t node = 0; node < nodes_.size(); ++node) {
+    const auto & cpus = nodes_[node].cpus;
+    if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) {
+      return node;
+    }
+  }
+  return nodes_.size();
+}
+
+size_t
+NumaTopology::get_current_node() const
+{
+#if defined(__linux__)
+  const int cpu = sched_getcpu();
+  if (cpu >= 0) {
+    const size_t node = get_node_of_cpu(cpu);
+    if (node < nodes_.size()) {
+      return node;
+    }
+  }
+#endif
+  return 0;
+}
+
+void
+NumaTopology::bind_current_thread(size_t node) const
+{
+  const Node & bound_node = nodes_.at(node);
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : bound_node.cpus) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    throw std::runtime_error(
+            "failed to bind thread to NUMA node " + std::to_string(node) + ": " +
+            last_error_string());
+  }
+  if (bound_node.memory_node >= 0) {
+    set_preferred_memory_node(bound_node.memory_node);
+  }
+#else
+  (void)bound_node;
+#endif
+}
+
+namespace
+{
+
+/// Header in front of each block of numa_allocate() taken from the heap.
+struct BlockHeader
+{
+  /// Start of the heap allocation the block is in.
+  void * memory;
+};
+
+/// Size of the header, keeping the blocks aligned like the ones of the heap.
+constexpr size_t kBlockHeaderSize =
+  (sizeof(BlockHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+  alignof(std::max_align_t);
+
+#if defined(__linux__)
+/// Maximum size of the mappings kept for reuse once deallocated, for all the nodes.
+constexpr size_t kMaxCachedMappingSize = 64 * 1024 * 1024;
+
+/// Mappings of the blocks of at least a page, bound to a memory node.
+/**
+ * The blocks have no header, so that a block of a page takes a single page:
+ * they start on a page boundary, which the blocks from the heap never do,
+ * and the size of their mapping is recorded here instead.
+ * Mappings are rounded up to a power of two pages, only the touched pages
+ * taking memory, and are kept for the next blocks of the same node once
+ * deallocated, instead of being mapped and bound each time.
+ */
+class MappingCache
+{
+public:
+  void *
+  allocate(size_t size, int memory_node)
+  {
+    size_t mapped_size = get_page_size();
+    while (mapped_size < size) {
+      if (mapped_size > std::numeric_limits<size_t>::max() / 2) {
+        throw std::bad_alloc();
+      }
+      mapped_size *= 2;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    void * memory = nullptr;
+    auto cached = cached_mappings_.find(std::make_pair(memory_node, mapped_size));
+    if (cached != cached_mappings_.end() && !cached->second.empty()) {
+      memory = cached->second.back();
+      cached->second.pop_back();
+      cached_size_ -= mapped_size;
+    } else {
+      // Other threads may use the cache meanwhile.
+      lock.unlock();
+      memory = map(mapped_size, memory_node);
+      lock.lock();
+    }
+    try {
+      mappings_[memory] = Mapping{mapped_size, memory_node};
+    } catch (...) {
+      munmap(memory, mapped_size);
+      throw;
+    }
+    return memory;
+  }
+
+  void
+  deallocate(void * memory) noexcept
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = mappings_.find(memory);
+    if (found == mappings_.end()) {
+      return;
+    }
+    const Mapping mapping = found->second;
+    mappings_.erase(found);
+    if (cached_size_ + mapping.size <= kMaxCachedMappingSize) {
+      try {
+        cached_mappings_[std::make_pair(mapping.memory_node, mapping.size)].push_back(memory);
+        cached_size_ += mapping.size;
+        return;
+      } catch (const std::bad_alloc &) {
+        // Unmapped instead.
+      }
+    }
+    munmap(memory, mapping.size);
+  }
+
+private:
+  struct Mapping
+  {
+    size_t size;
+    int memory_node;
+  };
+
+  static void *
+  map(size_t mapped_size, int memory_node)
+  {
+    void * memory = mmap(
+      nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == memory) {
+      throw std::bad_alloc();
+    }
+    const NodeMask mask = make_node_mask(memory_node);
+    // The pages are not touched yet, so they are all placed according to the policy.
+    syscall(
+      SYS_mbind, memory, mapped_size, kMemoryPolicyPreferred, mask.data(),
+      mask.size() * kBitsPerMaskWord + 1, 0);
+    return memory;
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<void *, Mapping> mappings_;
+  std::map<std::pair<int, size_t>, std::vector<void *>> cached_mappings_;
+  size_t cached_size_ = 0;
+};
+
+MappingCache &
+get_mapping_cache()
+{
+  // Never destroyed, as blocks may be deallocated by static objects.
+  static MappingCache * mapping_cache = new MappingCache();
+  return *mapping_cache;
+}
+
+bool
+is_mapped_block(const void * pointer)
+{
+  return reinterpret_cast<uintptr_t>(pointer) % get_page_size() == 0;
+}
+#endif
+
+}  // namespace
+
+void *
+numa_allocate(size_t size, int memory_node)
+{
+#if defined(__linux__)
+  if (memory_node >= 0 && size >= get_page_size()) {
+    return get_mapping_cache().allocate(size, memory_node);
+  }
+#else
+  (void)memory_node;
+#endif
+  // Room for the header, and to move the block off a page boundary.
+  if (size > std::numeric_limits<size_t>::max() - 2 * kBlockHeaderSize) {
+    throw std::bad_alloc();
+  }
+  void * memory = ::operator new(size + 2 * kBlockHeaderSize);
+  char * block = static_cast<char *>(memory) + kBlockHeaderSize;
+#if defined(__linux__)
+  if (is_mapped_block(block)) {
+    block += kBlockHeaderSize;
+  }
+#endif
+  reinterpret_cast<BlockHeader *>(block - kBlockHeaderSize)->memory = memory;
+  return block;
+}
+
+void
+numa_deallocate(void * pointer) noexcept
+{
+  if (!pointer) {
+    return;
+  }
+#if defined(__linux__)
+  if (is_mapped_block(pointer)) {
+    get_mapping_cache().deallocate(pointer);
+    return;
+  }
+#endif
+  char * block = static_cast<char *>(pointer);
+  ::operator delete(reinterpret_cast<BlockHeader *>(block - kBlockHeaderSize)->memory);
+}
+
+}  // namespace rclcpp
@@ -0,0 +1,209 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/parameter_event_handler.hpp"
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rclcpp
+{
+
+ParameterEventCallbackHandle::SharedPtr
+ParameterEventHandler::add_parameter_event_callback(
+  ParameterEventCallbackHandle::ParameterEventCallbackType callback)
+{
+  auto handle = std::make_shared<ParameterEventCallbackHandle>();
+  handle->callback = std::move(callback);
+  std::lock_guard<std::mutex> lock(callbacks_->mutex);
+  callbacks_->event_callbacks.emplace_back(handle);
+  return handle;
+}
+
+void
+ParameterEventHandler::remove_parameter_event_callback(
+  ParameterEventCallbackHandle::SharedPtr callback_handle)
+{
+  std::lock_guard<std::mutex> lock(callbacks_->mutex);
+  auto & event_callbacks = callbacks_->event_callbacks;
+  for (auto it = event_callbacks.begin(); it != event_callbacks.end(); ++it) {
+    if (it->lock() == callback_handle) {
+      event_callbacks.erase(it);
+      return;
+    }
+  }
+  throw std::runtime_error("Parameter event callback doesn't exist");
+}
+
+ParameterCallbackHandle::SharedPtr
+ParameterEventHandler::add_parameter_callback(
+  const std::string & parameter_name,
+  ParameterCallbackHandle::ParameterCallbackType callback,
+  const std::string & node_name)
+{
+  auto handle = std::make_shared<ParameterCallbackHandle>();
+  handle->parameter_name = parameter_name;
+  handle->node_name = resolve_node_name(node_name);
+  handle->callback = std::move(callback);
+  std::lock_guard<std::mutex> lock(callbacks_->mutex);
+  callbacks_->parameter_callbacks[handle->node_name][parameter_name].emplace_back(handle);
+  return handle;
+}
+
+void
+ParameterEventHandler::remove_parameter_callback(
+  ParameterCallbackHandle::SharedPtr callback_handle)
+{
+  if (!callback_handle) {
+    throw std::runtime_error("Parameter callback doesn't exist");
+  }
+  std::lock_guard<std::mutex> lock(callbacks_->mutex);
+  auto & parameter_callbacks = callbacks_->parameter_callbacks;
+  auto node_it = parameter_callbacks.find(callback_handle->node_name);
+  if (node_it != parameter_callbacks.end()) {
+    auto parameter_it = node_it->second.find(callback_handle->parameter_name);
+    if (parameter_it != node_it->second.end()) {
+      auto & callback_list = parameter_it->second;
+      for (auto it = callback_list.begin(); it != callback_list.end(); ++it) {
+        if (it->lock() == callback_handle) {
+          callback_list.erase(it);
+          if (callback_list.empty()) {
+            node_it->second.erase(parameter_it);
+            if (node_it->second.empty()) {
+              parameter_callbacks.erase(node_it);
+            }
+          }
+          return;
+        }
+      }
+    }
+  }
+  throw std::runtime_error("Parameter callback doesn't exist");
+}
+
+bool
+ParameterEventHandler::get_parameter_from_event(
+  const rcl_interfaces::msg::ParameterEvent & event,
+  rclcpp::Parameter & parameter,
+  const std::string & parameter_name,
+  const std::string & node_name)
+{
+  if (event.node != node_name) {
+    return false;
+  }
+  for (const auto & new_parameter : event.new_parameters) {
+    if (new_parameter.name == parameter_name) {
+      parameter = rclcpp::Parameter::from_parameter_msg(new_parameter);
+      return true;
+    }
+  }
+  for (const auto & changed_parameter : event.changed_parameters) {
+    if (changed_parameter.name == parameter_name) {
+      parameter = rclcpp::Parameter::from_parameter_msg(changed_parameter);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<rclcpp::Parameter>
+ParameterEventHandler::get_parameters_from_event(
+  const rcl_interfaces::msg::ParameterEvent & event)
+{
+  std::vector<rclcpp::Parameter> parameters;
+  parameters.reserve(event.new_parameters.size() + event.changed_parameters.size());
+  for (const auto & new_parameter : event.new_parameters) {
+    parameters.push_back(rclcpp::Parameter::from_parameter_msg(new_parameter));
+  }
+  for (const auto & changed_parameter : event.changed_parameters) {
+    parameters.push_back(rclcpp::Parameter::from_parameter_msg(changed_parameter));
+  }
+  return parameters;
+}
+
+std::string
+ParameterEventHandler::resolve_node_name(const std::string & node_name) const
+{
+  if (node_name.empty()) {
+    return node_base_->get_fully_qualified_name();
+  }
+  if (node_name.front() == '/') {
+    return node_name;
+  }
+  const std::string node_namespace = node_base_->get_namespace();
+  if (node_namespace == "/") {
+    return node_namespace + node_name;
+  }
+  return node_namespace + "/" + node_name;
+}
+
+void
+ParameterEventHandler::Callbacks::handle_event(
+  const rcl_interfaces::msg::ParameterEvent::SharedPtr & event)
+{
+  // Collected under the lock but called without it, so that callbacks can add or remove callbacks.
+  std::vector<std::pair<ParameterCallbackHandle::SharedPtr, const rcl_interfaces::msg::Parameter *>>
+  to_call;
+  std::vector<ParameterEventCallbackHandle::SharedPtr> event_callbacks_to_call;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto node_it = parameter_callbacks.find(event->node);
+    if (node_it != parameter_callbacks.end()) {
+      auto & callbacks_of_node = node_it->second;
+      for (const auto * parameters : {&event->new_parameters, &event->changed_parameters}) {
+        for (const auto & parameter : *parameters) {
+          auto parameter_it = callbacks_of_node.find(parameter.name);
+          if (parameter_it == callbacks_of_node.end()) {
+            continue;
+          }
+          auto & callback_list = parameter_it->second;
+          for (auto it = callback_list.begin(); it != callback_list.end(); ) {
+            auto handle = it->lock();
+            if (!handle) {
+              // The handle was dropped without removing the callback.
+              it = callback_list.erase(it);
+              continue;
+            }
+            to_call.emplace_back(std::move(handle), &parameter);
+            ++it;
+          }
+        }
+      }
+    }
+
+    for (auto it = event_callbacks.begin(); it != event_callbacks.end(); ) {
+      auto handle = it->lock();
+      if (!handle) {
+        it = event_callbacks.erase(it);
+        continue;
+      }
+      event_callbacks_to_call.push_back(std::move(handle));
+      ++it;
+    }
+  }
+
+  for (const auto & handle_and_parameter : to_call) {
+    handle_and_parameter.first->callback(
+      rclcpp::Parameter::from_parameter_msg(*handle_and_parameter.second));
+  }
+  for (const auto & handle : event_callbacks_to_call) {
+    handle->callback(event);
+  }
+}
+
+}  // namespace rclcpp
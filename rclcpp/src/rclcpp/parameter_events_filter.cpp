@@ -14,7 +14,9 @@
 
 #include "rclcpp/parameter_events_filter.hpp"
 
+#include <algorithm>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 using rclcpp::ParameterEventsFilter;
@@ -27,25 +29,41 @@ ParameterEventsFilter::ParameterEventsFilter(
   const std::vector<EventType> & types)
 : event_(event)
 {
-  if (std::find(types.begin(), types.end(), EventType::NEW) != types.end()) {
+  auto has_type = [&types](EventType type) {
+      return std::find(types.begin(), types.end(), type) != types.end();
+    };
+  // Scanning a few names is cheaper than hashing, but events may have many parameters.
+  std::unordered_set<std::string> names_set;
+  const bool use_names_set = names.size() > 8;
+  if (use_names_set) {
+    names_set.insert(names.begin(), names.end());
+  }
+  auto has_name = [&names, &names_set, use_names_set](const std::string & name) {
+      if (use_names_set) {
+        return names_set.count(name) != 0;
+      }
+      return std::find(names.begin(), names.end(), name) != names.end();
+    };
+
+  if (has_type(EventType::NEW)) {
     for (auto & new_parameter : event->new_parameters) {
-      if (std::find(names.begin(), names.end(), new_parameter.name) != names.end()) {
+      if (has_name(new_parameter.name)) {
         result_.push_back(
           EventPair(EventType::NEW, &new_parameter));
       }
     }
   }
-  if (std::find(types.begin(), types.end(), EventType::CHANGED) != types.end()) {
+  if (has_type(EventType::CHANGED)) {
     for (auto & changed_parameter : event->changed_parameters) {
-      if (std::find(names.begin(), names.end(), changed_parameter.name) != names.end()) {
+      if (has_name(changed_parameter.name)) {
         result_.push_back(
           EventPair(EventType::CHANGED, &changed_parameter));
       }
     }
   }
-  if (std::find(types.begin(), types.end(), EventType::DELETED) != types.end()) {
+  if (has_type(EventType::DELETED)) {
     for (auto & deleted_parameter : event->deleted_parameters) {
-      if (std::find(names.begin(), names.end(), deleted_parameter.name) != names.end()) {
+      if (has_name(deleted_parameter.name)) {
         result_.push_back(
           EventPair(EventType::DELETED, &deleted_parameter));
       }
@@ -0,0 +1,382 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/parameter_snapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#endif
+
+#include "rcl_interfaces/msg/parameter.hpp"
+#include "rcl_interfaces/msg/parameter_descriptor.hpp"
+#include "rclcpp/parameter_value.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rcutils/strerror.h"
+
+namespace rclcpp
+{
+
+namespace
+{
+
+constexpr char kMagic[8] = {'R', 'C', 'L', 'P', 'S', 'N', 'P', '1'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kRecordKindEnd = 0;
+constexpr uint32_t kRecordKindDeclared = 1;
+constexpr uint32_t kRecordKindUndeclared = 2;
+constexpr size_t kMinCapacity = 64 * 1024;
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t node_name_size;
+  uint8_t padding[16];
+};
+static_assert(sizeof(FileHeader) == 32, "unexpected parameter snapshot file header size");
+
+struct RecordHeader
+{
+  /// Written last, so that a record is ignored until it is complete.
+  uint32_t kind;
+  uint32_t parameter_size;
+  uint32_t descriptor_size;
+  uint32_t checksum;
+};
+static_assert(sizeof(RecordHeader) == 16, "unexpected parameter snapshot record header size");
+
+size_t
+align(size_t size)
+{
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+size_t
+get_records_offset(size_t node_name_size)
+{
+  return align(sizeof(FileHeader) + node_name_size);
+}
+
+// FNV-1a
+uint32_t
+checksum(const uint8_t * data, size_t size)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ data[i]) * 16777619u;
+  }
+  return hash;
+}
+
+/// Append the record of a parameter, or of its removal if info is null.
+void
+append_record(
+  std::vector<uint8_t> & buffer,
+  const std::string & name,
+  const node_interfaces::ParameterInfo * info)
+{
+  static rclcpp::Serialization<rcl_interfaces::msg::Parameter> parameter_serialization;
+  static rclcpp::Serialization<rcl_interfaces::msg::ParameterDescriptor> descriptor_serialization;
+
+  rclcpp::SerializedMessage serialized_parameter;
+  rclcpp::SerializedMessage serialized_descriptor;
+  rcl_interfaces::msg::Parameter parameter;
+  parameter.name = name;
+  if (info) {
+    parameter.value = info->value.to_value_msg();
+    descriptor_serialization.serialize_message(&info->descriptor, &serialized_descriptor);
+  }
+  parameter_serialization.serialize_message(&parameter, &serialized_parameter);
+
+  RecordHeader header;
+  header.kind = info ? kRecordKindDeclared : kRecordKindUndeclared;
+  header.parameter_size = static_cast<uint32_t>(serialized_parameter.size());
+  header.descriptor_size = info ? static_cast<uint32_t>(serialized_descriptor.size()) : 0;
+  const size_t offset = buffer.size();
+  buffer.resize(
+    offset + sizeof(RecordHeader) + align(header.parameter_size + header.descriptor_size), 0);
+  uint8_t * body = buffer.data() + offset + sizeof(RecordHeader);
+  std::memcpy(
+    body, serialized_parameter.get_rcl_serialized_message().buffer, header.parameter_size);
+  if (header.descriptor_size > 0) {
+    std::memcpy(
+      body + header.parameter_size, serialized_descriptor.get_rcl_serialized_message().buffer,
+      header.descriptor_size);
+  }
+  header.checksum = checksum(body, header.parameter_size + header.descriptor_size);
+  std::memcpy(buffer.data() + offset, &header, sizeof(header));
+}
+
+#if !defined(_WIN32)
+std::string
+last_error_string()
+{
+  char error_string[1024];
+  rcutils_strerror(error_string, sizeof(error_string));
+  return error_string;
+}
+
+uint8_t *
+map_file(int fd, size_t size, const std::string & file_path)
+{
+  void * data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (MAP_FAILED == data) {
+    throw std::runtime_error(
+            "failed to map parameter snapshot '" + file_path + "': " + last_error_string());
+  }
+  return static_cast<uint8_t *>(data);
+}
+#endif
+
+}  // namespace
+
+ParameterSnapshot::ParameterSnapshot(const std::string & file_path, const std::string & node_name)
+: file_path_(file_path),
+  node_name_(node_name),
+  data_(nullptr),
+  capacity_(0),
+  size_(0)
+{
+#if defined(_WIN32)
+  throw std::runtime_error("parameter snapshots are not supported on Windows");
+#else
+  int fd = open(file_path_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(
+            "failed to open parameter snapshot '" + file_path_ + "': " + last_error_string());
+  }
+  struct stat file_stat;
+  if (0 != fstat(fd, &file_stat)) {
+    std::string error = last_error_string();
+    close(fd);
+    throw std::runtime_error(
+            "failed to stat parameter snapshot '" + file_path_ + "': " + error);
+  }
+  if (file_stat.st_size > 0) {
+    try {
+      data_ = map_file(fd, static_cast<size_t>(file_stat.st_size), file_path_);
+    } catch (...) {
+      close(fd);
+      throw;
+    }
+    capacity_ = static_cast<size_t>(file_stat.st_size);
+  }
+  // The mapping keeps the file open.
+  close(fd);
+#endif
+}
+
+ParameterSnapshot::~ParameterSnapshot()
+{
+  unmap();
+}
+
+void
+ParameterSnapshot::unmap()
+{
+#if !defined(_WIN32)
+  if (data_) {
+    munmap(data_, capacity_);
+  }
+#endif
+  data_ = nullptr;
+  capacity_ = 0;
+  size_ = 0;
+}
+
+bool
+ParameterSnapshot::load(ParameterInfos & parameters)
+{
+  static rclcpp::Serialization<rcl_interfaces::msg::Parameter> parameter_serialization;
+  static rclcpp::Serialization<rcl_interfaces::msg::ParameterDescriptor> descriptor_serialization;
+
+  size_ = 0;
+  if (!data_ || capacity_ < sizeof(FileHeader)) {
+    return false;
+  }
+  FileHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  if (0 != std::memcmp(header.magic, kMagic, sizeof(kMagic)) || kVersion != header.version ||
+    header.node_name_size != node_name_.size() ||
+    get_records_offset(header.node_name_size) > capacity_ ||
+    0 != std::memcmp(data_ + sizeof(FileHeader), node_name_.data(), node_name_.size()))
+  {
+    return false;
+  }
+
+  ParameterInfos loaded_parameters;
+  size_t offset = get_records_offset(header.node_name_size);
+  try {
+    while (offset + sizeof(RecordHeader) <= capacity_) {
+      RecordHeader record;
+      std::memcpy(&record, data_ + offset, sizeof(record));
+      if (kRecordKindEnd == record.kind) {
+        break;
+      }
+      const size_t body_size = static_cast<size_t>(record.parameter_size) + record.descriptor_size;
+      const uint8_t * body = data_ + offset + sizeof(RecordHeader);
+      if ((kRecordKindDeclared != record.kind && kRecordKindUndeclared != record.kind) ||
+        align(body_size) > capacity_ - offset - sizeof(RecordHeader) ||
+        checksum(body, body_size) != record.checksum)
+      {
+        return false;
+      }
+      rcl_interfaces::msg::Parameter parameter;
+      const rclcpp::SerializedMessage serialized_parameter(body, record.parameter_size);
+      parameter_serialization.deserialize_message(&serialized_parameter, &parameter);
+      if (kRecordKindDeclared == record.kind) {
+        node_interfaces::ParameterInfo & info = loaded_parameters[parameter.name];
+        info.value = rclcpp::ParameterValue(parameter.value);
+        const rclcpp::SerializedMessage serialized_descriptor(
+          body + record.parameter_size, record.descriptor_size);
+        descriptor_serialization.deserialize_message(&serialized_descriptor, &info.descriptor);
+      } else {
+        loaded_parameters.erase(parameter.name);
+      }
+      offset += sizeof(RecordHeader) + align(body_size);
+    }
+  } catch (const std::exception &) {
+    return false;
+  }
+  size_ = offset;
+  parameters.swap(loaded_parameters);
+  return true;
+}
+
+bool
+ParameterSnapshot::update(
+  const std::string & name, const ParameterInfos & parameters,
+  const ParameterInfos & pending_parameters)
+{
+  if (0 == size_) {
+    // Neither loaded nor written yet.
+    write(parameters, pending_parameters);
+    return true;
+  }
+  auto it = parameters.find(name);
+  std::vector<uint8_t> record;
+  append_record(record, name, it != parameters.end() ? &it->second : nullptr);
+  // The end of the file is left zeroed, so that the next record is an end record.
+  if (record.size() + sizeof(RecordHeader) > capacity_ - size_) {
+    write(parameters, pending_parameters);
+    return true;
+  }
+  std::memcpy(
+    data_ + size_ + sizeof(uint32_t), record.data() + sizeof(uint32_t),
+    record.size() - sizeof(uint32_t));
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(data_ + size_, record.data(), sizeof(uint32_t));
+  size_ += record.size();
+  return false;
+}
+
+void
+ParameterSnapshot::write(
+  const ParameterInfos & parameters, const ParameterInfos & pending_parameters)
+{
+  std::vector<uint8_t> buffer(get_records_offset(node_name_.size()), 0);
+  FileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.node_name_size = static_cast<uint32_t>(node_name_.size());
+  std::memcpy(buffer.data(), &header, sizeof(header));
+  std::memcpy(buffer.data() + sizeof(header), node_name_.data(), node_name_.size());
+  for (const auto & parameter : parameters) {
+    append_record(buffer, parameter.first, &parameter.second);
+  }
+  for (const auto & parameter : pending_parameters) {
+    if (parameters.count(parameter.first) == 0) {
+      append_record(buffer, parameter.first, &parameter.second);
+    }
+  }
+  // Leave room to append about as many records.
+  size_t capacity = std::max(kMinCapacity, 2 * buffer.size() + sizeof(RecordHeader));
+  capacity = (capacity + 4095) & ~static_cast<size_t>(4095);
+
+#if defined(_WIN32)
+  (void)capacity;
+  throw std::runtime_error("parameter snapshots are not supported on Windows");
+#else
+  // Written aside and renamed, so that the file is never partially written.
+  const std::string temporary_file_path = file_path_ + ".tmp";
+  int fd = open(temporary_file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(
+            "failed to create parameter snapshot '" + temporary_file_path + "': " +
+            last_error_string());
+  }
+  uint8_t * data = nullptr;
+  try {
+    // The file is zero filled by extending it.
+    if (0 != ftruncate(fd, static_cast<off_t>(capacity))) {
+      throw std::runtime_error(
+              "failed to resize parameter snapshot '" + temporary_file_path + "': " +
+              last_error_string());
+    }
+    data = map_file(fd, capacity, temporary_file_path);
+  } catch (...) {
+    close(fd);
+    unlink(temporary_file_path.c_str());
+    throw;
+  }
+  close(fd);
+  std::memcpy(data, buffer.data(), buffer.size());
+  if (0 != std::rename(temporary_file_path.c_str(), file_path_.c_str())) {
+    std::string error = last_error_string();
+    munmap(data, capacity);
+    unlink(temporary_file_path.c_str());
+    throw std::runtime_error(
+            "failed to replace parameter snapshot '" + file_path_ + "': " + error);
+  }
+  unmap();
+  data_ = data;
+  capacity_ = capacity;
+  size_ = buffer.size();
+#endif
+}
+
+const std::string &
+ParameterSnapshot::get_file_path() const
+{
+  return file_path_;
+}
+
+size_t
+ParameterSnapshot::get_size() const
+{
+  return size_;
+}
+
+size_t
+ParameterSnapshot::get_capacity() const
+{
+  return capacity_;
+}
+
+}  // namespace rclcpp
@@ -201,6 +201,17 @@ PublisherBase::get_intra_process_subscription_count() const
   return ipm->get_subscription_count(intra_process_publisher_id_);
 }
 
+size_t
+PublisherBase::get_memory_usage() const
+{
+  size_t bytes = sizeof(PublisherBase);
+  auto ipm = weak_ipm_.lock();
+  if (intra_process_is_enabled_ && ipm) {
+    bytes += ipm->get_publisher_history_memory_usage(intra_process_publisher_id_);
+  }
+  return bytes;
+}
+
 rclcpp::QoS
 PublisherBase::get_actual_qos() const
 {
@@ -19,6 +19,7 @@
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/serialized_message.hpp"
+#include "rclcpp/type_support_registry.hpp"
 
 #include "rcpputils/asserts.hpp"
 
@@ -33,6 +34,13 @@ SerializationBase::SerializationBase(const rosidl_message_type_support_t * type_
   rcpputils::check_true(nullptr != type_support, "Typesupport is nullpointer.");
 }
 
+SerializationBase::SerializationBase(
+  const std::string & type, const std::string & typesupport_identifier)
+: SerializationBase(
+    rclcpp::get_global_type_support_registry()->get_message_type_support(
+      type, typesupport_identifier))
+{}
+
 void SerializationBase::serialize_message(
   const void * ros_message, SerializedMessage * serialized_message) const
 {
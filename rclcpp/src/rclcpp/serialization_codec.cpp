@@ -0,0 +1,331 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/serialization_codec.hpp"
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace rclcpp
+{
+
+namespace
+{
+
+// Size of the decoded size in front of the data encoded by the LZCodec.
+constexpr size_t lz_header_size = 4;
+constexpr size_t lz_min_match = 4;
+constexpr size_t lz_max_offset = 65535;
+constexpr size_t lz_hash_bits = 12;
+// Maximum number of bytes decoded from one encoded byte, an extra length byte.
+constexpr size_t lz_max_expansion = 255;
+// Size of the encapsulation header of CDR serialized messages.
+constexpr size_t cdr_header_size = 4;
+
+uint32_t
+read_uint32(const uint8_t * data)
+{
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+size_t
+hash_sequence(uint32_t sequence)
+{
+  return (sequence * 2654435761u) >> (32 - lz_hash_bits);
+}
+
+// Write the part of a length which does not fit in the 4 bits of the token.
+uint8_t *
+write_length(uint8_t * out, size_t length)
+{
+  for (length -= 15; length >= 255; length -= 255) {
+    *out++ = 255;
+  }
+  *out++ = static_cast<uint8_t>(length);
+  return out;
+}
+
+uint8_t *
+write_sequence(
+  uint8_t * out, const uint8_t * literals, size_t literal_length, size_t offset,
+  size_t match_length)
+{
+  uint8_t * token = out++;
+  *token = static_cast<uint8_t>((literal_length < 15 ? literal_length : 15) << 4);
+  if (literal_length >= 15) {
+    out = write_length(out, literal_length);
+  }
+  if (literal_length > 0) {
+    std::memcpy(out, literals, literal_length);
+    out += literal_length;
+  }
+  if (0 == match_length) {
+    // Last sequence, which only has literals.
+    return out;
+  }
+  *out++ = static_cast<uint8_t>(offset & 0xff);
+  *out++ = static_cast<uint8_t>(offset >> 8);
+  const size_t length = match_length - lz_min_match;
+  *token |= static_cast<uint8_t>(length < 15 ? length : 15);
+  if (length >= 15) {
+    out = write_length(out, length);
+  }
+  return out;
+}
+
+// Read the part of a length which does not fit in the 4 bits of the token.
+size_t
+read_length(const uint8_t *& in, const uint8_t * end)
+{
+  size_t length = 15;
+  uint8_t byte;
+  do {
+    if (in == end) {
+      throw std::runtime_error("encoded data is truncated");
+    }
+    byte = *in++;
+    length += byte;
+  } while (255 == byte);
+  return length;
+}
+
+}  // namespace
+
+std::string
+LZCodec::get_name() const
+{
+  return "lz";
+}
+
+size_t
+LZCodec::get_max_encoded_size(size_t decoded_size) const
+{
+  // Incompressible data is a single sequence of literals.
+  return lz_header_size + 1 + decoded_size + decoded_size / 255 + 1;
+}
+
+size_t
+LZCodec::encode(const uint8_t * data, size_t size, uint8_t * encoded) const
+{
+  if (size > std::numeric_limits<uint32_t>::max()) {
+    throw std::invalid_argument("data is too large to be encoded");
+  }
+  for (size_t i = 0; i < lz_header_size; ++i) {
+    encoded[i] = static_cast<uint8_t>(size >> (8 * i));
+  }
+  uint8_t * out = encoded + lz_header_size;
+
+  // Position + 1 of the last sequence of 4 bytes with each hash, 0 if none.
+  uint32_t table[1u << lz_hash_bits] = {};
+  size_t anchor = 0;
+  size_t position = 0;
+  while (position + lz_min_match <= size) {
+    const uint32_t sequence = read_uint32(data + position);
+    uint32_t & entry = table[hash_sequence(sequence)];
+    const size_t candidate = entry;
+    entry = static_cast<uint32_t>(position + 1);
+    if (0 == candidate || position + 1 - candidate > lz_max_offset ||
+      read_uint32(data + candidate - 1) != sequence)
+    {
+      ++position;
+      continue;
+    }
+    const size_t match = candidate - 1;
+    size_t match_length = lz_min_match;
+    while (position + match_length < size && data[match + match_length] ==
+      data[position + match_length])
+    {
+      ++match_length;
+    }
+    out = write_sequence(
+      out, data + anchor, position - anchor, position - match, match_length);
+    position += match_length;
+    anchor = position;
+  }
+  out = write_sequence(out, data + anchor, size - anchor, 0, 0);
+  return static_cast<size_t>(out - encoded);
+}
+
+size_t
+LZCodec::get_decoded_size(const uint8_t * encoded, size_t encoded_size) const
+{
+  if (encoded_size < lz_header_size + 1) {
+    throw std::runtime_error("encoded data is truncated");
+  }
+  size_t size = 0;
+  for (size_t i = 0; i < lz_header_size; ++i) {
+    size |= static_cast<size_t>(encoded[i]) << (8 * i);
+  }
+  // No encoded byte decodes to more than 255 bytes, so a larger size comes
+  // from invalid data, and must not be allocated.
+  if ((size + lz_max_expansion - 1) / lz_max_expansion > encoded_size - lz_header_size) {
+    throw std::runtime_error("encoded data is too short for its decoded size");
+  }
+  return size;
+}
+
+void
+LZCodec::decode(const uint8_t * encoded, size_t encoded_size, uint8_t * data, size_t size) const
+{
+  if (get_decoded_size(encoded, encoded_size) != size) {
+    throw std::runtime_error("size of the decoded data does not match the buffer");
+  }
+  const uint8_t * in = encoded + lz_header_size;
+  const uint8_t * in_end = encoded + encoded_size;
+  uint8_t * out = data;
+  uint8_t * out_end = data + size;
+  while (true) {
+    if (in == in_end) {
+      throw std::runtime_error("encoded data is truncated");
+    }
+    const uint8_t token = *in++;
+    size_t literal_length = token >> 4;
+    if (15 == literal_length) {
+      literal_length = read_length(in, in_end);
+    }
+    if (literal_length > static_cast<size_t>(in_end - in) ||
+      literal_length > static_cast<size_t>(out_end - out))
+    {
+      throw std::runtime_error("encoded data has literals out of bounds");
+    }
+    if (literal_length > 0) {
+      std::memcpy(out, in, literal_length);
+      in += literal_length;
+      out += literal_length;
+    }
+    if (in == in_end) {
+      break;
+    }
+    if (in_end - in < 2) {
+      throw std::runtime_error("encoded data is truncated");
+    }
+    const size_t offset = static_cast<size_t>(in[0]) | (static_cast<size_t>(in[1]) << 8);
+    in += 2;
+    size_t match_length = token & 0x0f;
+    if (15 == match_length) {
+      match_length = read_length(in, in_end);
+    }
+    match_length += lz_min_match;
+    if (0 == offset || offset > static_cast<size_t>(out - data) ||
+      match_length > static_cast<size_t>(out_end - out))
+    {
+      throw std::runtime_error("encoded data has a match out of bounds");
+    }
+    // Byte by byte, as the match may overlap the bytes being written.
+    const uint8_t * match = out - offset;
+    for (size_t i = 0; i < match_length; ++i) {
+      out[i] = match[i];
+    }
+    out += match_length;
+  }
+  if (out != out_end) {
+    throw std::runtime_error("encoded data is shorter than its decoded size");
+  }
+}
+
+SerializedMessagePool::SerializedMessagePool(size_t max_size)
+: max_size_(max_size)
+{}
+
+std::unique_ptr<rclcpp::SerializedMessage>
+SerializedMessagePool::acquire()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!messages_.empty()) {
+      auto message = std::move(messages_.back());
+      messages_.pop_back();
+      return message;
+    }
+  }
+  return std::make_unique<rclcpp::SerializedMessage>();
+}
+
+void
+SerializedMessagePool::release(std::unique_ptr<rclcpp::SerializedMessage> message)
+{
+  if (!message) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (messages_.size() < max_size_) {
+    messages_.push_back(std::move(message));
+  }
+}
+
+size_t
+SerializedMessagePool::get_memory_usage() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t bytes = messages_.capacity() * sizeof(messages_[0]);
+  for (const auto & message : messages_) {
+    bytes += sizeof(*message) + message->capacity();
+  }
+  return bytes;
+}
+
+void
+encode_serialized_message(
+  const SerializationCodec & codec,
+  const rcl_serialized_message_t & serialized_message,
+  rclcpp::SerializedMessage & encoded_message)
+{
+  if (serialized_message.buffer_length < cdr_header_size) {
+    throw std::invalid_argument("serialized message is shorter than its header");
+  }
+  const size_t size = serialized_message.buffer_length - cdr_header_size;
+  const size_t max_encoded_size = cdr_header_size + codec.get_max_encoded_size(size);
+  if (encoded_message.capacity() < max_encoded_size) {
+    encoded_message.reserve(max_encoded_size);
+  }
+  auto & encoded = encoded_message.get_rcl_serialized_message();
+  std::memcpy(encoded.buffer, serialized_message.buffer, cdr_header_size);
+  encoded.buffer_length = cdr_header_size + codec.encode(
+    serialized_message.buffer + cdr_header_size, size, encoded.buffer + cdr_header_size);
+}
+
+void
+decode_serialized_message(
+  const SerializationCodec & codec,
+  const rcl_serialized_message_t & encoded_message,
+  rclcpp::SerializedMessage & serialized_message)
+{
+  if (encoded_message.buffer_length < cdr_header_size) {
+    throw std::runtime_error("encoded message is shorter than its header");
+  }
+  const uint8_t * encoded = encoded_message.buffer + cdr_header_size;
+  const size_t encoded_size = encoded_message.buffer_length - cdr_header_size;
+  const size_t size = codec.get_decoded_size(encoded, encoded_size);
+  if (serialized_message.capacity() < cdr_header_size + size) {
+    serialized_message.reserve(cdr_header_size + size);
+  }
+  auto & decoded = serialized_message.get_rcl_serialized_message();
+  std::memcpy(decoded.buffer, encoded_message.buffer, cdr_header_size);
+  codec.decode(encoded, encoded_size, decoded.buffer + cdr_header_size, size);
+  decoded.buffer_length = cdr_header_size + size;
+}
+
+std::string
+get_encoded_topic_name(const std::string & topic_name, const SerializationCodec & codec)
+{
+  return topic_name + "/encoded_" + codec.get_name();
+}
+
+}  // namespace rclcpp
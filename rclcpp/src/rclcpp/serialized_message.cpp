@@ -15,6 +15,9 @@
 #include "rclcpp/serialized_message.hpp"
 
 #include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/logging.hpp"
@@ -55,6 +58,20 @@ SerializedMessage::SerializedMessage(
   }
 }
 
+SerializedMessage::SerializedMessage(
+  const uint8_t * data, size_t size, std::shared_ptr<const void> owner)
+: serialized_message_(rmw_get_zero_initialized_serialized_message()),
+  is_borrowed_(true),
+  borrowed_data_owner_(std::move(owner))
+{
+  // Only read by the middleware, e.g. when publishing.
+  serialized_message_.buffer = const_cast<uint8_t *>(data);
+  serialized_message_.buffer_length = size;
+  serialized_message_.buffer_capacity = size;
+  // Used to allocate copies of the data.
+  serialized_message_.allocator = rcl_get_default_allocator();
+}
+
 SerializedMessage::SerializedMessage(const SerializedMessage & other)
 : SerializedMessage(other.serialized_message_)
 {}
@@ -67,7 +84,9 @@ SerializedMessage::SerializedMessage(const rcl_serialized_message_t & other)
 
 SerializedMessage::SerializedMessage(SerializedMessage && other)
 : serialized_message_(
-    std::exchange(other.serialized_message_, rmw_get_zero_initialized_serialized_message()))
+    std::exchange(other.serialized_message_, rmw_get_zero_initialized_serialized_message())),
+  is_borrowed_(std::exchange(other.is_borrowed_, false)),
+  borrowed_data_owner_(std::move(other.borrowed_data_owner_))
 {}
 
 SerializedMessage::SerializedMessage(rcl_serialized_message_t && other)
@@ -80,6 +99,8 @@ SerializedMessage & SerializedMessage::operator=(const SerializedMessage & other
   if (this != &other) {
     serialized_message_ = rmw_get_zero_initialized_serialized_message();
     copy_rcl_message(other.serialized_message_, serialized_message_);
+    is_borrowed_ = false;
+    borrowed_data_owner_.reset();
   }
 
   return *this;
@@ -90,6 +111,8 @@ SerializedMessage & SerializedMessage::operator=(const rcl_serialized_message_t
   if (&serialized_message_ != &other) {
     serialized_message_ = rmw_get_zero_initialized_serialized_message();
     copy_rcl_message(other, serialized_message_);
+    is_borrowed_ = false;
+    borrowed_data_owner_.reset();
   }
 
   return *this;
@@ -100,6 +123,8 @@ SerializedMessage & SerializedMessage::operator=(SerializedMessage && other)
   if (this != &other) {
     serialized_message_ =
       std::exchange(other.serialized_message_, rmw_get_zero_initialized_serialized_message());
+    is_borrowed_ = std::exchange(other.is_borrowed_, false);
+    borrowed_data_owner_ = std::move(other.borrowed_data_owner_);
   }
 
   return *this;
@@ -110,13 +135,15 @@ SerializedMessage & SerializedMessage::operator=(rcl_serialized_message_t && oth
   if (&serialized_message_ != &other) {
     serialized_message_ =
       std::exchange(other, rmw_get_zero_initialized_serialized_message());
+    is_borrowed_ = false;
+    borrowed_data_owner_.reset();
   }
   return *this;
 }
 
 SerializedMessage::~SerializedMessage()
 {
-  if (nullptr != serialized_message_.buffer) {
+  if (nullptr != serialized_message_.buffer && !is_borrowed_) {
     const auto fini_ret = rmw_serialized_message_fini(&serialized_message_);
     if (RCL_RET_OK != fini_ret) {
       RCLCPP_ERROR(
@@ -128,6 +155,9 @@ SerializedMessage::~SerializedMessage()
 
 rcl_serialized_message_t & SerializedMessage::get_rcl_serialized_message()
 {
+  if (is_borrowed_) {
+    throw std::runtime_error("cannot modify a serialized message borrowing its data");
+  }
   return serialized_message_;
 }
 
@@ -148,6 +178,9 @@ size_t SerializedMessage::capacity() const
 
 void SerializedMessage::reserve(size_t capacity)
 {
+  if (is_borrowed_) {
+    throw std::runtime_error("cannot resize a serialized message borrowing its data");
+  }
   auto ret = rmw_serialized_message_resize(&serialized_message_, capacity);
   if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret);
@@ -156,9 +189,17 @@ void SerializedMessage::reserve(size_t capacity)
 
 rcl_serialized_message_t SerializedMessage::release_rcl_serialized_message()
 {
+  if (is_borrowed_) {
+    throw std::runtime_error("cannot release the data borrowed by a serialized message");
+  }
   auto ret = serialized_message_;
   serialized_message_ = rmw_get_zero_initialized_serialized_message();
 
   return ret;
 }
+
+bool SerializedMessage::is_borrowed() const
+{
+  return is_borrowed_;
+}
 }  // namespace rclcpp
@@ -0,0 +1,593 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/experimental/shared_memory_channel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#endif
+
+#include "rcutils/strerror.h"
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+namespace
+{
+
+constexpr char kMagic[8] = {'R', 'C', 'L', 'S', 'H', 'M', '0', '1'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kAlignment = 64;
+// Size of the header of a slot, in front of its data.
+constexpr size_t kSlotHeaderSize = kAlignment;
+// How long to wait for another process to finish creating a segment or writing a slot.
+constexpr std::chrono::seconds kTimeout(1);
+
+static_assert(
+  ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+  "shared memory channels need lock-free atomics");
+
+constexpr size_t
+align(size_t size)
+{
+  return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+#if defined(__linux__)
+std::string
+last_error_string()
+{
+  char error_string[1024];
+  rcutils_strerror(error_string, sizeof(error_string));
+  return error_string;
+}
+
+bool
+is_process_alive(int32_t pid)
+{
+  return pid == getpid() || 0 == kill(pid, 0) || EPERM == errno;
+}
+
+int32_t
+get_process_id()
+{
+  return static_cast<int32_t>(getpid());
+}
+
+void
+futex_wait(std::atomic<uint32_t> & word, uint32_t value, std::chrono::nanoseconds timeout)
+{
+  if (timeout < std::chrono::nanoseconds::zero()) {
+    timeout = std::chrono::nanoseconds::zero();
+  }
+  const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+  struct timespec timeout_spec;
+  timeout_spec.tv_sec = static_cast<time_t>(seconds.count());
+  timeout_spec.tv_nsec = static_cast<long>((timeout - seconds).count());  // NOLINT
+  // Not FUTEX_PRIVATE_FLAG, as the word is shared with other processes.
+  syscall(
+    SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, value, &timeout_spec,
+    nullptr, 0);
+}
+
+void
+futex_wake(std::atomic<uint32_t> & word)
+{
+  syscall(
+    SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#else
+bool
+is_process_alive(int32_t)
+{
+  return true;
+}
+
+int32_t
+get_process_id()
+{
+  return 1;
+}
+
+void
+futex_wait(std::atomic<uint32_t> &, uint32_t, std::chrono::nanoseconds)
+{}
+
+void
+futex_wake(std::atomic<uint32_t> &)
+{}
+#endif
+
+/// Claim an entry of a table whose pid is zero or of a process which ended.
+/**
+ * The entry is marked with -1 while it is filled by the caller.
+ */
+template<typename GetPid>
+bool
+claim_entry(size_t size, GetPid get_pid, size_t & index)
+{
+  for (index = 0; index < size; ++index) {
+    std::atomic<int32_t> & pid = get_pid(index);
+    int32_t current = pid.load(std::memory_order_acquire);
+    if (current < 0 || (current > 0 && is_process_alive(current))) {
+      continue;
+    }
+    if (pid.compare_exchange_strong(current, -1, std::memory_order_acq_rel)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+/// Header of the shared memory segment, followed by the slots.
+struct SharedMemoryChannel::Segment
+{
+  char magic[8];
+  uint32_t version;
+  std::atomic<uint32_t> initialized;
+  uint64_t number_of_slots;
+  uint64_t slot_size;
+  /// Number of channels using the segment, zero once it is being removed.
+  std::atomic<uint32_t> attach_count;
+  /// Incremented on each write, to wake up the readers.
+  std::atomic<uint32_t> futex_word;
+  /// Number of readers waiting on the futex word.
+  std::atomic<uint32_t> waiter_count;
+
+  alignas(kAlignment) std::atomic<uint64_t> write_sequence;
+
+  struct Writer
+  {
+    std::atomic<int32_t> pid;
+    uint8_t gid[RMW_GID_STORAGE_SIZE];
+  };
+  alignas(kAlignment) Writer writers[max_number_of_writers];
+  std::atomic<int32_t> reader_pids[max_number_of_readers];
+};
+
+/// Header of a slot, followed by its data.
+/**
+ * The sequence of the slot is 2 * n + 1 while the message n is written into
+ * it, and 2 * n + 2 once it is written.
+ */
+struct SharedMemoryChannel::Slot
+{
+  std::atomic<uint64_t> sequence;
+  uint64_t size;
+};
+static_assert(
+  sizeof(std::atomic<uint64_t>) + sizeof(uint64_t) <= kSlotHeaderSize,
+  "unexpected shared memory slot header size");
+
+SharedMemoryChannel::SharedMemoryChannel(
+  const std::string & name,
+  size_t number_of_slots,
+  size_t slot_size)
+: name_(name),
+  number_of_slots_(number_of_slots),
+  slot_size_(slot_size),
+  slot_stride_(0),
+  mapped_size_(0),
+  segment_(nullptr)
+{
+  if (0 == number_of_slots || 0 == slot_size) {
+    throw std::invalid_argument("number of slots and slot size must be positive");
+  }
+  const size_t header_size = align(sizeof(Segment));
+  const size_t max_size = std::numeric_limits<size_t>::max() / 2;
+  if (slot_size > max_size || number_of_slots > (max_size - header_size) / align(
+      kSlotHeaderSize + slot_size))
+  {
+    throw std::invalid_argument("shared memory channel is too large");
+  }
+  slot_stride_ = align(kSlotHeaderSize + slot_size);
+  mapped_size_ = header_size + number_of_slots * slot_stride_;
+
+#if defined(__linux__)
+  const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+  while (true) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      throw std::runtime_error("timed out opening shared memory channel '" + name_ + "'");
+    }
+    // Create the segment, or open the one created by another process.
+    bool created = true;
+    int fd = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (-1 == fd && EEXIST == errno) {
+      created = false;
+      fd = shm_open(name_.c_str(), O_RDWR, 0);
+      if (-1 == fd && ENOENT == errno) {
+        // Removed in the meantime.
+        continue;
+      }
+    }
+    if (-1 == fd) {
+      throw std::runtime_error(
+              "failed to open shared memory channel '" + name_ + "': " + last_error_string());
+    }
+    if (created && 0 != ftruncate(fd, static_cast<off_t>(mapped_size_))) {
+      const std::string error_string = last_error_string();
+      close(fd);
+      shm_unlink(name_.c_str());
+      throw std::runtime_error(
+              "failed to resize shared memory channel '" + name_ + "': " + error_string);
+    }
+    // Wait for the creator to resize it.
+    off_t file_size = static_cast<off_t>(mapped_size_);
+    while (!created) {
+      struct stat file_stat;
+      if (0 != fstat(fd, &file_stat)) {
+        const std::string error_string = last_error_string();
+        close(fd);
+        throw std::runtime_error(
+                "failed to stat shared memory channel '" + name_ + "': " + error_string);
+      }
+      file_size = file_stat.st_size;
+      if (0 != file_size || std::chrono::steady_clock::now() > deadline) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (static_cast<size_t>(file_size) != mapped_size_) {
+      close(fd);
+      throw std::runtime_error(
+              "shared memory channel '" + name_ +
+              "' exists with another number of slots or slot size");
+    }
+    void * memory = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const std::string error_string = last_error_string();
+    close(fd);
+    if (MAP_FAILED == memory) {
+      if (created) {
+        shm_unlink(name_.c_str());
+      }
+      throw std::runtime_error(
+              "failed to map shared memory channel '" + name_ + "': " + error_string);
+    }
+
+    if (created) {
+      segment_ = new (memory) Segment();
+      std::memcpy(segment_->magic, kMagic, sizeof(kMagic));
+      segment_->version = kVersion;
+      segment_->number_of_slots = number_of_slots_;
+      segment_->slot_size = slot_size_;
+      segment_->attach_count.store(1, std::memory_order_relaxed);
+      segment_->initialized.store(1, std::memory_order_release);
+      return;
+    }
+
+    segment_ = static_cast<Segment *>(memory);
+    while (0 == segment_->initialized.load(std::memory_order_acquire) &&
+      std::chrono::steady_clock::now() < deadline)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::string error;
+    if (0 == segment_->initialized.load(std::memory_order_acquire)) {
+      error = "' was not initialized by its creator, see remove()";
+    } else if (0 != std::memcmp(segment_->magic, kMagic, sizeof(kMagic)) ||  // NOLINT
+      kVersion != segment_->version)
+    {
+      error = "' is not a shared memory channel of this version";
+    } else if (number_of_slots_ != segment_->number_of_slots ||
+      slot_size_ != segment_->slot_size)
+    {
+      error = "' exists with another number of slots or slot size";
+    }
+    if (!error.empty()) {
+      munmap(memory, mapped_size_);
+      segment_ = nullptr;
+      throw std::runtime_error("shared memory channel '" + name_ + error);
+    }
+    uint32_t attach_count = segment_->attach_count.load(std::memory_order_acquire);
+    while (0 != attach_count) {
+      if (segment_->attach_count.compare_exchange_weak(
+          attach_count, attach_count + 1, std::memory_order_acq_rel))
+      {
+        return;
+      }
+    }
+    // The last channel using it is removing it, so create a new one.
+    munmap(memory, mapped_size_);
+    segment_ = nullptr;
+    std::this_thread::yield();
+  }
+#else
+  throw std::runtime_error("shared memory channels are only supported on Linux");
+#endif
+}
+
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+#if defined(__linux__)
+  if (1 == segment_->attach_count.fetch_sub(1, std::memory_order_acq_rel)) {
+    shm_unlink(name_.c_str());
+  }
+  munmap(segment_, mapped_size_);
+#endif
+}
+
+std::string
+SharedMemoryChannel::get_channel_name(const std::string & topic_name, size_t domain_id)
+{
+  std::string name = "/rclcpp_shm_" + std::to_string(domain_id);
+  if (topic_name.empty() || '/' != topic_name.front()) {
+    name += '.';
+  }
+  name += topic_name;
+  std::replace(name.begin() + 1, name.end(), '/', '.');
+  return name;
+}
+
+void
+SharedMemoryChannel::remove(const std::string & name)
+{
+#if defined(__linux__)
+  shm_unlink(name.c_str());
+#else
+  (void)name;
+#endif
+}
+
+size_t
+SharedMemoryChannel::get_number_of_slots() const
+{
+  return number_of_slots_;
+}
+
+size_t
+SharedMemoryChannel::get_slot_size() const
+{
+  return slot_size_;
+}
+
+SharedMemoryChannel::Slot *
+SharedMemoryChannel::get_slot(uint64_t sequence) const
+{
+  uint8_t * slots = reinterpret_cast<uint8_t *>(segment_) + align(sizeof(Segment));
+  return reinterpret_cast<Slot *>(slots + (sequence % number_of_slots_) * slot_stride_);
+}
+
+bool
+SharedMemoryChannel::write(const uint8_t * data, size_t size)
+{
+  if (size > slot_size_) {
+    return false;
+  }
+  const uint64_t sequence = segment_->write_sequence.fetch_add(1, std::memory_order_acq_rel);
+  Slot * slot = get_slot(sequence);
+  const uint64_t writing = 2 * sequence + 1;
+  const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+  uint64_t current = slot->sequence.load(std::memory_order_acquire);
+  while (true) {
+    if (current > writing) {
+      // A later message was written into the slot, so this one is already overwritten.
+      return true;
+    }
+    // Wait for a writer still writing an earlier message into the slot, unless it seems stuck.
+    if (1 == current % 2 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+      current = slot->sequence.load(std::memory_order_acquire);
+      continue;
+    }
+    if (slot->sequence.compare_exchange_weak(current, writing, std::memory_order_acq_rel)) {
+      break;
+    }
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  if (size > 0) {
+    std::memcpy(reinterpret_cast<uint8_t *>(slot) + kSlotHeaderSize, data, size);
+  }
+  slot->size = size;
+  uint64_t expected = writing;
+  slot->sequence.compare_exchange_strong(expected, writing + 1, std::memory_order_release);
+
+  segment_->futex_word.fetch_add(1, std::memory_order_seq_cst);
+  if (segment_->waiter_count.load(std::memory_order_seq_cst) > 0) {
+    futex_wake(segment_->futex_word);
+  }
+  return true;
+}
+
+uint64_t
+SharedMemoryChannel::get_write_sequence() const
+{
+  return segment_->write_sequence.load(std::memory_order_acquire);
+}
+
+bool
+SharedMemoryChannel::take(uint64_t & sequence, rclcpp::SerializedMessage & message)
+{
+  while (true) {
+    const uint64_t write_sequence = segment_->write_sequence.load(std::memory_order_acquire);
+    if (sequence >= write_sequence) {
+      return false;
+    }
+    if (write_sequence - sequence > number_of_slots_) {
+      // Fell behind by more than the ring.
+      dropped_count_ += write_sequence - number_of_slots_ - sequence;
+      sequence = write_sequence - number_of_slots_;
+    }
+    Slot * slot = get_slot(sequence);
+    const uint64_t written = 2 * sequence + 2;
+    const uint64_t before = slot->sequence.load(std::memory_order_acquire);
+    if (before < written) {
+      return false;
+    }
+    if (before == written) {
+      const size_t size = static_cast<size_t>(slot->size);
+      if (size <= slot_size_) {
+        if (message.capacity() < size) {
+          message.reserve(size);
+        }
+        auto & rcl_message = message.get_rcl_serialized_message();
+        if (size > 0) {
+          std::memcpy(
+            rcl_message.buffer, reinterpret_cast<uint8_t *>(slot) + kSlotHeaderSize, size);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) == written) {
+          rcl_message.buffer_length = size;
+          ++sequence;
+          return true;
+        }
+      }
+    }
+    // Overwritten before or while being copied.
+    ++dropped_count_;
+    ++sequence;
+  }
+}
+
+bool
+SharedMemoryChannel::has_data(uint64_t sequence) const
+{
+  const uint64_t write_sequence = segment_->write_sequence.load(std::memory_order_acquire);
+  if (sequence >= write_sequence) {
+    return false;
+  }
+  if (write_sequence - sequence > number_of_slots_) {
+    return true;
+  }
+  return get_slot(sequence)->sequence.load(std::memory_order_acquire) >= 2 * sequence + 2;
+}
+
+bool
+SharedMemoryChannel::wait_for_data(uint64_t sequence, std::chrono::nanoseconds timeout)
+{
+  segment_->waiter_count.fetch_add(1, std::memory_order_seq_cst);
+  const uint32_t value = segment_->futex_word.load(std::memory_order_seq_cst);
+  if (!has_data(sequence)) {
+    futex_wait(segment_->futex_word, value, timeout);
+  }
+  segment_->waiter_count.fetch_sub(1, std::memory_order_seq_cst);
+  return has_data(sequence);
+}
+
+void
+SharedMemoryChannel::notify()
+{
+  segment_->futex_word.fetch_add(1, std::memory_order_seq_cst);
+  futex_wake(segment_->futex_word);
+}
+
+uint64_t
+SharedMemoryChannel::get_dropped_count() const
+{
+  return dropped_count_.load();
+}
+
+void
+SharedMemoryChannel::add_writer(const rmw_gid_t & gid)
+{
+  size_t index;
+  auto get_pid = [this](size_t i) -> std::atomic<int32_t> & {
+      return segment_->writers[i].pid;
+    };
+  if (!claim_entry(max_number_of_writers, get_pid, index)) {
+    throw std::runtime_error(
+            "maximum number of writers of shared memory channel '" + name_ + "' reached");
+  }
+  std::memcpy(segment_->writers[index].gid, gid.data, RMW_GID_STORAGE_SIZE);
+  segment_->writers[index].pid.store(get_process_id(), std::memory_order_release);
+}
+
+void
+SharedMemoryChannel::remove_writer(const rmw_gid_t & gid)
+{
+  const int32_t pid = get_process_id();
+  for (auto & writer : segment_->writers) {
+    if (pid == writer.pid.load(std::memory_order_acquire) &&
+      0 == std::memcmp(writer.gid, gid.data, RMW_GID_STORAGE_SIZE))
+    {
+      writer.pid.store(0, std::memory_order_release);
+    }
+  }
+}
+
+bool
+SharedMemoryChannel::has_writer(const rmw_gid_t & gid) const
+{
+  for (const auto & writer : segment_->writers) {
+    if (writer.pid.load(std::memory_order_acquire) > 0 &&
+      0 == std::memcmp(writer.gid, gid.data, RMW_GID_STORAGE_SIZE))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t
+SharedMemoryChannel::register_reader()
+{
+  size_t index;
+  auto get_pid = [this](size_t i) -> std::atomic<int32_t> & {
+      return segment_->reader_pids[i];
+    };
+  if (!claim_entry(max_number_of_readers, get_pid, index)) {
+    throw std::runtime_error(
+            "maximum number of readers of shared memory channel '" + name_ + "' reached");
+  }
+  segment_->reader_pids[index].store(get_process_id(), std::memory_order_release);
+  return index;
+}
+
+void
+SharedMemoryChannel::unregister_reader(size_t index)
+{
+  if (index < max_number_of_readers &&
+    get_process_id() == segment_->reader_pids[index].load(std::memory_order_acquire))
+  {
+    segment_->reader_pids[index].store(0, std::memory_order_release);
+  }
+}
+
+size_t
+SharedMemoryChannel::get_reader_count() const
+{
+  size_t count = 0;
+  for (const auto & pid : segment_->reader_pids) {
+    const int32_t current = pid.load(std::memory_order_acquire);
+    if (current > 0 && is_process_alive(current)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+}  // namespace experimental
+}  // namespace rclcpp
@@ -15,6 +15,7 @@
 #include "rclcpp/subscription_base.hpp"
 
 #include <cstdio>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -155,6 +156,7 @@ SubscriptionBase::take_type_erased(void * message_out, rclcpp::MessageInfo & mes
     // we should ignore this copy of the message.
     return false;
   }
+  this->record_message_arrival(message_info_out);
   return true;
 }
 
@@ -173,9 +175,16 @@ SubscriptionBase::take_serialized(
   } else if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret);
   }
+  this->record_message_arrival(message_info_out);
   return true;
 }
 
+void
+SubscriptionBase::record_message_arrival(const rclcpp::MessageInfo & message_info)
+{
+  (void)message_info;
+}
+
 const rosidl_message_type_support_t &
 SubscriptionBase::get_message_type_support_handle() const
 {
@@ -219,6 +228,15 @@ SubscriptionBase::can_loan_messages() const
   return rcl_subscription_can_loan_messages(subscription_handle_.get());
 }
 
+std::size_t
+SubscriptionBase::get_ordering_key(const void * message) const
+{
+  if (ordering_key_function_) {
+    return ordering_key_function_(message);
+  }
+  return std::hash<const SubscriptionBase *>()(this);
+}
+
 rclcpp::Waitable::SharedPtr
 SubscriptionBase::get_intra_process_waitable() const
 {
@@ -238,6 +256,20 @@ SubscriptionBase::get_intra_process_waitable() const
   return ipm->get_subscription_intra_process(intra_process_subscription_id_);
 }
 
+size_t
+SubscriptionBase::get_memory_usage() const
+{
+  size_t bytes = sizeof(SubscriptionBase);
+  auto ipm = weak_ipm_.lock();
+  if (use_intra_process_ && ipm) {
+    auto waitable = ipm->get_subscription_intra_process(intra_process_subscription_id_);
+    if (waitable) {
+      bytes += waitable->get_memory_usage();
+    }
+  }
+  return bytes;
+}
+
 void
 SubscriptionBase::default_incompatible_qos_callback(
   rclcpp::QOSRequestedIncompatibleQoSInfo & event) const
@@ -93,6 +93,15 @@ TimerBase::is_canceled()
   return is_canceled;
 }
 
+void
+TimerBase::skip_callback()
+{
+  rcl_ret_t ret = rcl_timer_call(timer_handle_.get());
+  if (ret != RCL_RET_OK && ret != RCL_RET_TIMER_CANCELED) {
+    throw std::runtime_error("Failed to notify timer that callback was skipped");
+  }
+}
+
 void
 TimerBase::reset()
 {
@@ -136,3 +145,9 @@ TimerBase::exchange_in_use_by_wait_set_state(bool in_use_state)
 {
   return in_use_by_wait_set_.exchange(in_use_state);
 }
+
+size_t
+TimerBase::get_memory_usage() const
+{
+  return sizeof(TimerBase);
+}
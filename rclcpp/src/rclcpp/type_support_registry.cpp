@@ -0,0 +1,148 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rclcpp/type_support_registry.hpp"
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rcpputils/find_library.hpp"
+#include "rcpputils/shared_library.hpp"
+
+namespace rclcpp
+{
+
+namespace
+{
+
+struct TypeName
+{
+  std::string package_name;
+  std::string middle_module;
+  std::string type_name;
+};
+
+TypeName
+split_type_name(const std::string & type)
+{
+  std::vector<std::string> tokens;
+  size_t start = 0;
+  while (true) {
+    const size_t end = type.find('/', start);
+    tokens.push_back(type.substr(start, end - start));
+    if (std::string::npos == end) {
+      break;
+    }
+    start = end + 1;
+  }
+  if (2 == tokens.size()) {
+    tokens.insert(tokens.begin() + 1, "msg");
+  }
+  if (3 != tokens.size() || tokens[0].empty() || tokens[1].empty() || tokens[2].empty()) {
+    throw std::runtime_error("invalid type name '" + type + "'");
+  }
+  return TypeName{tokens[0], tokens[1], tokens[2]};
+}
+
+}  // namespace
+
+TypeSupportRegistry::TypeSupportRegistry()
+{}
+
+TypeSupportRegistry::~TypeSupportRegistry()
+{
+  // The type supports point into the libraries, so they go first.
+  message_type_supports_.clear();
+  libraries_.clear();
+}
+
+const rosidl_message_type_support_t *
+TypeSupportRegistry::get_message_type_support(
+  const std::string & type,
+  const std::string & typesupport_identifier)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Key key(type, typesupport_identifier);
+  auto it = message_type_supports_.find(key);
+  if (it != message_type_supports_.end()) {
+    return it->second;
+  }
+
+  const TypeName type_name = split_type_name(type);
+  auto library = get_library(type_name.package_name, typesupport_identifier);
+  const std::string symbol_name = typesupport_identifier + "__get_message_type_support_handle__" +
+    type_name.package_name + "__" + type_name.middle_module + "__" + type_name.type_name;
+  if (!library->has_symbol(symbol_name)) {
+    throw std::runtime_error(
+            "type support '" + typesupport_identifier + "' of type '" + type +
+            "' not found in library '" + library->get_library_path() + "'");
+  }
+  using GetTypeSupportHandle = const rosidl_message_type_support_t * (*)();
+  auto get_type_support_handle =
+    reinterpret_cast<GetTypeSupportHandle>(library->get_symbol(symbol_name));
+  const rosidl_message_type_support_t * type_support = get_type_support_handle();
+  if (nullptr == type_support) {
+    throw std::runtime_error(
+            "type support '" + typesupport_identifier + "' of type '" + type + "' is null");
+  }
+  message_type_supports_.emplace(key, type_support);
+  return type_support;
+}
+
+size_t
+TypeSupportRegistry::get_library_count() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return libraries_.size();
+}
+
+std::shared_ptr<rcpputils::SharedLibrary>
+TypeSupportRegistry::get_library(
+  const std::string & package_name,
+  const std::string & typesupport_identifier)
+{
+  const Key key(package_name, typesupport_identifier);
+  auto it = libraries_.find(key);
+  if (it != libraries_.end()) {
+    return it->second;
+  }
+  const std::string library_name =
+    rcpputils::get_platform_library_name(package_name + "__" + typesupport_identifier);
+  const std::string library_path = rcpputils::find_library_path(library_name);
+  if (library_path.empty()) {
+    throw std::runtime_error(
+            "typesupport library '" + library_name + "' not found in the library search path");
+  }
+  std::shared_ptr<rcpputils::SharedLibrary> library;
+  try {
+    library = std::make_shared<rcpputils::SharedLibrary>(library_path);
+  } catch (const std::exception & e) {
+    throw std::runtime_error(
+            "failed to load typesupport library '" + library_path + "': " + e.what());
+  }
+  libraries_.emplace(key, library);
+  return library;
+}
+
+TypeSupportRegistry::SharedPtr
+get_global_type_support_registry()
+{
+  static TypeSupportRegistry::SharedPtr registry = TypeSupportRegistry::make_shared();
+  return registry;
+}
+
+}  // namespace rclcpp
@@ -57,3 +57,9 @@ Waitable::exchange_in_use_by_wait_set_state(bool in_use_state)
 {
   return in_use_by_wait_set_.exchange(in_use_state);
 }
+
+size_t
+Waitable::get_memory_usage() const
+{
+  return 0u;
+}
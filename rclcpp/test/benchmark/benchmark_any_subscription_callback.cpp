@@ -0,0 +1,79 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/any_subscription_callback.hpp"
+#include "test_msgs/msg/empty.hpp"
+
+using performance_test_fixture::PerformanceTest;
+
+class PerformanceTestAnySubscriptionCallback : public PerformanceTest
+{
+public:
+  PerformanceTestAnySubscriptionCallback()
+  : any_subscription_callback(std::make_shared<std::allocator<void>>()),
+    message(std::make_shared<test_msgs::msg::Empty>()),
+    callback_count(0)
+  {
+  }
+
+  rclcpp::AnySubscriptionCallback<test_msgs::msg::Empty, std::allocator<void>>
+  any_subscription_callback;
+  std::shared_ptr<test_msgs::msg::Empty> message;
+  rclcpp::MessageInfo message_info;
+  size_t callback_count;
+};
+
+BENCHMARK_F(PerformanceTestAnySubscriptionCallback, dispatch_shared_ptr)(benchmark::State & st)
+{
+  any_subscription_callback.set(
+    [this](std::shared_ptr<test_msgs::msg::Empty>) {callback_count++;});
+
+  for (auto _ : st) {
+    any_subscription_callback.dispatch(message, message_info);
+  }
+  benchmark::DoNotOptimize(callback_count);
+}
+
+BENCHMARK_F(
+  PerformanceTestAnySubscriptionCallback,
+  dispatch_const_shared_ptr_with_info)(benchmark::State & st)
+{
+  // The slowest case if each of the callback types was tested in turn.
+  any_subscription_callback.set(
+    [this](std::shared_ptr<const test_msgs::msg::Empty>, const rclcpp::MessageInfo &) {
+      callback_count++;
+    });
+
+  for (auto _ : st) {
+    any_subscription_callback.dispatch(message, message_info);
+  }
+  benchmark::DoNotOptimize(callback_count);
+}
+
+BENCHMARK_F(PerformanceTestAnySubscriptionCallback, dispatch_unique_ptr)(benchmark::State & st)
+{
+  any_subscription_callback.set(
+    [this](std::unique_ptr<test_msgs::msg::Empty>) {callback_count++;});
+
+  for (auto _ : st) {
+    // Measures the allocation of the owned message as well.
+    any_subscription_callback.dispatch(
+      std::make_unique<test_msgs::msg::Empty>(), message_info);
+  }
+  benchmark::DoNotOptimize(callback_count);
+}
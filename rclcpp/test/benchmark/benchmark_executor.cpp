@@ -117,6 +117,28 @@ BENCHMARK_F(PerformanceTestExecutor, multi_thread_executor_spin_some)(benchmark:
   }
 }
 
+/// Executor which exposes the selection and dispatch steps of spin_once() separately.
+class DispatchExecutor : public rclcpp::executors::SingleThreadedExecutor
+{
+public:
+  void wait_for_ready_work()
+  {
+    wait_for_work(std::chrono::nanoseconds::zero());
+  }
+
+  bool dispatch_next()
+  {
+    spinning.store(true);
+    RCLCPP_SCOPE_EXIT(this->spinning.store(false); );
+    rclcpp::AnyExecutable any_exec;
+    if (!get_next_ready_executable(any_exec)) {
+      return false;
+    }
+    execute_any_executable(any_exec);
+    return true;
+  }
+};
+
 class PerformanceTestExecutorSimple : public PerformanceTest
 {
 public:
@@ -350,6 +372,45 @@ BENCHMARK_F(PerformanceTestExecutorSimple, spin_until_future_complete)(benchmark
   }
 }
 
+BENCHMARK_DEFINE_F(
+  PerformanceTestExecutorSimple,
+  single_thread_executor_dispatch_per_callback_group)(benchmark::State & st)
+{
+  const auto number_of_groups = static_cast<size_t>(st.range(0));
+  std::vector<rclcpp::CallbackGroup::SharedPtr> callback_groups;
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  int64_t callback_count = 0;
+  for (size_t i = 0u; i < number_of_groups; i++) {
+    callback_groups.push_back(
+      node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive));
+    // A zero period keeps every timer ready, so each wait yields one executable per group.
+    timers.push_back(
+      node->create_wall_timer(0ms, [&callback_count]() {callback_count++;}, callback_groups[i]));
+  }
+  DispatchExecutor executor;
+  executor.add_node(node);
+
+  reset_heap_counters();
+
+  for (auto _ : st) {
+    // Only the selection and execution of the ready timers is measured, not the wait itself.
+    st.PauseTiming();
+    executor.wait_for_ready_work();
+    st.ResumeTiming();
+
+    while (executor.dispatch_next()) {
+    }
+  }
+  if (callback_count == 0) {
+    st.SkipWithError("No timer was executed");
+  }
+  // Report the throughput per dispatched callback, so that it can be compared across group counts.
+  st.SetItemsProcessed(callback_count);
+}
+BENCHMARK_REGISTER_F(
+  PerformanceTestExecutorSimple,
+  single_thread_executor_dispatch_per_callback_group)->Arg(1)->Arg(10)->Arg(100);
+
 BENCHMARK_F(
   PerformanceTestExecutorSimple,
   static_executor_entities_collector_execute)(benchmark::State & st)
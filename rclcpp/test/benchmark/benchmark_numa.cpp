@@ -0,0 +1,95 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/numa.hpp"
+
+using performance_test_fixture::PerformanceTest;
+
+// Large enough to not fit in the caches, like a point cloud or an image.
+constexpr size_t data_size = 64 * 1024 * 1024;
+
+/// Cost of consuming data produced on the same or on another NUMA node.
+/**
+ * On a machine with a single NUMA node, two nodes are simulated, so both
+ * cases should perform the same.
+ */
+class PerformanceTestNuma : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state) override
+  {
+    topology = std::make_unique<rclcpp::NumaTopology>(rclcpp::NumaTopology::detect());
+    if (topology->get_node_count() < 2) {
+      topology = std::make_unique<rclcpp::NumaTopology>(rclcpp::NumaTopology::simulate(2));
+    }
+    state.counters["simulated"] = topology->is_simulated();
+
+    // Produce the data on NUMA node 0.
+    std::thread producer(
+      [this]() {
+        topology->bind_current_thread(0);
+        data = static_cast<uint64_t *>(
+          rclcpp::numa_allocate(data_size, topology->get_memory_node(0)));
+        std::memset(data, 1, data_size);
+      });
+    producer.join();
+    PerformanceTest::SetUp(state);
+  }
+
+  void TearDown(benchmark::State & state) override
+  {
+    PerformanceTest::TearDown(state);
+    rclcpp::numa_deallocate(data);
+  }
+
+  /// Read all the data from a thread bound to the given NUMA node.
+  void
+  consume_on(benchmark::State & state, size_t numa_node)
+  {
+    std::thread consumer(
+      [this, &state, numa_node]() {
+        topology->bind_current_thread(numa_node);
+        for (auto _ : state) {
+          uint64_t sum = 0;
+          for (size_t i = 0; i < data_size / sizeof(uint64_t); ++i) {
+            sum += data[i];
+          }
+          benchmark::DoNotOptimize(sum);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data_size));
+      });
+    consumer.join();
+  }
+
+protected:
+  std::unique_ptr<rclcpp::NumaTopology> topology;
+  uint64_t * data = nullptr;
+};
+
+BENCHMARK_F(PerformanceTestNuma, consume_on_same_numa_node)(benchmark::State & state)
+{
+  consume_on(state, 0);
+}
+
+BENCHMARK_F(PerformanceTestNuma, consume_on_other_numa_node)(benchmark::State & state)
+{
+  consume_on(state, 1);
+}
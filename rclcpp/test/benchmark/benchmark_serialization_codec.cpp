@@ -0,0 +1,107 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/serialization_codec.hpp"
+
+using performance_test_fixture::PerformanceTest;
+
+constexpr size_t data_size = 1024 * 1024;
+
+class PerformanceTestSerializationCodec : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & state) override
+  {
+    // Occupancy grid like data: long runs of a few values, with some noise.
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> run_length(1, 200);
+    std::uniform_int_distribution<int> value(0, 3);
+    compressible_data.clear();
+    while (compressible_data.size() < data_size) {
+      compressible_data.insert(
+        compressible_data.end(), run_length(generator), static_cast<uint8_t>(value(generator)));
+    }
+    compressible_data.resize(data_size);
+
+    std::uniform_int_distribution<int> byte(0, 255);
+    random_data.resize(data_size);
+    for (auto & b : random_data) {
+      b = static_cast<uint8_t>(byte(generator));
+    }
+
+    encoded.resize(codec.get_max_encoded_size(data_size));
+    decoded.resize(data_size);
+    PerformanceTest::SetUp(state);
+  }
+
+  void
+  encode(benchmark::State & state, const std::vector<uint8_t> & data)
+  {
+    size_t encoded_size = 0;
+    for (auto _ : state) {
+      encoded_size = codec.encode(data.data(), data.size(), encoded.data());
+      benchmark::DoNotOptimize(encoded_size);
+      benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    // Bytes saved on the wire, to weigh against the time spent encoding.
+    state.counters["encoded_size"] = static_cast<double>(encoded_size);
+    state.counters["bytes_saved"] = static_cast<double>(data.size()) - encoded_size;
+  }
+
+  void
+  decode(benchmark::State & state, const std::vector<uint8_t> & data)
+  {
+    const size_t encoded_size = codec.encode(data.data(), data.size(), encoded.data());
+    for (auto _ : state) {
+      codec.decode(encoded.data(), encoded_size, decoded.data(), decoded.size());
+      benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+  }
+
+  rclcpp::LZCodec codec;
+  std::vector<uint8_t> compressible_data;
+  std::vector<uint8_t> random_data;
+  std::vector<uint8_t> encoded;
+  std::vector<uint8_t> decoded;
+};
+
+BENCHMARK_F(PerformanceTestSerializationCodec, lz_encode_compressible)(benchmark::State & st)
+{
+  encode(st, compressible_data);
+}
+
+BENCHMARK_F(PerformanceTestSerializationCodec, lz_decode_compressible)(benchmark::State & st)
+{
+  decode(st, compressible_data);
+}
+
+BENCHMARK_F(PerformanceTestSerializationCodec, lz_encode_random)(benchmark::State & st)
+{
+  // The worst case, in which encoding costs time without saving any bytes.
+  encode(st, random_data);
+}
+
+BENCHMARK_F(PerformanceTestSerializationCodec, lz_decode_random)(benchmark::State & st)
+{
+  decode(st, random_data);
+}
@@ -0,0 +1,127 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/wait_set.hpp"
+#include "test_msgs/msg/empty.hpp"
+
+using namespace std::chrono_literals;
+using performance_test_fixture::PerformanceTest;
+
+constexpr size_t kNumberOfEntities = 10;
+
+using BenchmarkStaticWaitSet =
+  rclcpp::StaticWaitSet<kNumberOfEntities, kNumberOfEntities, 0, 0, 0, 0>;
+
+class PerformanceTestWaitSet : public PerformanceTest
+{
+public:
+  void SetUp(benchmark::State & st)
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("my_node");
+    for (size_t i = 0u; i < kNumberOfEntities; i++) {
+      subscriptions[i] = node->create_subscription<test_msgs::msg::Empty>(
+        "/empty_msgs_" + std::to_string(i), rclcpp::QoS(10),
+        [](test_msgs::msg::Empty::SharedPtr) {});
+      guard_conditions[i] = std::make_shared<rclcpp::GuardCondition>();
+    }
+    PerformanceTest::SetUp(st);
+  }
+
+  void TearDown(benchmark::State & st)
+  {
+    PerformanceTest::TearDown(st);
+    for (size_t i = 0u; i < kNumberOfEntities; i++) {
+      subscriptions[i].reset();
+      guard_conditions[i].reset();
+    }
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+  void add_entities(rclcpp::WaitSet & wait_set)
+  {
+    for (size_t i = 0u; i < kNumberOfEntities; i++) {
+      wait_set.add_subscription(subscriptions[i]);
+      wait_set.add_guard_condition(guard_conditions[i]);
+    }
+  }
+
+  rclcpp::Node::SharedPtr node;
+  std::array<rclcpp::SubscriptionBase::SharedPtr, kNumberOfEntities> subscriptions;
+  std::array<rclcpp::GuardCondition::SharedPtr, kNumberOfEntities> guard_conditions;
+};
+
+BENCHMARK_F(PerformanceTestWaitSet, static_wait_set_wait)(benchmark::State & st)
+{
+  std::array<BenchmarkStaticWaitSet::SubscriptionEntry, kNumberOfEntities> subscription_entries;
+  for (size_t i = 0u; i < kNumberOfEntities; i++) {
+    subscription_entries[i] = subscriptions[i];
+  }
+  BenchmarkStaticWaitSet wait_set(subscription_entries, guard_conditions, {}, {}, {}, {});
+
+  reset_heap_counters();
+
+  for (auto _ : st) {
+    auto wait_result = wait_set.wait(0ms);
+    if (wait_result.kind() != rclcpp::WaitResultKind::Timeout) {
+      st.SkipWithError("wait unexpectedly did not time out");
+      break;
+    }
+  }
+}
+
+BENCHMARK_F(PerformanceTestWaitSet, wait_set_wait)(benchmark::State & st)
+{
+  rclcpp::WaitSet wait_set;
+  add_entities(wait_set);
+
+  reset_heap_counters();
+
+  for (auto _ : st) {
+    auto wait_result = wait_set.wait(0ms);
+    if (wait_result.kind() != rclcpp::WaitResultKind::Timeout) {
+      st.SkipWithError("wait unexpectedly did not time out");
+      break;
+    }
+  }
+}
+
+BENCHMARK_F(PerformanceTestWaitSet, wait_set_wait_after_change)(benchmark::State & st)
+{
+  rclcpp::WaitSet wait_set;
+  add_entities(wait_set);
+  auto extra_guard_condition = std::make_shared<rclcpp::GuardCondition>();
+
+  reset_heap_counters();
+
+  for (auto _ : st) {
+    // Changing the wait set forces a full rebuild on the next wait.
+    wait_set.add_guard_condition(extra_guard_condition);
+    wait_set.remove_guard_condition(extra_guard_condition);
+    auto wait_result = wait_set.wait(0ms);
+    if (wait_result.kind() != rclcpp::WaitResultKind::Timeout) {
+      st.SkipWithError("wait unexpectedly did not time out");
+      break;
+    }
+  }
+}
@@ -14,15 +14,23 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/node.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp/executors.hpp"
 
+#include "test_msgs/msg/basic_types.hpp"
+
 using namespace std::chrono_literals;
 
 class TestMultiThreadedExecutor : public ::testing::Test
@@ -97,3 +105,78 @@ TEST_F(TestMultiThreadedExecutor, timer_over_take) {
   executor.add_node(node);
   executor.spin();
 }
+
+/*
+   Test that the callbacks of a key ordered callback group run one at a time, and in order,
+   for each key, while the callbacks for different keys run at the same time.
+ */
+TEST_F(TestMultiThreadedExecutor, key_ordered_callback_group) {
+  rclcpp::executors::MultiThreadedExecutor executor(rclcpp::ExecutorOptions(), 4u);
+  ASSERT_GT(executor.get_number_of_threads(), 1u);
+
+  auto node = std::make_shared<rclcpp::Node>("test_multi_threaded_executor_key_ordered");
+  auto cbg = node->create_callback_group(rclcpp::CallbackGroupType::KeyOrdered);
+
+  constexpr int32_t number_of_keys = 4;
+  constexpr int32_t number_of_messages = 100;
+  std::mutex mutex;
+  std::vector<std::vector<int32_t>> received(number_of_keys);
+  std::vector<bool> running(number_of_keys, false);
+  bool overlapped = false;
+  std::atomic_int received_count {0};
+
+  rclcpp::SubscriptionOptions options;
+  options.callback_group = cbg;
+  auto subscription = node->create_subscription<test_msgs::msg::BasicTypes>(
+    "key_ordered", rclcpp::QoS(number_of_messages),
+    [&](test_msgs::msg::BasicTypes::ConstSharedPtr message) {
+      const size_t key = static_cast<size_t>(message->int32_value % number_of_keys);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        overlapped = overlapped || running[key];
+        running[key] = true;
+      }
+      // Leave time for other threads to run a callback with the same key, if they could.
+      std::this_thread::sleep_for(1ms);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        running[key] = false;
+        received[key].push_back(message->int32_value);
+      }
+      received_count++;
+    },
+    options);
+  subscription->set_ordering_key_function(
+    [](const test_msgs::msg::BasicTypes & message) {
+      return static_cast<std::size_t>(message.int32_value % number_of_keys);
+    });
+  auto publisher = node->create_publisher<test_msgs::msg::BasicTypes>(
+    "key_ordered", rclcpp::QoS(number_of_messages));
+
+  executor.add_node(node);
+  std::thread spinner([&executor]() {executor.spin();});
+
+  auto end = std::chrono::steady_clock::now() + 10s;
+  while (publisher->get_subscription_count() == 0 && std::chrono::steady_clock::now() < end) {
+    std::this_thread::sleep_for(10ms);
+  }
+  test_msgs::msg::BasicTypes message;
+  for (int32_t i = 0; i < number_of_messages; ++i) {
+    message.int32_value = i;
+    publisher->publish(message);
+  }
+  while (received_count < number_of_messages && std::chrono::steady_clock::now() < end) {
+    std::this_thread::sleep_for(10ms);
+  }
+  executor.cancel();
+  spinner.join();
+
+  EXPECT_EQ(number_of_messages, received_count.load());
+  EXPECT_FALSE(overlapped);
+  for (int32_t key = 0; key < number_of_keys; ++key) {
+    const auto & values = received[static_cast<size_t>(key)];
+    for (size_t i = 1; i < values.size(); ++i) {
+      EXPECT_LT(values[i - 1], values[i]);
+    }
+  }
+}
@@ -0,0 +1,115 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "rclcpp/executors.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+class TestNumaExecutor : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestNumaExecutor, callback_groups_run_on_their_numa_node) {
+  rclcpp::executors::NumaExecutor executor(rclcpp::NumaTopology::simulate(2), 1);
+  const auto & topology = executor.get_numa_topology();
+  ASSERT_EQ(2u, topology.get_node_count());
+
+  auto node = std::make_shared<rclcpp::Node>("test_numa_executor");
+  std::atomic_int counts[3] = {{0}, {0}, {0}};
+  std::atomic_bool wrong_cpu(false);
+  auto make_callback = [&](size_t numa_node, size_t index) {
+      return [&, numa_node, index]() {
+#if defined(__linux__)
+               const auto & cpus = topology.get_cpus(numa_node);
+               if (std::find(cpus.begin(), cpus.end(), sched_getcpu()) == cpus.end()) {
+                 wrong_cpu.store(true);
+               }
+#else
+               (void)numa_node;
+#endif
+               if (++counts[index] >= 5 && counts[0] >= 5 && counts[1] >= 5 && counts[2] >= 5) {
+                 executor.cancel();
+               }
+             };
+    };
+
+  // The default callback group goes with the node.
+  auto default_timer = node->create_wall_timer(1ms, make_callback(0, 0));
+  auto group_0 = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+  auto timer_0 = node->create_wall_timer(1ms, make_callback(0, 1), group_0);
+  auto group_1 = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+  auto timer_1 = node->create_wall_timer(1ms, make_callback(1, 2), group_1);
+
+  executor.add_node(node, 0);
+  executor.add_callback_group(group_0, node->get_node_base_interface(), 0);
+  executor.add_callback_group(group_1, node->get_node_base_interface(), 1);
+  EXPECT_THROW(
+    executor.add_callback_group(group_1, node->get_node_base_interface(), 2), std::out_of_range);
+
+  std::thread watchdog(
+    [&executor, &counts]() {
+      const auto start = std::chrono::steady_clock::now();
+      while (counts[2] < 5 && std::chrono::steady_clock::now() - start < 10s) {
+        std::this_thread::sleep_for(10ms);
+      }
+      // Stop the test if a NUMA node doesn't execute its callbacks.
+      std::this_thread::sleep_for(1s);
+      executor.cancel();
+    });
+  executor.spin();
+  watchdog.join();
+
+  EXPECT_GE(counts[0], 5);
+  EXPECT_GE(counts[1], 5);
+  EXPECT_GE(counts[2], 5);
+  EXPECT_FALSE(wrong_cpu.load());
+
+  executor.remove_callback_group(group_1);
+  EXPECT_THROW(executor.remove_callback_group(group_1), std::runtime_error);
+  executor.remove_node(node);
+  EXPECT_THROW(executor.remove_node(node), std::runtime_error);
+}
+
+#if defined(__linux__)
+TEST_F(TestNumaExecutor, failed_binding_cancels_all_numa_nodes) {
+  // No thread can be bound to a CPU which doesn't exist, so the thread of the
+  // second NUMA node fails, possibly before the first one starts spinning.
+  rclcpp::executors::NumaExecutor executor(rclcpp::NumaTopology({{0}, {1000}}, {-1, -1}), 1);
+  auto node = std::make_shared<rclcpp::Node>("test_numa_executor_failed_binding");
+  executor.add_node(node, 0);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_THROW(executor.spin(), std::runtime_error);
+  }
+}
+#endif
@@ -0,0 +1,124 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/executors/static_wait_set_executor.hpp"
+
+#include "test_msgs/msg/empty.hpp"
+
+#include "../../utils/rclcpp_gtest_macros.hpp"
+
+using namespace std::chrono_literals;
+
+class TestStaticWaitSetExecutor : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    rclcpp::init(0, nullptr);
+    node = std::make_shared<rclcpp::Node>("node", "ns");
+  }
+
+  void TearDown()
+  {
+    node.reset();
+    rclcpp::shutdown();
+  }
+
+  rclcpp::Node::SharedPtr node;
+};
+
+using TimerOnlyExecutor = rclcpp::executors::StaticWaitSetExecutor<0, 0, 1, 0, 0, 0>;
+
+TEST_F(TestStaticWaitSetExecutor, nullptr_entity) {
+  RCLCPP_EXPECT_THROW_EQ(
+    TimerOnlyExecutor({}, {}, {nullptr}, {}, {}, {}),
+    std::runtime_error("unexpected condition, fixed storage policy needs pruning"));
+}
+
+TEST_F(TestStaticWaitSetExecutor, spin_once_timer) {
+  int timer_count = 0;
+  auto timer = node->create_wall_timer(1ms, [&timer_count]() {timer_count++;});
+  TimerOnlyExecutor executor({}, {}, {timer}, {}, {}, {});
+
+  executor.spin_once(1s);
+  EXPECT_EQ(1, timer_count);
+}
+
+TEST_F(TestStaticWaitSetExecutor, spin_once_subscription) {
+  int message_count = 0;
+  auto publisher = node->create_publisher<test_msgs::msg::Empty>("topic", 10);
+  auto subscription = node->create_subscription<test_msgs::msg::Empty>(
+    "topic", 10, [&message_count](test_msgs::msg::Empty::SharedPtr) {message_count++;});
+  rclcpp::executors::StaticWaitSetExecutor<1, 0, 0, 0, 0, 0> executor(
+    {subscription}, {}, {}, {}, {}, {});
+
+  // Nothing is ready yet.
+  executor.spin_once(10ms);
+  EXPECT_EQ(0, message_count);
+
+  publisher->publish(test_msgs::msg::Empty());
+  auto start = std::chrono::steady_clock::now();
+  while (message_count == 0 && std::chrono::steady_clock::now() - start < 10s) {
+    executor.spin_once(100ms);
+  }
+  EXPECT_EQ(1, message_count);
+}
+
+TEST_F(TestStaticWaitSetExecutor, guard_condition_wakes_up) {
+  auto guard_condition = std::make_shared<rclcpp::GuardCondition>();
+  rclcpp::executors::StaticWaitSetExecutor<0, 1, 0, 0, 0, 0> executor(
+    {}, {guard_condition}, {}, {}, {}, {});
+
+  guard_condition->trigger();
+  auto start = std::chrono::steady_clock::now();
+  executor.spin_once(10s);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 10s);
+}
+
+TEST_F(TestStaticWaitSetExecutor, spin_and_cancel) {
+  std::atomic<int> timer_count{0};
+  auto timer = node->create_wall_timer(1ms, [&timer_count]() {timer_count++;});
+  TimerOnlyExecutor executor({}, {}, {timer}, {}, {}, {});
+
+  std::thread spinner([&executor]() {executor.spin();});
+  while (timer_count < 5) {
+    std::this_thread::sleep_for(1ms);
+  }
+  RCLCPP_EXPECT_THROW_EQ(
+    executor.spin_once(0ms),
+    std::runtime_error("spin_once() called while already spinning"));
+  executor.cancel();
+  spinner.join();
+  EXPECT_GE(timer_count, 5);
+}
+
+TEST_F(TestStaticWaitSetExecutor, spin_stops_on_shutdown) {
+  auto guard_condition = std::make_shared<rclcpp::GuardCondition>();
+  rclcpp::executors::StaticWaitSetExecutor<0, 1, 0, 0, 0, 0> executor(
+    {}, {guard_condition}, {}, {}, {}, {});
+
+  std::thread spinner([&executor]() {executor.spin();});
+  std::this_thread::sleep_for(10ms);
+  rclcpp::shutdown();
+  spinner.join();
+}
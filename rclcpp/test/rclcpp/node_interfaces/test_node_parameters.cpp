@@ -21,12 +21,14 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cstdio>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "rclcpp/node.hpp"
 #include "rclcpp/node_interfaces/node_parameters.hpp"
+#include "rclcpp/parameter_snapshot.hpp"
 
 #include "../../mocking_utils/patch.hpp"
 #include "../../utils/rclcpp_gtest_macros.hpp"
@@ -199,3 +201,103 @@ TEST_F(TestNodeParameters, add_remove_parameters_callback) {
     node_parameters->remove_on_set_parameters_callback(handle.get()),
     std::runtime_error("Callback doesn't exist"));
 }
+
+#if !defined(_WIN32)
+TEST_F(TestNodeParameters, parameter_snapshot) {
+  const std::string snapshot_file = ::testing::TempDir() + "test_node_parameters_snapshot";
+  std::remove(snapshot_file.c_str());
+
+  rclcpp::NodeOptions node_options;
+  node_options.parameter_snapshot_file(snapshot_file);
+  node_options.append_parameter_override("overridden", 1);
+  node_options.append_parameter_override("changed_type", 2);
+  {
+    auto node2 = std::make_shared<rclcpp::Node>("node2", "ns", node_options);
+    EXPECT_EQ(1, node2->declare_parameter("overridden", 0));
+    EXPECT_EQ(2, node2->declare_parameter("changed_type", 0));
+    node2->declare_parameter("removed", "value");
+    EXPECT_TRUE(node2->set_parameter(rclcpp::Parameter("overridden", 10)).successful);
+    EXPECT_TRUE(node2->set_parameter(rclcpp::Parameter("changed_type", 20)).successful);
+    node2->undeclare_parameter("removed");
+  }
+
+  // On restart, the parameters keep the values they had when the node was destroyed.
+  auto node2 = std::make_shared<rclcpp::Node>("node2", "ns", node_options);
+  EXPECT_FALSE(node2->has_parameter("removed"));
+  // Not parameters of the node until declared again.
+  EXPECT_FALSE(node2->has_parameter("overridden"));
+  const auto names = node2->list_parameters({}, 0).names;
+  EXPECT_EQ(names.end(), std::find(names.begin(), names.end(), "overridden"));
+  EXPECT_EQ(10, node2->declare_parameter("overridden", 0));
+  EXPECT_TRUE(node2->has_parameter("overridden"));
+  // Unless they are not declared the same way anymore, using the overrides instead.
+  EXPECT_EQ(
+    rclcpp::ParameterValue(2),
+    node2->declare_parameter("changed_type", rclcpp::ParameterValue("default")));
+  EXPECT_EQ(2u, node2->get_node_parameters_interface()->get_parameter_overrides().size());
+  EXPECT_THROW(
+    node2->declare_parameter("overridden", 0),
+    rclcpp::exceptions::ParameterAlreadyDeclaredException);
+}
+
+TEST_F(TestNodeParameters, parameter_snapshot_rewritten_on_restart) {
+  const std::string snapshot_file = ::testing::TempDir() + "test_node_parameters_snapshot_full";
+  std::remove(snapshot_file.c_str());
+
+  // A snapshot with a nearly full log, which cannot hold a record for each restored parameter.
+  const int parameter_count = 20;
+  size_t size = 0;
+  {
+    rclcpp::ParameterSnapshot snapshot(snapshot_file, "/ns/node2");
+    rclcpp::ParameterSnapshot::ParameterInfos parameters;
+    for (int i = 0; i < parameter_count; ++i) {
+      parameters["p" + std::to_string(i)].value = rclcpp::ParameterValue(100 + i);
+    }
+    parameters["undeclared"].value = rclcpp::ParameterValue(0);
+    snapshot.write(parameters);
+    size = snapshot.get_size();
+    size_t record_size = 0;
+    for (int i = 1; snapshot.get_capacity() - size > 3 * record_size; ++i) {
+      parameters["undeclared"].value = rclcpp::ParameterValue(i);
+      ASSERT_FALSE(snapshot.update("undeclared", parameters));
+      record_size = snapshot.get_size() - size;
+      size = snapshot.get_size();
+    }
+  }
+
+  rclcpp::NodeOptions node_options;
+  node_options.parameter_snapshot_file(snapshot_file);
+  rcl_interfaces::msg::ParameterDescriptor descriptor;
+  descriptor.description = "declared";
+  {
+    // Declared with another descriptor, so that each declaration appends a record.
+    auto node2 = std::make_shared<rclcpp::Node>("node2", "ns", node_options);
+    for (int i = 0; i < parameter_count; ++i) {
+      EXPECT_EQ(100 + i, node2->declare_parameter("p" + std::to_string(i), 0, descriptor));
+    }
+  }
+  {
+    // The log was rewritten, keeping the parameters not declared again at that point.
+    rclcpp::ParameterSnapshot snapshot(snapshot_file, "/ns/node2");
+    rclcpp::ParameterSnapshot::ParameterInfos loaded;
+    ASSERT_TRUE(snapshot.load(loaded));
+    EXPECT_LT(snapshot.get_size(), size);
+    ASSERT_EQ(1u, loaded.count("undeclared"));
+    EXPECT_GT(loaded["undeclared"].value.get<int64_t>(), 0);
+    size = snapshot.get_size();
+  }
+
+  {
+    auto node2 = std::make_shared<rclcpp::Node>("node2", "ns", node_options);
+    for (int i = 0; i < parameter_count; ++i) {
+      EXPECT_EQ(100 + i, node2->declare_parameter("p" + std::to_string(i), 0, descriptor));
+    }
+  }
+  // Parameters declared as they were restored are not recorded again.
+  rclcpp::ParameterSnapshot snapshot(snapshot_file, "/ns/node2");
+  rclcpp::ParameterSnapshot::ParameterInfos loaded;
+  ASSERT_TRUE(snapshot.load(loaded));
+  EXPECT_EQ(size, snapshot.get_size());
+  EXPECT_EQ(1u, loaded.count("undeclared"));
+}
+#endif
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <list>
 #include <map>
 #include <memory>
@@ -681,6 +682,40 @@ TEST_F(TestAllocatorMemoryStrategy, get_next_timer) {
   EXPECT_TRUE(TestGetNextEntity(node1, node2, get_next_entity));
 }
 
+TEST_F(TestAllocatorMemoryStrategy, get_next_timer_from_many_groups) {
+  auto node = create_node_with_disabled_callback_groups("node");
+  auto node_base = node->get_node_base_interface();
+  WeakCallbackGroupsToNodesMap weak_groups_to_nodes;
+  std::vector<rclcpp::CallbackGroup::SharedPtr> groups;
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  constexpr size_t number_of_groups = 5u;
+  for (size_t i = 0u; i < number_of_groups; ++i) {
+    auto callback_group =
+      node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+    timers.push_back(node->create_wall_timer(std::chrono::seconds(10), []() {}, callback_group));
+    groups.push_back(callback_group);
+    weak_groups_to_nodes.insert(
+      std::pair<rclcpp::CallbackGroup::WeakPtr,
+      rclcpp::node_interfaces::NodeBaseInterface::WeakPtr>(callback_group, node_base));
+  }
+  allocator_memory_strategy()->collect_entities(weak_groups_to_nodes);
+  EXPECT_EQ(number_of_groups, allocator_memory_strategy()->number_of_ready_timers());
+
+  // Every timer must be returned together with the group it was created in.
+  for (size_t i = 0u; i < number_of_groups; ++i) {
+    rclcpp::AnyExecutable result;
+    allocator_memory_strategy()->get_next_timer(result, weak_groups_to_nodes);
+    ASSERT_NE(nullptr, result.timer);
+    auto timer_it = std::find(timers.begin(), timers.end(), result.timer);
+    ASSERT_NE(timers.end(), timer_it);
+    EXPECT_EQ(groups[static_cast<size_t>(timer_it - timers.begin())], result.callback_group);
+    EXPECT_EQ(node_base, result.node_base);
+  }
+  rclcpp::AnyExecutable result;
+  allocator_memory_strategy()->get_next_timer(result, weak_groups_to_nodes);
+  EXPECT_EQ(nullptr, result.timer);
+}
+
 TEST_F(TestAllocatorMemoryStrategy, get_next_waitable) {
   auto node1 = std::make_shared<rclcpp::Node>("waitable_node", "ns");
   auto node2 = std::make_shared<rclcpp::Node>("waitable_node2", "ns");
@@ -165,6 +165,8 @@ TEST_F(TestAnySubscriptionCallback, set_dispatch_unique_ptr) {
 
   any_subscription_callback_.set(unique_ptr_callback);
 
+  EXPECT_TRUE(any_subscription_callback_.use_take_unique_method());
+
   // Message is copied into unique_ptr
   EXPECT_NO_THROW(any_subscription_callback_.dispatch(msg_shared_ptr_, message_info_));
   EXPECT_EQ(callback_count, 1);
@@ -178,6 +180,11 @@ TEST_F(TestAnySubscriptionCallback, set_dispatch_unique_ptr) {
   EXPECT_NO_THROW(
     any_subscription_callback_.dispatch_intra_process(std::move(msg_unique_ptr_), message_info_));
   EXPECT_EQ(callback_count, 2);
+
+  EXPECT_NO_THROW(
+    any_subscription_callback_.dispatch(
+      std::make_unique<test_msgs::msg::Empty>(), message_info_));
+  EXPECT_EQ(callback_count, 3);
 }
 
 TEST_F(TestAnySubscriptionCallback, set_dispatch_unique_ptr_w_info) {
@@ -203,3 +210,22 @@ TEST_F(TestAnySubscriptionCallback, set_dispatch_unique_ptr_w_info) {
     any_subscription_callback_.dispatch_intra_process(std::move(msg_unique_ptr_), message_info_));
   EXPECT_EQ(callback_count, 2);
 }
+
+TEST_F(TestAnySubscriptionCallback, set_replaces_callback) {
+  int shared_callback_count = 0;
+  int unique_callback_count = 0;
+  any_subscription_callback_.set(
+    [&shared_callback_count](const std::shared_ptr<test_msgs::msg::Empty>) {
+      shared_callback_count++;
+    });
+  any_subscription_callback_.set(
+    [&unique_callback_count](std::unique_ptr<test_msgs::msg::Empty>) {
+      unique_callback_count++;
+    });
+  EXPECT_TRUE(any_subscription_callback_.use_take_unique_method());
+  EXPECT_FALSE(any_subscription_callback_.use_take_shared_method());
+
+  EXPECT_NO_THROW(any_subscription_callback_.dispatch(msg_shared_ptr_, message_info_));
+  EXPECT_EQ(0, shared_callback_count);
+  EXPECT_EQ(1, unique_callback_count);
+}
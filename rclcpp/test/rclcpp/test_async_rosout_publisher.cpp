@@ -0,0 +1,155 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rcl_interfaces/msg/log.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+class TestAsyncRosoutPublisher : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+protected:
+  void SetUp()
+  {
+    listener = std::make_shared<rclcpp::Node>("test_async_rosout_listener");
+    subscription = listener->create_subscription<rcl_interfaces::msg::Log>(
+      "/rosout", rclcpp::RosoutQoS().keep_last(10000),
+      [this](rcl_interfaces::msg::Log::SharedPtr log) {
+        if (log->name == logger_name) {
+          logs.push_back(*log);
+        }
+      });
+  }
+
+  template<typename ConditionT>
+  void
+  spin_until(ConditionT condition)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    while (!condition() && std::chrono::steady_clock::now() - start < 10s) {
+      rclcpp::spin_some(listener);
+      std::this_thread::sleep_for(10ms);
+    }
+  }
+
+  /// Wait until the subscription is matched with the publisher of the node.
+  void
+  wait_for_rosout_publisher(const rclcpp::Node::SharedPtr & node)
+  {
+    logger_name = node->get_logger().get_name();
+    spin_until([this]() {return subscription->get_publisher_count() >= 2;});
+  }
+
+  rclcpp::Node::SharedPtr listener;
+  rclcpp::Subscription<rcl_interfaces::msg::Log>::SharedPtr subscription;
+  std::string logger_name;
+  std::vector<rcl_interfaces::msg::Log> logs;
+};
+
+TEST_F(TestAsyncRosoutPublisher, synchronous_by_default) {
+  auto node = std::make_shared<rclcpp::Node>("test_sync_rosout");
+  EXPECT_EQ(nullptr, node->get_node_logging_interface()->get_async_rosout_publisher());
+
+  auto options = rclcpp::NodeOptions().async_rosout(true).enable_rosout(false);
+  auto node_without_rosout = std::make_shared<rclcpp::Node>("test_no_rosout", options);
+  EXPECT_EQ(
+    nullptr, node_without_rosout->get_node_logging_interface()->get_async_rosout_publisher());
+}
+
+TEST_F(TestAsyncRosoutPublisher, log_records_published) {
+  auto node = std::make_shared<rclcpp::Node>(
+    "test_async_rosout", rclcpp::NodeOptions().async_rosout(true));
+  auto publisher = node->get_node_logging_interface()->get_async_rosout_publisher();
+  ASSERT_NE(nullptr, publisher);
+  EXPECT_EQ(node->get_logger().get_name(), publisher->get_logger_name());
+  wait_for_rosout_publisher(node);
+
+  RCLCPP_INFO(node->get_logger(), "message %d", 1);
+  RCLCPP_WARN(node->get_logger(), "message %s", "2");
+  // Records of other loggers aren't published by the node.
+  RCLCPP_INFO(node->get_logger().get_child("child"), "message of a child logger");
+
+  spin_until([this]() {return logs.size() >= 2;});
+  ASSERT_EQ(2u, logs.size());
+  EXPECT_EQ("message 1", logs[0].msg);
+  EXPECT_EQ(rcl_interfaces::msg::Log::INFO, logs[0].level);
+  EXPECT_EQ(std::string(__FILE__), logs[0].file);
+  EXPECT_EQ("message 2", logs[1].msg);
+  EXPECT_EQ(rcl_interfaces::msg::Log::WARN, logs[1].level);
+
+  // The records may be received before the publisher counts them.
+  spin_until([&publisher]() {return publisher->get_statistics().published_count >= 2;});
+  const auto statistics = publisher->get_statistics();
+  EXPECT_EQ(2u, statistics.published_count);
+  EXPECT_EQ(0u, statistics.dropped_count);
+  EXPECT_GE(statistics.max_batch_size, 1u);
+}
+
+TEST_F(TestAsyncRosoutPublisher, dropped_log_records_counted) {
+  auto node = std::make_shared<rclcpp::Node>(
+    "test_async_rosout_drops",
+    rclcpp::NodeOptions().async_rosout(true).async_rosout_queue_depth(2));
+  auto publisher = node->get_node_logging_interface()->get_async_rosout_publisher();
+  ASSERT_NE(nullptr, publisher);
+  wait_for_rosout_publisher(node);
+
+  const size_t log_count = 1000;
+  for (size_t i = 0; i < log_count; ++i) {
+    RCLCPP_INFO(node->get_logger(), "burst %zu", i);
+  }
+
+  spin_until(
+    [&publisher, log_count]() {
+      const auto statistics = publisher->get_statistics();
+      return statistics.published_count + statistics.dropped_count >= log_count;
+    });
+  const auto statistics = publisher->get_statistics();
+  EXPECT_EQ(log_count, statistics.published_count + statistics.dropped_count);
+  EXPECT_LE(statistics.max_batch_size, 2u);
+
+  if (statistics.dropped_count > 0) {
+    // The drops are reported on /rosout too.
+    auto find_warning = [this]() {
+        for (const auto & log : logs) {
+          if (log.level == rcl_interfaces::msg::Log::WARN) {
+            return &log;
+          }
+        }
+        return static_cast<const rcl_interfaces::msg::Log *>(nullptr);
+      };
+    spin_until([&find_warning]() {return find_warning() != nullptr;});
+    const auto warning = find_warning();
+    ASSERT_NE(nullptr, warning);
+    EXPECT_NE(std::string::npos, warning->msg.find("dropped"));
+  }
+}
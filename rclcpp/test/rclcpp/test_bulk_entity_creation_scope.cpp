@@ -0,0 +1,134 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "rclcpp/bulk_entity_creation_scope.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "../mocking_utils/patch.hpp"
+
+using namespace std::chrono_literals;
+
+class TestBulkEntityCreationScope : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+protected:
+  void SetUp()
+  {
+    node = std::make_shared<rclcpp::Node>("test_bulk_entity_creation_scope");
+    node_base = node->get_node_base_interface();
+  }
+
+  rclcpp::Node::SharedPtr node;
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base;
+};
+
+TEST_F(TestBulkEntityCreationScope, notifications_not_coalesced_without_executor) {
+  EXPECT_EQ(RCL_RET_OK, node_base->trigger_notify_guard_condition());
+  auto mock = mocking_utils::patch_and_return(
+    "lib:rclcpp", rcl_trigger_guard_condition, RCL_RET_ERROR);
+  EXPECT_EQ(RCL_RET_ERROR, node_base->trigger_notify_guard_condition());
+  rcutils_reset_error();
+}
+
+TEST_F(TestBulkEntityCreationScope, notifications_coalesced_until_consumed) {
+  node_base->get_associated_with_executor_atomic().store(true);
+  EXPECT_EQ(RCL_RET_OK, node_base->trigger_notify_guard_condition());
+  {
+    auto mock = mocking_utils::patch_and_return(
+      "lib:rclcpp", rcl_trigger_guard_condition, RCL_RET_ERROR);
+    // The notification is still pending, so the guard condition isn't triggered again.
+    EXPECT_EQ(RCL_RET_OK, node_base->trigger_notify_guard_condition());
+    node_base->consume_notify_guard_condition();
+    EXPECT_EQ(RCL_RET_ERROR, node_base->trigger_notify_guard_condition());
+    rcutils_reset_error();
+  }
+  // A failed notification isn't pending.
+  EXPECT_EQ(RCL_RET_OK, node_base->trigger_notify_guard_condition());
+  node_base->get_associated_with_executor_atomic().store(false);
+}
+
+TEST_F(TestBulkEntityCreationScope, notifications_deferred) {
+  EXPECT_THROW(node_base->resume_notify_guard_condition(), std::runtime_error);
+
+  auto mock = mocking_utils::patch_and_return(
+    "lib:rclcpp", rcl_trigger_guard_condition, RCL_RET_ERROR);
+  node_base->defer_notify_guard_condition();
+  // Nothing to notify.
+  EXPECT_EQ(RCL_RET_OK, node_base->resume_notify_guard_condition());
+
+  node_base->defer_notify_guard_condition();
+  node_base->defer_notify_guard_condition();
+  EXPECT_EQ(RCL_RET_OK, node_base->trigger_notify_guard_condition());
+  EXPECT_EQ(RCL_RET_OK, node_base->trigger_notify_guard_condition());
+  EXPECT_EQ(RCL_RET_OK, node_base->resume_notify_guard_condition());
+  // The outermost deferral triggers the guard condition.
+  EXPECT_EQ(RCL_RET_ERROR, node_base->resume_notify_guard_condition());
+  rcutils_reset_error();
+}
+
+TEST_F(TestBulkEntityCreationScope, entities_created_in_scope_are_executed) {
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  executor.spin_some();
+
+  std::vector<size_t> executions(10, 0);
+  std::vector<rclcpp::TimerBase::SharedPtr> timers;
+  {
+    rclcpp::BulkEntityCreationScope scope(node);
+    for (size_t i = 0; i < executions.size() / 2; ++i) {
+      timers.push_back(node->create_wall_timer(1ms, [&executions, i]() {++executions[i];}));
+    }
+    rclcpp::BulkEntityCreationScope nested_scope(node_base);
+    for (size_t i = executions.size() / 2; i < executions.size(); ++i) {
+      timers.push_back(node->create_wall_timer(1ms, [&executions, i]() {++executions[i];}));
+    }
+  }
+
+  auto all_executed = [&executions]() {
+      for (size_t count : executions) {
+        if (count == 0) {
+          return false;
+        }
+      }
+      return true;
+    };
+  const auto start = std::chrono::steady_clock::now();
+  while (!all_executed() && std::chrono::steady_clock::now() - start < 10s) {
+    executor.spin_once(100ms);
+  }
+  EXPECT_TRUE(all_executed());
+}
+
+TEST_F(TestBulkEntityCreationScope, scope_with_null_node) {
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr null_node_base;
+  EXPECT_THROW(
+    rclcpp::BulkEntityCreationScope scope(null_node_base), std::invalid_argument);
+}
@@ -0,0 +1,125 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "rclcpp/cpu_time.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+/// Keep the calling thread busy for the given thread CPU time.
+void
+burn_cpu_time(std::chrono::nanoseconds cpu_time)
+{
+  const auto start = rclcpp::get_thread_cpu_time();
+  while (rclcpp::get_thread_cpu_time() - start < cpu_time) {
+  }
+}
+
+}  // namespace
+
+class TestCpuTime : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestCpuTime, thread_cpu_time) {
+  const auto start = rclcpp::get_thread_cpu_time();
+  EXPECT_GT(start, 0ns);
+  burn_cpu_time(5ms);
+  EXPECT_GE(rclcpp::get_thread_cpu_time() - start, 5ms);
+
+  // Sleeping doesn't consume CPU time.
+  const auto before_sleep = rclcpp::get_thread_cpu_time();
+  std::this_thread::sleep_for(50ms);
+  EXPECT_LT(rclcpp::get_thread_cpu_time() - before_sleep, 25ms);
+}
+
+TEST_F(TestCpuTime, account) {
+  rclcpp::CpuTimeAccount account;
+  EXPECT_EQ(0ns, account.get_cpu_time());
+  EXPECT_EQ(0u, account.get_execution_count());
+  account.add(3ms);
+  account.add(2ms);
+  EXPECT_EQ(5ms, account.get_cpu_time());
+  EXPECT_EQ(2u, account.get_execution_count());
+}
+
+TEST_F(TestCpuTime, executor_accounting) {
+  auto node = std::make_shared<rclcpp::Node>("test_cpu_time");
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  int busy_count = 0;
+  auto busy_timer = node->create_wall_timer(
+    1ms, [&busy_count]() {
+      burn_cpu_time(2ms);
+      ++busy_count;
+    }, group);
+  int idle_count = 0;
+  auto idle_timer = node->create_wall_timer(1ms, [&idle_count]() {++idle_count;});
+
+  rclcpp::ExecutorOptions options;
+  options.cpu_time_accounting = true;
+  rclcpp::executors::SingleThreadedExecutor executor(options);
+  executor.add_node(node);
+  const auto start = std::chrono::steady_clock::now();
+  while ((busy_count < 5 || idle_count < 5) && std::chrono::steady_clock::now() - start < 10s) {
+    executor.spin_once(100ms);
+  }
+  ASSERT_GE(busy_count, 5);
+  ASSERT_GE(idle_count, 5);
+
+  auto & group_account = group->get_cpu_time_account();
+  EXPECT_EQ(static_cast<uint64_t>(busy_count), group_account.get_execution_count());
+  EXPECT_GE(group_account.get_cpu_time(), busy_count * 2ms);
+
+  auto & node_account = node->get_node_base_interface()->get_cpu_time_account();
+  EXPECT_GE(node_account.get_execution_count(), static_cast<uint64_t>(busy_count + idle_count));
+  EXPECT_GE(node_account.get_cpu_time(), group_account.get_cpu_time());
+  auto & default_account = node->get_node_base_interface()->get_default_callback_group()
+    ->get_cpu_time_account();
+  EXPECT_GE(default_account.get_execution_count(), static_cast<uint64_t>(idle_count));
+}
+
+TEST_F(TestCpuTime, executor_accounting_disabled) {
+  auto node = std::make_shared<rclcpp::Node>("test_cpu_time");
+  int count = 0;
+  auto timer = node->create_wall_timer(1ms, [&count]() {++count;});
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  const auto start = std::chrono::steady_clock::now();
+  while (count < 1 && std::chrono::steady_clock::now() - start < 10s) {
+    executor.spin_once(100ms);
+  }
+  ASSERT_GE(count, 1);
+  EXPECT_EQ(0u, node->get_node_base_interface()->get_cpu_time_account().get_execution_count());
+  EXPECT_EQ(0ns, node->get_node_base_interface()->get_cpu_time_account().get_cpu_time());
+}
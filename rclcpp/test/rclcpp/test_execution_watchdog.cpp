@@ -0,0 +1,179 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/execution_watchdog.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+class TestExecutionWatchdog : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+protected:
+  void SetUp()
+  {
+    node = std::make_shared<rclcpp::Node>("test_execution_watchdog");
+    watchdog = std::make_shared<rclcpp::ExecutionWatchdog>();
+    watchdog->set_overrun_handler(
+      [this](const rclcpp::ExecutionWatchdog::Overrun & overrun) {
+        std::lock_guard<std::mutex> lock(overruns_mutex);
+        overruns.push_back(overrun);
+      });
+    rclcpp::ExecutorOptions options;
+    options.execution_watchdog = watchdog;
+    executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>(options);
+    executor->add_node(node);
+  }
+
+  template<typename ConditionT>
+  void
+  spin_until(ConditionT condition)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    while (!condition() && std::chrono::steady_clock::now() - start < 10s) {
+      executor->spin_once(100ms);
+    }
+  }
+
+  std::vector<rclcpp::ExecutionWatchdog::Overrun>
+  get_overruns()
+  {
+    std::lock_guard<std::mutex> lock(overruns_mutex);
+    return overruns;
+  }
+
+  rclcpp::Node::SharedPtr node;
+  rclcpp::ExecutionWatchdog::SharedPtr watchdog;
+  rclcpp::executors::SingleThreadedExecutor::SharedPtr executor;
+  std::mutex overruns_mutex;
+  std::vector<rclcpp::ExecutionWatchdog::Overrun> overruns;
+};
+
+TEST_F(TestExecutionWatchdog, invalid_budget) {
+  auto timer = node->create_wall_timer(1s, []() {});
+  EXPECT_THROW(watchdog->set_budget(timer, 0ns), std::invalid_argument);
+  EXPECT_THROW(
+    watchdog->set_budget(rclcpp::TimerBase::SharedPtr(), 1ms), std::invalid_argument);
+}
+
+TEST_F(TestExecutionWatchdog, timer_overrun_skips_invocations) {
+  int count = 0;
+  auto timer = node->create_wall_timer(
+    10ms, [&count]() {
+      if (++count == 1) {
+        std::this_thread::sleep_for(50ms);
+      }
+    });
+  watchdog->set_budget(timer, 20ms, 2);
+
+  spin_until(
+    [this, &timer]() {return watchdog->get_statistics(timer).execution_count >= 3;});
+  const auto statistics = watchdog->get_statistics(timer);
+  EXPECT_EQ(3u, statistics.execution_count);
+  EXPECT_EQ(1u, statistics.overrun_count);
+  EXPECT_EQ(2u, statistics.skipped_count);
+  EXPECT_GE(statistics.max_execution_time, 50ms);
+  EXPECT_EQ(3, count);
+
+  // The report may come slightly after the end of the execution.
+  spin_until([this]() {return !get_overruns().empty();});
+  const auto reported_overruns = get_overruns();
+  ASSERT_EQ(1u, reported_overruns.size());
+  EXPECT_EQ(timer, reported_overruns[0].executable.timer);
+  EXPECT_EQ(20ms, reported_overruns[0].budget);
+  EXPECT_GE(reported_overruns[0].execution_time, 20ms);
+}
+
+TEST_F(TestExecutionWatchdog, callback_group_budget) {
+  auto group = node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  int slow_count = 0;
+  auto slow_timer = node->create_wall_timer(
+    10ms, [&slow_count]() {
+      ++slow_count;
+      std::this_thread::sleep_for(20ms);
+    }, group);
+  int other_count = 0;
+  auto other_timer = node->create_wall_timer(
+    10ms, [&other_count]() {
+      ++other_count;
+      std::this_thread::sleep_for(20ms);
+    }, group);
+  watchdog->set_budget(group, 5ms);
+  // The budget of an entity takes precedence over the one of its group.
+  watchdog->set_budget(other_timer, 1s);
+
+  spin_until([&]() {return slow_count >= 2 && other_count >= 2;});
+  ASSERT_GE(slow_count, 2);
+  const auto group_statistics = watchdog->get_statistics(group);
+  EXPECT_EQ(static_cast<uint64_t>(slow_count), group_statistics.execution_count);
+  EXPECT_EQ(static_cast<uint64_t>(slow_count), group_statistics.overrun_count);
+  EXPECT_EQ(0u, group_statistics.skipped_count);
+  const auto other_statistics = watchdog->get_statistics(other_timer);
+  EXPECT_EQ(static_cast<uint64_t>(other_count), other_statistics.execution_count);
+  EXPECT_EQ(0u, other_statistics.overrun_count);
+
+  spin_until([&]() {return get_overruns().size() >= static_cast<size_t>(slow_count);});
+  for (const auto & overrun : get_overruns()) {
+    EXPECT_EQ(slow_timer, overrun.executable.timer);
+    EXPECT_EQ(group, overrun.executable.callback_group);
+  }
+
+  watchdog->remove_budget(group);
+  EXPECT_EQ(0u, watchdog->get_statistics(group).execution_count);
+}
+
+TEST_F(TestExecutionWatchdog, overrun_reported_while_running) {
+  std::promise<void> reported;
+  auto reported_future = reported.get_future().share();
+  watchdog->set_overrun_handler(
+    [&reported](const rclcpp::ExecutionWatchdog::Overrun & overrun) {
+      EXPECT_FALSE(overrun.finished);
+      reported.set_value();
+    });
+  bool reported_in_time = false;
+  bool executed = false;
+  auto timer = node->create_wall_timer(
+    1ms, [&]() {
+      if (!executed) {
+        executed = true;
+        // Only returns once the watchdog reported the overrun.
+        reported_in_time = reported_future.wait_for(5s) == std::future_status::ready;
+      }
+    });
+  watchdog->set_budget(timer, 10ms);
+
+  spin_until([&executed]() {return executed;});
+  EXPECT_TRUE(reported_in_time);
+  EXPECT_EQ(1u, watchdog->get_statistics(timer).overrun_count);
+}
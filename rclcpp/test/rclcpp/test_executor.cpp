@@ -451,6 +451,22 @@ TEST_F(TestExecutor, get_group_by_timer_add_callback_group) {
   ASSERT_EQ(cb_group.get(), dummy.local_get_group_by_timer(timer).get());
 }
 
+TEST_F(TestExecutor, get_group_by_timer_created_after_add) {
+  DummyExecutor dummy;
+  auto node = std::make_shared<rclcpp::Node>("node", "ns");
+  rclcpp::CallbackGroup::SharedPtr cb_group = node->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive);
+  dummy.add_callback_group(cb_group, node->get_node_base_interface(), false);
+  auto timer =
+    node->create_wall_timer(std::chrono::milliseconds(1), [&]() {}, cb_group);
+
+  ASSERT_EQ(cb_group.get(), dummy.local_get_group_by_timer(timer).get());
+  ASSERT_EQ(cb_group.get(), dummy.local_get_group_by_timer(timer).get());
+
+  dummy.remove_callback_group(cb_group, false);
+  ASSERT_EQ(nullptr, dummy.local_get_group_by_timer(timer).get());
+}
+
 TEST_F(TestExecutor, spin_until_future_complete_in_spin_until_future_complete) {
   DummyExecutor dummy;
   auto node = std::make_shared<rclcpp::Node>("node", "ns");
@@ -0,0 +1,211 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rclcpp/experimental/flight_recorder.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "test_msgs/msg/strings.hpp"
+
+using rclcpp::experimental::FlightRecorder;
+using rclcpp::experimental::read_flight_record;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+std::string
+temporary_file(const std::string & name)
+{
+  return ::testing::TempDir() + "test_flight_recorder_" + name;
+}
+
+std::vector<uint8_t>
+make_data(uint8_t value, size_t size)
+{
+  return std::vector<uint8_t>(size, value);
+}
+
+}  // namespace
+
+TEST(TestFlightRecorder, construction) {
+  const std::string path = temporary_file("construction");
+  EXPECT_THROW(FlightRecorder(path, 0, 1024, 1s), std::invalid_argument);
+  EXPECT_THROW(FlightRecorder(path, 1, 8, 1s), std::invalid_argument);
+  EXPECT_THROW(FlightRecorder(path, 1, 1024, 0s), std::invalid_argument);
+  EXPECT_THROW(FlightRecorder("/nonexistent/directory/file", 1, 1024, 1s), std::runtime_error);
+
+  FlightRecorder recorder(path, 1, 1024, 1s);
+  recorder.add_topic("/topic", "pkg/msg/Type");
+  EXPECT_THROW(recorder.add_topic("/other", "pkg/msg/Type"), std::runtime_error);
+
+  auto flight_record = read_flight_record(path);
+  EXPECT_EQ(1s, flight_record.window);
+  ASSERT_EQ(1u, flight_record.topics.size());
+  EXPECT_EQ("/topic", flight_record.topics[0].topic_name);
+  EXPECT_EQ("pkg/msg/Type", flight_record.topics[0].type_name);
+  EXPECT_TRUE(flight_record.topics[0].messages.empty());
+}
+
+TEST(TestFlightRecorder, record_and_read) {
+  const std::string path = temporary_file("record_and_read");
+  FlightRecorder recorder(path, 2, 1024, 10s);
+  auto topic_a = recorder.add_topic("/a", "pkg/msg/A");
+  auto topic_b = recorder.add_topic("/b", "pkg/msg/B");
+  EXPECT_EQ("/a", topic_a->get_topic_name());
+
+  auto data_1 = make_data(1, 3);
+  auto data_2 = make_data(2, 17);
+  auto data_3 = make_data(3, 0);
+  auto now = std::chrono::system_clock::now();
+  EXPECT_TRUE(topic_a->record(data_1.data(), data_1.size(), now));
+  EXPECT_TRUE(topic_a->record(data_2.data(), data_2.size(), now + 1ms));
+  EXPECT_TRUE(topic_b->record(data_3.data(), data_3.size(), now + 2ms));
+  // Larger than the ring of a topic.
+  auto too_large = make_data(4, 1024);
+  EXPECT_FALSE(topic_b->record(too_large.data(), too_large.size()));
+  recorder.flush();
+
+  auto flight_record = read_flight_record(path);
+  ASSERT_EQ(2u, flight_record.topics.size());
+  const auto & messages_a = flight_record.topics[0].messages;
+  ASSERT_EQ(2u, messages_a.size());
+  EXPECT_EQ(data_1, messages_a[0].serialized_data);
+  EXPECT_EQ(data_2, messages_a[1].serialized_data);
+  EXPECT_EQ(
+    std::chrono::time_point_cast<std::chrono::microseconds>(now),
+    std::chrono::time_point_cast<std::chrono::microseconds>(messages_a[0].receive_time));
+  const auto & messages_b = flight_record.topics[1].messages;
+  ASSERT_EQ(1u, messages_b.size());
+  EXPECT_TRUE(messages_b[0].serialized_data.empty());
+}
+
+TEST(TestFlightRecorder, ring_wraps_around) {
+  const std::string path = temporary_file("ring_wraps_around");
+  // Room for 4 records of 40 bytes, 16 of which are the record header.
+  FlightRecorder recorder(path, 1, 160, 10s);
+  auto topic = recorder.add_topic("/topic", "pkg/msg/Type");
+  auto now = std::chrono::system_clock::now();
+  for (uint8_t i = 0; i < 10; ++i) {
+    // Use varying sizes, so that records need padding at the end of the ring.
+    auto data = make_data(i, 20u + (i % 3) * 8u);
+    ASSERT_TRUE(topic->record(data.data(), data.size(), now + i * 1ms));
+  }
+
+  auto flight_record = read_flight_record(path);
+  ASSERT_EQ(1u, flight_record.topics.size());
+  const auto & messages = flight_record.topics[0].messages;
+  ASSERT_FALSE(messages.empty());
+  EXPECT_LE(messages.size(), 4u);
+  // The newest messages are kept, in order.
+  uint8_t expected = static_cast<uint8_t>(10 - messages.size());
+  for (const auto & message : messages) {
+    ASSERT_FALSE(message.serialized_data.empty());
+    EXPECT_EQ(expected, message.serialized_data[0]);
+    EXPECT_EQ(20u + (expected % 3) * 8u, message.serialized_data.size());
+    ++expected;
+  }
+}
+
+TEST(TestFlightRecorder, old_messages_expire) {
+  const std::string path = temporary_file("old_messages_expire");
+  FlightRecorder recorder(path, 2, 1024, 100ms);
+  auto topic_a = recorder.add_topic("/a", "pkg/msg/A");
+  auto topic_b = recorder.add_topic("/b", "pkg/msg/B");
+  auto data = make_data(1, 8);
+  auto now = std::chrono::system_clock::now();
+  topic_a->record(data.data(), data.size(), now);
+  topic_a->record(data.data(), data.size(), now + 50ms);
+  topic_b->record(data.data(), data.size(), now + 60ms);
+  // Drops the first two messages of the topic when recording.
+  topic_a->record(data.data(), data.size(), now + 200ms);
+
+  auto flight_record = read_flight_record(path);
+  ASSERT_EQ(2u, flight_record.topics.size());
+  EXPECT_EQ(1u, flight_record.topics[0].messages.size());
+  // Skipped when reading, as it is older than the window before the newest message.
+  EXPECT_EQ(0u, flight_record.topics[1].messages.size());
+}
+
+TEST(TestFlightRecorder, dump) {
+  const std::string path = temporary_file("dump");
+  const std::string dump_path = temporary_file("dump_copy");
+  FlightRecorder recorder(path, 1, 1024, 10s);
+  auto topic = recorder.add_topic("/topic", "pkg/msg/Type");
+  auto data = make_data(7, 12);
+  topic->record(data.data(), data.size());
+  recorder.dump(dump_path);
+  // Not in the copy.
+  topic->record(data.data(), data.size());
+
+  auto flight_record = read_flight_record(dump_path);
+  ASSERT_EQ(1u, flight_record.topics.size());
+  ASSERT_EQ(1u, flight_record.topics[0].messages.size());
+  EXPECT_EQ(data, flight_record.topics[0].messages[0].serialized_data);
+  EXPECT_EQ(2u, read_flight_record(path).topics[0].messages.size());
+}
+
+TEST(TestFlightRecorder, record_topic) {
+  rclcpp::init(0, nullptr);
+  {
+    auto node = std::make_shared<rclcpp::Node>("flight_recorder", "/ns");
+    const std::string path = temporary_file("record_topic");
+    FlightRecorder recorder(path, 1, 4096, 10s);
+    recorder.record_topic<test_msgs::msg::Strings>(node, "topic", rclcpp::QoS(10));
+    auto publisher = node->create_publisher<test_msgs::msg::Strings>("topic", 10);
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(node);
+
+    test_msgs::msg::Strings message;
+    message.string_value = "recorded";
+    // Published until received, as the subscription may not be matched yet.
+    auto end = std::chrono::steady_clock::now() + 5s;
+    while (read_flight_record(path).topics[0].messages.empty() &&
+      std::chrono::steady_clock::now() < end)
+    {
+      publisher->publish(message);
+      executor.spin_once(100ms);
+    }
+
+    auto flight_record = read_flight_record(path);
+    ASSERT_EQ(1u, flight_record.topics.size());
+    EXPECT_EQ("/ns/topic", flight_record.topics[0].topic_name);
+    EXPECT_EQ("test_msgs/msg/Strings", flight_record.topics[0].type_name);
+    ASSERT_FALSE(flight_record.topics[0].messages.empty());
+    const auto & data = flight_record.topics[0].messages[0].serialized_data;
+    rclcpp::SerializedMessage serialized_message(data.data(), data.size());
+    test_msgs::msg::Strings recorded_message;
+    rclcpp::Serialization<test_msgs::msg::Strings>().deserialize_message(
+      &serialized_message, &recorded_message);
+    EXPECT_EQ("recorded", recorded_message.string_value);
+  }
+  rclcpp::shutdown();
+}
+
+TEST(TestFlightRecorder, invalid_file) {
+  EXPECT_THROW(read_flight_record(temporary_file("does_not_exist")), std::runtime_error);
+  const std::string path = temporary_file("invalid_file");
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "not a flight record, but long enough to hold a file header of 64 bytes";
+  }
+  EXPECT_THROW(read_flight_record(path), std::runtime_error);
+}
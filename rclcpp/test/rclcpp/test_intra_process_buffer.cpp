@@ -13,7 +13,9 @@
 // limitations under the License.
 
 
+#include <chrono>
 #include <memory>
+#include <thread>
 #include <utility>
 
 #include "gtest/gtest.h"
@@ -238,3 +240,48 @@ TEST(TestIntraProcessBuffer, unique_buffer_consume) {
   EXPECT_EQ(original_value, *popped_unique_msg);
   EXPECT_EQ(original_message_pointer, popped_message_pointer);
 }
+
+/*
+  Remove expired messages from an intra-process buffer with a lifespan
+  - Nothing is removed without a lifespan
+  - Messages older than the lifespan are removed
+ */
+TEST(TestIntraProcessBuffer, remove_expired) {
+  using MessageT = char;
+  using Alloc = std::allocator<void>;
+  using Deleter = std::default_delete<MessageT>;
+  using SharedMessageT = std::shared_ptr<const MessageT>;
+  using SharedIntraProcessBufferT = rclcpp::experimental::buffers::TypedIntraProcessBuffer<
+    MessageT, Alloc, Deleter, SharedMessageT>;
+
+  auto buffer_impl =
+    std::make_unique<rclcpp::experimental::buffers::RingBufferImplementation<SharedMessageT>>(
+    2, true);
+  SharedIntraProcessBufferT intra_process_buffer(std::move(buffer_impl));
+
+  intra_process_buffer.add_shared(std::make_shared<char>('a'));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(0u, intra_process_buffer.remove_expired());
+  EXPECT_EQ(true, intra_process_buffer.has_data());
+
+  auto timed_buffer_impl =
+    std::make_unique<rclcpp::experimental::buffers::RingBufferImplementation<SharedMessageT>>(
+    2, true);
+  SharedIntraProcessBufferT timed_intra_process_buffer(
+    std::move(timed_buffer_impl), nullptr, std::chrono::milliseconds(10));
+
+  auto original_message = std::make_shared<char>('a');
+  timed_intra_process_buffer.add_shared(original_message);
+  EXPECT_EQ(2u, original_message.use_count());
+  EXPECT_EQ(0u, timed_intra_process_buffer.remove_expired());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  timed_intra_process_buffer.add_shared(std::make_shared<char>('b'));
+
+  EXPECT_EQ(1u, timed_intra_process_buffer.remove_expired());
+  // The buffer does not keep a reference to removed messages.
+  EXPECT_EQ(1u, original_message.use_count());
+  EXPECT_EQ(true, timed_intra_process_buffer.has_data());
+  EXPECT_EQ('b', *timed_intra_process_buffer.consume_shared());
+  EXPECT_EQ(false, timed_intra_process_buffer.has_data());
+}
@@ -670,3 +670,65 @@ TEST(TestIntraProcessManager, multiple_subscriptions_different_type) {
   EXPECT_EQ(original_message_pointer, received_message_pointer_10);
   EXPECT_NE(original_message_pointer, received_message_pointer_11);
 }
+
+/*
+   This tests the late joiner support of transient local publishers:
+   - Publishes 3 messages with a transient local publisher whose history has a depth of 2.
+   - The history is expected to keep the last 2 messages.
+   - Add a transient local subscription not requesting ownership.
+   - The history is expected to be replayed to it, without copies.
+   - Add a volatile subscription, nothing is expected to be replayed to it.
+   - A volatile publisher is not expected to be connected with the transient local subscription.
+ */
+TEST(TestIntraProcessManager, transient_local_late_joiner) {
+  using IntraProcessManagerT = rclcpp::experimental::IntraProcessManager;
+  using MessageT = rcl_interfaces::msg::Log;
+  using PublisherT = rclcpp::mock::Publisher<MessageT>;
+  using SubscriptionIntraProcessT = rclcpp::experimental::mock::SubscriptionIntraProcess<MessageT>;
+  using HistoryT = rclcpp::experimental::IntraProcessPublisherHistory<MessageT>;
+
+  EXPECT_THROW(HistoryT(0), std::invalid_argument);
+
+  auto ipm = std::make_shared<IntraProcessManagerT>();
+
+  auto p1 = std::make_shared<PublisherT>();
+  p1->qos.transient_local();
+  auto history = std::make_shared<HistoryT>(2);
+  auto p1_id = ipm->add_publisher(p1, history);
+  p1->set_intra_process_manager(p1_id, ipm);
+
+  std::uintptr_t original_message_pointer = 0;
+  for (int i = 0; i < 3; ++i) {
+    auto unique_msg = std::make_unique<MessageT>();
+    original_message_pointer = reinterpret_cast<std::uintptr_t>(unique_msg.get());
+    p1->publish(std::move(unique_msg));
+  }
+  EXPECT_EQ(2u, history->size());
+
+  auto s1 = std::make_shared<SubscriptionIntraProcessT>();
+  s1->take_shared_method = true;
+  s1->qos_profile.durability = RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL;
+  auto s1_id = ipm->add_subscription(s1);
+  (void)s1_id;
+  EXPECT_EQ(1u, ipm->get_subscription_count(p1_id));
+  // The last replayed message is the last published one.
+  EXPECT_EQ(original_message_pointer, s1->pop());
+
+  auto s2 = std::make_shared<SubscriptionIntraProcessT>();
+  s2->take_shared_method = true;
+  auto s2_id = ipm->add_subscription(s2);
+  (void)s2_id;
+  EXPECT_EQ(2u, ipm->get_subscription_count(p1_id));
+  EXPECT_EQ(nullptr, s2->buffer->shared_msg);
+
+  auto p2 = std::make_shared<PublisherT>();
+  auto p2_id = ipm->add_publisher(p2);
+  EXPECT_EQ(1u, ipm->get_subscription_count(p2_id));
+
+  auto unique_msg = std::make_unique<MessageT>();
+  original_message_pointer = reinterpret_cast<std::uintptr_t>(unique_msg.get());
+  p1->publish(std::move(unique_msg));
+  EXPECT_EQ(original_message_pointer, s1->pop());
+  EXPECT_EQ(original_message_pointer, s2->pop());
+  EXPECT_EQ(2u, history->size());
+}
@@ -0,0 +1,110 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/detail/keyed_task_queue.hpp"
+
+using rclcpp::detail::KeyedTaskQueue;
+
+TEST(TestKeyedTaskQueue, nothing_taken) {
+  KeyedTaskQueue queue;
+  bool ran = false;
+  queue.take_and_run(
+    [&ran](std::size_t &, KeyedTaskQueue::Task & task) {
+      task = [&ran]() {ran = true;};
+      return false;
+    });
+  EXPECT_FALSE(ran);
+  EXPECT_EQ(0u, queue.number_of_active_keys());
+}
+
+TEST(TestKeyedTaskQueue, ordered_within_key_parallel_across_keys) {
+  constexpr std::size_t number_of_keys = 4;
+  constexpr std::size_t number_of_threads = 8;
+  constexpr std::size_t tasks_per_thread = 1000;
+
+  KeyedTaskQueue queue;
+  std::size_t next_sequence = 0;
+  std::array<std::vector<std::size_t>, number_of_keys> executed;
+  std::array<std::atomic<int>, number_of_keys> running_per_key{};
+  std::atomic<bool> overlapped{false};
+
+  auto worker = [&]() {
+      for (std::size_t i = 0; i < tasks_per_thread; ++i) {
+        queue.take_and_run(
+          [&](std::size_t & key, KeyedTaskQueue::Task & task) {
+            // Called with the queue locked, like taking from a subscription.
+            std::size_t sequence = next_sequence++;
+            key = sequence % number_of_keys;
+            task = [&, key, sequence]() {
+                if (running_per_key[key].fetch_add(1) != 0) {
+                  overlapped = true;
+                }
+                executed[key].push_back(sequence);
+                running_per_key[key].fetch_sub(1);
+              };
+            return true;
+          });
+      }
+    };
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < number_of_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_FALSE(overlapped.load());
+  EXPECT_EQ(0u, queue.number_of_active_keys());
+  std::size_t total = 0;
+  for (std::size_t key = 0; key < number_of_keys; ++key) {
+    total += executed[key].size();
+    for (std::size_t i = 1; i < executed[key].size(); ++i) {
+      EXPECT_LT(executed[key][i - 1], executed[key][i]);
+    }
+  }
+  EXPECT_EQ(number_of_threads * tasks_per_thread, total);
+}
+
+TEST(TestKeyedTaskQueue, task_throws) {
+  KeyedTaskQueue queue;
+  EXPECT_THROW(
+    queue.take_and_run(
+      [](std::size_t & key, KeyedTaskQueue::Task & task) {
+        key = 1;
+        task = []() {throw std::runtime_error("task failed");};
+        return true;
+      }),
+    std::runtime_error);
+  EXPECT_EQ(0u, queue.number_of_active_keys());
+
+  // The key is not left blocked by the failed task.
+  bool ran = false;
+  queue.take_and_run(
+    [&ran](std::size_t & key, KeyedTaskQueue::Task & task) {
+      key = 1;
+      task = [&ran]() {ran = true;};
+      return true;
+    });
+  EXPECT_TRUE(ran);
+  EXPECT_EQ(0u, queue.number_of_active_keys());
+}
@@ -0,0 +1,176 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/memory_usage.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "statistics_msgs/msg/metrics_message.hpp"
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/srv/empty.hpp"
+
+using namespace std::chrono_literals;
+
+class TestMemoryUsage : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+protected:
+  void SetUp()
+  {
+    node = std::make_shared<rclcpp::Node>(
+      "test_memory_usage", "/ns", rclcpp::NodeOptions().use_intra_process_comms(true));
+  }
+
+  static const rclcpp::EntityMemoryUsage *
+  find_entity(
+    const rclcpp::NodeMemoryUsage & usage, rclcpp::EntityKind kind, const std::string & name)
+  {
+    auto it = std::find_if(
+      usage.entities.begin(), usage.entities.end(),
+      [kind, &name](const rclcpp::EntityMemoryUsage & entity) {
+        return entity.kind == kind && entity.name == name;
+      });
+    return it != usage.entities.end() ? &*it : nullptr;
+  }
+
+  rclcpp::Node::SharedPtr node;
+};
+
+TEST_F(TestMemoryUsage, entities_of_node) {
+  auto publisher = node->create_publisher<test_msgs::msg::BasicTypes>("topic", 10);
+  auto subscription = node->create_subscription<test_msgs::msg::BasicTypes>(
+    "topic", 10, [](test_msgs::msg::BasicTypes::SharedPtr) {});
+  auto service = node->create_service<test_msgs::srv::Empty>(
+    "service",
+    [](
+      const test_msgs::srv::Empty::Request::SharedPtr,
+      test_msgs::srv::Empty::Response::SharedPtr) {});
+  auto client = node->create_client<test_msgs::srv::Empty>("service");
+  auto timer = node->create_wall_timer(1s, []() {});
+
+  auto usage = rclcpp::get_memory_usage(node);
+  EXPECT_EQ("/ns/test_memory_usage", usage.node_name);
+  size_t sum = 0;
+  for (const auto & entity : usage.entities) {
+    EXPECT_GT(entity.bytes, 0u);
+    sum += entity.bytes;
+  }
+  EXPECT_EQ(sum, usage.bytes);
+
+  EXPECT_NE(nullptr, find_entity(usage, rclcpp::EntityKind::Publisher, "/ns/topic"));
+  EXPECT_NE(nullptr, find_entity(usage, rclcpp::EntityKind::Service, "/ns/service"));
+  EXPECT_NE(nullptr, find_entity(usage, rclcpp::EntityKind::Client, "/ns/service"));
+  EXPECT_NE(nullptr, find_entity(usage, rclcpp::EntityKind::Timer, ""));
+  // The intra-process waitable of the subscription is not listed on its own.
+  EXPECT_EQ(
+    0, std::count_if(
+      usage.entities.begin(), usage.entities.end(),
+      [](const rclcpp::EntityMemoryUsage & entity) {
+        return entity.kind == rclcpp::EntityKind::Waitable;
+      }));
+  auto subscription_usage =
+    find_entity(usage, rclcpp::EntityKind::Subscription, "/ns/topic");
+  ASSERT_NE(nullptr, subscription_usage);
+
+  // Messages waiting in the intra-process buffer are accounted with the subscription.
+  const size_t subscription_bytes = subscription_usage->bytes;
+  publisher->publish(test_msgs::msg::BasicTypes());
+  publisher->publish(test_msgs::msg::BasicTypes());
+  usage = rclcpp::get_memory_usage(node);
+  subscription_usage = find_entity(usage, rclcpp::EntityKind::Subscription, "/ns/topic");
+  ASSERT_NE(nullptr, subscription_usage);
+  EXPECT_GE(
+    subscription_usage->bytes, subscription_bytes + 2 * sizeof(test_msgs::msg::BasicTypes));
+
+  // Destroyed entities are not listed anymore.
+  publisher.reset();
+  client.reset();
+  usage = rclcpp::get_memory_usage(node);
+  EXPECT_EQ(nullptr, find_entity(usage, rclcpp::EntityKind::Publisher, "/ns/topic"));
+  EXPECT_EQ(nullptr, find_entity(usage, rclcpp::EntityKind::Client, "/ns/service"));
+}
+
+TEST_F(TestMemoryUsage, client_pending_requests) {
+  auto client = node->create_client<test_msgs::srv::Empty>("no_service");
+  const size_t client_bytes = client->get_memory_usage();
+  auto future = client->async_send_request(std::make_shared<test_msgs::srv::Empty::Request>());
+  EXPECT_GT(client->get_memory_usage(), client_bytes);
+}
+
+TEST_F(TestMemoryUsage, reporter) {
+  auto other_node = std::make_shared<rclcpp::Node>("other_node", "/ns");
+  auto other_publisher = other_node->create_publisher<test_msgs::msg::BasicTypes>("topic", 10);
+
+  std::vector<statistics_msgs::msg::MetricsMessage> messages;
+  auto subscription = node->create_subscription<statistics_msgs::msg::MetricsMessage>(
+    "memory_usage", 100,
+    [&messages](statistics_msgs::msg::MetricsMessage::SharedPtr message) {
+      messages.push_back(*message);
+    });
+
+  auto reporter = std::make_shared<rclcpp::MemoryUsageReporter>(node, 10ms);
+  reporter->add_node(
+    other_node->get_node_base_interface(), other_node->get_node_topics_interface());
+  other_node.reset();
+  other_publisher.reset();
+  auto another_node = std::make_shared<rclcpp::Node>("another_node", "/ns");
+  reporter->add_node(
+    another_node->get_node_base_interface(), another_node->get_node_topics_interface());
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  auto start = std::chrono::steady_clock::now();
+  auto has_total = [&messages](const std::string & node_name) {
+      return std::any_of(
+        messages.begin(), messages.end(),
+        [&node_name](const statistics_msgs::msg::MetricsMessage & message) {
+          return message.measurement_source_name == node_name && message.metrics_source == "total";
+        });
+    };
+  while (!(has_total("/ns/test_memory_usage") && has_total("/ns/another_node")) &&
+    std::chrono::steady_clock::now() - start < 10s)
+  {
+    executor.spin_some(100ms);
+  }
+  ASSERT_TRUE(has_total("/ns/test_memory_usage"));
+  ASSERT_TRUE(has_total("/ns/another_node"));
+  for (const auto & message : messages) {
+    EXPECT_NE("/ns/other_node", message.measurement_source_name);
+    EXPECT_EQ("bytes", message.unit);
+    ASSERT_EQ(1u, message.statistics.size());
+  }
+  EXPECT_TRUE(
+    std::any_of(
+      messages.begin(), messages.end(),
+      [](const statistics_msgs::msg::MetricsMessage & message) {
+        return message.metrics_source == "subscription /ns/memory_usage";
+      }));
+}
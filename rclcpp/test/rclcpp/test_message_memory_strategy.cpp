@@ -56,3 +56,16 @@ TEST(TestMemoryStrategies, standard_allocation) {
   EXPECT_EQ(42u, serialized_message->capacity());
   EXPECT_NO_THROW(memory_strategy->return_serialized_message(serialized_message));
 }
+
+TEST(TestMemoryStrategies, unique_allocation) {
+  auto memory_strategy =
+    rclcpp::message_memory_strategy::MessageMemoryStrategy<
+    test_msgs::msg::Empty>::create_default();
+  ASSERT_NE(nullptr, memory_strategy);
+
+  auto first_message = memory_strategy->borrow_unique_message();
+  ASSERT_NE(nullptr, first_message);
+  auto second_message = memory_strategy->borrow_unique_message();
+  ASSERT_NE(nullptr, second_message);
+  EXPECT_NE(first_message.get(), second_message.get());
+}
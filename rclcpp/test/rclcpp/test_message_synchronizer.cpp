@@ -0,0 +1,164 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "rclcpp/experimental/message_synchronizer.hpp"
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/empty.hpp"
+
+using namespace std::chrono_literals;
+using test_msgs::msg::BasicTypes;
+using test_msgs::msg::Empty;
+
+namespace rclcpp
+{
+namespace experimental
+{
+
+// The test messages have no header, use a field as the stamp instead.
+template<>
+struct MessageStamp<BasicTypes>
+{
+  static int64_t
+  nanoseconds(const BasicTypes & message)
+  {
+    return message.int64_value;
+  }
+};
+
+}  // namespace experimental
+}  // namespace rclcpp
+
+namespace
+{
+
+std::shared_ptr<const BasicTypes>
+make_message(int64_t stamp)
+{
+  auto message = std::make_shared<BasicTypes>();
+  message->int64_value = stamp;
+  return message;
+}
+
+}  // namespace
+
+class TestMessageSynchronizer : public ::testing::Test
+{
+protected:
+  using Synchronizer = rclcpp::experimental::MessageSynchronizer<BasicTypes, BasicTypes, Empty>;
+
+  std::shared_ptr<Synchronizer>
+  make_synchronizer(size_t queue_size, std::chrono::nanoseconds max_interval)
+  {
+    return std::make_shared<Synchronizer>(
+      queue_size,
+      max_interval,
+      [this](
+        std::shared_ptr<const BasicTypes> first,
+        std::shared_ptr<const BasicTypes> second,
+        std::shared_ptr<const Empty> third)
+      {
+        ASSERT_NE(nullptr, third);
+        matched.emplace_back(first->int64_value, second->int64_value);
+      });
+  }
+
+  std::vector<std::tuple<int64_t, int64_t>> matched;
+};
+
+TEST_F(TestMessageSynchronizer, construction) {
+  auto callback = [](
+    std::shared_ptr<const BasicTypes>, std::shared_ptr<const BasicTypes>,
+    std::shared_ptr<const Empty>) {};
+  EXPECT_THROW(Synchronizer(0, 1ms, callback), std::invalid_argument);
+  EXPECT_THROW(Synchronizer(1, -1ms, callback), std::invalid_argument);
+  EXPECT_THROW(Synchronizer(1, 1ms, nullptr), std::invalid_argument);
+  Synchronizer synchronizer(1, 0ms, callback);
+  EXPECT_THROW(synchronizer.add_message<0>(nullptr), std::invalid_argument);
+}
+
+TEST_F(TestMessageSynchronizer, exact) {
+  auto synchronizer = make_synchronizer(10, 0ns);
+  auto empty = std::make_shared<const Empty>();
+  synchronizer->add_message<0>(make_message(1));
+  synchronizer->add_message<0>(make_message(2));
+  synchronizer->add_message<1>(make_message(2));
+  EXPECT_TRUE(matched.empty());
+  synchronizer->add_message<2>(empty, 2);
+  ASSERT_EQ(1u, matched.size());
+  EXPECT_EQ(std::make_tuple(2, 2), matched[0]);
+  // The first message was dropped, as it could not match.
+  EXPECT_EQ(1u, synchronizer->get_dropped_count());
+
+  synchronizer->add_message<2>(empty, 3);
+  synchronizer->add_message<1>(make_message(4));
+  synchronizer->add_message<0>(make_message(4));
+  synchronizer->add_message<2>(empty, 4);
+  ASSERT_EQ(2u, matched.size());
+  EXPECT_EQ(std::make_tuple(4, 4), matched[1]);
+  EXPECT_EQ(2u, synchronizer->get_dropped_count());
+}
+
+TEST_F(TestMessageSynchronizer, approximate) {
+  auto synchronizer = make_synchronizer(10, 5ns);
+  auto empty = std::make_shared<const Empty>();
+  synchronizer->add_message<0>(make_message(100));
+  synchronizer->add_message<1>(make_message(93));
+  synchronizer->add_message<1>(make_message(98));
+  synchronizer->add_message<2>(empty, 102);
+  // 93 is dropped, as 98 is closer to 102.
+  ASSERT_EQ(1u, matched.size());
+  EXPECT_EQ(std::make_tuple(100, 98), matched[0]);
+  EXPECT_EQ(1u, synchronizer->get_dropped_count());
+
+  // Too far apart, 110 can never match.
+  synchronizer->add_message<0>(make_message(110));
+  synchronizer->add_message<1>(make_message(120));
+  synchronizer->add_message<2>(empty, 121);
+  EXPECT_EQ(1u, matched.size());
+  EXPECT_EQ(2u, synchronizer->get_dropped_count());
+  synchronizer->add_message<0>(make_message(118));
+  ASSERT_EQ(2u, matched.size());
+  EXPECT_EQ(std::make_tuple(118, 120), matched[1]);
+}
+
+TEST_F(TestMessageSynchronizer, out_of_order_and_bounded_queues) {
+  auto synchronizer = make_synchronizer(2, 0ns);
+  auto empty = std::make_shared<const Empty>();
+  synchronizer->add_message<0>(make_message(3));
+  synchronizer->add_message<0>(make_message(2));
+  // The queue is full, the oldest message is dropped.
+  synchronizer->add_message<0>(make_message(4));
+  EXPECT_EQ(1u, synchronizer->get_dropped_count());
+  synchronizer->add_message<1>(make_message(3));
+  synchronizer->add_message<2>(empty, 3);
+  ASSERT_EQ(1u, matched.size());
+  EXPECT_EQ(std::make_tuple(3, 3), matched[0]);
+
+  // Older than the last matched message of its topic.
+  synchronizer->add_message<1>(make_message(2));
+  EXPECT_EQ(2u, synchronizer->get_dropped_count());
+  synchronizer->add_message<1>(make_message(4));
+  synchronizer->add_message<2>(empty, 4);
+  ASSERT_EQ(2u, matched.size());
+  EXPECT_EQ(std::make_tuple(4, 4), matched[1]);
+}
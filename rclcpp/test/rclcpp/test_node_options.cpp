@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -172,6 +173,24 @@ TEST(TestNodeOptions, enable_rosout) {
   }
 }
 
+TEST(TestNodeOptions, async_rosout) {
+  auto options = rclcpp::NodeOptions();
+  EXPECT_FALSE(options.async_rosout());
+  EXPECT_EQ(1000u, options.async_rosout_queue_depth());
+
+  // rclcpp publishes on /rosout instead of rcl.
+  options.async_rosout(true).async_rosout_queue_depth(10);
+  EXPECT_TRUE(options.async_rosout());
+  EXPECT_EQ(10u, options.async_rosout_queue_depth());
+  EXPECT_TRUE(options.enable_rosout());
+  EXPECT_FALSE(options.get_rcl_node_options()->enable_rosout);
+
+  options.async_rosout(false);
+  EXPECT_TRUE(options.get_rcl_node_options()->enable_rosout);
+
+  EXPECT_THROW(options.async_rosout_queue_depth(0), std::invalid_argument);
+}
+
 TEST(TestNodeOptions, copy) {
   std::vector<std::string> expected_args{"--unknown-flag", "arg"};
   auto options = rclcpp::NodeOptions().arguments(expected_args).use_global_arguments(false);
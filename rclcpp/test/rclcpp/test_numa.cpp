@@ -0,0 +1,173 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include "rclcpp/allocator/allocator_common.hpp"
+#include "rclcpp/numa.hpp"
+#include "rclcpp/strategies/message_pool_memory_strategy.hpp"
+
+#include "test_msgs/msg/basic_types.hpp"
+
+TEST(TestNuma, detect) {
+  auto topology = rclcpp::NumaTopology::detect();
+  ASSERT_GE(topology.get_node_count(), 1u);
+  for (size_t node = 0; node < topology.get_node_count(); ++node) {
+    EXPECT_FALSE(topology.get_cpus(node).empty());
+  }
+  EXPECT_LT(topology.get_current_node(), topology.get_node_count());
+  EXPECT_THROW(topology.get_cpus(topology.get_node_count()), std::out_of_range);
+}
+
+TEST(TestNuma, simulate) {
+  EXPECT_THROW(rclcpp::NumaTopology::simulate(0), std::invalid_argument);
+
+  auto topology = rclcpp::NumaTopology::simulate(2);
+  ASSERT_EQ(2u, topology.get_node_count());
+  EXPECT_TRUE(topology.is_simulated());
+  EXPECT_EQ(-1, topology.get_memory_node(0));
+  EXPECT_EQ(-1, topology.get_memory_node(1));
+  const auto & cpus = topology.get_cpus(0);
+  ASSERT_FALSE(cpus.empty());
+  EXPECT_EQ(0u, topology.get_node_of_cpu(cpus.front()));
+  EXPECT_EQ(2u, topology.get_node_of_cpu(-1));
+
+  // More nodes than CPUs share the CPUs.
+  auto large_topology = rclcpp::NumaTopology::simulate(4096);
+  EXPECT_EQ(4096u, large_topology.get_node_count());
+  for (size_t node = 0; node < large_topology.get_node_count(); ++node) {
+    EXPECT_EQ(1u, large_topology.get_cpus(node).size());
+  }
+}
+
+TEST(TestNuma, invalid_topology) {
+  EXPECT_THROW(rclcpp::NumaTopology({}, {}), std::invalid_argument);
+  EXPECT_THROW(rclcpp::NumaTopology({{0}}, {0, 1}), std::invalid_argument);
+  EXPECT_THROW(rclcpp::NumaTopology({{0}, {}}, {-1, -1}), std::invalid_argument);
+}
+
+#if defined(__linux__)
+TEST(TestNuma, bind_current_thread) {
+  auto topology = rclcpp::NumaTopology::simulate(2);
+  std::thread thread(
+    [&topology]() {
+      topology.bind_current_thread(1);
+      const auto & cpus = topology.get_cpus(1);
+      for (int i = 0; i < 10; ++i) {
+        EXPECT_NE(cpus.end(), std::find(cpus.begin(), cpus.end(), sched_getcpu()));
+        std::this_thread::yield();
+      }
+      // Threads created by a bound thread are bound too.
+      std::thread([&cpus]() {
+        EXPECT_NE(cpus.end(), std::find(cpus.begin(), cpus.end(), sched_getcpu()));
+      }).join();
+    });
+  thread.join();
+  EXPECT_THROW(topology.bind_current_thread(2), std::out_of_range);
+}
+#endif
+
+TEST(TestNuma, allocate) {
+  auto topology = rclcpp::NumaTopology::detect();
+  const int memory_node = topology.get_memory_node(topology.get_node_count() - 1);
+  for (size_t size : {16u, 4096u, 1024u * 1024u}) {
+    for (int node : {-1, memory_node}) {
+      auto data = static_cast<char *>(rclcpp::numa_allocate(size, node));
+      ASSERT_NE(nullptr, data);
+      std::memset(data, 1, size);
+      rclcpp::numa_deallocate(data);
+    }
+  }
+
+  rclcpp::NumaAllocator<int> allocator(topology, topology.get_node_count() - 1);
+  EXPECT_EQ(memory_node, allocator.get_memory_node());
+  std::vector<int, rclcpp::NumaAllocator<int>> values(allocator);
+  values.resize(100000, 42);
+  EXPECT_EQ(42, values.back());
+  rclcpp::NumaAllocator<char> other_allocator(allocator);
+  EXPECT_TRUE(allocator == other_allocator);
+  EXPECT_EQ(memory_node == -1, allocator == rclcpp::NumaAllocator<char>());
+}
+
+#if defined(__linux__)
+TEST(TestNuma, mapped_blocks_reused) {
+  const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  // A block of a page takes a single page, as it has no header.
+  auto data = static_cast<char *>(rclcpp::numa_allocate(page_size, 0));
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(data) % page_size);
+  std::memset(data, 1, page_size);
+  rclcpp::numa_deallocate(data);
+
+  // Its mapping is reused by the next block of the node, instead of mapping another one.
+  auto other_data = static_cast<char *>(rclcpp::numa_allocate(page_size, 0));
+  EXPECT_EQ(data, other_data);
+  rclcpp::numa_deallocate(other_data);
+
+  // Blocks from the heap never start on a page boundary.
+  std::vector<void *> blocks;
+  for (size_t i = 0; i < 1000; ++i) {
+    blocks.push_back(rclcpp::numa_allocate(64, -1));
+    EXPECT_NE(0u, reinterpret_cast<uintptr_t>(blocks.back()) % page_size);
+  }
+  for (void * block : blocks) {
+    rclcpp::numa_deallocate(block);
+  }
+}
+#endif
+
+TEST(TestNuma, rcl_allocator) {
+  // The memory of node 0 is bound even on a machine without NUMA nodes, so
+  // the blocks of at least a page are mapped.
+  rclcpp::NumaTopology topology({{0}}, {0});
+  // Like subscriptions do, with the allocator rebound to the message type.
+  rclcpp::NumaAllocator<char> allocator(topology, 0);
+  // rcl deallocates without giving the size of the blocks.
+  rcl_allocator_t rcl_allocator = rclcpp::allocator::get_rcl_allocator<char>(allocator);
+  ASSERT_TRUE(rcutils_allocator_is_valid(&rcl_allocator));
+  const size_t page_size = 4096;
+  for (size_t size : {size_t(16), page_size, 4 * page_size}) {
+    auto data = static_cast<char *>(rcl_allocator.allocate(size, rcl_allocator.state));
+    ASSERT_NE(nullptr, data);
+    std::memset(data, 1, size);
+    data = static_cast<char *>(rcl_allocator.reallocate(data, 2 * size, rcl_allocator.state));
+    ASSERT_NE(nullptr, data);
+    std::memset(data, 2, 2 * size);
+    rcl_allocator.deallocate(data, rcl_allocator.state);
+  }
+  rcl_allocator.deallocate(nullptr, rcl_allocator.state);
+}
+
+TEST(TestNuma, message_pool) {
+  using MessagePool =
+    rclcpp::strategies::message_pool_memory_strategy::MessagePoolMemoryStrategy<
+    test_msgs::msg::BasicTypes, 2>;
+  auto topology = rclcpp::NumaTopology::detect();
+  MessagePool pool(rclcpp::NumaAllocator<void>(topology, 0));
+  auto message = pool.borrow_message();
+  ASSERT_NE(nullptr, message);
+  message->int32_value = 42;
+  pool.return_message(message);
+}
@@ -0,0 +1,172 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/parameter_event_handler.hpp"
+
+#include "rcl_interfaces/msg/parameter_event.hpp"
+
+class TestParameterEventHandler : public rclcpp::ParameterEventHandler
+{
+public:
+  explicit TestParameterEventHandler(rclcpp::Node::SharedPtr node)
+  : ParameterEventHandler(node)
+  {}
+
+  void test_event(const rcl_interfaces::msg::ParameterEvent::SharedPtr & event)
+  {
+    callbacks_->handle_event(event);
+  }
+};
+
+class TestNode : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp()
+  {
+    node = std::make_shared<rclcpp::Node>("test_parameter_events_handler", "/ns");
+    handler = std::make_shared<TestParameterEventHandler>(node);
+
+    event = std::make_shared<rcl_interfaces::msg::ParameterEvent>();
+    event->node = "/ns/test_parameter_events_handler";
+    rcl_interfaces::msg::Parameter parameter;
+    parameter.name = "new";
+    parameter.value.type = rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER;
+    parameter.value.integer_value = 1;
+    event->new_parameters.push_back(parameter);
+    parameter.name = "changed";
+    parameter.value.integer_value = 2;
+    event->changed_parameters.push_back(parameter);
+    parameter.name = "deleted";
+    parameter.value.integer_value = 3;
+    event->deleted_parameters.push_back(parameter);
+  }
+
+  void TearDown()
+  {
+    handler.reset();
+    node.reset();
+  }
+
+  rclcpp::Node::SharedPtr node;
+  std::shared_ptr<TestParameterEventHandler> handler;
+  rcl_interfaces::msg::ParameterEvent::SharedPtr event;
+};
+
+TEST_F(TestNode, get_parameter_from_event) {
+  rclcpp::Parameter parameter;
+  EXPECT_TRUE(
+    rclcpp::ParameterEventHandler::get_parameter_from_event(
+      *event, parameter, "new", "/ns/test_parameter_events_handler"));
+  EXPECT_EQ(1, parameter.as_int());
+  EXPECT_TRUE(
+    rclcpp::ParameterEventHandler::get_parameter_from_event(
+      *event, parameter, "changed", "/ns/test_parameter_events_handler"));
+  EXPECT_EQ(2, parameter.as_int());
+  EXPECT_FALSE(
+    rclcpp::ParameterEventHandler::get_parameter_from_event(
+      *event, parameter, "deleted", "/ns/test_parameter_events_handler"));
+  EXPECT_FALSE(
+    rclcpp::ParameterEventHandler::get_parameter_from_event(
+      *event, parameter, "new", "/ns/other_node"));
+
+  auto parameters = rclcpp::ParameterEventHandler::get_parameters_from_event(*event);
+  ASSERT_EQ(2u, parameters.size());
+  EXPECT_EQ("new", parameters[0].get_name());
+  EXPECT_EQ("changed", parameters[1].get_name());
+}
+
+TEST_F(TestNode, parameter_callbacks) {
+  std::vector<int64_t> values;
+  auto callback = [&values](const rclcpp::Parameter & parameter) {
+      values.push_back(parameter.as_int());
+    };
+  // Resolved in the namespace of the node.
+  auto handle_new = handler->add_parameter_callback("new", callback);
+  auto handle_changed = handler->add_parameter_callback(
+    "changed", callback, "test_parameter_events_handler");
+  auto handle_deleted = handler->add_parameter_callback("deleted", callback);
+  auto handle_other_node = handler->add_parameter_callback("new", callback, "/other_node");
+
+  handler->test_event(event);
+  EXPECT_EQ((std::vector<int64_t>{1, 2}), values);
+
+  values.clear();
+  handler->remove_parameter_callback(handle_new);
+  EXPECT_THROW(handler->remove_parameter_callback(handle_new), std::runtime_error);
+  handler->test_event(event);
+  EXPECT_EQ((std::vector<int64_t>{2}), values);
+
+  // Dropping the handle stops the callback as well.
+  values.clear();
+  handle_changed.reset();
+  handler->test_event(event);
+  EXPECT_TRUE(values.empty());
+
+  event->node = "/other_node";
+  handler->test_event(event);
+  EXPECT_EQ((std::vector<int64_t>{1}), values);
+}
+
+TEST_F(TestNode, parameter_event_callbacks) {
+  int calls = 0;
+  auto handle = handler->add_parameter_event_callback(
+    [&calls](const rcl_interfaces::msg::ParameterEvent::SharedPtr &) {
+      calls++;
+    });
+  handler->test_event(event);
+  event->node = "/other_node";
+  handler->test_event(event);
+  EXPECT_EQ(2, calls);
+
+  handler->remove_parameter_event_callback(handle);
+  EXPECT_THROW(handler->remove_parameter_event_callback(handle), std::runtime_error);
+  handler->test_event(event);
+  EXPECT_EQ(2, calls);
+}
+
+TEST_F(TestNode, add_callback_from_callback) {
+  int calls = 0;
+  rclcpp::ParameterCallbackHandle::SharedPtr added_handle;
+  auto handle = handler->add_parameter_callback(
+    "new",
+    [this, &calls, &added_handle](const rclcpp::Parameter &) {
+      calls++;
+      if (!added_handle) {
+        added_handle = handler->add_parameter_callback(
+          "changed", [&calls](const rclcpp::Parameter &) {calls++;});
+      }
+    });
+  handler->test_event(event);
+  EXPECT_EQ(1, calls);
+  handler->test_event(event);
+  EXPECT_EQ(3, calls);
+}
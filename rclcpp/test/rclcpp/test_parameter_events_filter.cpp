@@ -16,6 +16,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/parameter_events_filter.hpp"
@@ -203,3 +204,21 @@ TEST_F(TestParameterEventFilter, validate_data) {
   EXPECT_EQ(1, res.get_events()[0].second->value.integer_value);
   EXPECT_EQ(2, res.get_events()[1].second->value.integer_value);
 }
+
+TEST_F(TestParameterEventFilter, many_names) {
+  std::vector<std::string> names;
+  for (int i = 0; i < 20; ++i) {
+    names.push_back("name" + std::to_string(i));
+  }
+  auto res = rclcpp::ParameterEventsFilter(full, names, {nt, ct, dt});
+  EXPECT_EQ(0u, res.get_events().size());
+
+  names.push_back("changed");
+  names.push_back("deleted");
+  res = rclcpp::ParameterEventsFilter(full, names, {nt, ct, dt});
+  ASSERT_EQ(2u, res.get_events().size());
+  EXPECT_EQ(ct, res.get_events()[0].first);
+  EXPECT_EQ("changed", res.get_events()[0].second->name);
+  EXPECT_EQ(dt, res.get_events()[1].first);
+  EXPECT_EQ("deleted", res.get_events()[1].second->name);
+}
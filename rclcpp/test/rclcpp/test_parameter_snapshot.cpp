@@ -0,0 +1,189 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rclcpp/parameter_snapshot.hpp"
+
+using rclcpp::ParameterSnapshot;
+
+namespace
+{
+
+std::string
+temporary_file(const std::string & name)
+{
+  const std::string path = ::testing::TempDir() + "test_parameter_snapshot_" + name;
+  std::remove(path.c_str());
+  return path;
+}
+
+rclcpp::node_interfaces::ParameterInfo
+make_info(const std::string & name, const rclcpp::ParameterValue & value)
+{
+  rclcpp::node_interfaces::ParameterInfo info;
+  info.value = value;
+  info.descriptor.name = name;
+  info.descriptor.type = value.get_type();
+  return info;
+}
+
+}  // namespace
+
+#if !defined(_WIN32)
+
+TEST(TestParameterSnapshot, write_and_load) {
+  const std::string path = temporary_file("write_and_load");
+  ParameterSnapshot::ParameterInfos parameters;
+  parameters["int"] = make_info("int", rclcpp::ParameterValue(42));
+  parameters["string"] = make_info("string", rclcpp::ParameterValue("value"));
+  parameters["array"] = make_info(
+    "array", rclcpp::ParameterValue(std::vector<double>{1.0, 2.5}));
+  parameters["int"].descriptor.read_only = true;
+  parameters["int"].descriptor.description = "an integer";
+  {
+    ParameterSnapshot snapshot(path, "/ns/node");
+    ParameterSnapshot::ParameterInfos loaded;
+    EXPECT_FALSE(snapshot.load(loaded));
+    snapshot.write(parameters);
+    EXPECT_GT(snapshot.get_size(), 0u);
+    EXPECT_GE(snapshot.get_capacity(), snapshot.get_size());
+    EXPECT_EQ(path, snapshot.get_file_path());
+  }
+
+  ParameterSnapshot snapshot(path, "/ns/node");
+  ParameterSnapshot::ParameterInfos loaded;
+  ASSERT_TRUE(snapshot.load(loaded));
+  ASSERT_EQ(3u, loaded.size());
+  EXPECT_EQ(rclcpp::ParameterValue(42), loaded["int"].value);
+  EXPECT_TRUE(loaded["int"].descriptor.read_only);
+  EXPECT_EQ("an integer", loaded["int"].descriptor.description);
+  EXPECT_EQ(rclcpp::ParameterValue("value"), loaded["string"].value);
+  EXPECT_EQ(rclcpp::ParameterValue(std::vector<double>{1.0, 2.5}), loaded["array"].value);
+}
+
+TEST(TestParameterSnapshot, update_and_load) {
+  const std::string path = temporary_file("update_and_load");
+  ParameterSnapshot::ParameterInfos parameters;
+  {
+    ParameterSnapshot snapshot(path, "/node");
+    // The first update writes the whole file.
+    parameters["a"] = make_info("a", rclcpp::ParameterValue(1));
+    EXPECT_TRUE(snapshot.update("a", parameters));
+    const size_t size = snapshot.get_size();
+    EXPECT_GT(size, 0u);
+
+    parameters["b"] = make_info("b", rclcpp::ParameterValue(true));
+    EXPECT_FALSE(snapshot.update("b", parameters));
+    parameters["a"].value = rclcpp::ParameterValue(2);
+    snapshot.update("a", parameters);
+    parameters.erase("b");
+    snapshot.update("b", parameters);
+    EXPECT_GT(snapshot.get_size(), size);
+  }
+
+  ParameterSnapshot snapshot(path, "/node");
+  ParameterSnapshot::ParameterInfos loaded;
+  ASSERT_TRUE(snapshot.load(loaded));
+  ASSERT_EQ(1u, loaded.size());
+  EXPECT_EQ(rclcpp::ParameterValue(2), loaded["a"].value);
+
+  // Updates go on after a load.
+  parameters["c"] = make_info("c", rclcpp::ParameterValue(3.5));
+  snapshot.update("c", parameters);
+  ParameterSnapshot reopened(path, "/node");
+  ASSERT_TRUE(reopened.load(loaded));
+  EXPECT_EQ(2u, loaded.size());
+  EXPECT_EQ(rclcpp::ParameterValue(3.5), loaded["c"].value);
+}
+
+TEST(TestParameterSnapshot, compaction) {
+  const std::string path = temporary_file("compaction");
+  ParameterSnapshot snapshot(path, "/node");
+  ParameterSnapshot::ParameterInfos parameters;
+  parameters["value"] = make_info("value", rclcpp::ParameterValue(0));
+  snapshot.write(parameters);
+  const size_t capacity = snapshot.get_capacity();
+
+  // Enough updates to fill the file, which is then rewritten with a single record.
+  size_t previous_size = snapshot.get_size();
+  bool compacted = false;
+  for (int i = 1; i < 100000 && !compacted; ++i) {
+    parameters["value"].value = rclcpp::ParameterValue(i);
+    const bool rewritten = snapshot.update("value", parameters);
+    compacted = snapshot.get_size() < previous_size;
+    EXPECT_EQ(compacted, rewritten);
+    previous_size = snapshot.get_size();
+  }
+  EXPECT_TRUE(compacted);
+  EXPECT_EQ(capacity, snapshot.get_capacity());
+
+  ParameterSnapshot reopened(path, "/node");
+  ParameterSnapshot::ParameterInfos loaded;
+  ASSERT_TRUE(reopened.load(loaded));
+  EXPECT_EQ(parameters["value"].value, loaded["value"].value);
+}
+
+TEST(TestParameterSnapshot, other_node) {
+  const std::string path = temporary_file("other_node");
+  ParameterSnapshot::ParameterInfos parameters;
+  parameters["a"] = make_info("a", rclcpp::ParameterValue(1));
+  ParameterSnapshot(path, "/node").write(parameters);
+
+  ParameterSnapshot snapshot(path, "/other_node");
+  ParameterSnapshot::ParameterInfos loaded;
+  EXPECT_FALSE(snapshot.load(loaded));
+  EXPECT_TRUE(loaded.empty());
+}
+
+TEST(TestParameterSnapshot, corrupted) {
+  const std::string path = temporary_file("corrupted");
+  ParameterSnapshot::ParameterInfos parameters;
+  parameters["a"] = make_info("a", rclcpp::ParameterValue("some value"));
+  ParameterSnapshot(path, "/node").write(parameters);
+  {
+    // Change a byte of the serialized parameter, past the header and the node name.
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(32 + 8 + 16 + 4 + 4 + 2);
+    file.put('X');
+  }
+  ParameterSnapshot snapshot(path, "/node");
+  ParameterSnapshot::ParameterInfos loaded;
+  EXPECT_FALSE(snapshot.load(loaded));
+
+  {
+    std::ofstream file(path, std::ios::trunc | std::ios::binary);
+    file << "not a snapshot";
+  }
+  ParameterSnapshot other_snapshot(path, "/node");
+  EXPECT_FALSE(other_snapshot.load(loaded));
+  // Rewritten before being updated.
+  other_snapshot.update("a", parameters);
+  ParameterSnapshot reopened(path, "/node");
+  ASSERT_TRUE(reopened.load(loaded));
+  EXPECT_EQ(parameters["a"].value, loaded["a"].value);
+}
+
+TEST(TestParameterSnapshot, invalid_path) {
+  EXPECT_THROW(
+    ParameterSnapshot("/nonexistent/directory/file", "/node"), std::runtime_error);
+}
+
+#endif
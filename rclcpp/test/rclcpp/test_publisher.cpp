@@ -185,11 +185,7 @@ static std::vector<TestParameters> invalid_qos_profiles()
 {
   std::vector<TestParameters> parameters;
 
-  parameters.reserve(2);
-  parameters.push_back(
-    TestParameters(
-      rclcpp::QoS(rclcpp::KeepLast(10)).transient_local(),
-      "transient_local_qos"));
+  parameters.reserve(1);
   parameters.push_back(
     TestParameters(
       rclcpp::QoS(rclcpp::KeepAll()),
@@ -298,6 +294,11 @@ TEST_F(TestPublisher, serialized_message_publish) {
   EXPECT_NO_THROW(publisher->publish(serialized_msg));
 
   EXPECT_NO_THROW(publisher->publish(serialized_msg.get_rcl_serialized_message()));
+
+  // Data held elsewhere is published without being copied.
+  const uint8_t data[] = {0, 1, 0, 0};
+  rclcpp::SerializedMessage borrowed_msg(data, sizeof(data));
+  EXPECT_NO_THROW(publisher->publish(borrowed_msg));
 }
 
 TEST_F(TestPublisher, rcl_publisher_init_error) {
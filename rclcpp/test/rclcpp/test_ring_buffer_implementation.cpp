@@ -13,6 +13,7 @@
 // limitations under the License.
 
 
+#include <chrono>
 #include <memory>
 #include <utility>
 
@@ -79,3 +80,49 @@ TEST(TestRingBufferImplementation, basic_usage) {
   EXPECT_EQ(false, rb.has_data());
   EXPECT_EQ(false, rb.is_full());
 }
+
+/*
+   Removing old elements
+   - nothing is removed unless enqueue times are recorded
+   - only the elements enqueued before the given time are removed
+ */
+TEST(TestRingBufferImplementation, remove_enqueued_before) {
+  rclcpp::experimental::buffers::RingBufferImplementation<char> rb(3);
+
+  rb.enqueue('a');
+  EXPECT_EQ(0u, rb.remove_enqueued_before(std::chrono::steady_clock::now()));
+  EXPECT_EQ(true, rb.has_data());
+
+  rclcpp::experimental::buffers::RingBufferImplementation<char> timed_rb(3, true);
+
+  timed_rb.enqueue('a');
+  timed_rb.enqueue('b');
+  auto time = std::chrono::steady_clock::now() + std::chrono::nanoseconds(1);
+  while (std::chrono::steady_clock::now() <= time) {}
+  timed_rb.enqueue('c');
+
+  EXPECT_EQ(2u, timed_rb.remove_enqueued_before(time));
+  EXPECT_EQ(true, timed_rb.has_data());
+  EXPECT_EQ('c', timed_rb.dequeue());
+  EXPECT_EQ(false, timed_rb.has_data());
+  EXPECT_EQ(0u, timed_rb.remove_enqueued_before(std::chrono::steady_clock::now()));
+}
+
+/*
+   Memory usage
+   - the ring is always accounted
+   - stored elements are accounted with the given size
+ */
+TEST(TestRingBufferImplementation, get_memory_usage) {
+  rclcpp::experimental::buffers::RingBufferImplementation<std::unique_ptr<int>> rb(4);
+
+  const size_t empty_usage = rb.get_memory_usage(100);
+  EXPECT_GE(empty_usage, 4 * sizeof(std::unique_ptr<int>));
+
+  rb.enqueue(std::make_unique<int>(1));
+  rb.enqueue(std::make_unique<int>(2));
+  EXPECT_EQ(empty_usage + 200, rb.get_memory_usage(100));
+
+  rb.dequeue();
+  EXPECT_EQ(empty_usage + 100, rb.get_memory_usage(100));
+}
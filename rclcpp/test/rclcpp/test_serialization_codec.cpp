@@ -0,0 +1,278 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/serialization_codec.hpp"
+#include "rclcpp/serialized_message.hpp"
+
+#include "test_msgs/msg/strings.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+std::vector<uint8_t>
+encode(const rclcpp::SerializationCodec & codec, const std::vector<uint8_t> & data)
+{
+  std::vector<uint8_t> encoded(codec.get_max_encoded_size(data.size()));
+  encoded.resize(codec.encode(data.data(), data.size(), encoded.data()));
+  return encoded;
+}
+
+std::vector<uint8_t>
+decode(const rclcpp::SerializationCodec & codec, const std::vector<uint8_t> & encoded)
+{
+  std::vector<uint8_t> data(codec.get_decoded_size(encoded.data(), encoded.size()));
+  codec.decode(encoded.data(), encoded.size(), data.data(), data.size());
+  return data;
+}
+
+std::vector<uint8_t>
+make_random_data(size_t size)
+{
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<uint8_t> data(size);
+  for (auto & byte : data) {
+    byte = static_cast<uint8_t>(distribution(generator));
+  }
+  return data;
+}
+
+}  // namespace
+
+TEST(TestSerializationCodec, lz_round_trip) {
+  rclcpp::LZCodec codec;
+  EXPECT_EQ("lz", codec.get_name());
+
+  std::vector<std::vector<uint8_t>> inputs;
+  inputs.emplace_back();
+  inputs.emplace_back(1, 7);
+  inputs.emplace_back(100000, 0);
+  inputs.push_back(make_random_data(100000));
+  std::vector<uint8_t> text;
+  for (int i = 0; i < 1000; ++i) {
+    const std::string line = "line " + std::to_string(i % 37) + " of a repetitive map\n";
+    text.insert(text.end(), line.begin(), line.end());
+  }
+  inputs.push_back(text);
+
+  for (const auto & data : inputs) {
+    auto encoded = encode(codec, data);
+    EXPECT_LE(encoded.size(), codec.get_max_encoded_size(data.size()));
+    EXPECT_EQ(data, decode(codec, encoded));
+  }
+  // Compressible data is compressed.
+  EXPECT_LT(encode(codec, inputs[2]).size(), inputs[2].size() / 100);
+  EXPECT_LT(encode(codec, text).size(), text.size() / 4);
+}
+
+TEST(TestSerializationCodec, lz_invalid_data) {
+  rclcpp::LZCodec codec;
+  std::vector<uint8_t> text(1000);
+  for (size_t i = 0; i < text.size(); ++i) {
+    text[i] = static_cast<uint8_t>('a' + i % 13);
+  }
+  auto encoded = encode(codec, text);
+
+  // Truncated.
+  for (size_t size : {size_t(0), size_t(3), encoded.size() / 2, encoded.size() - 1}) {
+    std::vector<uint8_t> truncated(encoded.begin(), encoded.begin() + size);
+    EXPECT_THROW(decode(codec, truncated), std::runtime_error);
+  }
+  // Wrong decoded size.
+  auto wrong_size = encoded;
+  wrong_size[0] ^= 1;
+  EXPECT_THROW(decode(codec, wrong_size), std::runtime_error);
+  std::vector<uint8_t> data(text.size() + 1);
+  EXPECT_THROW(
+    codec.decode(encoded.data(), encoded.size(), data.data(), data.size()), std::runtime_error);
+  // Decoded size larger than the encoded data can decode to.
+  std::vector<uint8_t> too_large = {0xff, 0xff, 0xff, 0xff, 0x00};
+  EXPECT_THROW(codec.get_decoded_size(too_large.data(), too_large.size()), std::runtime_error);
+  std::vector<uint8_t> largest = {0xff, 0, 0, 0, 0x00};
+  EXPECT_EQ(255u, codec.get_decoded_size(largest.data(), largest.size()));
+  largest[0] = 0;
+  largest[1] = 1;
+  EXPECT_THROW(codec.get_decoded_size(largest.data(), largest.size()), std::runtime_error);
+  // Offset before the start of the data.
+  std::vector<uint8_t> bad_offset = {8, 0, 0, 0, 0x40, 'a', 'b', 'c', 'd', 0x05, 0x00};
+  EXPECT_THROW(decode(codec, bad_offset), std::runtime_error);
+
+  // Any corruption is detected or decodes to some data, but never goes out of bounds.
+  for (size_t i = 4; i < encoded.size(); ++i) {
+    auto corrupted = encoded;
+    corrupted[i] ^= 0x5a;
+    try {
+      decode(codec, corrupted);
+    } catch (const std::runtime_error &) {
+    }
+  }
+}
+
+TEST(TestSerializationCodec, serialized_message) {
+  rclcpp::LZCodec codec;
+  rclcpp::SerializedMessage serialized_message(1004);
+  auto & rcl_serialized_message = serialized_message.get_rcl_serialized_message();
+  const uint8_t header[4] = {0, 1, 0, 0};
+  std::memcpy(rcl_serialized_message.buffer, header, sizeof(header));
+  std::memset(rcl_serialized_message.buffer + 4, 'x', 1000);
+  rcl_serialized_message.buffer_length = 1004;
+
+  rclcpp::SerializedMessage encoded_message;
+  rclcpp::encode_serialized_message(codec, rcl_serialized_message, encoded_message);
+  EXPECT_LT(encoded_message.size(), 100u);
+  // The header is kept.
+  EXPECT_EQ(
+    0, std::memcmp(header, encoded_message.get_rcl_serialized_message().buffer, sizeof(header)));
+
+  rclcpp::SerializedMessage decoded_message;
+  rclcpp::decode_serialized_message(
+    codec, encoded_message.get_rcl_serialized_message(), decoded_message);
+  ASSERT_EQ(serialized_message.size(), decoded_message.size());
+  EXPECT_EQ(
+    0, std::memcmp(
+      rcl_serialized_message.buffer,
+      decoded_message.get_rcl_serialized_message().buffer,
+      serialized_message.size()));
+
+  rclcpp::SerializedMessage too_short;
+  EXPECT_THROW(
+    rclcpp::encode_serialized_message(
+      codec, too_short.get_rcl_serialized_message(), encoded_message),
+    std::invalid_argument);
+  EXPECT_THROW(
+    rclcpp::decode_serialized_message(
+      codec, too_short.get_rcl_serialized_message(), decoded_message),
+    std::runtime_error);
+
+  // Not allocated for the decoded size of invalid data.
+  rclcpp::SerializedMessage too_large(9);
+  auto & rcl_too_large = too_large.get_rcl_serialized_message();
+  const uint8_t too_large_data[9] = {0, 1, 0, 0, 0xff, 0xff, 0xff, 0xff, 0x00};
+  std::memcpy(rcl_too_large.buffer, too_large_data, sizeof(too_large_data));
+  rcl_too_large.buffer_length = sizeof(too_large_data);
+  EXPECT_THROW(
+    rclcpp::decode_serialized_message(codec, rcl_too_large, decoded_message),
+    std::runtime_error);
+  EXPECT_EQ(serialized_message.size(), decoded_message.capacity());
+
+  // Borrowed data is never written, even when it is large enough.
+  std::vector<uint8_t> data(2000);
+  rclcpp::SerializedMessage borrowed(data.data(), data.size());
+  EXPECT_THROW(
+    rclcpp::encode_serialized_message(codec, rcl_serialized_message, borrowed),
+    std::runtime_error);
+  EXPECT_THROW(
+    rclcpp::decode_serialized_message(
+      codec, encoded_message.get_rcl_serialized_message(), borrowed),
+    std::runtime_error);
+}
+
+TEST(TestSerializationCodec, serialized_message_pool) {
+  rclcpp::SerializedMessagePool pool(1);
+  auto first = pool.acquire();
+  auto second = pool.acquire();
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  first->reserve(64);
+  auto first_address = first.get();
+  pool.release(std::move(first));
+  // Not kept, as the pool is full.
+  pool.release(std::move(second));
+  pool.release(nullptr);
+
+  auto reused = pool.acquire();
+  EXPECT_EQ(first_address, reused.get());
+  EXPECT_EQ(64u, reused->capacity());
+}
+
+TEST(TestSerializationCodec, encoded_topic_name) {
+  rclcpp::LZCodec codec;
+  EXPECT_EQ("/map/encoded_lz", rclcpp::get_encoded_topic_name("/map", codec));
+  EXPECT_EQ("map/encoded_lz", rclcpp::get_encoded_topic_name("map", codec));
+}
+
+class TestSerializationCodecPubSub : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestSerializationCodecPubSub, publish_and_subscribe) {
+  auto node = std::make_shared<rclcpp::Node>("test_serialization_codec", "/ns");
+  auto codec = std::make_shared<rclcpp::LZCodec>();
+
+  rclcpp::PublisherOptions publisher_options;
+  publisher_options.serialization_codec = codec;
+  auto publisher = node->create_publisher<test_msgs::msg::Strings>(
+    "topic", 10, publisher_options);
+  EXPECT_STREQ("/ns/topic/encoded_lz", publisher->get_topic_name());
+
+  rclcpp::SubscriptionOptions subscription_options;
+  subscription_options.serialization_codec = codec;
+  std::vector<test_msgs::msg::Strings> received;
+  auto subscription = node->create_subscription<test_msgs::msg::Strings>(
+    "topic", 10,
+    [&received](test_msgs::msg::Strings::UniquePtr message) {
+      received.push_back(*message);
+    },
+    subscription_options);
+  size_t serialized_received = 0;
+  auto serialized_subscription = node->create_subscription<test_msgs::msg::Strings>(
+    "topic", 10,
+    [&serialized_received](std::shared_ptr<rclcpp::SerializedMessage> message) {
+      (void)message;
+      ++serialized_received;
+    },
+    subscription_options);
+  EXPECT_STREQ("/ns/topic/encoded_lz", subscription->get_topic_name());
+
+  test_msgs::msg::Strings message;
+  message.string_value = std::string(10000, 'r');
+  message.bounded_string_value = "bounded";
+  publisher->publish(message);
+
+  auto start = std::chrono::steady_clock::now();
+  while ((received.empty() || 0u == serialized_received) &&
+    std::chrono::steady_clock::now() - start < 10s)
+  {
+    rclcpp::spin_some(node);
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_EQ(1u, received.size());
+  EXPECT_EQ(message, received[0]);
+  EXPECT_EQ(1u, serialized_received);
+}
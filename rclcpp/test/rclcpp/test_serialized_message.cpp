@@ -16,8 +16,10 @@
 
 #include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "rclcpp/serialization.hpp"
 #include "rclcpp/serialized_message.hpp"
@@ -140,6 +142,55 @@ TEST(TestSerializedMessage, release) {
   EXPECT_EQ(RCL_RET_OK, rmw_serialized_message_fini(&released_handle));
 }
 
+TEST(TestSerializedMessage, borrowed) {
+  const std::string content = "Hello World";
+  auto owner = std::make_shared<std::vector<uint8_t>>(content.begin(), content.end());
+  std::weak_ptr<std::vector<uint8_t>> weak_owner = owner;
+  {
+    rclcpp::SerializedMessage borrowed(owner->data(), owner->size(), owner);
+    const rclcpp::SerializedMessage & const_borrowed = borrowed;
+    owner.reset();
+    EXPECT_FALSE(weak_owner.expired());
+    EXPECT_TRUE(borrowed.is_borrowed());
+    EXPECT_EQ(content.size(), borrowed.size());
+    EXPECT_EQ(weak_owner.lock()->data(), const_borrowed.get_rcl_serialized_message().buffer);
+    EXPECT_THROW(borrowed.get_rcl_serialized_message(), std::runtime_error);
+    EXPECT_THROW(borrowed.reserve(100), std::runtime_error);
+    EXPECT_THROW(borrowed.release_rcl_serialized_message(), std::runtime_error);
+
+    // Copies own their data.
+    rclcpp::SerializedMessage copy(borrowed);
+    EXPECT_FALSE(copy.is_borrowed());
+    EXPECT_NE(
+      const_borrowed.get_rcl_serialized_message().buffer,
+      copy.get_rcl_serialized_message().buffer);
+    EXPECT_EQ(
+      0, std::memcmp(
+        const_borrowed.get_rcl_serialized_message().buffer,
+        copy.get_rcl_serialized_message().buffer, content.size()));
+    copy.reserve(100);
+
+    rclcpp::SerializedMessage assigned;
+    assigned = borrowed;
+    EXPECT_FALSE(assigned.is_borrowed());
+    EXPECT_EQ(content.size(), assigned.size());
+
+    // Moves keep borrowing.
+    rclcpp::SerializedMessage moved(std::move(borrowed));
+    EXPECT_TRUE(moved.is_borrowed());
+    EXPECT_FALSE(borrowed.is_borrowed());
+    EXPECT_EQ(
+      weak_owner.lock()->data(),
+      static_cast<const rclcpp::SerializedMessage &>(moved).get_rcl_serialized_message().buffer);
+    rclcpp::SerializedMessage move_assigned;
+    move_assigned = std::move(moved);
+    EXPECT_TRUE(move_assigned.is_borrowed());
+    EXPECT_FALSE(weak_owner.expired());
+  }
+  // Released, but not freed, with the last borrowing serialized message.
+  EXPECT_TRUE(weak_owner.expired());
+}
+
 TEST(TestSerializedMessage, reserve) {
   rclcpp::SerializedMessage serialized_msg(13);
   EXPECT_EQ(13u, serialized_msg.capacity());
@@ -0,0 +1,322 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "rclcpp/experimental/shared_memory_channel.hpp"
+#include "rclcpp/experimental/shared_memory_transport.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/serialized_message.hpp"
+
+#include "test_msgs/msg/strings.hpp"
+
+using rclcpp::experimental::SharedMemoryChannel;
+
+#if defined(__linux__)
+
+class TestSharedMemoryChannel : public ::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    name = SharedMemoryChannel::get_channel_name(
+      "/test_shared_memory_channel/" +
+      std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()),
+      static_cast<size_t>(getpid()));
+    SharedMemoryChannel::remove(name);
+  }
+
+  void TearDown()
+  {
+    SharedMemoryChannel::remove(name);
+  }
+
+  std::string name;
+};
+
+std::vector<uint8_t>
+make_data(size_t size, uint8_t seed)
+{
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(seed + i);
+  }
+  return data;
+}
+
+bool
+equals(const std::vector<uint8_t> & data, const rclcpp::SerializedMessage & message)
+{
+  return data.size() == message.size() &&
+         0 == std::memcmp(data.data(), message.get_rcl_serialized_message().buffer, data.size());
+}
+
+TEST(TestSharedMemoryChannelName, get_channel_name) {
+  EXPECT_EQ(
+    "/rclcpp_shm_0.ns.chatter", SharedMemoryChannel::get_channel_name("/ns/chatter", 0));
+  EXPECT_EQ("/rclcpp_shm_42.chatter", SharedMemoryChannel::get_channel_name("/chatter", 42));
+}
+
+TEST_F(TestSharedMemoryChannel, invalid_arguments) {
+  EXPECT_THROW(SharedMemoryChannel(name, 0, 1024), std::invalid_argument);
+  EXPECT_THROW(SharedMemoryChannel(name, 4, 0), std::invalid_argument);
+  EXPECT_THROW(SharedMemoryChannel("not_a_valid/name", 4, 1024), std::runtime_error);
+}
+
+TEST_F(TestSharedMemoryChannel, geometry_mismatch) {
+  SharedMemoryChannel channel(name, 4, 1024);
+  EXPECT_EQ(4u, channel.get_number_of_slots());
+  EXPECT_EQ(1024u, channel.get_slot_size());
+  EXPECT_THROW(SharedMemoryChannel(name, 8, 1024), std::runtime_error);
+  EXPECT_THROW(SharedMemoryChannel(name, 4, 2048), std::runtime_error);
+  EXPECT_NO_THROW(SharedMemoryChannel(name, 4, 1024));
+}
+
+TEST_F(TestSharedMemoryChannel, write_and_take) {
+  SharedMemoryChannel writer(name, 4, 1024);
+  SharedMemoryChannel reader(name, 4, 1024);
+  rclcpp::SerializedMessage message;
+
+  uint64_t sequence = reader.get_write_sequence();
+  EXPECT_FALSE(reader.has_data(sequence));
+  EXPECT_FALSE(reader.take(sequence, message));
+
+  const auto first = make_data(1024, 1);
+  const auto second = make_data(10, 2);
+  const std::vector<uint8_t> empty;
+  EXPECT_TRUE(writer.write(first.data(), first.size()));
+  EXPECT_TRUE(writer.write(second.data(), second.size()));
+  EXPECT_TRUE(writer.write(empty.data(), empty.size()));
+  EXPECT_EQ(3u, reader.get_write_sequence());
+
+  EXPECT_TRUE(reader.has_data(sequence));
+  ASSERT_TRUE(reader.take(sequence, message));
+  EXPECT_TRUE(equals(first, message));
+  ASSERT_TRUE(reader.take(sequence, message));
+  EXPECT_TRUE(equals(second, message));
+  ASSERT_TRUE(reader.take(sequence, message));
+  EXPECT_EQ(0u, message.size());
+  EXPECT_EQ(3u, sequence);
+  EXPECT_FALSE(reader.take(sequence, message));
+  EXPECT_EQ(0u, reader.get_dropped_count());
+
+  // Messages larger than a slot are not written.
+  const auto too_large = make_data(1025, 3);
+  EXPECT_FALSE(writer.write(too_large.data(), too_large.size()));
+  EXPECT_FALSE(reader.has_data(sequence));
+}
+
+TEST_F(TestSharedMemoryChannel, overrun) {
+  SharedMemoryChannel channel(name, 4, 64);
+  rclcpp::SerializedMessage message;
+  uint64_t sequence = channel.get_write_sequence();
+  for (uint8_t i = 0; i < 10; ++i) {
+    const auto data = make_data(16, i);
+    ASSERT_TRUE(channel.write(data.data(), data.size()));
+  }
+  // Only the last messages are left.
+  for (uint8_t i = 6; i < 10; ++i) {
+    ASSERT_TRUE(channel.take(sequence, message));
+    EXPECT_TRUE(equals(make_data(16, i), message));
+  }
+  EXPECT_FALSE(channel.take(sequence, message));
+  EXPECT_EQ(6u, channel.get_dropped_count());
+}
+
+TEST_F(TestSharedMemoryChannel, wait_for_data) {
+  SharedMemoryChannel writer(name, 4, 1024);
+  SharedMemoryChannel reader(name, 4, 1024);
+  const uint64_t sequence = reader.get_write_sequence();
+  EXPECT_FALSE(reader.wait_for_data(sequence, std::chrono::milliseconds(10)));
+
+  const auto data = make_data(100, 0);
+  std::thread thread(
+    [&writer, &data]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      writer.write(data.data(), data.size());
+    });
+  const auto start = std::chrono::steady_clock::now();
+  bool has_data = false;
+  while (!has_data && std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+    has_data = reader.wait_for_data(sequence, std::chrono::seconds(10));
+  }
+  thread.join();
+  EXPECT_TRUE(has_data);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  // Returns right away once there is data.
+  EXPECT_TRUE(reader.wait_for_data(sequence, std::chrono::seconds(10)));
+}
+
+TEST_F(TestSharedMemoryChannel, writers_and_readers) {
+  SharedMemoryChannel channel(name, 4, 1024);
+  rmw_gid_t gid = {};
+  gid.data[0] = 1;
+  rmw_gid_t other_gid = {};
+  other_gid.data[0] = 2;
+
+  EXPECT_FALSE(channel.has_writer(gid));
+  channel.add_writer(gid);
+  EXPECT_TRUE(channel.has_writer(gid));
+  EXPECT_FALSE(channel.has_writer(other_gid));
+  channel.remove_writer(gid);
+  EXPECT_FALSE(channel.has_writer(gid));
+
+  for (size_t i = 0; i < SharedMemoryChannel::max_number_of_writers; ++i) {
+    channel.add_writer(other_gid);
+  }
+  EXPECT_THROW(channel.add_writer(gid), std::runtime_error);
+
+  EXPECT_EQ(0u, channel.get_reader_count());
+  const size_t index = channel.register_reader();
+  EXPECT_EQ(1u, channel.get_reader_count());
+  SharedMemoryChannel other_channel(name, 4, 1024);
+  const size_t other_index = other_channel.register_reader();
+  EXPECT_NE(index, other_index);
+  EXPECT_EQ(2u, channel.get_reader_count());
+  channel.unregister_reader(index);
+  other_channel.unregister_reader(other_index);
+  EXPECT_EQ(0u, channel.get_reader_count());
+}
+
+TEST_F(TestSharedMemoryChannel, across_processes) {
+  constexpr size_t number_of_slots = 8;
+  constexpr uint8_t number_of_messages = 100;
+  const std::string acknowledgement_name = name + "_ack";
+  SharedMemoryChannel::remove(acknowledgement_name);
+  SharedMemoryChannel channel(name, number_of_slots, 4096);
+  SharedMemoryChannel acknowledgements(acknowledgement_name, 1, 1);
+  uint64_t sequence = channel.get_write_sequence();
+
+  const pid_t pid = fork();
+  ASSERT_NE(-1, pid);
+  if (0 == pid) {
+    // The child never gets more than the number of slots ahead of the parent.
+    int status = 0;
+    try {
+      SharedMemoryChannel writer(name, number_of_slots, 4096);
+      SharedMemoryChannel reader(acknowledgement_name, 1, 1);
+      for (uint8_t i = 0; i < number_of_messages; ++i) {
+        while (reader.get_write_sequence() + number_of_slots <= i) {
+          std::this_thread::yield();
+        }
+        const auto data = make_data(4096, i);
+        writer.write(data.data(), data.size());
+      }
+    } catch (...) {
+      status = 1;
+    }
+    _exit(status);
+  }
+
+  rclcpp::SerializedMessage message;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint8_t i = 0; i < number_of_messages; ++i) {
+    while (!channel.take(sequence, message) &&
+      std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+    {
+      channel.wait_for_data(sequence, std::chrono::milliseconds(100));
+    }
+    ASSERT_TRUE(equals(make_data(4096, i), message));
+    acknowledgements.write(nullptr, 0);
+  }
+  EXPECT_EQ(0u, channel.get_dropped_count());
+  int status = 0;
+  ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(0, WEXITSTATUS(status));
+  SharedMemoryChannel::remove(acknowledgement_name);
+}
+
+class TestSharedMemoryTransport : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+};
+
+TEST_F(TestSharedMemoryTransport, publish_and_subscribe) {
+  auto node = std::make_shared<rclcpp::Node>("test_shared_memory_transport");
+  const std::string topic_name = "shared_memory_transport";
+  std::vector<std::string> received;
+  auto subscription =
+    std::make_shared<rclcpp::experimental::SharedMemorySubscription<test_msgs::msg::Strings>>(
+    node, topic_name, rclcpp::QoS(10),
+    [&received](std::shared_ptr<const test_msgs::msg::Strings> message) {
+      received.push_back(message->string_value);
+    });
+  auto publisher =
+    std::make_shared<rclcpp::experimental::SharedMemoryPublisher<test_msgs::msg::Strings>>(
+    node, topic_name, rclcpp::QoS(10));
+  ASSERT_TRUE(subscription->uses_shared_memory());
+  ASSERT_TRUE(publisher->uses_shared_memory());
+  auto regular_subscription = node->create_subscription<test_msgs::msg::Strings>(
+    topic_name, rclcpp::QoS(10), [](std::shared_ptr<const test_msgs::msg::Strings>) {});
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  // Wait for the middleware subscriptions to be matched.
+  const auto start = std::chrono::steady_clock::now();
+  while (publisher->get_publisher()->get_subscription_count() < 2u &&
+    std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // Also published through the middleware for the regular subscription,
+  // but received only once.
+  test_msgs::msg::Strings message;
+  message.string_value = std::string(1024 * 1024, 'a');
+  publisher->publish(message);
+  message.string_value = "b";
+  publisher->publish(message);
+  while (received.size() < 2u &&
+    std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+  {
+    executor.spin_some(std::chrono::milliseconds(10));
+  }
+  executor.spin_some(std::chrono::milliseconds(100));
+  ASSERT_EQ(2u, received.size());
+  EXPECT_EQ(std::string(1024 * 1024, 'a'), received[0]);
+  EXPECT_EQ("b", received[1]);
+  EXPECT_EQ(0u, subscription->get_dropped_count());
+
+  message.string_value = std::string(publisher->get_channel()->get_slot_size(), 'c');
+  EXPECT_THROW(publisher->publish(message), std::invalid_argument);
+
+  // Removed from the node.
+  subscription.reset();
+  executor.spin_some(std::chrono::milliseconds(10));
+}
+
+#endif  // defined(__linux__)
@@ -23,6 +23,7 @@
 
 #include "rclcpp/exceptions.hpp"
 #include "rclcpp/rclcpp.hpp"
+#include "rclcpp/strategies/message_pool_memory_strategy.hpp"
 
 #include "../mocking_utils/patch.hpp"
 #include "../utils/rclcpp_gtest_macros.hpp"
@@ -444,6 +445,61 @@ TEST_F(TestSubscription, handle_loaned_message) {
   EXPECT_NO_THROW(sub->handle_loaned_message(&msg, message_info));
 }
 
+TEST_F(TestSubscription, handle_message_unique_ptr) {
+  initialize();
+  const test_msgs::msg::Empty * received_message = nullptr;
+  auto callback = [&received_message](std::unique_ptr<test_msgs::msg::Empty> msg) {
+      received_message = msg.get();
+    };
+  auto sub = node->create_subscription<test_msgs::msg::Empty>("topic", 10, callback);
+  rclcpp::MessageInfo message_info;
+
+  // The taken message is given to the callback without being copied.
+  std::shared_ptr<void> message = sub->create_message();
+  ASSERT_NE(nullptr, message);
+  const void * taken_message = message.get();
+  EXPECT_NO_THROW(sub->handle_message(message, message_info));
+  EXPECT_EQ(taken_message, received_message);
+  EXPECT_NO_THROW(sub->return_message(message));
+  EXPECT_EQ(nullptr, message);
+
+  // Unless it is still used elsewhere.
+  message = sub->create_message();
+  auto other_owner = message;
+  EXPECT_NO_THROW(sub->handle_message(message, message_info));
+  EXPECT_NE(message.get(), received_message);
+  EXPECT_NO_THROW(sub->return_message(message));
+}
+
+TEST_F(TestSubscription, handle_message_unique_ptr_message_pool) {
+  initialize();
+  using rclcpp::strategies::message_pool_memory_strategy::MessagePoolMemoryStrategy;
+  auto message_pool = std::make_shared<MessagePoolMemoryStrategy<test_msgs::msg::Empty, 1>>();
+  const test_msgs::msg::Empty * received_message = nullptr;
+  auto callback = [&received_message](std::unique_ptr<test_msgs::msg::Empty> msg) {
+      received_message = msg.get();
+    };
+  auto sub = node->create_subscription<test_msgs::msg::Empty>(
+    "topic", 10, callback, rclcpp::SubscriptionOptions(), message_pool);
+  rclcpp::MessageInfo message_info;
+
+  // The message is taken from the pool, and copied for the callback.
+  std::shared_ptr<void> message = sub->create_message();
+  ASSERT_NE(nullptr, message);
+  RCLCPP_EXPECT_THROW_EQ(
+    message_pool->borrow_message(),
+    std::runtime_error("Tried to access message that was still in use! Abort."));
+  EXPECT_NO_THROW(sub->handle_message(message, message_info));
+  EXPECT_NE(nullptr, received_message);
+  EXPECT_NE(message.get(), received_message);
+  EXPECT_NO_THROW(sub->return_message(message));
+
+  // Once returned, the message is available again.
+  message = sub->create_message();
+  ASSERT_NE(nullptr, message);
+  EXPECT_NO_THROW(sub->return_message(message));
+}
+
 /*
    Testing subscription with intraprocess enabled and invalid QoS
  */
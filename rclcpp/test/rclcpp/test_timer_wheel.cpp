@@ -0,0 +1,175 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "rclcpp/detail/timer_wheel.hpp"
+
+using rclcpp::detail::TimerWheel;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+void
+wait_for(const std::atomic<int> & value, int expected)
+{
+  auto end = std::chrono::steady_clock::now() + 5s;
+  while (value.load() < expected && std::chrono::steady_clock::now() < end) {
+    std::this_thread::sleep_for(1ms);
+  }
+}
+
+}  // namespace
+
+TEST(TestTimerWheel, construction) {
+  EXPECT_THROW(TimerWheel(0ms), std::invalid_argument);
+  EXPECT_THROW(TimerWheel(1ms, 0), std::invalid_argument);
+  TimerWheel wheel;
+  EXPECT_EQ(0u, wheel.size());
+  EXPECT_THROW(wheel.add_timer(TimerWheel::Clock::now(), nullptr), std::invalid_argument);
+}
+
+TEST(TestTimerWheel, global_instance) {
+  auto wheel = TimerWheel::get_global_instance();
+  ASSERT_NE(nullptr, wheel);
+  EXPECT_EQ(wheel, TimerWheel::get_global_instance());
+}
+
+TEST(TestTimerWheel, one_shot) {
+  TimerWheel wheel(1ms, 8);
+  std::atomic<int> calls{0};
+  auto start = TimerWheel::Clock::now();
+  TimerWheel::TimePoint called_at;
+  wheel.add_timer(
+    start + 20ms,
+    [&](TimerWheel::TimePoint now) {
+      called_at = now;
+      calls++;
+      return TimerWheel::TimePoint();
+    });
+  EXPECT_EQ(1u, wheel.size());
+  wait_for(calls, 1);
+  EXPECT_EQ(1, calls.load());
+  // Further than the number of slots times the tick, but never early.
+  EXPECT_GE(called_at, start + 20ms);
+  std::this_thread::sleep_for(30ms);
+  EXPECT_EQ(1, calls.load());
+  EXPECT_EQ(0u, wheel.size());
+}
+
+TEST(TestTimerWheel, rearm_and_remove) {
+  TimerWheel wheel(1ms);
+  std::atomic<int> calls{0};
+  auto timer_id = wheel.add_timer(
+    TimerWheel::Clock::now() + 5ms,
+    [&](TimerWheel::TimePoint now) {
+      calls++;
+      return now + 5ms;
+    });
+  wait_for(calls, 3);
+  EXPECT_GE(calls.load(), 3);
+  wheel.remove_timer(timer_id);
+  EXPECT_EQ(0u, wheel.size());
+  int calls_after_removal = calls.load();
+  std::this_thread::sleep_for(20ms);
+  EXPECT_EQ(calls_after_removal, calls.load());
+  // Removing again does nothing.
+  wheel.remove_timer(timer_id);
+}
+
+TEST(TestTimerWheel, remove_from_callback) {
+  TimerWheel wheel(1ms);
+  std::atomic<int> calls{0};
+  TimerWheel::TimerId timer_id = 0;
+  std::atomic<bool> added{false};
+  timer_id = wheel.add_timer(
+    TimerWheel::Clock::now() + 1ms,
+    [&](TimerWheel::TimePoint now) {
+      while (!added.load()) {}
+      wheel.remove_timer(timer_id);
+      calls++;
+      return now + 1ms;
+    });
+  added.store(true);
+  wait_for(calls, 1);
+  std::this_thread::sleep_for(10ms);
+  EXPECT_EQ(1, calls.load());
+  EXPECT_EQ(0u, wheel.size());
+}
+
+TEST(TestTimerWheel, throwing_callback_is_removed) {
+  TimerWheel wheel(1ms);
+  std::atomic<int> calls{0};
+  wheel.add_timer(
+    TimerWheel::Clock::now(),
+    [&](TimerWheel::TimePoint) -> TimerWheel::TimePoint {
+      calls++;
+      throw std::runtime_error("error");
+    });
+  wait_for(calls, 1);
+  std::this_thread::sleep_for(10ms);
+  EXPECT_EQ(1, calls.load());
+  EXPECT_EQ(0u, wheel.size());
+}
+
+TEST(TestTimerWheel, destroyed_from_callback) {
+  auto wheel = std::make_shared<TimerWheel>(1ms);
+  std::atomic<int> calls{0};
+  auto expiration_time = TimerWheel::Clock::now() + 5ms;
+  // Both expire in the same tick, so the wheel still runs timers once destroyed.
+  for (int i = 0; i < 2; ++i) {
+    wheel->add_timer(
+      expiration_time,
+      [&wheel, &calls](TimerWheel::TimePoint) {
+        wheel.reset();
+        calls++;
+        return TimerWheel::TimePoint();
+      });
+  }
+  wait_for(calls, 1);
+  std::this_thread::sleep_for(10ms);
+  EXPECT_EQ(1, calls.load());
+  EXPECT_EQ(nullptr, wheel);
+}
+
+TEST(TestTimerWheel, sleeps_until_expiration) {
+  TimerWheel wheel(1ms, 8);
+  std::atomic<int> calls{0};
+  auto start = TimerWheel::Clock::now();
+  TimerWheel::TimePoint called_at;
+  wheel.add_timer(
+    start + 50ms,
+    [&](TimerWheel::TimePoint now) {
+      called_at = now;
+      calls++;
+      return TimerWheel::TimePoint();
+    });
+  // Expires before the first one, while the thread waits for it.
+  wheel.add_timer(
+    start + 10ms,
+    [&](TimerWheel::TimePoint now) {
+      EXPECT_LT(now, start + 50ms);
+      calls++;
+      return TimerWheel::TimePoint();
+    });
+  wait_for(calls, 2);
+  EXPECT_EQ(2, calls.load());
+  EXPECT_GE(called_at, start + 50ms);
+}
@@ -0,0 +1,109 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "rclcpp/type_support_registry.hpp"
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+
+#include "test_msgs/message_fixtures.hpp"
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/empty.hpp"
+
+TEST(TestTypeSupportRegistry, get_message_type_support) {
+  rclcpp::TypeSupportRegistry registry;
+  EXPECT_EQ(0u, registry.get_library_count());
+
+  auto type_support = registry.get_message_type_support("test_msgs/msg/BasicTypes");
+  ASSERT_NE(nullptr, type_support);
+  EXPECT_STREQ(
+    rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::BasicTypes>()->
+    typesupport_identifier,
+    type_support->typesupport_identifier);
+  EXPECT_EQ(1u, registry.get_library_count());
+
+  // Cached, and the library is shared by the types of the package.
+  EXPECT_EQ(type_support, registry.get_message_type_support("test_msgs/msg/BasicTypes"));
+  EXPECT_EQ(type_support, registry.get_message_type_support("test_msgs/BasicTypes"));
+  EXPECT_NE(nullptr, registry.get_message_type_support("test_msgs/msg/Empty"));
+  EXPECT_EQ(1u, registry.get_library_count());
+
+  EXPECT_NE(
+    nullptr,
+    registry.get_message_type_support(
+      "test_msgs/msg/Empty", "rosidl_typesupport_introspection_cpp"));
+  EXPECT_EQ(2u, registry.get_library_count());
+}
+
+TEST(TestTypeSupportRegistry, invalid_types) {
+  rclcpp::TypeSupportRegistry registry;
+  EXPECT_THROW(registry.get_message_type_support(""), std::runtime_error);
+  EXPECT_THROW(registry.get_message_type_support("BasicTypes"), std::runtime_error);
+  EXPECT_THROW(registry.get_message_type_support("test_msgs//BasicTypes"), std::runtime_error);
+  EXPECT_THROW(
+    registry.get_message_type_support("test_msgs/msg/BasicTypes/extra"), std::runtime_error);
+  EXPECT_THROW(
+    registry.get_message_type_support("test_msgs/msg/NotAType"), std::runtime_error);
+  EXPECT_THROW(
+    registry.get_message_type_support("not_a_package/msg/BasicTypes"), std::runtime_error);
+  EXPECT_THROW(
+    registry.get_message_type_support("test_msgs/msg/BasicTypes", "not_a_typesupport"),
+    std::runtime_error);
+}
+
+TEST(TestTypeSupportRegistry, concurrent_lookups) {
+  rclcpp::TypeSupportRegistry registry;
+  constexpr size_t number_of_threads = 8;
+  std::vector<const rosidl_message_type_support_t *> type_supports(number_of_threads);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < number_of_threads; ++i) {
+    threads.emplace_back(
+      [&registry, &type_supports, i]() {
+        for (int j = 0; j < 100; ++j) {
+          type_supports[i] = registry.get_message_type_support("test_msgs/msg/BasicTypes");
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  for (auto type_support : type_supports) {
+    EXPECT_EQ(type_supports[0], type_support);
+  }
+  EXPECT_EQ(1u, registry.get_library_count());
+}
+
+TEST(TestTypeSupportRegistry, serialization_by_type_name) {
+  auto registry = rclcpp::get_global_type_support_registry();
+  EXPECT_EQ(registry, rclcpp::get_global_type_support_registry());
+
+  rclcpp::SerializationBase serialization("test_msgs/msg/BasicTypes");
+  auto message = get_messages_basic_types()[0];
+  rclcpp::SerializedMessage serialized_message;
+  serialization.serialize_message(message.get(), &serialized_message);
+  test_msgs::msg::BasicTypes deserialized_message;
+  serialization.deserialize_message(&serialized_message, &deserialized_message);
+  EXPECT_EQ(*message, deserialized_message);
+
+  EXPECT_THROW(rclcpp::SerializationBase("test_msgs/msg/NotAType"), std::runtime_error);
+}
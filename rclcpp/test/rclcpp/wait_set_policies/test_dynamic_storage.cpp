@@ -231,6 +231,27 @@ TEST_F(TestDynamicStorage, add_remove_out_of_scope) {
   EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_set.wait(std::chrono::milliseconds(10)).kind());
 }
 
+TEST_F(TestDynamicStorage, rewait_after_out_of_scope) {
+  rclcpp::WaitSet wait_set;
+
+  auto guard_condition = std::make_shared<rclcpp::GuardCondition>();
+  wait_set.add_guard_condition(guard_condition);
+  {
+    auto timer = node->create_wall_timer(std::chrono::milliseconds(1), []() {});
+    wait_set.add_timer(timer);
+
+    // Waits twice without changes, so the second wait re-arms the recorded handles.
+    EXPECT_EQ(rclcpp::WaitResultKind::Ready, wait_set.wait(std::chrono::seconds(-1)).kind());
+    EXPECT_EQ(rclcpp::WaitResultKind::Ready, wait_set.wait(std::chrono::seconds(-1)).kind());
+  }
+
+  // The timer is gone, so the recorded handles must not be reused.
+  EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_set.wait(std::chrono::milliseconds(10)).kind());
+
+  guard_condition->trigger();
+  EXPECT_EQ(rclcpp::WaitResultKind::Ready, wait_set.wait(std::chrono::seconds(-1)).kind());
+}
+
 TEST_F(TestDynamicStorage, wait_subscription) {
   rclcpp::WaitSet wait_set;
 
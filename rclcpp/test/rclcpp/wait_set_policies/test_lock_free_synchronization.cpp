@@ -0,0 +1,194 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/wait_set.hpp"
+#include "../../utils/rclcpp_gtest_macros.hpp"
+
+#include "test_msgs/msg/empty.hpp"
+#include "test_msgs/srv/empty.hpp"
+
+class TestLockFreeSynchronization : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    rclcpp::init(0, nullptr);
+  }
+
+  static void TearDownTestCase()
+  {
+    rclcpp::shutdown();
+  }
+
+  void SetUp()
+  {
+    node = std::make_shared<rclcpp::Node>("node", "ns");
+  }
+
+  std::shared_ptr<rclcpp::Node> node;
+};
+
+class TestWaitable : public rclcpp::Waitable
+{
+public:
+  TestWaitable()
+  : is_ready_(false) {}
+  bool add_to_wait_set(rcl_wait_set_t *) override {return true;}
+
+  bool is_ready(rcl_wait_set_t *) override {return is_ready_;}
+
+  std::shared_ptr<void> take_data() override {return nullptr;}
+
+  void
+  execute(std::shared_ptr<void> & data) override {(void)data;}
+
+  void set_is_ready(bool value) {is_ready_ = value;}
+
+private:
+  bool is_ready_;
+};
+
+TEST_F(TestLockFreeSynchronization, default_construct_destruct) {
+  rclcpp::LockFreeWaitSet wait_set;
+  EXPECT_TRUE(rcl_wait_set_is_valid(&wait_set.get_rcl_wait_set()));
+
+  // The interrupt guard condition is never triggered, so this times out
+  EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_set.wait(std::chrono::milliseconds(10)).kind());
+}
+
+TEST_F(TestLockFreeSynchronization, add_remove_dynamically) {
+  rclcpp::LockFreeWaitSet wait_set;
+
+  auto subscription = node->create_subscription<test_msgs::msg::Empty>(
+    "topic", 10, [](test_msgs::msg::Empty::SharedPtr) {});
+  // This is long, so it can stick around and be removed
+  auto timer = node->create_wall_timer(std::chrono::seconds(100), []() {});
+  auto guard_condition = std::make_shared<rclcpp::GuardCondition>();
+  auto service =
+    node->create_service<test_msgs::srv::Empty>(
+    "service",
+    [](
+      const test_msgs::srv::Empty::Request::SharedPtr,
+      test_msgs::srv::Empty::Response::SharedPtr) {});
+  auto client = node->create_client<test_msgs::srv::Empty>("service");
+  auto waitable = std::make_shared<TestWaitable>();
+
+  // Adding twice does not throw, the second add is rejected when applied.
+  rclcpp::SubscriptionWaitSetMask mask{true, true, true};
+  EXPECT_NO_THROW(wait_set.add_subscription(subscription, mask));
+  EXPECT_NO_THROW(wait_set.add_subscription(subscription, mask));
+  EXPECT_NO_THROW(wait_set.add_timer(timer));
+  EXPECT_NO_THROW(wait_set.add_timer(timer));
+  EXPECT_NO_THROW(wait_set.add_guard_condition(guard_condition));
+  EXPECT_NO_THROW(wait_set.add_service(service));
+  EXPECT_NO_THROW(wait_set.add_client(client));
+  EXPECT_NO_THROW(wait_set.add_waitable(waitable));
+
+  // Nothing is applied until the next wait.
+  EXPECT_EQ(0u, wait_set.get_rcl_wait_set().size_of_timers);
+  EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_set.wait(std::chrono::milliseconds(10)).kind());
+  EXPECT_EQ(1u, wait_set.get_rcl_wait_set().size_of_timers);
+
+  wait_set.remove_subscription(subscription, mask);
+  wait_set.remove_timer(timer);
+  wait_set.remove_guard_condition(guard_condition);
+  wait_set.remove_service(service);
+  wait_set.remove_client(client);
+  wait_set.remove_waitable(waitable);
+  wait_set.prune_deleted_entities();
+
+  // Everything was removed, so this times out
+  EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_set.wait(std::chrono::milliseconds(10)).kind());
+  EXPECT_EQ(0u, wait_set.get_rcl_wait_set().size_of_timers);
+}
+
+TEST_F(TestLockFreeSynchronization, add_remove_nullptr) {
+  rclcpp::LockFreeWaitSet wait_set;
+
+  // These are still checked before staging, so they throw to the caller.
+  RCLCPP_EXPECT_THROW_EQ(
+    wait_set.add_subscription(nullptr), std::invalid_argument("subscription is nullptr"));
+  RCLCPP_EXPECT_THROW_EQ(
+    wait_set.add_guard_condition(nullptr), std::invalid_argument("guard_condition is nullptr"));
+  RCLCPP_EXPECT_THROW_EQ(
+    wait_set.add_timer(nullptr), std::invalid_argument("timer is nullptr"));
+  RCLCPP_EXPECT_THROW_EQ(
+    wait_set.add_client(nullptr), std::invalid_argument("client is nullptr"));
+  RCLCPP_EXPECT_THROW_EQ(
+    wait_set.add_service(nullptr), std::invalid_argument("service is nullptr"));
+  RCLCPP_EXPECT_THROW_EQ(
+    wait_set.add_waitable(nullptr), std::invalid_argument("waitable is nullptr"));
+}
+
+TEST_F(TestLockFreeSynchronization, add_out_of_scope) {
+  rclcpp::LockFreeWaitSet wait_set;
+
+  {
+    // This is short, so it will trigger the wait while it is alive
+    auto timer = node->create_wall_timer(std::chrono::milliseconds(1), []() {});
+    wait_set.add_timer(timer);
+  }
+
+  // The staged change keeps the timer alive through the wait which applies it, and its result.
+  EXPECT_EQ(rclcpp::WaitResultKind::Ready, wait_set.wait(std::chrono::seconds(-1)).kind());
+  // But not any longer than that.
+  EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_set.wait(std::chrono::milliseconds(10)).kind());
+}
+
+TEST_F(TestLockFreeSynchronization, add_while_waiting) {
+  rclcpp::LockFreeWaitSet wait_set;
+  auto guard_condition = std::make_shared<rclcpp::GuardCondition>();
+  auto start = std::chrono::steady_clock::now();
+
+  std::thread producer([&wait_set, guard_condition]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      guard_condition->trigger();
+      wait_set.add_guard_condition(guard_condition);
+    });
+
+  // The wait is interrupted, applies the change, and then sees the guard condition.
+  auto wait_result = wait_set.wait(std::chrono::seconds(10));
+  producer.join();
+  EXPECT_EQ(rclcpp::WaitResultKind::Ready, wait_result.kind());
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+}
+
+TEST_F(TestLockFreeSynchronization, wait_subscription) {
+  rclcpp::LockFreeWaitSet wait_set;
+
+  // Not added to wait_set, just used for publishing to the topic
+  auto publisher = node->create_publisher<test_msgs::msg::Empty>("topic", 10);
+
+  auto subscription = node->create_subscription<test_msgs::msg::Empty>(
+    "topic", 10, [](test_msgs::msg::Empty::SharedPtr) {});
+  wait_set.add_subscription(subscription);
+
+  {
+    auto wait_result = wait_set.wait(std::chrono::milliseconds(10));
+    EXPECT_EQ(rclcpp::WaitResultKind::Timeout, wait_result.kind());
+  }
+
+  publisher->publish(test_msgs::msg::Empty());
+  {
+    auto wait_result = wait_set.wait(std::chrono::seconds(-1));
+    EXPECT_EQ(rclcpp::WaitResultKind::Ready, wait_result.kind());
+  }
+}